@@ -9,6 +9,11 @@
 #include "tensor_tools.h"
 #include "../image_transforms/interpolation.h"
 #include "../threads.h"
+#include "../simd.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace dlib
 {
@@ -1291,6 +1296,95 @@ namespace dlib
     // -----------------------------------------------------------------------------------
     // -----------------------------------------------------------------------------------
 
+        namespace
+        {
+            // The activation kernels below do very little work per element, so they are
+            // only split across the thread pool once a tensor is at least this big.
+            const long min_parallel_activation_size = 1<<16;
+
+            template <typename T>
+            void for_each_span (
+                long size,
+                const T& funct
+            )
+            /*!
+                ensures
+                    - calls funct(begin,end) on disjoint ranges that together cover
+                      [0,size).  Large sizes are split across default_thread_pool().
+            !*/
+            {
+                if (size < min_parallel_activation_size || default_thread_pool().num_threads_in_pool() <= 1)
+                    funct(0, size);
+                else
+                    parallel_for_blocked(0, size, funct, 4);
+            }
+
+            template <typename T>
+            void for_each_sample (
+                const tensor& t,
+                const T& funct
+            )
+            /*!
+                ensures
+                    - calls funct(n) for each n in [0,t.num_samples()).  Samples are
+                      processed in parallel when t is large.
+            !*/
+            {
+                if ((long)t.size() < min_parallel_activation_size || t.num_samples() <= 1 ||
+                    default_thread_pool().num_threads_in_pool() <= 1)
+                {
+                    for (long n = 0; n < t.num_samples(); ++n)
+                        funct(n);
+                }
+                else
+                {
+                    parallel_for(0, t.num_samples(), funct);
+                }
+            }
+
+            // load() and store() move up to 8 floats between memory and a simd8f.  The
+            // tail of a range is padded with zeros so that every element, including the
+            // last few, goes through the same vectorized code.
+            inline simd8f load (
+                const float* ptr,
+                long n
+            )
+            {
+                simd8f v;
+                if (n == 8)
+                {
+                    v.load(ptr);
+                }
+                else
+                {
+                    float temp[8] = {};
+                    std::copy(ptr, ptr+n, temp);
+                    v.load(temp);
+                }
+                return v;
+            }
+
+            inline void store (
+                const simd8f& v,
+                float* ptr,
+                long n
+            )
+            {
+                if (n == 8)
+                {
+                    v.store(ptr);
+                }
+                else
+                {
+                    float temp[8];
+                    v.store(temp);
+                    std::copy(temp, temp+n, ptr);
+                }
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
         namespace ttimpl
         {
         void softmax (
@@ -1309,39 +1403,55 @@ namespace dlib
             // exp() to avoid numeric overflow in the subsequent computations.  Doing this
             // doesn't change the resulting output, it just makes it more numerically
             // stable.
-            for (long n = 0; n < src.num_samples(); ++n)
+            for_each_sample(src, [&](long n)
             {
-                auto ss = s + num_locations*num_channels*n;
-                auto dd = d + num_locations*num_channels*n;
-                for (long i = 0; i < num_locations; ++i)
+                const auto ss = s + num_locations*num_channels*n;
+                const auto dd = d + num_locations*num_channels*n;
+                if (num_locations == 1)
                 {
+                    // The channels are contiguous, so vectorize over them.
                     float max_val = -std::numeric_limits<float>::infinity();
                     for (long k = 0; k < num_channels; ++k)
-                        max_val = std::max(max_val, ss[k*num_locations]);
+                        max_val = std::max(max_val, ss[k]);
 
+                    simd8f temp = 0;
+                    for (long k = 0; k < num_channels; k += 8)
+                    {
+                        const long len = std::min<long>(8, num_channels-k);
+                        const simd8f v = exp(load(ss+k, len) - max_val);
+                        store(v, dd+k, len);
+                        // In the last block, reload so the padded lanes don't count.
+                        temp += (len == 8) ? v : load(dd+k, len);
+                    }
+                    const float scale = 1/sum(temp);
                     for (long k = 0; k < num_channels; ++k)
-                        dd[k*num_locations] = std::exp(ss[k*num_locations]-max_val);
-
-                    ++ss;
-                    ++dd;
+                        dd[k] *= scale;
                 }
-            }
-
-            // Now normalize each channel so they sum to 1.
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                const auto dd = d + num_locations*num_channels*n;
-                for (long i = 0; i < num_locations; ++i)
+                else
                 {
-                    const auto ddd = dd+i;
+                    // Otherwise the locations are contiguous, so do 8 of them at a time.
+                    for (long i = 0; i < num_locations; i += 8)
+                    {
+                        const long len = std::min<long>(8, num_locations-i);
+                        simd8f max_val = -std::numeric_limits<float>::infinity();
+                        for (long k = 0; k < num_channels; ++k)
+                            max_val = max(max_val, load(ss+k*num_locations+i, len));
 
-                    float temp = 0;
-                    for (long k = 0; k < num_channels; ++k)
-                        temp += ddd[k*num_locations];
-                    for (long k = 0; k < num_channels; ++k)
-                        ddd[k*num_locations] /= temp;
+                        simd8f temp = 0;
+                        for (long k = 0; k < num_channels; ++k)
+                        {
+                            const simd8f v = exp(load(ss+k*num_locations+i, len) - max_val);
+                            store(v, dd+k*num_locations+i, len);
+                            temp += v;
+                        }
+
+                        // Now normalize each channel so they sum to 1.
+                        const simd8f scale = 1/temp;
+                        for (long k = 0; k < num_channels; ++k)
+                            store(load(dd+k*num_locations+i, len)*scale, dd+k*num_locations+i, len);
+                    }
                 }
-            }
+            });
         }
 
         void softmax_gradient (
@@ -1360,7 +1470,7 @@ namespace dlib
             const auto in = gradient_input.host();
 
 
-            for (long n = 0; n < grad.num_samples(); ++n)
+            for_each_sample(grad, [&](long n)
             {
                 const auto d2 = d + num_locations*num_channels*n;
                 const auto g2 = g + num_locations*num_channels*n;
@@ -1385,7 +1495,7 @@ namespace dlib
                             g3[k*num_locations] += d3[k*num_locations]*(temp+in3[k*num_locations]);
                     }
                 }
-            }
+            });
         }
         }
 
@@ -1442,8 +1552,14 @@ namespace dlib
         {
             const auto d = dest.host();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
-                d[i] = 1/(1+std::exp(-s[i]));
+            for_each_span(src.size(), [&](long begin, long end)
+            {
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    store(1/(1+exp(0-load(s+i, len))), d+i, len);
+                }
+            });
         }
 
         void sigmoid_gradient (
@@ -1455,16 +1571,20 @@ namespace dlib
             const auto g = grad.host();
             const auto d = dest.host();
             const auto in = gradient_input.host();
-            if (is_same_object(gradient_input, grad))
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] = in[i]*d[i]*(1-d[i]);
-            }
-            else
+            const bool add_to = !is_same_object(gradient_input, grad);
+            for_each_span(dest.size(), [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] += in[i]*d[i]*(1-d[i]);
-            }
+                if (add_to)
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] += in[i]*d[i]*(1-d[i]);
+                }
+                else
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] = in[i]*d[i]*(1-d[i]);
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1476,12 +1596,17 @@ namespace dlib
         {
             const auto d = dest.host_write_only();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
+            for_each_span(src.size(), [&](long begin, long end)
             {
-                const auto e = std::exp(s[i]);
-                const auto delta = 2*e + e*e + 2;
-                d[i] = s[i] - 2*s[i]/delta;
-            }
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    const simd8f x = load(s+i, len);
+                    const simd8f e = exp(x);
+                    const simd8f delta = 2*e + e*e + 2;
+                    store(x - 2*x/delta, d+i, len);
+                }
+            });
         }
 
         void mish_gradient(
@@ -1493,30 +1618,31 @@ namespace dlib
             const auto g = grad.host();
             const auto s = src.host();
             const auto in = gradient_input.host();
-
-            const auto calculate_gradient = [](float x)
-            {
-                if (x >= 8)
-                    return 1.f;
-                if (x <= -8)
-                    return 0.f;
-
-                const auto e = std::exp(x);
-                const auto delta = 2*e + e*e + 2;
-                const auto omega = 4*(x + 1) + 4*e*e + e*e*e + e*(4*x + 6);
-                return e*omega/(delta*delta);
+            const bool add_to = !is_same_object(gradient_input, grad);
+
+            const auto calculate_gradient = [](const simd8f& x_)
+            {
+                // Clamp x so e*e*e can't overflow in the lanes that get replaced below.
+                const simd8f x = min(max(x_, -8), 8);
+                const simd8f e = exp(x);
+                const simd8f delta = 2*e + e*e + 2;
+                const simd8f omega = 4*(x + 1) + 4*e*e + e*e*e + e*(4*x + 6);
+                simd8f result = e*omega/(delta*delta);
+                result = select(x_ >= 8, 1, result);
+                return select(x_ <= -8, 0, result);
             };
 
-            if (is_same_object(gradient_input, grad))
-            {
-                for (size_t i = 0; i < src.size(); ++i)
-                    g[i] = in[i]*calculate_gradient(s[i]);
-            }
-            else
+            for_each_span(src.size(), [&](long begin, long end)
             {
-                for (size_t i = 0; i < src.size(); ++i)
-                    g[i] += in[i]*calculate_gradient(s[i]);
-            }
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    simd8f v = load(in+i, len)*calculate_gradient(load(s+i, len));
+                    if (add_to)
+                        v += load(g+i, len);
+                    store(v, g+i, len);
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1569,13 +1695,15 @@ namespace dlib
             const float p = param.host()[0];
             const float* s = src.host();
             float* d = dest.host();
-            for (size_t i = 0; i < dest.size(); ++i)
+            for_each_span(dest.size(), [&](long begin, long end)
             {
-                if (s[i] > 0)
-                    d[i] = s[i];
-                else
-                    d[i] = p*s[i];
-            }
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    const simd8f x = load(s+i, len);
+                    store(select(x > 0, x, p*x), d+i, len);
+                }
+            });
         }
 
         void prelu_gradient (
@@ -1591,19 +1719,23 @@ namespace dlib
             const float* gi = gradient_input.host();
             const float* s = src.host();
             float* out = grad.host();
+            std::mutex m;
             float pgrad = 0;
-            for (size_t i = 0; i < src.size(); ++i)
+            for_each_span(src.size(), [&](long begin, long end)
             {
-                if (s[i] > 0)
-                {
-                    out[i] += gi[i];
-                }
-                else
+                simd8f temp = 0;
+                for (long i = begin; i < end; i += 8)
                 {
-                    out[i] += p*gi[i];
-                    pgrad += gi[i]*s[i];
+                    const long len = std::min<long>(8, end-i);
+                    const simd8f x = load(s+i, len);
+                    const simd8f g = load(gi+i, len);
+                    const auto positive = x > 0;
+                    store(load(out+i, len) + select(positive, g, p*g), out+i, len);
+                    temp += select(positive, 0, g*x);
                 }
-            }
+                std::lock_guard<std::mutex> lock(m);
+                pgrad += sum(temp);
+            });
             params_grad.host()[0] = pgrad;
         }
 
@@ -1617,13 +1749,15 @@ namespace dlib
         {
             const float* s = src.host();
             float* d = dest.host();
-            for (size_t i = 0; i < dest.size(); ++i)
+            for_each_span(dest.size(), [&](long begin, long end)
             {
-                if (s[i] > 0)
-                    d[i] = s[i];
-                else
-                    d[i] = alpha * s[i];
-            }
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    const simd8f x = load(s+i, len);
+                    store(select(x > 0, x, alpha*x), d+i, len);
+                }
+            });
         }
 
         void leaky_relu_gradient (
@@ -1636,26 +1770,19 @@ namespace dlib
             const float* gi = gradient_input.host();
             const float* in = dest.host();
             float* out = grad.host();
-            if (is_same_object(grad, gradient_input))
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
-                {
-                    if (in[i] > 0)
-                        out[i] = gi[i];
-                    else
-                        out[i] = alpha * gi[i];
-                }
-            }
-            else
+            const bool add_to = !is_same_object(grad, gradient_input);
+            for_each_span(dest.size(), [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
+                for (long i = begin; i < end; i += 8)
                 {
-                    if (in[i] > 0)
-                        out[i] += gi[i];
-                    else
-                        out[i] += alpha * gi[i];
+                    const long len = std::min<long>(8, end-i);
+                    const simd8f g = load(gi+i, len);
+                    simd8f v = select(load(in+i, len) > 0, g, alpha*g);
+                    if (add_to)
+                        v += load(out+i, len);
+                    store(v, out+i, len);
                 }
-            }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1667,8 +1794,14 @@ namespace dlib
         {
             const auto d = dest.host();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
-                d[i] = std::tanh(s[i]);
+            for_each_span(src.size(), [&](long begin, long end)
+            {
+                for (long i = begin; i < end; i += 8)
+                {
+                    const long len = std::min<long>(8, end-i);
+                    store(dlib::tanh(load(s+i, len)), d+i, len);
+                }
+            });
         }
 
         void tanh_gradient (
@@ -1680,16 +1813,20 @@ namespace dlib
             const auto g = grad.host();
             const auto d = dest.host();
             const auto in = gradient_input.host();
-            if (is_same_object(grad, gradient_input))
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] = in[i]*(1-d[i]*d[i]);
-            }
-            else
+            const bool add_to = !is_same_object(grad, gradient_input);
+            for_each_span(dest.size(), [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] += in[i]*(1-d[i]*d[i]);
-            }
+                if (add_to)
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] += in[i]*(1-d[i]*d[i]);
+                }
+                else
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] = in[i]*(1-d[i]*d[i]);
+                }
+            });
         }
 
     // ----------------------------------------------------------------------------------------
@@ -2133,10 +2270,46 @@ namespace dlib
             const tensor& data,
             const tensor& filters
         )
+        {
+            epilogue_biases = nullptr;
+            forward(add_to_output, output, data, filters);
+        }
+
+        void tensor_conv::operator() (
+            const bool add_to_output,
+            resizable_tensor& output,
+            const tensor& data,
+            const tensor& filters,
+            const tensor& biases,
+            conv_activation activation,
+            float activation_param
+        )
+        {
+            DLIB_CASSERT(biases.size() == (size_t)filters.num_samples());
+            DLIB_CASSERT(last_stride_y > 0 && last_stride_x > 0, "You must call setup() before calling this function.");
+            output.set_size(data.num_samples(),
+                            filters.num_samples(),
+                            1+(data.nr()+2*last_padding_y-filters.nr())/last_stride_y,
+                            1+(data.nc()+2*last_padding_x-filters.nc())/last_stride_x);
+            epilogue_biases = &biases;
+            epilogue_activation = activation;
+            epilogue_param = activation_param;
+            forward(add_to_output, output, data, filters);
+            epilogue_biases = nullptr;
+        }
+
+        void tensor_conv::
+        forward (
+            const bool add_to_output,
+            tensor& output,
+            const tensor& data,
+            const tensor& filters
+        )
         {
             DLIB_CASSERT(is_same_object(output,data) == false);
             DLIB_CASSERT(is_same_object(output,filters) == false);
-            DLIB_CASSERT(filters.k() == data.k());
+            DLIB_CASSERT(filters.k()*last_groups == data.k());
+            DLIB_CASSERT(filters.num_samples()%last_groups == 0);
             DLIB_CASSERT(last_stride_y > 0 && last_stride_x > 0, "You must call setup() before calling this function.");
             DLIB_CASSERT(filters.nr() <= data.nr() + 2*last_padding_y,
                 "Filter windows must be small enough to fit into the padded image.");
@@ -2148,77 +2321,1042 @@ namespace dlib
             DLIB_CASSERT(output.nr() == 1+(data.nr()+2*last_padding_y-filters.nr())/last_stride_y);
             DLIB_CASSERT(output.nc() == 1+(data.nc()+2*last_padding_x-filters.nc())/last_stride_x);
 
+            if (output.size() == 0)
+                return;
 
-            matrix<float> temp;
-            for (long n = 0; n < data.num_samples(); ++n)
-            {
-                img2col(temp, data, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+            last_algorithm = select_algorithm(output, data, filters);
+            run_algorithm(last_algorithm, add_to_output, output, data, filters);
+        }
 
-                if (add_to_output)
-                    output.add_to_sample(n, mat(filters)*trans(temp));
-                else 
-                    output.set_sample(n, mat(filters)*trans(temp));
+        void tensor_conv::
+        apply_epilogue (
+            tensor& output,
+            long sample
+        ) const
+        {
+            if (epilogue_biases == nullptr)
+                return;
+
+            // The arithmetic here matches tt::add(), tt::relu(), tt::prelu(), and
+            // tt::leaky_relu() exactly, so fusing them doesn't change any outputs.
+            const long plane_size = output.nr()*output.nc();
+            float* out = output.host() + sample*output.k()*plane_size;
+            const float* b = epilogue_biases->host();
+            const float p = epilogue_param;
+            for (long k = 0; k < output.k(); ++k, out += plane_size)
+            {
+                const float bias = b[k];
+                switch (epilogue_activation)
+                {
+                    case conv_activation::none:
+                        for (long i = 0; i < plane_size; ++i)
+                            out[i] += bias;
+                        break;
+                    case conv_activation::relu:
+                        for (long i = 0; i < plane_size; ++i)
+                        {
+                            const float v = out[i] + bias;
+                            out[i] = v >= 0 ? v : 0;
+                        }
+                        break;
+                    case conv_activation::prelu:
+                    case conv_activation::leaky_relu:
+                        for (long i = 0; i < plane_size; ++i)
+                        {
+                            const float v = out[i] + bias;
+                            out[i] = v > 0 ? v : p*v;
+                        }
+                        break;
+                }
             }
         }
 
     // ------------------------------------------------------------------------------------
 
+        namespace
+        {
+            struct conv_shape
+            {
+                long k, nr, nc;
+                long num_filters, filter_nr, filter_nc;
+                long stride_y, stride_x, padding_y, padding_x;
+
+                bool operator< (const conv_shape& rhs) const
+                {
+                    return std::tie(k, nr, nc, num_filters, filter_nr, filter_nc, stride_y, stride_x, padding_y, padding_x) <
+                        std::tie(rhs.k, rhs.nr, rhs.nc, rhs.num_filters, rhs.filter_nr, rhs.filter_nc,
+                            rhs.stride_y, rhs.stride_x, rhs.padding_y, rhs.padding_x);
+                }
+            };
+
+            // The algorithm the autotuner found to be fastest for each convolution shape
+            // seen so far.  Shared by all tensor_conv objects in the program.
+            std::mutex tuned_conv_algorithms_mutex;
+            std::map<conv_shape, conv_algorithm> tuned_conv_algorithms;
+        }
+
+        bool tensor_conv::
+        is_applicable (
+            conv_algorithm algo,
+            const tensor& filters
+        ) const
+        {
+            if (last_groups != 1)
+                return algo == conv_algorithm::direct_grouped;
+
+            switch (algo)
+            {
+                case conv_algorithm::img2col_gemm:
+                    return true;
+                case conv_algorithm::direct_1x1:
+                    return filters.nr() == 1 && filters.nc() == 1 && 
+                        last_stride_y == 1 && last_stride_x == 1 &&
+                        last_padding_y == 0 && last_padding_x == 0;
+                case conv_algorithm::winograd_3x3:
+                    return filters.nr() == 3 && filters.nc() == 3 &&
+                        last_stride_y == 1 && last_stride_x == 1;
+                default:
+                    return false;
+            }
+        }
+
+        bool tensor_conv::
+        use_direct_1x1_gradients (
+            const tensor& filters
+        ) const
+        {
+            return (forced_algorithm == conv_algorithm::automatic || forced_algorithm == conv_algorithm::direct_1x1) &&
+                is_applicable(conv_algorithm::direct_1x1, filters);
+        }
+
+        conv_algorithm tensor_conv::
+        select_algorithm (
+            const tensor& output,
+            const tensor& data,
+            const tensor& filters
+        )
+        {
+            // Grouped convolutions have only one implementation.
+            if (last_groups != 1)
+                return conv_algorithm::direct_grouped;
+            if (forced_algorithm != conv_algorithm::automatic)
+                return is_applicable(forced_algorithm, filters) ? forced_algorithm : conv_algorithm::img2col_gemm;
+
+            // direct_1x1 doesn't need any scratch memory and is just the GEMM img2col_gemm
+            // would do anyway, so there is nothing to tune.
+            if (is_applicable(conv_algorithm::direct_1x1, filters))
+                return conv_algorithm::direct_1x1;
+            if (!is_applicable(conv_algorithm::winograd_3x3, filters))
+                return conv_algorithm::img2col_gemm;
+
+            // Winograd needs 16*data.k() floats of scratch space per 2x2 output tile
+            // while img2col needs 9*data.k() per output pixel, so Winograd is also the
+            // small option.
+            if (!dnn_prefer_fastest_algorithms())
+                return conv_algorithm::winograd_3x3;
+
+            const conv_shape shape = {data.k(), data.nr(), data.nc(),
+                filters.num_samples(), filters.nr(), filters.nc(),
+                last_stride_y, last_stride_x, last_padding_y, last_padding_x};
+            {
+                std::lock_guard<std::mutex> lock(tuned_conv_algorithms_mutex);
+                auto i = tuned_conv_algorithms.find(shape);
+                if (i != tuned_conv_algorithms.end())
+                    return i->second;
+            }
+
+            // We haven't seen this shape before, so time each applicable algorithm on
+            // the real inputs and remember the fastest one.
+            resizable_tensor scratch;
+            scratch.copy_size(output);
+            conv_algorithm best = conv_algorithm::img2col_gemm;
+            auto best_time = std::chrono::high_resolution_clock::duration::max();
+            for (auto algo : {conv_algorithm::img2col_gemm, conv_algorithm::winograd_3x3})
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                run_algorithm(algo, false, scratch, data, filters);
+                const auto elapsed = std::chrono::high_resolution_clock::now() - start;
+                if (elapsed < best_time)
+                {
+                    best_time = elapsed;
+                    best = algo;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(tuned_conv_algorithms_mutex);
+            tuned_conv_algorithms[shape] = best;
+            return best;
+        }
+
         void tensor_conv::
-        get_gradient_for_data (
+        run_algorithm (
+            conv_algorithm algo,
             const bool add_to_output,
-            const tensor& gradient_input, 
-            const tensor& filters,
-            tensor& data_gradient
+            tensor& output,
+            const tensor& data,
+            const tensor& filters
         )
         {
-            matrix<float> temp;
-            if (!add_to_output)
-                data_gradient = 0;
-            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            switch (algo)
             {
-                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
-                              gradient_input.k(),
-                              gradient_input.nr()*gradient_input.nc());
-                                    
-
-                temp = trans(gi)*mat(filters);
-                col2img(temp, data_gradient, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+                case conv_algorithm::direct_1x1:
+                    forward_direct_1x1(add_to_output, output, data, filters); break;
+                case conv_algorithm::winograd_3x3:
+                    forward_winograd_3x3(add_to_output, output, data, filters); break;
+                case conv_algorithm::direct_grouped:
+                    forward_direct_grouped(add_to_output, output, data, filters); break;
+                default:
+                    forward_img2col_gemm(add_to_output, output, data, filters); break;
             }
         }
 
-    // ------------------------------------------------------------------------------------
-
         void tensor_conv::
-        get_gradient_for_filters (
+        forward_img2col_gemm (
             const bool add_to_output,
-            const tensor& gradient_input, 
+            tensor& output,
             const tensor& data,
-            tensor& filters_gradient
+            const tensor& filters
         )
         {
-            matrix<float> temp;
-            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            for (long n = 0; n < data.num_samples(); ++n)
             {
-                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
-                              gradient_input.k(),
-                              gradient_input.nr()*gradient_input.nc());
+                img2col(img2col_buffer, data, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
 
+                if (add_to_output)
+                    output.add_to_sample(n, mat(filters)*trans(img2col_buffer));
+                else 
+                    output.set_sample(n, mat(filters)*trans(img2col_buffer));
+                apply_epilogue(output, n);
+            }
+        }
 
-                img2col(temp, data, n, filters_gradient.nr(), filters_gradient.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
-                if (n == 0)
-                {
-                    if (add_to_output)
-                        filters_gradient += gi*temp;
-                    else
-                        filters_gradient = gi*temp;
-                }
-                else
+        void tensor_conv::
+        forward_direct_1x1 (
+            const bool add_to_output,
+            tensor& output,
+            const tensor& data,
+            const tensor& filters
+        )
+        {
+            // With 1x1 filters, unit stride, and no padding, the img2col matrix of a sample
+            // is just the transpose of the sample itself.  So skip building it.
+            const long plane_size = data.nr()*data.nc();
+            for (long n = 0; n < data.num_samples(); ++n)
+            {
+                auto d = mat(data.host()+n*data.k()*plane_size, data.k(), plane_size);
+                if (add_to_output)
+                    output.add_to_sample(n, mat(filters)*d);
+                else 
+                    output.set_sample(n, mat(filters)*d);
+                apply_epilogue(output, n);
+            }
+        }
+
+        void tensor_conv::
+        forward_winograd_3x3 (
+            const bool add_to_output,
+            tensor& output,
+            const tensor& data,
+            const tensor& filters
+        )
+        {
+            /*
+                This is the F(2x2,3x3) algorithm from "Fast Algorithms for Convolutional
+                Neural Networks" by Lavin and Gray.  Each 2x2 block of output pixels is
+                computed from a 4x4 block of input pixels as
+                    Y = trans(A)*[sum over channels of (G*g*trans(G)) .* (trans(B)*d*B)]*A
+                where g is a 3x3 filter and .* is element-wise multiplication.  The sum
+                over channels for each of the 16 element positions is a GEMM, so we
+                transform the filters and a block of input tiles, run 16 GEMMs, and then
+                transform the products back into output pixels.
+            */
+            const long K = filters.num_samples();
+            const long C = data.k();
+            const long out_nr = output.nr();
+            const long out_nc = output.nc();
+            const long tiles_nr = (out_nr+1)/2;
+            const long tiles_nc = (out_nc+1)/2;
+            const long num_tiles = tiles_nr*tiles_nc;
+            // Process the tiles in blocks so the transformed input stays small.
+            const long block_size = std::min<long>(num_tiles, 256);
+
+            wino_filters.resize(16);
+            wino_data.resize(16);
+            wino_prod.resize(16);
+            for (long xi = 0; xi < 16; ++xi)
+                wino_filters[xi].set_size(K, C);
+
+            // Filter transform: U = G*g*trans(G)
+            const float* f = filters.host();
+            for (long k = 0; k < K; ++k)
+            {
+                for (long c = 0; c < C; ++c, f += 9)
+                {
+                    float gg[4][3];
+                    for (long x = 0; x < 3; ++x)
+                    {
+                        gg[0][x] = f[x];
+                        gg[1][x] = 0.5f*(f[x] + f[3+x] + f[6+x]);
+                        gg[2][x] = 0.5f*(f[x] - f[3+x] + f[6+x]);
+                        gg[3][x] = f[6+x];
+                    }
+                    for (long y = 0; y < 4; ++y)
+                    {
+                        wino_filters[y*4+0](k,c) = gg[y][0];
+                        wino_filters[y*4+1](k,c) = 0.5f*(gg[y][0] + gg[y][1] + gg[y][2]);
+                        wino_filters[y*4+2](k,c) = 0.5f*(gg[y][0] - gg[y][1] + gg[y][2]);
+                        wino_filters[y*4+3](k,c) = gg[y][2];
+                    }
+                }
+            }
+
+            for (long n = 0; n < data.num_samples(); ++n)
+            {
+                const float* d = data.host() + n*C*data.nr()*data.nc();
+                float* out = output.host() + n*K*out_nr*out_nc;
+
+                for (long tile_begin = 0; tile_begin < num_tiles; tile_begin += block_size)
+                {
+                    const long tile_end = std::min(num_tiles, tile_begin+block_size);
+                    const long num = tile_end-tile_begin;
+                    for (long xi = 0; xi < 16; ++xi)
+                        wino_data[xi].set_size(C, num);
+
+                    // Input transform: V = trans(B)*d*B
+                    for (long c = 0; c < C; ++c)
+                    {
+                        const float* plane = d + c*data.nr()*data.nc();
+                        for (long t = 0; t < num; ++t)
+                        {
+                            const long top = 2*((tile_begin+t)/tiles_nc) - last_padding_y;
+                            const long left = 2*((tile_begin+t)%tiles_nc) - last_padding_x;
+                            float v[4][4];
+                            for (long y = 0; y < 4; ++y)
+                            {
+                                for (long x = 0; x < 4; ++x)
+                                {
+                                    const long r = top+y;
+                                    const long cc = left+x;
+                                    if (0 <= r && r < data.nr() && 0 <= cc && cc < data.nc())
+                                        v[y][x] = plane[r*data.nc()+cc];
+                                    else
+                                        v[y][x] = 0;
+                                }
+                            }
+                            float bd[4][4];
+                            for (long x = 0; x < 4; ++x)
+                            {
+                                bd[0][x] = v[0][x] - v[2][x];
+                                bd[1][x] = v[1][x] + v[2][x];
+                                bd[2][x] = v[2][x] - v[1][x];
+                                bd[3][x] = v[1][x] - v[3][x];
+                            }
+                            for (long y = 0; y < 4; ++y)
+                            {
+                                wino_data[y*4+0](c,t) = bd[y][0] - bd[y][2];
+                                wino_data[y*4+1](c,t) = bd[y][1] + bd[y][2];
+                                wino_data[y*4+2](c,t) = bd[y][2] - bd[y][1];
+                                wino_data[y*4+3](c,t) = bd[y][1] - bd[y][3];
+                            }
+                        }
+                    }
+
+                    for (long xi = 0; xi < 16; ++xi)
+                        wino_prod[xi] = wino_filters[xi]*wino_data[xi];
+
+                    // Output transform: Y = trans(A)*M*A
+                    for (long k = 0; k < K; ++k)
+                    {
+                        float* out_plane = out + k*out_nr*out_nc;
+                        for (long t = 0; t < num; ++t)
+                        {
+                            float am[2][4];
+                            for (long x = 0; x < 4; ++x)
+                            {
+                                am[0][x] = wino_prod[x](k,t) + wino_prod[4+x](k,t) + wino_prod[8+x](k,t);
+                                am[1][x] = wino_prod[4+x](k,t) - wino_prod[8+x](k,t) - wino_prod[12+x](k,t);
+                            }
+                            const long top = 2*((tile_begin+t)/tiles_nc);
+                            const long left = 2*((tile_begin+t)%tiles_nc);
+                            for (long y = 0; y < 2 && top+y < out_nr; ++y)
+                            {
+                                const float val[2] = {am[y][0] + am[y][1] + am[y][2],
+                                                      am[y][1] - am[y][2] - am[y][3]};
+                                for (long x = 0; x < 2 && left+x < out_nc; ++x)
+                                {
+                                    float& o = out_plane[(top+y)*out_nc + left+x];
+                                    if (add_to_output)
+                                        o += val[x];
+                                    else
+                                        o = val[x];
+                                }
+                            }
+                        }
+                    }
+                }
+                apply_epilogue(output, n);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        namespace
+        {
+            template <typename T>
+            void for_each_conv_task (
+                long num_tasks,
+                double flops,
+                const T& funct
+            )
+            {
+                // Only bother with threads if there is enough work to amortize their
+                // overhead.  Each task writes to its own part of the output.
+                if (num_tasks > 1 && flops > 4e6 && default_thread_pool().num_threads_in_pool() > 1)
+                {
+                    parallel_for(0, num_tasks, funct);
+                }
+                else
+                {
+                    for (long i = 0; i < num_tasks; ++i)
+                        funct(i);
+                }
+            }
+
+            void pad_planes (
+                std::vector<float>& buf,
+                const float* src,
+                long num_planes,
+                long nr,
+                long nc,
+                long padding_y,
+                long padding_x
+            )
+            /*!
+                ensures
+                    - copies the num_planes nr by nc planes at src into buf, surrounding
+                      each of them with padding_y rows and padding_x columns of zeros.
+            !*/
+            {
+                const long pnr = nr+2*padding_y;
+                const long pnc = nc+2*padding_x;
+                buf.assign(num_planes*pnr*pnc, 0);
+                for (long k = 0; k < num_planes; ++k)
+                {
+                    for (long r = 0; r < nr; ++r)
+                    {
+                        const float* s = src + (k*nr + r)*nc;
+                        std::copy(s, s+nc, buf.data() + (k*pnr + r+padding_y)*pnc + padding_x);
+                    }
+                }
+            }
+        }
+
+        void tensor_conv::
+        forward_direct_grouped (
+            const bool add_to_output,
+            tensor& output,
+            const tensor& data,
+            const tensor& filters
+        )
+        {
+            // Each group is an independent, smaller convolution, and there are usually too
+            // few input channels per group for img2col+GEMM to pay off.  So this works
+            // directly on a zero padded copy of each group's input planes, one output row
+            // at a time, which keeps the inner loops contiguous when stride_x == 1.
+            const long groups = last_groups;
+            const long in_k = filters.k();
+            const long out_k = filters.num_samples()/groups;
+            const long fnr = filters.nr();
+            const long fnc = filters.nc();
+            const long sy = last_stride_y;
+            const long sx = last_stride_x;
+            const long pnr = data.nr()+2*last_padding_y;
+            const long pnc = data.nc()+2*last_padding_x;
+            const long out_nr = output.nr();
+            const long out_nc = output.nc();
+            const long in_plane = data.nr()*data.nc();
+            const long out_plane = out_nr*out_nc;
+
+            const float* d = data.host();
+            const float* f = filters.host();
+            float* out = add_to_output ? output.host() : output.host_write_only();
+
+            const double flops = 2.0*output.size()*in_k*fnr*fnc;
+            for_each_conv_task(data.num_samples()*groups, flops, [&](long i)
+            {
+                const long n = i/groups;
+                const long g = i%groups;
+                std::vector<float> buf;
+                pad_planes(buf, d + (n*data.k() + g*in_k)*in_plane, in_k, data.nr(), data.nc(),
+                    last_padding_y, last_padding_x);
+
+                for (long o = g*out_k; o < (g+1)*out_k; ++o)
+                {
+                    float* plane = out + (n*output.k() + o)*out_plane;
+                    if (!add_to_output)
+                        std::fill(plane, plane+out_plane, 0);
+                    const float* w = f + o*in_k*fnr*fnc;
+                    for (long y = 0; y < out_nr; ++y)
+                    {
+                        float* orow = plane + y*out_nc;
+                        for (long c = 0; c < in_k; ++c)
+                        {
+                            for (long fy = 0; fy < fnr; ++fy)
+                            {
+                                const float* prow = buf.data() + (c*pnr + y*sy + fy)*pnc;
+                                const float* wr = w + (c*fnr + fy)*fnc;
+                                if (sx == 1 && fnc == 3)
+                                {
+                                    // The common depthwise 3x3 case.  Doing all three taps
+                                    // in one pass saves two trips over the output row.
+                                    const float w0 = wr[0], w1 = wr[1], w2 = wr[2];
+                                    for (long x = 0; x < out_nc; ++x)
+                                        orow[x] += w0*prow[x] + w1*prow[x+1] + w2*prow[x+2];
+                                }
+                                else if (sx == 1)
+                                {
+                                    for (long fx = 0; fx < fnc; ++fx)
+                                    {
+                                        const float wv = wr[fx];
+                                        const float* p = prow + fx;
+                                        for (long x = 0; x < out_nc; ++x)
+                                            orow[x] += wv*p[x];
+                                    }
+                                }
+                                else
+                                {
+                                    for (long fx = 0; fx < fnc; ++fx)
+                                    {
+                                        const float wv = wr[fx];
+                                        const float* p = prow + fx;
+                                        for (long x = 0; x < out_nc; ++x)
+                                            orow[x] += wv*p[x*sx];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+
+            for (long n = 0; n < data.num_samples(); ++n)
+                apply_epilogue(output, n);
+        }
+
+        void tensor_conv::
+        get_gradient_for_data_grouped (
+            const bool add_to_output,
+            const tensor& gradient_input, 
+            const tensor& filters,
+            tensor& data_gradient
+        )
+        {
+            // The transpose of forward_direct_grouped(): scatter each gradient row back
+            // into a zero padded copy of the group's input planes, then copy out the
+            // interior.
+            const long groups = last_groups;
+            const long in_k = filters.k();
+            const long out_k = filters.num_samples()/groups;
+            const long fnr = filters.nr();
+            const long fnc = filters.nc();
+            const long sy = last_stride_y;
+            const long sx = last_stride_x;
+            const long nr = data_gradient.nr();
+            const long nc = data_gradient.nc();
+            const long pnr = nr+2*last_padding_y;
+            const long pnc = nc+2*last_padding_x;
+            const long out_nr = gradient_input.nr();
+            const long out_nc = gradient_input.nc();
+            const long out_plane = out_nr*out_nc;
+
+            const float* gi = gradient_input.host();
+            const float* f = filters.host();
+            float* dg = add_to_output ? data_gradient.host() : data_gradient.host_write_only();
+
+            const double flops = 2.0*gradient_input.size()*in_k*fnr*fnc;
+            for_each_conv_task(data_gradient.num_samples()*groups, flops, [&](long i)
+            {
+                const long n = i/groups;
+                const long g = i%groups;
+                std::vector<float> buf(in_k*pnr*pnc, 0);
+                for (long o = g*out_k; o < (g+1)*out_k; ++o)
+                {
+                    const float* plane = gi + (n*gradient_input.k() + o)*out_plane;
+                    const float* w = f + o*in_k*fnr*fnc;
+                    for (long y = 0; y < out_nr; ++y)
+                    {
+                        const float* grow = plane + y*out_nc;
+                        for (long c = 0; c < in_k; ++c)
+                        {
+                            for (long fy = 0; fy < fnr; ++fy)
+                            {
+                                float* prow = buf.data() + (c*pnr + y*sy + fy)*pnc;
+                                const float* wr = w + (c*fnr + fy)*fnc;
+                                for (long fx = 0; fx < fnc; ++fx)
+                                {
+                                    const float wv = wr[fx];
+                                    float* p = prow + fx;
+                                    if (sx == 1)
+                                    {
+                                        for (long x = 0; x < out_nc; ++x)
+                                            p[x] += wv*grow[x];
+                                    }
+                                    else
+                                    {
+                                        for (long x = 0; x < out_nc; ++x)
+                                            p[x*sx] += wv*grow[x];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+
+                for (long c = 0; c < in_k; ++c)
+                {
+                    for (long r = 0; r < nr; ++r)
+                    {
+                        const float* s = buf.data() + (c*pnr + r+last_padding_y)*pnc + last_padding_x;
+                        float* dst = dg + ((n*data_gradient.k() + g*in_k + c)*nr + r)*nc;
+                        if (add_to_output)
+                        {
+                            for (long x = 0; x < nc; ++x)
+                                dst[x] += s[x];
+                        }
+                        else
+                        {
+                            std::copy(s, s+nc, dst);
+                        }
+                    }
+                }
+            });
+        }
+
+        void tensor_conv::
+        get_gradient_for_filters_grouped (
+            const bool add_to_output,
+            const tensor& gradient_input, 
+            const tensor& data,
+            tensor& filters_gradient
+        )
+        {
+            // Every sample contributes to every filter, so split the work by group rather
+            // than by sample.  That way each task owns its filters outright.
+            const long groups = last_groups;
+            const long in_k = filters_gradient.k();
+            const long out_k = filters_gradient.num_samples()/groups;
+            const long fnr = filters_gradient.nr();
+            const long fnc = filters_gradient.nc();
+            const long sy = last_stride_y;
+            const long sx = last_stride_x;
+            const long pnr = data.nr()+2*last_padding_y;
+            const long pnc = data.nc()+2*last_padding_x;
+            const long in_plane = data.nr()*data.nc();
+            const long out_nr = gradient_input.nr();
+            const long out_nc = gradient_input.nc();
+            const long out_plane = out_nr*out_nc;
+            const long filter_size = in_k*fnr*fnc;
+
+            const float* gi = gradient_input.host();
+            const float* d = data.host();
+            float* fg = add_to_output ? filters_gradient.host() : filters_gradient.host_write_only();
+
+            const double flops = 2.0*gradient_input.size()*filter_size;
+            for_each_conv_task(groups, flops, [&](long g)
+            {
+                if (!add_to_output)
+                    std::fill(fg + g*out_k*filter_size, fg + (g+1)*out_k*filter_size, 0);
+
+                std::vector<float> buf;
+                for (long n = 0; n < data.num_samples(); ++n)
+                {
+                    pad_planes(buf, d + (n*data.k() + g*in_k)*in_plane, in_k, data.nr(), data.nc(),
+                        last_padding_y, last_padding_x);
+                    for (long o = g*out_k; o < (g+1)*out_k; ++o)
+                    {
+                        const float* plane = gi + (n*gradient_input.k() + o)*out_plane;
+                        float* wg = fg + o*filter_size;
+                        for (long c = 0; c < in_k; ++c)
+                        {
+                            for (long fy = 0; fy < fnr; ++fy)
+                            {
+                                for (long fx = 0; fx < fnc; ++fx)
+                                {
+                                    float acc = 0;
+                                    for (long y = 0; y < out_nr; ++y)
+                                    {
+                                        const float* grow = plane + y*out_nc;
+                                        const float* p = buf.data() + (c*pnr + y*sy + fy)*pnc + fx;
+                                        if (sx == 1)
+                                        {
+                                            for (long x = 0; x < out_nc; ++x)
+                                                acc += grow[x]*p[x];
+                                        }
+                                        else
+                                        {
+                                            for (long x = 0; x < out_nc; ++x)
+                                                acc += grow[x]*p[x*sx];
+                                        }
+                                    }
+                                    wg[(c*fnr + fy)*fnc + fx] += acc;
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void tensor_conv::
+        get_gradient_for_data (
+            const bool add_to_output,
+            const tensor& gradient_input, 
+            const tensor& filters,
+            tensor& data_gradient
+        )
+        {
+            if (last_groups != 1)
+            {
+                get_gradient_for_data_grouped(add_to_output, gradient_input, filters, data_gradient);
+                return;
+            }
+
+            if (use_direct_1x1_gradients(filters))
+            {
+                const long plane_size = data_gradient.nr()*data_gradient.nc();
+                for (long n = 0; n < gradient_input.num_samples(); ++n)
+                {
+                    auto gi = mat(gradient_input.host()+gradient_input.k()*plane_size*n,
+                                  gradient_input.k(),
+                                  plane_size);
+                    if (add_to_output)
+                        data_gradient.add_to_sample(n, trans(mat(filters))*gi);
+                    else
+                        data_gradient.set_sample(n, trans(mat(filters))*gi);
+                }
+                return;
+            }
+
+            matrix<float> temp;
+            if (!add_to_output)
+                data_gradient = 0;
+            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            {
+                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
+                              gradient_input.k(),
+                              gradient_input.nr()*gradient_input.nc());
+                                    
+
+                temp = trans(gi)*mat(filters);
+                col2img(temp, data_gradient, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void tensor_conv::
+        get_gradient_for_filters (
+            const bool add_to_output,
+            const tensor& gradient_input, 
+            const tensor& data,
+            tensor& filters_gradient
+        )
+        {
+            if (last_groups != 1)
+            {
+                get_gradient_for_filters_grouped(add_to_output, gradient_input, data, filters_gradient);
+                return;
+            }
+
+            if (use_direct_1x1_gradients(filters_gradient))
+            {
+                const long plane_size = data.nr()*data.nc();
+                for (long n = 0; n < gradient_input.num_samples(); ++n)
+                {
+                    auto gi = mat(gradient_input.host()+gradient_input.k()*plane_size*n,
+                                  gradient_input.k(),
+                                  plane_size);
+                    auto d = mat(data.host()+data.k()*plane_size*n, data.k(), plane_size);
+                    if (n == 0 && !add_to_output)
+                        filters_gradient = gi*trans(d);
+                    else
+                        filters_gradient += gi*trans(d);
+                }
+                return;
+            }
+
+            matrix<float> temp;
+            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            {
+                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
+                              gradient_input.k(),
+                              gradient_input.nr()*gradient_input.nc());
+
+
+                img2col(temp, data, n, filters_gradient.nr(), filters_gradient.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+                if (n == 0)
+                {
+                    if (add_to_output)
+                        filters_gradient += gi*temp;
+                    else
+                        filters_gradient = gi*temp;
+                }
+                else
                 {
                     filters_gradient += gi*temp;
                 }
             }
         }
 
+    // ------------------------------------------------------------------------------------
+
+        void int8_weights::
+        quantize (
+            const float* weights,
+            long num_outputs,
+            long num_inputs,
+            bool transposed
+        )
+        {
+            num_out = num_outputs;
+            num_in = num_inputs;
+            values.resize(num_out*num_in);
+            scales.resize(num_out);
+            for (long i = 0; i < num_out; ++i)
+            {
+                auto w = [&](long j) { return transposed ? weights[j*num_out+i] : weights[i*num_in+j]; };
+                float max_abs = 0;
+                for (long j = 0; j < num_in; ++j)
+                    max_abs = std::max(max_abs, std::abs(w(j)));
+                // An all zero row can use any scale, so just avoid dividing by zero.
+                scales[i] = max_abs != 0 ? max_abs/127 : 1;
+                for (long j = 0; j < num_in; ++j)
+                    values[i*num_in+j] = static_cast<int16>(std::lround(w(j)/scales[i]));
+            }
+        }
+
+        void int8_weights::
+        dequantize (
+            float* weights,
+            bool transposed
+        ) const
+        {
+            for (long i = 0; i < num_out; ++i)
+            {
+                const int16* r = row(i);
+                for (long j = 0; j < num_in; ++j)
+                {
+                    if (transposed)
+                        weights[j*num_out+i] = scales[i]*r[j];
+                    else
+                        weights[i*num_in+j] = scales[i]*r[j];
+                }
+            }
+        }
+
+        void serialize(const int8_weights& item, std::ostream& out)
+        {
+            dlib::serialize("int8_weights", out);
+            dlib::serialize(item.num_out, out);
+            dlib::serialize(item.num_in, out);
+            // The values are all in [-127,127] so save them as bytes.
+            dlib::serialize(std::vector<char>(item.values.begin(), item.values.end()), out);
+            dlib::serialize(item.scales, out);
+        }
+
+        void deserialize(int8_weights& item, std::istream& in)
+        {
+            std::string version;
+            dlib::deserialize(version, in);
+            if (version != "int8_weights")
+                throw serialization_error("Unexpected version '"+version+"' found while deserializing dlib::cpu::int8_weights.");
+            dlib::deserialize(item.num_out, in);
+            dlib::deserialize(item.num_in, in);
+            std::vector<char> values;
+            dlib::deserialize(values, in);
+            item.values.resize(values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                item.values[i] = static_cast<signed char>(values[i]);
+            dlib::deserialize(item.scales, in);
+            if (item.values.size() != (size_t)(item.num_out*item.num_in) || item.scales.size() != (size_t)item.num_out)
+                throw serialization_error("Corrupt dlib::cpu::int8_weights object found while deserializing.");
+        }
+
+        void quantize_to_int8 (
+            std::vector<int16>& dest,
+            const tensor& src,
+            float scale
+        )
+        {
+            DLIB_CASSERT(scale > 0);
+            dest.resize(src.size());
+            const float inv_scale = 1/scale;
+            const float* s = src.host();
+            for (size_t i = 0; i < src.size(); ++i)
+            {
+                const float v = std::min(127.0f, std::max(-127.0f, std::round(s[i]*inv_scale)));
+                dest[i] = static_cast<int16>(v);
+            }
+        }
+
+        namespace
+        {
+            void int8_gemm_nt (
+                const int16* a,
+                long M,
+                const int16* b,
+                long N,
+                long K,
+                int32* c
+            )
+            /*!
+                ensures
+                    - a is a row major M by K matrix and b is a row major N by K matrix.
+                    - #c is a row major M by N matrix such that c[m*N+n] == dot(row m of a, row n of b)
+            !*/
+            {
+                // Both operands are read along contiguous rows, so the compiler turns the
+                // inner loops into 16 bit multiply-adds (pmaddwd) with 32 bit accumulation.
+                // We do 4 rows of a at a time so each row of b is loaded once per 4 outputs.
+                long m = 0;
+                for (; m+4 <= M; m += 4)
+                {
+                    const int16* a0 = a + (m+0)*K;
+                    const int16* a1 = a + (m+1)*K;
+                    const int16* a2 = a + (m+2)*K;
+                    const int16* a3 = a + (m+3)*K;
+                    for (long n = 0; n < N; ++n)
+                    {
+                        const int16* bb = b + n*K;
+                        int32 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                        for (long k = 0; k < K; ++k)
+                        {
+                            const int32 v = bb[k];
+                            s0 += a0[k]*v;
+                            s1 += a1[k]*v;
+                            s2 += a2[k]*v;
+                            s3 += a3[k]*v;
+                        }
+                        c[(m+0)*N+n] = s0;
+                        c[(m+1)*N+n] = s1;
+                        c[(m+2)*N+n] = s2;
+                        c[(m+3)*N+n] = s3;
+                    }
+                }
+                for (; m < M; ++m)
+                {
+                    const int16* aa = a + m*K;
+                    for (long n = 0; n < N; ++n)
+                    {
+                        const int16* bb = b + n*K;
+                        int32 sum = 0;
+                        for (long k = 0; k < K; ++k)
+                            sum += aa[k]*bb[k];
+                        c[m*N+n] = sum;
+                    }
+                }
+            }
+        }
+
+        void int8_fc (
+            resizable_tensor& output,
+            const tensor& data,
+            float data_scale,
+            const int8_weights& weights
+        )
+        {
+            const long num_inputs = data.k()*data.nr()*data.nc();
+            DLIB_CASSERT(weights.num_inputs() == num_inputs);
+
+            output.set_size(data.num_samples(), weights.num_outputs());
+            if (output.size() == 0)
+                return;
+
+            std::vector<int16> qdata;
+            quantize_to_int8(qdata, data, data_scale);
+            std::vector<int32> acc(output.size());
+            int8_gemm_nt(&qdata[0], data.num_samples(),
+                weights.row(0), weights.num_outputs(), num_inputs, &acc[0]);
+
+            float* out = output.host();
+            for (long n = 0; n < output.num_samples(); ++n)
+            {
+                for (long k = 0; k < output.k(); ++k, ++out)
+                    *out = acc[n*output.k()+k]*data_scale*weights.scale(k);
+            }
+        }
+
+        void int8_conv (
+            resizable_tensor& output,
+            const tensor& data,
+            float data_scale,
+            const int8_weights& filters,
+            long filter_nr,
+            long filter_nc,
+            int stride_y,
+            int stride_x,
+            int padding_y,
+            int padding_x
+        )
+        {
+            DLIB_CASSERT(filters.num_inputs() == data.k()*filter_nr*filter_nc);
+
+            const long out_nr = 1+(data.nr()+2*padding_y-filter_nr)/stride_y;
+            const long out_nc = 1+(data.nc()+2*padding_x-filter_nc)/stride_x;
+            output.set_size(data.num_samples(), filters.num_outputs(), out_nr, out_nc);
+            if (output.size() == 0)
+                return;
+
+            std::vector<int16> qdata;
+            quantize_to_int8(qdata, data, data_scale);
+
+            // This is img2col() on the quantized data, laid out so that each output
+            // pixel's receptive field is one contiguous row.
+            const long row_size = filters.num_inputs();
+            const long num_pixels = out_nr*out_nc;
+            std::vector<int16> cols(num_pixels*row_size);
+            std::vector<int32> acc(filters.num_outputs()*num_pixels);
+            const long sample_size = data.k()*data.nr()*data.nc();
+            for (long n = 0; n < data.num_samples(); ++n)
+            {
+                const int16* d = &qdata[0] + n*sample_size;
+                int16* t = &cols[0];
+                for (long r = 0; r < out_nr; ++r)
+                {
+                    for (long c = 0; c < out_nc; ++c)
+                    {
+                        for (long k = 0; k < data.k(); ++k)
+                        {
+                            for (long y = 0; y < filter_nr; ++y)
+                            {
+                                const long yy = r*stride_y - padding_y + y;
+                                for (long x = 0; x < filter_nc; ++x)
+                                {
+                                    const long xx = c*stride_x - padding_x + x;
+                                    if (0 <= yy && yy < data.nr() && 0 <= xx && xx < data.nc())
+                                        *t++ = d[(k*data.nr() + yy)*data.nc() + xx];
+                                    else
+                                        *t++ = 0;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                int8_gemm_nt(filters.row(0), filters.num_outputs(), &cols[0], num_pixels, row_size, &acc[0]);
+
+                float* out = output.host() + n*filters.num_outputs()*num_pixels;
+                for (long k = 0; k < filters.num_outputs(); ++k)
+                {
+                    const float s = data_scale*filters.scale(k);
+                    for (long i = 0; i < num_pixels; ++i)
+                        out[k*num_pixels+i] = acc[k*num_pixels+i]*s;
+                }
+            }
+        }
+
      // ------------------------------------------------------------------------------------
 
         void copy_tensor(
@@ -8,6 +8,7 @@
 
 #include "tensor.h"
 #include "../geometry/rectangle.h"
+#include <vector>
 
 namespace dlib
 {
@@ -442,6 +443,23 @@ namespace dlib
 
     // -----------------------------------------------------------------------------------
 
+        enum class conv_algorithm
+        {
+            automatic,    // pick one of the options below based on the convolution's shape
+            img2col_gemm, // unfold the input with img2col() and run one GEMM per sample
+            direct_1x1,   // 1x1 filters with stride 1, a GEMM straight on the input tensor
+            winograd_3x3, // Winograd F(2x2,3x3) for 3x3 filters with stride 1
+            direct_grouped // direct loops over each group, always used when groups > 1
+        };
+
+        enum class conv_activation
+        {
+            none,
+            relu,       // max(0,x)
+            prelu,      // x>0 ? x : p*x
+            leaky_relu  // x>0 ? x : alpha*x
+        };
+
         class tensor_conv
         {
         public:
@@ -451,7 +469,29 @@ namespace dlib
             tensor_conv() {}
 
             void clear(
-            ) {}
+            ) { last_algorithm = conv_algorithm::img2col_gemm; }
+
+            void force_algorithm (
+                conv_algorithm algo
+            ) { forced_algorithm = algo; }
+            /*!
+                ensures
+                    - Subsequent calls to operator() use algo whenever it supports the
+                      shape of the convolution, falling back to img2col_gemm otherwise.
+                      Grouped convolutions always use direct_grouped.
+                      conv_algorithm::automatic restores the default behavior, where the
+                      algorithm is picked per shape.  If dnn_prefer_fastest_algorithms()
+                      then the applicable algorithms are timed on the first call for each
+                      shape and the fastest is remembered, otherwise the algorithm using
+                      the least scratch memory is used.
+            !*/
+
+            conv_algorithm get_last_algorithm (
+            ) const { return last_algorithm; }
+            /*!
+                ensures
+                    - returns the algorithm used by the most recent call to operator().
+            !*/
 
             void setup(
                 const tensor& data,    /* not used but required for interface */
@@ -459,17 +499,20 @@ namespace dlib
                 int stride_y,
                 int stride_x,
                 int padding_y,
-                int padding_x
+                int padding_x,
+                int groups = 1
             ) 
             {
                 (void)data;    /* silence compiler */
                 DLIB_CASSERT(stride_y > 0 && stride_x > 0);
                 DLIB_CASSERT(0 <= padding_y && padding_y < filters.nr());
                 DLIB_CASSERT(0 <= padding_x && padding_x < filters.nc());
+                DLIB_CASSERT(groups > 0);
                 last_stride_y = stride_y;
                 last_stride_x = stride_x;
                 last_padding_y = padding_y;
                 last_padding_x = padding_x;            
+                last_groups = groups;
             }
 
              void operator() (
@@ -486,6 +529,28 @@ namespace dlib
                 const tensor& filters
             );
 
+            void operator() (
+                const bool add_to_output,
+                resizable_tensor& output,
+                const tensor& data,
+                const tensor& filters,
+                const tensor& biases,
+                conv_activation activation,
+                float activation_param
+            );
+            /*!
+                requires
+                    - biases.size() == filters.num_samples()
+                ensures
+                    - Computes the same thing as calling (*this)(add_to_output,output,data,filters),
+                      then tt::add(1,output,1,biases), and then applying the given
+                      activation to output in place.  activation_param is prelu's
+                      parameter or leaky_relu's alpha and is otherwise ignored.
+                    - The bias and activation are applied to each sample right after it is
+                      convolved, while it's still in cache, rather than in separate passes
+                      over the whole output tensor.  The results are bit for bit the same.
+            !*/
+
             void get_gradient_for_data (
                 const bool add_to_output,
                 const tensor& gradient_input, 
@@ -502,12 +567,224 @@ namespace dlib
 
         private:
 
+            void forward (
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void apply_epilogue (
+                tensor& output,
+                long sample
+            ) const;
+            /*!
+                ensures
+                    - if (epilogue_biases != nullptr) then adds the biases to the given
+                      sample of output and applies epilogue_activation to it.
+            !*/
+
+            bool is_applicable (
+                conv_algorithm algo,
+                const tensor& filters
+            ) const;
+
+            bool use_direct_1x1_gradients (
+                const tensor& filters
+            ) const;
+
+            conv_algorithm select_algorithm (
+                const tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void run_algorithm (
+                conv_algorithm algo,
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void forward_img2col_gemm (
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void forward_direct_1x1 (
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void forward_winograd_3x3 (
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void forward_direct_grouped (
+                const bool add_to_output,
+                tensor& output,
+                const tensor& data,
+                const tensor& filters
+            );
+
+            void get_gradient_for_data_grouped (
+                const bool add_to_output,
+                const tensor& gradient_input, 
+                const tensor& filters,
+                tensor& data_gradient
+            );
+
+            void get_gradient_for_filters_grouped (
+                const bool add_to_output,
+                const tensor& gradient_input, 
+                const tensor& data,
+                tensor& filters_gradient
+            );
+
             long last_stride_y = 0;
             long last_stride_x = 0;
             long last_padding_y = 0;
             long last_padding_x = 0;
+            long last_groups = 1;
+
+            conv_algorithm forced_algorithm = conv_algorithm::automatic;
+            conv_algorithm last_algorithm = conv_algorithm::img2col_gemm;
+
+            const tensor* epilogue_biases = nullptr;
+            conv_activation epilogue_activation = conv_activation::none;
+            float epilogue_param = 0;
+
+            // scratch space reused across calls to avoid reallocating it for every sample
+            matrix<float> img2col_buffer;
+            std::vector<matrix<float>> wino_filters;
+            std::vector<matrix<float>> wino_data;
+            std::vector<matrix<float>> wino_prod;
         };
 
+    // -----------------------------------------------------------------------------------
+
+        class int8_weights
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object holds a num_outputs() by num_inputs() weight matrix that
+                    has been quantized to signed 8 bit integers.  Each row (i.e. each
+                    output channel) has its own scale, so row i of the original matrix is
+                    approximately scale(i)*row(i).  All values are in [-127,127].
+
+                    The values are held in memory widened to 16 bits.  That lets the
+                    kernels use the 16 bit multiply-add instructions every x86 CPU has,
+                    which is much faster than multiplying 8 bit values without AVX-512
+                    VNNI.  They are serialized as 8 bit values.
+            !*/
+        public:
+
+            int8_weights() = default;
+
+            void quantize (
+                const float* weights,
+                long num_outputs,
+                long num_inputs,
+                bool transposed
+            );
+            /*!
+                ensures
+                    - quantizes the given matrix.  If transposed==false then weights is a
+                      row major num_outputs by num_inputs matrix, otherwise it's a row
+                      major num_inputs by num_outputs matrix.
+            !*/
+
+            void dequantize (
+                float* weights,
+                bool transposed
+            ) const;
+            /*!
+                ensures
+                    - writes scale(i)*row(i) back into weights, using the same layout
+                      conventions as quantize().
+            !*/
+
+            bool empty() const { return values.size() == 0; }
+            long num_outputs() const { return num_out; }
+            long num_inputs() const { return num_in; }
+            float scale(long i) const { return scales[i]; }
+            const int16* row(long i) const { return &values[0] + i*num_in; }
+
+            void clear() { values.clear(); scales.clear(); num_out = 0; num_in = 0; }
+
+            friend void serialize(const int8_weights& item, std::ostream& out);
+            friend void deserialize(int8_weights& item, std::istream& in);
+
+        private:
+            long num_out = 0;
+            long num_in = 0;
+            std::vector<int16> values;
+            std::vector<float> scales;
+        };
+
+        void quantize_to_int8 (
+            std::vector<int16>& dest,
+            const tensor& src,
+            float scale
+        );
+        /*!
+            requires
+                - scale > 0
+            ensures
+                - #dest.size() == src.size()
+                - #dest[i] == the integer nearest to src.host()[i]/scale, clamped to
+                  [-127,127].
+        !*/
+
+        void int8_fc (
+            resizable_tensor& output,
+            const tensor& data,
+            float data_scale,
+            const int8_weights& weights
+        );
+        /*!
+            requires
+                - weights.num_inputs() == data.k()*data.nr()*data.nc()
+            ensures
+                - quantizes data to int8 using data_scale, multiplies it with weights
+                  using 32 bit integer accumulation, and then stores the rescaled float
+                  results into output.
+                - #output.num_samples() == data.num_samples()
+                - #output.k() == weights.num_outputs()
+                - #output.nr() == 1
+                - #output.nc() == 1
+        !*/
+
+        void int8_conv (
+            resizable_tensor& output,
+            const tensor& data,
+            float data_scale,
+            const int8_weights& filters,
+            long filter_nr,
+            long filter_nc,
+            int stride_y,
+            int stride_x,
+            int padding_y,
+            int padding_x
+        );
+        /*!
+            requires
+                - filters.num_inputs() == data.k()*filter_nr*filter_nc
+            ensures
+                - performs the same convolution as tensor_conv, except that the data is
+                  quantized to int8 using data_scale and the products are accumulated
+                  as 32 bit integers before being rescaled to float.
+                - #output.k() == filters.num_outputs()
+        !*/
+
     // -----------------------------------------------------------------------------------
 
         void copy_tensor(
@@ -729,6 +729,7 @@ namespace dlib
             stride_x = 0;
             padding_y = 0;
             padding_x = 0;
+            groups = 1;
             data_num_samples = 0;
             data_k = 0;
             data_nr = 0;
@@ -783,10 +784,13 @@ namespace dlib
             int stride_y_,
             int stride_x_,
             int padding_y_,
-            int padding_x_
+            int padding_x_,
+            int groups_
         ) 
         {
-            DLIB_CASSERT(data.k() == filters.k());
+            DLIB_CASSERT(groups_ > 0);
+            DLIB_CASSERT(data.k() == filters.k()*groups_);
+            DLIB_CASSERT(filters.num_samples()%groups_ == 0);
 
             // if the last call to setup gave the same exact settings then don't do
             // anything.
@@ -794,6 +798,7 @@ namespace dlib
                 stride_x_ == stride_x &&
                 padding_y_ == padding_y && 
                 padding_x_ == padding_x &&
+                groups_ == groups &&
                 data_num_samples == data.num_samples() &&
                 data_k == data.k() &&
                 data_nr == data.nr() &&
@@ -813,6 +818,7 @@ namespace dlib
                 stride_x = stride_x_;
                 padding_y = padding_y_;
                 padding_x = padding_x_;
+                groups = groups_;
                 data_num_samples = data.num_samples();
                 data_k = data.k();
                 data_nr = data.nr();
@@ -850,6 +856,11 @@ namespace dlib
                         1, 1, // must be 1,1
                         CUDNN_CROSS_CORRELATION)); // could also be CUDNN_CONVOLUTION
 #endif
+#if CUDNN_MAJOR >= 7
+                CHECK_CUDNN(cudnnSetConvolutionGroupCount((cudnnConvolutionDescriptor_t)conv_handle, groups));
+#else
+                DLIB_CASSERT(groups == 1, "Grouped convolutions require cuDNN 7 or newer.");
+#endif
 
                 CHECK_CUDNN(cudnnGetConvolution2dForwardOutputDim(
                         (const cudnnConvolutionDescriptor_t)conv_handle,
@@ -1040,7 +1051,7 @@ namespace dlib
         {
             DLIB_CASSERT(is_same_object(output,data) == false);
             DLIB_CASSERT(is_same_object(output,filters) == false);
-            DLIB_CASSERT(filters.k() == data.k());
+            DLIB_CASSERT(filters.k()*groups == data.k());
             DLIB_CASSERT(stride_y > 0 && stride_x > 0, "You must call setup() before calling this function");
             DLIB_CASSERT(filters.nc() <= data.nc() + 2*padding_x,
                 "Filter windows must be small enough to fit into the padded image."
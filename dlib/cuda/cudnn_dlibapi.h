@@ -205,7 +205,8 @@ namespace dlib
                 int stride_y,
                 int stride_x,
                 int padding_y,
-                int padding_x
+                int padding_x,
+                int groups = 1
             );
 
         private:
@@ -215,6 +216,7 @@ namespace dlib
             int stride_x;
             int padding_y;
             int padding_x;
+            int groups;
             long data_num_samples, data_k, data_nr, data_nc;
             long filters_num_samples, filters_k, filters_nr, filters_nc;
 
@@ -84,6 +84,26 @@ namespace dlib
         }
 #endif
 
+        void set_host_memory (
+            const std::shared_ptr<float>& mem,
+            size_t new_size
+        )
+        {
+#ifdef DLIB_USE_CUDA
+            // The device needs its own memory anyway, so just copy into our usual buffers.
+            set_size(new_size);
+            if (new_size != 0)
+                std::memcpy(host_write_only(), mem.get(), new_size*sizeof(float));
+#else
+            data_size = new_size;
+            host_current = true;
+            device_current = true;
+            device_in_use = false;
+            data_host = new_size != 0 ? mem : std::shared_ptr<float>();
+            data_device.reset();
+#endif
+        }
+
         const float* host() const 
         { 
             copy_to_host();
@@ -85,6 +85,24 @@ namespace dlib
                 - #size() == new_size
         !*/
 
+        void set_host_memory (
+            const std::shared_ptr<float>& mem,
+            size_t new_size
+        );
+        /*!
+            requires
+                - mem points to at least new_size floats
+            ensures
+                - #size() == new_size
+                - #host() contains the first new_size floats in mem.
+                - if (DLIB_USE_CUDA is not defined) then
+                    - no copy is made.  *this simply shares mem, so #host() == mem.get()
+                      and changes to one are visible in the other.  This is how tensors
+                      loaded from a mapped archive point into the mapped file.
+                - else
+                    - the floats are copied into memory owned by *this.
+        !*/
+
         bool host_ready (
         ) const;
         /*!
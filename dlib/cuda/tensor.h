@@ -18,6 +18,8 @@ namespace dlib
 // ----------------------------------------------------------------------------------------
 
     class tensor;
+    class resizable_tensor;
+    inline void deserialize(resizable_tensor& item, std::istream& in);
     namespace cuda
     {
         void set_tensor (
@@ -431,6 +433,8 @@ namespace dlib
 
     private:
 
+        friend void deserialize(resizable_tensor& item, std::istream& in);
+
 #ifdef DLIB_USE_CUDA
         cuda::tensor_descriptor cudnn_descriptor;
 #endif 
@@ -449,6 +453,11 @@ namespace dlib
         serialize(item.k(), out);
         serialize(item.nr(), out);
         serialize(item.nc(), out);
+        if (auto archive = ser_helper::get_mapped_archive(out))
+        {
+            archive->write_block(item.host(), item.size());
+            return;
+        }
         byte_orderer bo;
         auto sbuf = out.rdbuf();
         for (auto d : item)
@@ -477,6 +486,15 @@ namespace dlib
         deserialize(k, in);
         deserialize(nr, in);
         deserialize(nc, in);
+        if (auto archive = ser_helper::get_mapped_archive(in))
+        {
+            // Point the tensor straight at the mapped file rather than copying it.  The
+            // tensor keeps the mapping alive.
+            const size_t size = num_samples*k*nr*nc;
+            item.data_instance.set_host_memory(archive->read_block<float>(size), size);
+            item.set_size(num_samples, k, nr, nc);
+            return;
+        }
         item.set_size(num_samples, k, nr, nc);
         byte_orderer bo;
         auto sbuf = in.rdbuf();
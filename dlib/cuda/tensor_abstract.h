@@ -567,6 +567,10 @@ namespace dlib
     /*!
         provides serialization support for tensor and resizable_tensor.  Note that you can
         serialize to/from any combination of tenor and resizable_tensor objects.
+
+        When reading from a mapped archive (see serialize_mapped() in dlib/serialize.h)
+        the tensor's host memory points directly into the mapped file, unless CUDA is
+        being used, in which case the data is copied.
     !*/
 
 // ----------------------------------------------------------------------------------------
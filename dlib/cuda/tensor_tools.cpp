@@ -281,6 +281,45 @@ namespace dlib { namespace tt
 #endif
     }
 
+// ----------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------
+
+    void tensor_conv::operator() (
+        const bool add_to_output,
+        resizable_tensor& output,
+        const tensor& data,
+        const tensor& filters,
+        const tensor& biases,
+        cpu::conv_activation activation,
+        float activation_param
+    )
+    {
+#ifdef DLIB_USE_CUDA
+        impl(add_to_output,output,data,filters);
+        add(1,output,1,biases);
+        switch (activation)
+        {
+            case cpu::conv_activation::none:
+                break;
+            case cpu::conv_activation::relu:
+                relu(output, output);
+                break;
+            case cpu::conv_activation::prelu:
+                {
+                    resizable_tensor param(1);
+                    param = activation_param;
+                    prelu(output, output, param);
+                }
+                break;
+            case cpu::conv_activation::leaky_relu:
+                leaky_relu(output, output, activation_param);
+                break;
+        }
+#else
+        impl(add_to_output,output,data,filters,biases,activation,activation_param);
+#endif
+    }
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
 
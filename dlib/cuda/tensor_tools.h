@@ -942,10 +942,11 @@ namespace dlib { namespace tt
         /*!
             requires
                 - setup() has been called.  Specifically, setup() has been called like this:
-                    this->setup(data, filters, stride_y, stride_x, padding_y, padding_x);
+                    this->setup(data, filters, stride_y, stride_x, padding_y, padding_x, groups);
                 - is_same_object(output,data) == false
                 - is_same_object(output,filters) == false
-                - filters.k() == data.k()
+                - filters.k()*groups == data.k()
+                - filters.num_samples()%groups == 0
                 - filters.nr() <= src.nr() + 2*padding_y
                 - filters.nc() <= src.nc() + 2*padding_x
                 - #output.num_samples() == data.num_samples()
@@ -957,6 +958,10 @@ namespace dlib { namespace tt
                   results to output, otherwise we assign to output, overwriting the
                   previous values in output.
                 - filters contains filters.num_samples() filters. 
+                - The channels of data and the filters are split into groups equal
+                  parts.  Filter i only sees the data channels in group
+                  i/(filters.num_samples()/groups), so output channels of one group
+                  don't depend on the inputs of any other group.
         !*/
 
         void operator() (
@@ -968,10 +973,11 @@ namespace dlib { namespace tt
         /*!
             requires
                 - setup() has been called.  Specifically, setup() has been called like this:
-                    this->setup(data, filters, stride_y, stride_x, padding_y, padding_x);
+                    this->setup(data, filters, stride_y, stride_x, padding_y, padding_x, groups);
                 - is_same_object(output,data) == false
                 - is_same_object(output,filters) == false
-                - filters.k() == data.k()
+                - filters.k()*groups == data.k()
+                - filters.num_samples()%groups == 0
                 - filters.nr() <= src.nr() + 2*padding_y
                 - filters.nc() <= src.nc() + 2*padding_x
             ensures
@@ -985,6 +991,29 @@ namespace dlib { namespace tt
                 - #output.nc() == 1+(data.nc() + 2*padding_x - filters.nc())/stride_x
         !*/
 
+        void operator() (
+            const bool add_to_output,
+            resizable_tensor& output,
+            const tensor& data,
+            const tensor& filters,
+            const tensor& biases,
+            cpu::conv_activation activation,
+            float activation_param
+        );
+        /*!
+            requires
+                - The same requirements as the above operator() apply.
+                - biases.size() == filters.num_samples()
+            ensures
+                - Performs (*this)(add_to_output,output,data,filters), then adds biases to
+                  each channel of output as tt::add(1,output,1,biases) would, and then
+                  applies the requested activation to output.  activation_param is the
+                  prelu parameter or the leaky_relu alpha, and is ignored otherwise.
+                - On the CPU the bias and activation are fused into the convolution so
+                  they don't require extra passes over output.  The results are identical
+                  to doing the steps separately.
+        !*/
+
         void get_gradient_for_data (
             const bool add_to_output,
             const tensor& gradient_input, 
@@ -998,7 +1027,7 @@ namespace dlib { namespace tt
                       last call to operator().  Also, data_gradient has the same dimensions
                       as the data object given to the last call to operator().
                     - setup() has been called.  Specifically, setup() has been called like this:
-                      this->setup(data_gradient, filters, stride_y, stride_x, padding_y, padding_x);
+                      this->setup(data_gradient, filters, stride_y, stride_x, padding_y, padding_x, groups);
                 - gradient_input has the following dimensions:
                     - gradient_input.num_samples() == data_gradient.num_samples()
                     - gradient_input.k() == filters.num_samples()
@@ -1033,7 +1062,7 @@ namespace dlib { namespace tt
                       to the last call to operator().  Also, data has the same dimensions
                       as the data object given to the last call to operator().
                     - setup() has been called.  Specifically, setup() has been called like this:
-                      this->setup(data, filters_gradient, stride_y, stride_x, padding_y, padding_x);
+                      this->setup(data, filters_gradient, stride_y, stride_x, padding_y, padding_x, groups);
                 - gradient_input has the following dimensions:
                     - gradient_input.num_samples() == data.num_samples()
                     - gradient_input.k() == filters.num_samples()
@@ -1062,11 +1091,14 @@ namespace dlib { namespace tt
             int stride_y,
             int stride_x,
             int padding_y,
-            int padding_x
-        ) {impl.setup(data,filters,stride_y,stride_x,padding_y,padding_x); }
+            int padding_x,
+            int groups = 1
+        ) {impl.setup(data,filters,stride_y,stride_x,padding_y,padding_x,groups); }
         /*!
             requires
-                - filters.k() == data.k()
+                - groups > 0
+                - filters.k()*groups == data.k()
+                - filters.num_samples()%groups == 0
                 - stride_y > 0
                 - stride_x > 0
                 - 0 <= padding_y < filters.nr()
@@ -1077,6 +1109,10 @@ namespace dlib { namespace tt
                     - output.nc() == 1+(data.nc() + 2*padding_x - filters.nc())/stride_x
                     - output.num_samples() == data.num_samples()
                     - output.k() == filters.num_samples()
+                - The convolution is split into the given number of groups.  groups == 1
+                  is an ordinary convolution and groups == data.k() is a depthwise one.
+                  On the CPU, grouped convolutions are computed directly rather than with
+                  img2col and a GEMM.
                 - The point of setup() is to allow this object to gather information about
                   all the tensor sizes and filter layouts involved in the computation.  In
                   particular, the reason the tensors are input into setup() is just to
@@ -27,10 +27,16 @@
 #include "dnn/core.h"
 #include "dnn/solvers.h"
 #include "dnn/trainer.h"
+#include "dnn/data_loader.h"
+#include "dnn/batching.h"
 #include "cuda/cpu_dlib.h"
 #include "cuda/tensor_tools.h"
 #include "dnn/utilities.h"
 #include "dnn/validation.h"
+#include "dnn/tiled_inference.h"
+#include "dnn/graph.h"
+#include "dnn/quantization.h"
+#include "dnn/shared_net.h"
 
 #endif // DLIB_DNn_
 
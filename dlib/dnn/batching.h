@@ -0,0 +1,195 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_BATCHING_H_
+#define DLIB_DNn_BATCHING_H_
+
+#include "batching_abstract.h"
+#include "core.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_batching_executor
+    {
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::output_label_type output_label_type;
+
+        explicit dnn_batching_executor (
+            const net_type& net_,
+            size_t max_batch_size_ = 32,
+            std::chrono::microseconds max_delay_ = std::chrono::milliseconds(2)
+        ) :
+            net(net_),
+            max_batch_size(max_batch_size_),
+            max_delay(max_delay_),
+            stopping(false),
+            requests(0),
+            batches(0)
+        {
+            DLIB_CASSERT(max_batch_size_ > 0);
+            DLIB_CASSERT(max_delay_.count() >= 0);
+            worker = std::thread([this](){ process_requests(); });
+        }
+
+        dnn_batching_executor(const dnn_batching_executor&) = delete;
+        dnn_batching_executor& operator=(const dnn_batching_executor&) = delete;
+
+        ~dnn_batching_executor (
+        )
+        {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            worker.join();
+        }
+
+        size_t get_max_batch_size (
+        ) const { return max_batch_size; }
+
+        std::chrono::microseconds get_max_delay (
+        ) const { return max_delay; }
+
+        std::future<output_label_type> submit (
+            input_type x
+        )
+        {
+            request r;
+            r.x = std::move(x);
+            r.arrival = clock::now();
+            std::future<output_label_type> result = r.promise.get_future();
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                queue.push_back(std::move(r));
+                // The worker only needs to hear about the first request of a batch, so
+                // it can start its deadline, and about the one that fills a batch.
+                wake = queue.size() == 1 || queue.size() == max_batch_size;
+            }
+            if (wake)
+                cv.notify_one();
+            return result;
+        }
+
+        output_label_type operator() (
+            const input_type& x
+        )
+        {
+            return submit(x).get();
+        }
+
+        unsigned long long get_num_requests (
+        ) const { std::lock_guard<std::mutex> lock(m); return requests; }
+
+        unsigned long long get_num_batches (
+        ) const { std::lock_guard<std::mutex> lock(m); return batches; }
+
+        double get_average_batch_size (
+        ) const
+        {
+            std::lock_guard<std::mutex> lock(m);
+            return batches ? requests/(double)batches : 0;
+        }
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        struct request
+        {
+            input_type x;
+            std::promise<output_label_type> promise;
+            clock::time_point arrival;
+        };
+
+        void process_requests (
+        )
+        {
+            std::vector<request> batch;
+            std::vector<input_type> inputs;
+            std::vector<output_label_type> outputs;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    cv.wait(lock, [this](){ return stopping || queue.size() != 0; });
+                    if (queue.size() == 0)
+                        return;
+
+                    // Wait for more requests until the batch is full or the oldest request
+                    // has waited max_delay.  When stopping we don't wait at all since no
+                    // more requests are coming.
+                    const auto deadline = queue.front().arrival + max_delay;
+                    cv.wait_until(lock, deadline, [this](){ return stopping || queue.size() >= max_batch_size; });
+
+                    const size_t num = std::min(queue.size(), max_batch_size);
+                    batch.clear();
+                    for (size_t i = 0; i < num; ++i)
+                    {
+                        batch.push_back(std::move(queue.front()));
+                        queue.pop_front();
+                    }
+                    requests += num;
+                    ++batches;
+                }
+
+                inputs.resize(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i)
+                    inputs[i] = std::move(batch[i].x);
+                outputs.resize(batch.size());
+                std::exception_ptr eptr;
+                try
+                {
+                    net(inputs.begin(), inputs.end(), outputs.begin());
+                }
+                catch (...)
+                {
+                    eptr = std::current_exception();
+                }
+
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    if (eptr)
+                        batch[i].promise.set_exception(eptr);
+                    else
+                        batch[i].promise.set_value(std::move(outputs[i]));
+                }
+            }
+        }
+
+        net_type net;
+        const size_t max_batch_size;
+        const std::chrono::microseconds max_delay;
+
+        mutable std::mutex m;
+        std::condition_variable cv;
+        std::deque<request> queue;
+        bool stopping;
+        unsigned long long requests;
+        unsigned long long batches;
+
+        std::thread worker;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_BATCHING_H_
+
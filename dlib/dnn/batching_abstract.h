@@ -0,0 +1,144 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_BATCHING_ABSTRACT_H_
+#ifdef DLIB_DNn_BATCHING_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include <chrono>
+#include <future>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_batching_executor
+    {
+        /*!
+            REQUIREMENTS ON NET_TYPE
+                NET_TYPE is an add_loss_layer object.
+
+            WHAT THIS OBJECT REPRESENTS
+                This object runs a network on inputs that arrive one at a time from many
+                threads, e.g. the request handlers of a web service, by collecting them
+                into mini-batches.  Running a network on a mini-batch is much cheaper per
+                sample than running it on each sample separately, since the convolutions
+                and matrix multiplies turn into larger and more efficient GEMM calls.
+
+                Each call to submit() queues one input and returns a std::future for its
+                output.  A background thread waits until either get_max_batch_size()
+                inputs are queued or the oldest queued input has waited get_max_delay(),
+                then runs them all through its copy of the network in one call to
+                to_tensor() and forward() and gives each caller its part of the
+                output.  So under light load a request waits at most get_max_delay()
+                longer than it would otherwise, and under heavy load the network runs on
+                full mini-batches.
+
+                All the inputs in a mini-batch must be accepted together by the network's
+                to_tensor().  E.g. for input_rgb_image all the images must be the same
+                size.  If to_tensor() or the network throws then every request in that
+                mini-batch gets the exception.
+
+            THREAD SAFETY
+                All the member functions of this object are thread safe.
+        !*/
+
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::output_label_type output_label_type;
+
+        explicit dnn_batching_executor (
+            const net_type& net,
+            size_t max_batch_size = 32,
+            std::chrono::microseconds max_delay = std::chrono::milliseconds(2)
+        );
+        /*!
+            requires
+                - max_batch_size > 0
+                - max_delay.count() >= 0
+            ensures
+                - #*this runs a copy of net.
+                - #get_max_batch_size() == max_batch_size
+                - #get_max_delay() == max_delay
+                - #get_num_requests() == 0
+                - #get_num_batches() == 0
+        !*/
+
+        ~dnn_batching_executor (
+        );
+        /*!
+            ensures
+                - Processes all the inputs that have already been submitted and then
+                  stops the background thread.
+        !*/
+
+        size_t get_max_batch_size (
+        ) const;
+        /*!
+            ensures
+                - returns the largest number of inputs run through the network at once.
+        !*/
+
+        std::chrono::microseconds get_max_delay (
+        ) const;
+        /*!
+            ensures
+                - returns how long an input waits for other inputs to batch with before
+                  the network is run on whatever has been submitted so far.
+        !*/
+
+        std::future<output_label_type> submit (
+            input_type x
+        );
+        /*!
+            ensures
+                - Queues x to be run through the network and returns a future that will
+                  hold the network's output for x, i.e. the same thing net(x) would
+                  return.
+        !*/
+
+        output_label_type operator() (
+            const input_type& x
+        );
+        /*!
+            ensures
+                - returns submit(x).get()
+        !*/
+
+        unsigned long long get_num_requests (
+        ) const;
+        /*!
+            ensures
+                - returns the number of inputs that have been run through the network so
+                  far.
+        !*/
+
+        unsigned long long get_num_batches (
+        ) const;
+        /*!
+            ensures
+                - returns the number of mini-batches that have been run through the
+                  network so far.
+        !*/
+
+        double get_average_batch_size (
+        ) const;
+        /*!
+            ensures
+                - if (get_num_batches() == 0) then
+                    - returns 0
+                - else
+                    - returns get_num_requests()/(double)get_num_batches()
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_BATCHING_ABSTRACT_H_
+
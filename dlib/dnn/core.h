@@ -4,9 +4,11 @@
 #define DLIB_DNn_CORE_H_
 
 #include "core_abstract.h"
+#include "profiler.h"
 #include "../cuda/tensor.h"
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <type_traits>
 #include "../statistics.h"
@@ -525,6 +527,91 @@ namespace dlib
             layer.forward_inplace(sub.get_output(),static_cast<tensor&>(data_output));
         }
 
+        template <typename layer_type, typename SUBNET>
+        auto can_overwrite_input(
+            layer_type& layer,
+            const SUBNET& sub,
+            special_
+        ) -> decltype(layer.can_overwrite_input(sub))
+        {
+            return layer.can_overwrite_input(sub);
+        }
+
+        template <typename layer_type, typename SUBNET>
+        bool can_overwrite_input(
+            layer_type& layer,
+            const SUBNET& sub,
+            general_
+        )
+        {
+            // Layers with a forward_inplace() can always be run on top of their input.
+            return is_inplace_layer(layer, sub);
+        }
+
+        template <typename layer_type, typename SUBNET>
+        auto forward_as_view(
+            layer_type& layer,
+            const SUBNET& sub,
+            alias_tensor& view,
+            size_t& offset,
+            special_
+        ) -> decltype(layer.forward_as_view(sub,view,offset))
+        {
+            return layer.forward_as_view(sub,view,offset);
+        }
+
+        template <typename layer_type, typename SUBNET>
+        bool forward_as_view(
+            layer_type& ,
+            const SUBNET& ,
+            alias_tensor& ,
+            size_t& ,
+            general_
+        )
+        {
+            return false;
+        }
+
+        template <typename layer_type, typename SUBNET>
+        constexpr auto can_forward_as_view(
+            layer_type& layer,
+            const SUBNET& sub,
+            special_
+        ) -> typename alwaysbool<decltype(layer.forward_as_view(sub,std::declval<alias_tensor&>(),std::declval<size_t&>()))>::type
+        {
+            return true;
+        }
+
+        template <typename layer_type, typename SUBNET>
+        constexpr bool can_forward_as_view(
+            layer_type& ,
+            const SUBNET& ,
+            general_
+        )
+        {
+            return false;
+        }
+
+        template <typename layer_type, typename SUBNET>
+        auto estimate_flops(
+            const layer_type& layer,
+            const SUBNET& sub,
+            special_
+        ) -> decltype(layer.estimate_flops(sub))
+        {
+            return layer.estimate_flops(sub);
+        }
+
+        template <typename layer_type, typename SUBNET>
+        double estimate_flops(
+            const layer_type& ,
+            const SUBNET& ,
+            general_
+        )
+        {
+            return 0;
+        }
+
 
     } // end namespace impl
 
@@ -709,6 +796,123 @@ namespace dlib
     template <typename T, typename U>
     struct is_nonloss_layer_type<add_layer<T,U>> : std::true_type {};
 
+    template <size_t num, template<typename> class REPEATED_LAYER, typename SUBNET>
+    class repeat;
+
+    namespace impl
+    {
+        class tensor_pool
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This is the set of spare output tensors shared by all the layers of a
+                    network that has inference memory planning enabled.  When a layer's
+                    output is no longer needed by the rest of the forward pass its memory
+                    goes back in here so the next layer can reuse it.  Since several
+                    copies of a network may share one pool, it is thread safe.
+            !*/
+        public:
+            void acquire (
+                resizable_tensor& t
+            )
+            {
+                // If t still holds memory from the last forward pass then just keep using it.
+                if (t.size() != 0)
+                    return;
+
+                std::lock_guard<std::mutex> lock(m);
+                if (buffers.size() == 0)
+                    return;
+                // Take the biggest tensor since it's the one least likely to need
+                // reallocating.
+                size_t best = 0;
+                for (size_t i = 1; i < buffers.size(); ++i)
+                {
+                    if (buffers[i].size() > buffers[best].size())
+                        best = i;
+                }
+                t.swap(buffers[best]);
+                buffers[best].swap(buffers.back());
+                buffers.pop_back();
+            }
+
+            void release (
+                resizable_tensor& t
+            )
+            {
+                if (t.size() == 0)
+                    return;
+
+                std::lock_guard<std::mutex> lock(m);
+                buffers.emplace_back();
+                buffers.back().swap(t);
+            }
+
+            void clear (
+            )
+            {
+                std::lock_guard<std::mutex> lock(m);
+                buffers.clear();
+            }
+
+        private:
+            std::mutex m;
+            std::vector<resizable_tensor> buffers;
+        };
+
+        class visitor_set_profiler;
+
+        struct inference_memory_planner
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This gives the network layers access to each other's output tensors
+                    so they can hand them back to their tensor_pool.  Only add_layer
+                    objects are ever released this way.  Tag and skip layers expose their
+                    outputs to layers further up the network, so we conservatively
+                    assume anything below them stays alive for the whole forward pass.
+            !*/
+
+            template <typename T>
+            static resizable_tensor* releasable_output (T&) { return nullptr; }
+
+            template <typename T, typename U, typename E>
+            static resizable_tensor* releasable_output (add_layer<T,U,E>& l) { return l.releasable_output(); }
+
+            template <size_t N, template<typename> class L, typename S>
+            static resizable_tensor* releasable_output (repeat<N,L,S>& l) { return releasable_output(l.details[0]); }
+
+            template <typename T>
+            static void release_output (T& l)
+            {
+                resizable_tensor* t = releasable_output(l);
+                if (t)
+                    get_pool(l)->release(*t);
+            }
+
+            template <typename T>
+            static std::shared_ptr<tensor_pool> get_pool (T&) { return nullptr; }
+
+            template <typename T, typename U, typename E>
+            static std::shared_ptr<tensor_pool> get_pool (add_layer<T,U,E>& l) { return l.memory_pool; }
+
+            template <size_t N, template<typename> class L, typename S>
+            static std::shared_ptr<tensor_pool> get_pool (repeat<N,L,S>& l) { return get_pool(l.details[0]); }
+
+            template <typename T>
+            static void set_pool (T&, const std::shared_ptr<tensor_pool>&) {}
+
+            template <typename T, typename U, typename E>
+            static void set_pool (add_layer<T,U,E>& l, const std::shared_ptr<tensor_pool>& pool)
+            {
+                l.memory_pool = pool;
+                // Otherwise the outputs of earlier forward passes would all end up in
+                // the pool.
+                l.cached_output.clear();
+            }
+        };
+    }
+
     template <typename LAYER_DETAILS, typename SUBNET>
     class add_layer<LAYER_DETAILS,SUBNET,
             typename std::enable_if<is_nonloss_layer_type<SUBNET>::value>::type>
@@ -739,9 +943,16 @@ namespace dlib
             gradient_input_is_stale = item.gradient_input_is_stale;
             get_output_and_gradient_input_disabled = item.get_output_and_gradient_input_disabled;
             x_grad = item.x_grad;
-            cached_output = item.cached_output; 
+            // A view points into item's subnetwork, so copy what it shows instead.
+            if (item.output_view)
+                cached_output = *item.output_view;
+            else
+                cached_output = item.cached_output; 
             params_grad = item.params_grad; 
             temp_tensor = item.temp_tensor;
+            memory_pool = item.memory_pool;
+            profiler = item.profiler;
+            profiler_index = item.profiler_index;
         }
         add_layer& operator=(const add_layer& item) { add_layer(item).swap(*this); return *this;}
         add_layer(add_layer&& item) : add_layer() { swap(item); }
@@ -757,6 +968,8 @@ namespace dlib
         friend class add_skip_layer;
         template <size_t N, template<typename> class L, typename S>
         friend class repeat;
+        friend struct impl::inference_memory_planner;
+        friend class impl::visitor_set_profiler;
 
         // Allow copying networks from one to another as long as their corresponding 
         // layers can be constructed from each other.
@@ -770,7 +983,10 @@ namespace dlib
             gradient_input_is_stale(item.gradient_input_is_stale),
             get_output_and_gradient_input_disabled(item.get_output_and_gradient_input_disabled),
             x_grad(item.x_grad),
-            cached_output(item.cached_output)
+            cached_output(item.output_view ? static_cast<const tensor&>(*item.output_view) : item.cached_output),
+            memory_pool(item.memory_pool),
+            profiler(item.profiler),
+            profiler_index(item.profiler_index)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -916,20 +1132,92 @@ namespace dlib
                 details.setup(wsub);
                 this_layer_setup_called = true;
             }
-            if (this_layer_operates_inplace())
-                impl::call_layer_forward(details, wsub, private_get_output());
+            if (profiler)
+            {
+                const double flops = impl::estimate_flops(details, wsub, special_());
+                const auto start = dnn_profiler::clock::now();
+                forward_layer(wsub);
+                profiler->record_forward(profiler_index, start, flops,
+                    this_layer_operates_inplace() || output_view ? 0 : cached_output.size()*sizeof(float),
+                    details.get_layer_params().size()*sizeof(float));
+            }
             else
-                impl::call_layer_forward(details, wsub, cached_output);
+            {
+                forward_layer(wsub);
+            }
 
             gradient_input_is_stale = true;
             return private_get_output();
         }
 
     private:
+        template <typename SUBNET_WRAPPER>
+        void forward_layer(const SUBNET_WRAPPER& wsub)
+        {
+            if (forward_as_view(wsub))
+                return;
+            if (this_layer_operates_inplace())
+                impl::call_layer_forward(details, wsub, private_get_output());
+            else if (memory_pool)
+                forward_with_memory_pool(wsub);
+            else
+                impl::call_layer_forward(details, wsub, cached_output);
+        }
+
+        template <typename SUBNET_WRAPPER>
+        void forward_with_memory_pool(const SUBNET_WRAPPER& wsub)
+        {
+            // If nothing but this layer reads the subnetwork's output then we can give
+            // its memory back to the pool once we are done.  Better yet, if this layer
+            // allows it, we can write our output right on top of it.
+            resizable_tensor* sub_output = impl::inference_memory_planner::releasable_output(*subnetwork);
+            if (sub_output && impl::can_overwrite_input(details, wsub, special_()))
+            {
+                impl::call_layer_forward(details, wsub, *sub_output);
+                cached_output.swap(*sub_output);
+            }
+            else
+            {
+                memory_pool->acquire(cached_output);
+                impl::call_layer_forward(details, wsub, cached_output);
+            }
+            if (sub_output)
+                memory_pool->release(*sub_output);
+        }
+
+        template <typename SUBNET_WRAPPER>
+        bool forward_as_view(const SUBNET_WRAPPER& wsub)
+        {
+            // Layers like extract_ can make their output a view of part of their input
+            // rather than copying it.  That's not done when memory planning is enabled
+            // since the input's memory may then be handed to another layer.
+            alias_tensor view;
+            size_t offset = 0;
+            if (!memory_pool && impl::forward_as_view(details, wsub, view, offset, special_()))
+            {
+                output_view.reset(new alias_tensor_instance(view(subnetwork->private_get_output(), offset)));
+                cached_output.clear();
+                return true;
+            }
+            output_view.reset();
+            return false;
+        }
+
+        resizable_tensor* releasable_output()
+        {
+            if (!memory_pool)
+                return nullptr;
+            if (this_layer_operates_inplace())
+                return impl::inference_memory_planner::releasable_output(*subnetwork);
+            return &cached_output;
+        }
+
         tensor& private_get_output() const
         { 
             if (const_cast<add_layer&>(*this).this_layer_operates_inplace())
                 return subnetwork->private_get_output();
+            else if (output_view)
+                return *output_view;
             else
                 return const_cast<resizable_tensor&>(cached_output); 
         }
@@ -975,10 +1263,14 @@ namespace dlib
         }
         void back_propagate_error(const tensor& x, const tensor& gradient_input)
         {
+            DLIB_CASSERT(!memory_pool, "You can't train a network that has inference memory planning enabled.");
             dimpl::subnet_wrapper<subnet_type> wsub(*subnetwork);
+            const auto start = profiler ? dnn_profiler::clock::now() : dnn_profiler::clock::time_point();
             params_grad.copy_size(details.get_layer_params());
             impl::call_layer_backward(details, private_get_output(),
                 gradient_input, wsub, static_cast<tensor&>(params_grad));
+            if (profiler)
+                profiler->record_backward(profiler_index, start, (params_grad.size()+x_grad.size())*sizeof(float));
 
             subnetwork->back_propagate_error(x); 
 
@@ -1024,8 +1316,11 @@ namespace dlib
         {
             x_grad.clear();
             cached_output.clear();
+            output_view.reset();
             params_grad.clear();
             temp_tensor.clear();
+            if (memory_pool)
+                memory_pool->clear();
             gradient_input_is_stale = true;
             subnetwork->clean();
             call_clean_method_if_exists(details);
@@ -1041,7 +1336,10 @@ namespace dlib
             serialize(item.gradient_input_is_stale, out);
             serialize(item.get_output_and_gradient_input_disabled, out);
             serialize(item.x_grad, out);
-            serialize(item.cached_output, out);
+            if (item.output_view)
+                serialize(resizable_tensor(*item.output_view), out);
+            else
+                serialize(item.cached_output, out);
             serialize(item.params_grad, out);
         }
 
@@ -1088,7 +1386,10 @@ namespace dlib
         bool this_layer_requires_forward_output(
         ) 
         {
-            return impl::backward_requires_forward_output(details, *subnetwork);
+            // If our output may be a view of our subnetwork's output then an in-place
+            // layer on top of us would overwrite the subnetwork's output.
+            return impl::backward_requires_forward_output(details, *subnetwork) ||
+                impl::can_forward_as_view(details, *subnetwork, special_());
         }
 
         void swap(add_layer& item)
@@ -1100,7 +1401,11 @@ namespace dlib
             std::swap(get_output_and_gradient_input_disabled, item.get_output_and_gradient_input_disabled);
             std::swap(x_grad, item.x_grad);
             std::swap(cached_output, item.cached_output);
+            std::swap(output_view, item.output_view);
             std::swap(params_grad, item.params_grad);
+            std::swap(memory_pool, item.memory_pool);
+            std::swap(profiler, item.profiler);
+            std::swap(profiler_index, item.profiler_index);
         }
 
 
@@ -1114,6 +1419,9 @@ namespace dlib
         // layer.
         resizable_tensor x_grad;
         resizable_tensor cached_output; 
+        // Only set if the last forward() made this layer's output a view of the
+        // subnetwork's output.  cached_output isn't used then.
+        std::unique_ptr<alias_tensor_instance> output_view;
 
         resizable_tensor params_grad; 
 
@@ -1121,6 +1429,12 @@ namespace dlib
         // It is here only to prevent it from being reallocated over and over.
         resizable_tensor temp_tensor;
 
+        // Only set if inference memory planning is enabled.
+        std::shared_ptr<impl::tensor_pool> memory_pool;
+
+        // Only set if profiling is enabled.
+        std::shared_ptr<dnn_profiler> profiler;
+        size_t profiler_index = 0;
     };
 
     template <typename T, typename U, typename E>
@@ -1169,6 +1483,8 @@ namespace dlib
         friend class add_skip_layer;
         template <size_t N, template<typename> class L, typename S>
         friend class repeat;
+        friend struct impl::inference_memory_planner;
+        friend class impl::visitor_set_profiler;
 
         // Allow copying networks from one to another as long as their corresponding 
         // layers can be constructed from each other.
@@ -1184,7 +1500,10 @@ namespace dlib
             _sample_expansion_factor(item._sample_expansion_factor),
             x_grad(item.x_grad),
             cached_output(item.cached_output),
-            grad_final(item.grad_final)
+            grad_final(item.grad_final),
+            memory_pool(item.memory_pool),
+            profiler(item.profiler),
+            profiler_index(item.profiler_index)
         {
         }
 
@@ -1300,12 +1619,30 @@ namespace dlib
                 details.setup(wsub);
                 this_layer_setup_called = true;
             }
-            impl::call_layer_forward(details, wsub, cached_output);
+            if (memory_pool)
+                memory_pool->acquire(cached_output);
+            if (profiler)
+            {
+                const double flops = impl::estimate_flops(details, wsub, special_());
+                const auto start = dnn_profiler::clock::now();
+                impl::call_layer_forward(details, wsub, cached_output);
+                profiler->record_forward(profiler_index, start, flops, cached_output.size()*sizeof(float),
+                    details.get_layer_params().size()*sizeof(float));
+            }
+            else
+            {
+                impl::call_layer_forward(details, wsub, cached_output);
+            }
             gradient_input_is_stale = true;
             return private_get_output();
         }
 
     private:
+        resizable_tensor* releasable_output()
+        {
+            return memory_pool ? &cached_output : nullptr;
+        }
+
         tensor& private_get_output() const { return const_cast<resizable_tensor&>(cached_output); }
         tensor& private_get_gradient_input() 
         { 
@@ -1342,15 +1679,19 @@ namespace dlib
         }
         void back_propagate_error(const tensor& x, const tensor& gradient_input)
         {
+            DLIB_CASSERT(!memory_pool, "You can't train a network that has inference memory planning enabled.");
             // make sure grad_final is initialized to 0
             if (!have_same_dimensions(x, grad_final))
                 grad_final.copy_size(x);
             grad_final = 0;  
 
             subnet_wrapper wsub(x, grad_final, _sample_expansion_factor);
+            const auto start = profiler ? dnn_profiler::clock::now() : dnn_profiler::clock::time_point();
             params_grad.copy_size(details.get_layer_params());
             impl::call_layer_backward(details, private_get_output(),
                 gradient_input, wsub, static_cast<tensor&>(params_grad));
+            if (profiler)
+                profiler->record_backward(profiler_index, start, (params_grad.size()+x_grad.size()+grad_final.size())*sizeof(float));
 
             // zero out get_gradient_input()
             gradient_input_is_stale = true;
@@ -1396,6 +1737,8 @@ namespace dlib
             cached_output.clear();
             params_grad.clear();
             temp_tensor.clear();
+            if (memory_pool)
+                memory_pool->clear();
             gradient_input_is_stale = true;
             call_clean_method_if_exists(details);
         }
@@ -1499,6 +1842,9 @@ namespace dlib
             std::swap(cached_output, item.cached_output); 
             std::swap(grad_final, item.grad_final); 
             std::swap(_sample_expansion_factor, item._sample_expansion_factor); 
+            std::swap(memory_pool, item.memory_pool);
+            std::swap(profiler, item.profiler);
+            std::swap(profiler_index, item.profiler_index);
         }
 
         subnet_type input_layer;
@@ -1516,6 +1862,13 @@ namespace dlib
         // member functions.
         resizable_tensor params_grad; 
         resizable_tensor temp_tensor; 
+
+        // Only set if inference memory planning is enabled.
+        std::shared_ptr<impl::tensor_pool> memory_pool;
+
+        // Only set if profiling is enabled.
+        std::shared_ptr<dnn_profiler> profiler;
+        size_t profiler_index = 0;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -1855,8 +2208,12 @@ namespace dlib
         {
             subnetwork.forward(x);
             details[details.size()-1].forward(subnetwork.get_output());
+            impl::inference_memory_planner::release_output(subnetwork);
             for (long i = details.size()-2; i >= 0; --i)
+            {
                 details[i].forward(details[i+1].get_output());
+                impl::inference_memory_planner::release_output(details[i+1]);
+            }
             return private_get_output();
         }
 
@@ -1983,6 +2340,7 @@ namespace dlib
         friend class add_skip_layer;
         template <size_t N, template<typename> class L, typename S>
         friend class repeat;
+        friend struct impl::inference_memory_planner;
 
         bool this_layer_requires_forward_output(
         ) 
@@ -2292,6 +2650,34 @@ namespace dlib
         template < typename net_type, typename solver_type > friend class dnn_trainer; 
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <typename loss_type, typename label_iterator, typename SUBNET>
+        auto call_prepare_for_labels(
+            loss_type& loss,
+            const tensor& x,
+            label_iterator lbegin,
+            SUBNET& sub,
+            special_
+        ) -> decltype(loss.prepare_for_labels(x, lbegin, sub))
+        {
+            return loss.prepare_for_labels(x, lbegin, sub);
+        }
+
+        template <typename loss_type, typename label_iterator, typename SUBNET>
+        void call_prepare_for_labels(
+            loss_type& ,
+            const tensor& ,
+            label_iterator ,
+            SUBNET& ,
+            general_
+        )
+        {
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <typename LOSS_DETAILS, typename SUBNET>
@@ -2509,6 +2895,7 @@ namespace dlib
             label_iterator lbegin 
         )
         {
+            impl::call_prepare_for_labels(loss, x, lbegin, subnetwork, special_());
             subnetwork.forward(x);
             dimpl::subnet_wrapper<subnet_type> wsub(subnetwork);
             return loss.compute_loss_value_and_gradient(x, lbegin, wsub);
@@ -2550,6 +2937,7 @@ namespace dlib
             label_iterator lbegin
         )
         {
+            impl::call_prepare_for_labels(loss, x, lbegin, subnetwork, special_());
             subnetwork.forward(x);
             dimpl::subnet_wrapper<subnet_type> wsub(subnetwork);
             double l = loss.compute_loss_value_and_gradient(x, lbegin, wsub);
@@ -3776,6 +4164,102 @@ namespace dlib
         impl::vl_until_tag<0,tag_id>::visit(net, net, v);
     }
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class visitor_set_memory_pool
+        {
+        public:
+            explicit visitor_set_memory_pool(
+                const std::shared_ptr<tensor_pool>& pool_
+            ) : pool(pool_) {}
+
+            template <typename T>
+            void operator()(size_t, T& l) const
+            {
+                inference_memory_planner::set_pool(l, pool);
+            }
+
+        private:
+            std::shared_ptr<tensor_pool> pool;
+        };
+    }
+
+    template <
+        typename net_type
+        >
+    void enable_inference_memory_planning (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_set_memory_pool(std::make_shared<impl::tensor_pool>()));
+    }
+
+    template <
+        typename net_type
+        >
+    void disable_inference_memory_planning (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_set_memory_pool(nullptr));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class visitor_set_profiler
+        {
+        public:
+            explicit visitor_set_profiler(
+                const std::shared_ptr<dnn_profiler>& profiler_
+            ) : profiler(profiler_) {}
+
+            template <typename T>
+            void operator()(size_t, T&) const {}
+
+            template <typename T, typename U, typename E>
+            void operator()(size_t i, add_layer<T,U,E>& l) const
+            {
+                l.profiler = profiler;
+                l.profiler_index = i;
+                if (profiler)
+                {
+                    std::ostringstream sout;
+                    sout << l.layer_details();
+                    profiler->register_layer(i, sout.str());
+                }
+            }
+
+        private:
+            std::shared_ptr<dnn_profiler> profiler;
+        };
+    }
+
+    template <
+        typename net_type
+        >
+    std::shared_ptr<dnn_profiler> enable_profiling (
+        net_type& net
+    )
+    {
+        auto profiler = std::make_shared<dnn_profiler>();
+        visit_layers(net, impl::visitor_set_profiler(profiler));
+        return profiler;
+    }
+
+    template <
+        typename net_type
+        >
+    void disable_profiling (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_set_profiler(nullptr));
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -4,6 +4,7 @@
 #ifdef DLIB_DNn_CORE_ABSTRACT_H_
 
 #include "../cuda/tensor_abstract.h"
+#include "profiler_abstract.h"
 #include <memory>
 #include <type_traits>
 #include <tuple>
@@ -166,6 +167,11 @@ namespace dlib
             - If dlib should prefer to use fast algorithms rather than ones that use less
               RAM then this function returns true and false otherwise.
             - On program startup this function will default to true.
+            - This affects how convolution algorithms are selected.  When using cuDNN
+              it's passed on to cuDNN's algorithm search.  On the CPU, when this is
+              true, the first time a convolution of a particular shape is run each
+              applicable algorithm (e.g. img2col+GEMM and Winograd) is timed and the
+              fastest one is used for all subsequent convolutions of that shape.
     !*/
 
     void set_dnn_prefer_fastest_algorithms(
@@ -1854,6 +1860,97 @@ namespace dlib
                 v(layer<i>(net));  // also visits the tag layer itself at the very end.
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename net_type
+        >
+    void enable_inference_memory_planning (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Normally every layer in a network keeps its own output tensor, so running a
+              network takes as much memory as all of its layer outputs put together.  This
+              function makes net reuse that memory instead.  Once a forward pass no longer
+              needs a layer's output, its memory goes back into a pool of spare tensors
+              that is shared by all the layers of net, and layers allowed to do so (see
+              can_overwrite_input() in layers_abstract.h) write their output over their
+              input.  So most of the forward pass runs in a couple of "ping-pong" buffers,
+              which uses much less memory and is friendlier to the CPU cache.
+            - After a forward pass only the following layer outputs are still available:
+                - the output of the top layer of net.
+                - the outputs of layers that are below a tag or skip layer, since those
+                  can be read by any of the layers above them.
+              The get_output() of any other layer returns an empty tensor.
+            - Since the outputs are gone you can't call back_propagate_error() on net,
+              i.e. you can't train it.  Use this only for inference.
+            - Discards the outputs of the last forward pass.
+            - Copies of net share its pool of spare tensors.  This is thread safe, so the
+              copies can still be used from different threads at the same time.
+    !*/
+
+    template <
+        typename net_type
+        >
+    void disable_inference_memory_planning (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Undoes enable_inference_memory_planning(net), so each layer keeps its own
+              output tensor again.
+            - Discards the outputs of the last forward pass.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename net_type
+        >
+    std::shared_ptr<dnn_profiler> enable_profiling (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Makes every computational layer of net record how long its forward() and
+              backward() calls take, how much memory it holds, and roughly how many
+              floating point operations it performs (see estimate_flops() in
+              layers_abstract.h).  This covers the layers inside repeat layers too.
+            - returns the dnn_profiler the measurements are recorded into.  Layer
+              layer<i>(net) is reported with index i.
+            - Only the layers' own computations are timed, not the layers below them, so
+              the times of all layers add up to the time of the whole network, minus the
+              loss layer and to_tensor().
+            - Copies of net record into the same dnn_profiler.
+            - Calling enable_profiling() again replaces the profiler with a new one.
+    !*/
+
+    template <
+        typename net_type
+        >
+    void disable_profiling (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Undoes enable_profiling(net).  The layers of a network that isn't being
+              profiled only check a null pointer, so profiling costs nothing when it is
+              off.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     struct layer_test_results
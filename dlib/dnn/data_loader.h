@@ -0,0 +1,214 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_DATA_LOADER_H_
+#define DLIB_DNn_DATA_LOADER_H_
+
+#include "data_loader_abstract.h"
+#include "core.h"
+#include "../pipe.h"
+#include "../rand.h"
+#include "../string.h"
+#include "../threads/thread_pool_extension.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_data_loader
+    {
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::training_label_type training_label_type;
+        typedef std::function<void(input_type&, training_label_type&, dlib::rand&)> load_function;
+
+        struct mini_batch
+        {
+            std::vector<input_type> samples;
+            std::vector<training_label_type> labels;
+            resizable_tensor data;
+
+            friend void swap (
+                mini_batch& a,
+                mini_batch& b
+            )
+            {
+                a.samples.swap(b.samples);
+                a.labels.swap(b.labels);
+                a.data.swap(b.data);
+            }
+        };
+
+        dnn_data_loader (
+            const net_type& net,
+            size_t mini_batch_size_,
+            const load_function& load_sample_,
+            unsigned long num_threads_ = default_num_threads(),
+            size_t max_queued_mini_batches_ = 2
+        ) :
+            input(input_layer(const_cast<net_type&>(net))),
+            load_sample(load_sample_),
+            mbsize(mini_batch_size_),
+            threads(num_threads_),
+            max_queued(max_queued_mini_batches_),
+            ready(max_queued_mini_batches_),
+            spare(max_queued_mini_batches_+num_threads_+1),
+            num_batches(0),
+            num_starved(0),
+            starved_seconds(0),
+            pool(num_threads_)
+        {
+            DLIB_CASSERT(mini_batch_size_ > 0);
+            DLIB_CASSERT(num_threads_ > 0);
+            DLIB_CASSERT(max_queued_mini_batches_ > 0);
+            DLIB_CASSERT(load_sample_ != nullptr);
+
+            for (unsigned long i = 0; i < num_threads_; ++i)
+                pool.add_task_by_value([this,i](){ fill_mini_batches(i); });
+        }
+
+        dnn_data_loader(const dnn_data_loader&) = delete;
+        dnn_data_loader& operator=(const dnn_data_loader&) = delete;
+
+        ~dnn_data_loader (
+        )
+        {
+            ready.disable();
+            spare.disable();
+            pool.wait_for_all_tasks();
+        }
+
+        size_t get_mini_batch_size (
+        ) const { return mbsize; }
+
+        unsigned long num_threads (
+        ) const { return threads; }
+
+        size_t get_max_queued_mini_batches (
+        ) const { return max_queued; }
+
+        void get_next (
+            mini_batch& batch
+        )
+        {
+            // Give the buffers of the previous mini-batch back to the workers so they can
+            // be reused rather than reallocated.
+            if (batch.samples.size() != 0)
+                spare.enqueue_or_timeout(batch, 0);
+
+            const bool starved = ready.size() == 0;
+            const auto start = std::chrono::steady_clock::now();
+            const bool got_batch = ready.dequeue(batch);
+            const double waited = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+            std::lock_guard<std::mutex> lock(m);
+            // A worker that fails puts an empty mini-batch into the queue, after all the
+            // mini-batches that were finished before the failure.
+            if (!got_batch || batch.samples.size() == 0)
+            {
+                ready.disable();
+                spare.disable();
+                if (eptr)
+                    std::rethrow_exception(eptr);
+                throw dlib::error("dnn_data_loader::get_next() called on a loader that is shutting down.");
+            }
+
+            ++num_batches;
+            if (starved)
+            {
+                ++num_starved;
+                starved_seconds += waited;
+            }
+        }
+
+        unsigned long long get_num_mini_batches (
+        ) const { std::lock_guard<std::mutex> lock(m); return num_batches; }
+
+        unsigned long long get_num_starved_mini_batches (
+        ) const { std::lock_guard<std::mutex> lock(m); return num_starved; }
+
+        double get_starved_seconds (
+        ) const { std::lock_guard<std::mutex> lock(m); return starved_seconds; }
+
+    private:
+
+        static unsigned long default_num_threads (
+        )
+        {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        void fill_mini_batches (
+            unsigned long worker_id
+        )
+        {
+            dlib::rand rnd("dnn_data_loader " + cast_to_string(worker_id));
+            mini_batch batch;
+            try
+            {
+                while (true)
+                {
+                    spare.dequeue_or_timeout(batch, 0);
+
+                    batch.samples.resize(mbsize);
+                    batch.labels.resize(mbsize);
+                    for (size_t i = 0; i < mbsize; ++i)
+                        load_sample(batch.samples[i], batch.labels[i], rnd);
+                    input.to_tensor(batch.samples.begin(), batch.samples.end(), batch.data);
+
+                    if (!ready.enqueue(batch))
+                        return;
+                }
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    if (!eptr)
+                        eptr = std::current_exception();
+                }
+                mini_batch failed;
+                ready.enqueue(failed);
+            }
+        }
+
+        typedef typename std::remove_const<typename std::remove_reference<
+            decltype(input_layer(std::declval<net_type&>()))>::type>::type input_layer_type;
+
+        const input_layer_type input;
+        const load_function load_sample;
+        const size_t mbsize;
+        const unsigned long threads;
+        const size_t max_queued;
+
+        dlib::pipe<mini_batch> ready;
+        dlib::pipe<mini_batch> spare;
+
+        mutable std::mutex m;
+        std::exception_ptr eptr = nullptr;
+        unsigned long long num_batches;
+        unsigned long long num_starved;
+        double starved_seconds;
+
+        // This is last so the workers are stopped before anything they use is destroyed.
+        thread_pool pool;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_DATA_LOADER_H_
+
@@ -0,0 +1,203 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_DATA_LOADER_ABSTRACT_H_
+#ifdef DLIB_DNn_DATA_LOADER_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include "../rand/rand_kernel_abstract.h"
+#include <functional>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_data_loader
+    {
+        /*!
+            REQUIREMENTS ON NET_TYPE
+                NET_TYPE is an add_loss_layer object.
+
+            WHAT THIS OBJECT REPRESENTS
+                This object makes mini-batches for training a network in background
+                threads, so that loading and augmenting the training data happens at the
+                same time as the network is being trained rather than in between training
+                steps.
+
+                You give it a function that produces one random training sample and its
+                label, e.g. by picking a random image from disk and randomly cropping it.
+                A set of worker threads then repeatedly calls that function to fill
+                mini-batches, converts each mini-batch into a tensor using the network's
+                input layer, and puts it into a bounded queue.  get_next() takes the next
+                finished mini-batch from that queue.  The buffers of mini-batches you are
+                done with are handed back to the workers and reused, so once the loader
+                is warmed up no memory is allocated for new mini-batches.
+
+                You would normally use it with the dnn_trainer like this:
+                    dnn_data_loader<net_type> loader(net, 128, load_random_sample);
+                    while (trainer.get_learning_rate() >= 1e-4)
+                        trainer.train_one_step(loader);
+
+                If the network is consuming mini-batches faster than the workers can make
+                them then get_next() has to wait.  This object counts how often that
+                happens so you can tell if training is limited by data loading, in which
+                case you should use more threads or make loading cheaper.  The
+                dnn_trainer also prints this information when it's in verbose mode.
+
+            COPYING
+                This object is not copyable.
+
+            THREAD SAFETY
+                get_next() must only be called by one thread at a time.  The load
+                function is called from several threads at once, so it must be thread
+                safe.
+        !*/
+
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::training_label_type training_label_type;
+        typedef std::function<void(input_type&, training_label_type&, dlib::rand&)> load_function;
+
+        struct mini_batch
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This is one mini-batch made by a dnn_data_loader.  samples and labels
+                    are the training samples and labels given by the load function and
+                    data is the output of calling to_tensor() on samples.
+            !*/
+
+            std::vector<input_type> samples;
+            std::vector<training_label_type> labels;
+            resizable_tensor data;
+        };
+
+        dnn_data_loader (
+            const net_type& net,
+            size_t mini_batch_size,
+            const load_function& load_sample,
+            unsigned long num_threads = std::thread::hardware_concurrency(),
+            size_t max_queued_mini_batches = 2
+        );
+        /*!
+            requires
+                - mini_batch_size > 0
+                - num_threads > 0
+                - max_queued_mini_batches > 0
+                - load_sample != nullptr
+            ensures
+                - #get_mini_batch_size() == mini_batch_size
+                - #num_threads() == num_threads
+                - #get_max_queued_mini_batches() == max_queued_mini_batches
+                - Starts num_threads threads that each make mini-batches by calling
+                  load_sample(sample, label, rnd) mini_batch_size times and then
+                  converting the samples into a tensor with a copy of the input layer of
+                  net.  rnd is a random number generator that belongs to the calling
+                  thread.  Each thread seeds its generator differently so they don't
+                  produce the same samples.
+                - At most max_queued_mini_batches finished mini-batches are waiting in
+                  the queue at any time.  A worker that finishes a mini-batch when the
+                  queue is full waits until get_next() makes room.
+                - net is not referenced after the constructor finishes.  The input layer
+                  is copied, so changing the input layer of net afterwards doesn't affect
+                  *this.
+        !*/
+
+        ~dnn_data_loader (
+        );
+        /*!
+            ensures
+                - Stops the worker threads.  Any mini-batch a worker is filling when the
+                  destructor is called is finished first, so this blocks for as long as
+                  it takes to make one mini-batch.
+        !*/
+
+        size_t get_mini_batch_size (
+        ) const;
+        /*!
+            ensures
+                - returns the number of samples in each mini-batch.
+        !*/
+
+        unsigned long num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of worker threads making mini-batches.
+        !*/
+
+        size_t get_max_queued_mini_batches (
+        ) const;
+        /*!
+            ensures
+                - returns the maximum number of finished mini-batches that can be waiting
+                  to be taken out of *this by get_next().
+        !*/
+
+        void get_next (
+            mini_batch& batch
+        );
+        /*!
+            ensures
+                - Waits until a mini-batch is finished and then swaps it into #batch.
+                - #batch.samples.size() == get_mini_batch_size()
+                - #batch.labels.size() == get_mini_batch_size()
+                - #batch.data contains the tensor made from #batch.samples.
+                - The previous contents of batch are given back to the worker threads to
+                  be reused for future mini-batches.
+                - #get_num_mini_batches() == get_num_mini_batches() + 1
+                - if (no finished mini-batch was waiting when get_next() was called) then
+                    - #get_num_starved_mini_batches() == get_num_starved_mini_batches() + 1
+                    - #get_starved_seconds() is increased by the time spent waiting for
+                      the mini-batch.
+            throws
+                - any exception thrown by the load function or input layer.  Once this
+                  happens the worker threads stop and every later call to get_next()
+                  throws the same exception.
+        !*/
+
+        unsigned long long get_num_mini_batches (
+        ) const;
+        /*!
+            ensures
+                - returns the number of mini-batches that have been returned by
+                  get_next().
+        !*/
+
+        unsigned long long get_num_starved_mini_batches (
+        ) const;
+        /*!
+            ensures
+                - returns the number of calls to get_next() that had to wait for a
+                  mini-batch because the worker threads weren't keeping up.
+        !*/
+
+        double get_starved_seconds (
+        ) const;
+        /*!
+            ensures
+                - returns the total number of seconds get_next() has spent waiting for
+                  the worker threads.
+        !*/
+    };
+
+    template <typename net_type>
+    void swap (
+        typename dnn_data_loader<net_type>::mini_batch& a,
+        typename dnn_data_loader<net_type>::mini_batch& b
+    );
+    /*!
+        provides a global swap function for mini_batch objects
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_DATA_LOADER_ABSTRACT_H_
+
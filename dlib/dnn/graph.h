@@ -0,0 +1,838 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_GRAPH_H_
+#define DLIB_DNn_GRAPH_H_
+
+#include "graph_abstract.h"
+#include "core.h"
+#include "layers.h"
+#include "../cuda/tensor_tools.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        enum class graph_op_kind
+        {
+            con,
+            cont,
+            fc,
+            relu,
+            prelu,
+            leaky_relu,
+            sig,
+            htan,
+            mish,
+            softmax,
+            max_pool,
+            avg_pool,
+            affine_con,
+            affine_fc,
+            multiply,
+            add_prev,
+            mult_prev,
+            concat,
+            upsample
+        };
+
+        struct graph_op_info
+        {
+            graph_op_kind kind;
+            const char* name;
+            long num_inputs;     // -1 means any number > 0
+            size_t num_iattrs;
+            size_t num_fattrs;
+            size_t min_tensors;
+            size_t max_tensors;
+            bool in_place;       // the op can write its output over its input
+        };
+
+        inline const std::vector<graph_op_info>& graph_ops (
+        )
+        {
+            // The integer attributes are, for con and cont: stride_y, stride_x, padding_y,
+            // padding_x, groups and, for con only, the fused activation.  For the pooling
+            // ops: nr, nc, stride_y, stride_x, padding_y, padding_x.  For upsample:
+            // scale_y, scale_x.  The float attributes are con's fused activation
+            // parameter, leaky_relu's alpha and multiply's value.
+            static const std::vector<graph_op_info> ops = {
+                {graph_op_kind::con,        "con",         1, 6, 1, 2, 2, false},
+                {graph_op_kind::cont,       "cont",        1, 5, 0, 2, 2, false},
+                {graph_op_kind::fc,         "fc",          1, 0, 0, 1, 2, false},
+                {graph_op_kind::relu,       "relu",        1, 0, 0, 0, 0, true},
+                {graph_op_kind::prelu,      "prelu",       1, 0, 0, 1, 1, false},
+                {graph_op_kind::leaky_relu, "leaky_relu",  1, 0, 1, 0, 0, true},
+                {graph_op_kind::sig,        "sig",         1, 0, 0, 0, 0, true},
+                {graph_op_kind::htan,       "htan",        1, 0, 0, 0, 0, true},
+                {graph_op_kind::mish,       "mish",        1, 0, 0, 0, 0, false},
+                {graph_op_kind::softmax,    "softmax",     1, 0, 0, 0, 0, true},
+                {graph_op_kind::max_pool,   "max_pool",    1, 6, 0, 0, 0, false},
+                {graph_op_kind::avg_pool,   "avg_pool",    1, 6, 0, 0, 0, false},
+                {graph_op_kind::affine_con, "affine_con",  1, 0, 0, 2, 2, true},
+                {graph_op_kind::affine_fc,  "affine_fc",   1, 0, 0, 2, 2, true},
+                {graph_op_kind::multiply,   "multiply",    1, 0, 1, 0, 0, true},
+                {graph_op_kind::add_prev,   "add_prev",    2, 0, 0, 0, 0, false},
+                {graph_op_kind::mult_prev,  "mult_prev",   2, 0, 0, 0, 0, false},
+                {graph_op_kind::concat,     "concat",     -1, 0, 0, 0, 0, false},
+                {graph_op_kind::upsample,   "upsample",    1, 2, 0, 0, 0, false}
+            };
+            return ops;
+        }
+
+        inline const graph_op_info& graph_op (
+            graph_op_kind kind
+        )
+        {
+            return graph_ops()[static_cast<size_t>(kind)];
+        }
+
+        struct graph_node
+        {
+            /*!
+                One layer of a dnn_graph.  Values are numbered so that 0 is the input of
+                the graph and i+1 is the output of the i-th node.
+            !*/
+
+            graph_op_kind kind;
+            std::vector<long> inputs;
+            std::vector<long> iattrs;
+            std::vector<float> fattrs;
+            std::vector<resizable_tensor> tensors;
+        };
+
+        inline bool is_bias_for (
+            const tensor& b,
+            long num_outputs
+        )
+        {
+            return b.num_samples() == 1 && b.k() == num_outputs && b.nr() == 1 && b.nc() == 1;
+        }
+
+        inline bool graph_node_shapes_are_valid (
+            const graph_node& n
+        )
+        /*!
+            requires
+                - n has the number of inputs, attributes, and tensors graph_op(n.kind)
+                  says it should.
+            ensures
+                - returns true if n's attributes and tensors agree with each other, so
+                  that running n can't read or write outside of them.  Whether they agree
+                  with the shape of n's input is checked when the graph is run.
+        !*/
+        {
+            const auto& ia = n.iattrs;
+            const auto& t = n.tensors;
+            switch (n.kind)
+            {
+                case graph_op_kind::con:
+                    // iattrs: stride_y, stride_x, padding_y, padding_x, groups, activation
+                    // tensors: filters (num_filters, k/groups, nr, nc), biases
+                    return ia[0] > 0 && ia[1] > 0 && ia[4] > 0 &&
+                        t[0].size() != 0 && t[0].num_samples()%ia[4] == 0 &&
+                        0 <= ia[2] && ia[2] < t[0].nr() && 0 <= ia[3] && ia[3] < t[0].nc() &&
+                        is_bias_for(t[1], t[0].num_samples());
+                case graph_op_kind::cont:
+                    // iattrs: stride_y, stride_x, padding_y, padding_x, groups
+                    // tensors: filters (k, num_filters/groups, nr, nc), biases
+                    return ia[0] > 0 && ia[1] > 0 && ia[4] > 0 &&
+                        t[0].size() != 0 && t[0].num_samples()%ia[4] == 0 &&
+                        0 <= ia[2] && ia[2] < t[0].nr() && 0 <= ia[3] && ia[3] < t[0].nc() &&
+                        is_bias_for(t[1], t[0].k()*ia[4]);
+                case graph_op_kind::fc:
+                    // tensors: weights (num_inputs, num_outputs), and optionally biases
+                    return t[0].size() != 0 && t[0].nr() == 1 && t[0].nc() == 1 &&
+                        (t.size() == 1 || is_bias_for(t[1], t[0].k()));
+                case graph_op_kind::prelu:
+                    return t[0].size() == 1;
+                case graph_op_kind::max_pool:
+                case graph_op_kind::avg_pool:
+                    // iattrs: nr, nc, stride_y, stride_x, padding_y, padding_x.  A window
+                    // size of 0 means the whole input.
+                    return ia[0] >= 0 && ia[1] >= 0 && ia[2] > 0 && ia[3] > 0 &&
+                        0 <= ia[4] && (ia[0] == 0 || ia[4] < ia[0]) &&
+                        0 <= ia[5] && (ia[1] == 0 || ia[5] < ia[1]);
+                case graph_op_kind::affine_con:
+                    return t[0].size() != 0 && is_bias_for(t[0], t[0].k()) && have_same_dimensions(t[0], t[1]);
+                case graph_op_kind::affine_fc:
+                    return t[0].size() != 0 && t[0].num_samples() == 1 && have_same_dimensions(t[0], t[1]);
+                case graph_op_kind::upsample:
+                    return ia[0] > 0 && ia[1] > 0;
+                default:
+                    return true;
+            }
+        }
+
+        inline resizable_tensor copy_graph_tensor (
+            const tensor& t
+        )
+        {
+            resizable_tensor temp;
+            temp.copy_size(t);
+            memcpy(temp, t);
+            return temp;
+        }
+
+        inline resizable_tensor copy_graph_tensor (
+            const tensor& t,
+            size_t offset,
+            long n, long k, long nr = 1, long nc = 1
+        )
+        {
+            alias_tensor a(n, k, nr, nc);
+            return copy_graph_tensor(a(t, offset).get());
+        }
+
+        class visitor_build_graph
+        {
+            /*!
+                Walks a network from its input to its output and appends a graph_node for
+                each of its computational layers.  current is the value holding the output
+                of the layers visited so far.  Tags and skip layers don't compute anything,
+                they just record and restore current.
+            !*/
+        public:
+            visitor_build_graph(std::vector<graph_node>& nodes_) : nodes(nodes_) {}
+
+            template <typename input_layer_type>
+            void operator()(const input_layer_type& )
+            {
+                current = 0;
+            }
+
+            void operator()(const repeat_input_layer& )
+            {
+                // the input of a repeated block is whatever came before it
+            }
+
+            template <typename T, typename U>
+            void operator()(const add_loss_layer<T,U>& net)
+            {
+                (*this)(net.subnet());
+            }
+
+            template <typename T, typename U, typename E>
+            void operator()(const add_layer<T,U,E>& net)
+            {
+                (*this)(net.subnet());
+                add(net.layer_details());
+            }
+
+            template <unsigned long ID, typename U, typename E>
+            void operator()(const add_tag_layer<ID,U,E>& net)
+            {
+                (*this)(net.subnet());
+                tags[ID] = current;
+            }
+
+            template <template<typename> class TAG_TYPE, typename U>
+            void operator()(const add_skip_layer<TAG_TYPE,U>& net)
+            {
+                (*this)(net.subnet());
+                current = tag(tag_id<TAG_TYPE>::id);
+            }
+
+            template <size_t N, template<typename> class L, typename S>
+            void operator()(const repeat<N,L,S>& net)
+            {
+                (*this)(net.subnet());
+                for (size_t i = net.num_repetitions(); i-- > 0;)
+                    (*this)(net.get_repeated_layer(i));
+            }
+
+        private:
+
+            long tag (unsigned long id) const
+            {
+                auto i = tags.find(id);
+                DLIB_CASSERT(i != tags.end(), "The network refers to tag" << id << " but doesn't contain it.");
+                return i->second;
+            }
+
+            graph_node& push (
+                graph_op_kind kind,
+                std::vector<long> inputs
+            )
+            {
+                nodes.emplace_back();
+                nodes.back().kind = kind;
+                nodes.back().inputs = std::move(inputs);
+                current = nodes.size();
+                return nodes.back();
+            }
+
+            template <typename T>
+            void add (const T& )
+            {
+                static_assert(sizeof(T) == 0, "dnn_graph doesn't support this layer type.");
+            }
+
+            template <long nf, long nr, long nc, int sy, int sx, int py, int px, int g>
+            void add (const con_<nf,nr,nc,sy,sx,py,px,g>& l)
+            {
+                DLIB_CASSERT(!l.is_int8(), "dnn_graph doesn't support int8 con_ layers.");
+                const tensor& params = l.get_layer_params();
+                DLIB_CASSERT(params.size() != 0, "Run the network once before converting it to a dnn_graph.");
+                const long k = (params.size()-l.num_filters())/(l.num_filters()*l.nr()*l.nc());
+                auto& n = push(graph_op_kind::con, {current});
+                n.iattrs = {l.stride_y(), l.stride_x(), l.padding_y(), l.padding_x(), g,
+                            static_cast<long>(l.get_fused_activation())};
+                n.fattrs = {l.get_fused_activation_param()};
+                n.tensors.push_back(copy_graph_tensor(params, 0, l.num_filters(), k, l.nr(), l.nc()));
+                n.tensors.push_back(copy_graph_tensor(params, n.tensors[0].size(), 1, l.num_filters()));
+            }
+
+            template <long nf, long nr, long nc, int sy, int sx, int py, int px, int g>
+            void add (const cont_<nf,nr,nc,sy,sx,py,px,g>& l)
+            {
+                const tensor& params = l.get_layer_params();
+                DLIB_CASSERT(params.size() != 0, "Run the network once before converting it to a dnn_graph.");
+                const long k = (params.size()-l.num_filters())/((l.num_filters()/g)*l.nr()*l.nc());
+                auto& n = push(graph_op_kind::cont, {current});
+                n.iattrs = {l.stride_y(), l.stride_x(), l.padding_y(), l.padding_x(), g};
+                n.tensors.push_back(copy_graph_tensor(params, 0, k, l.num_filters()/g, l.nr(), l.nc()));
+                n.tensors.push_back(copy_graph_tensor(params, n.tensors[0].size(), 1, l.num_filters()));
+            }
+
+            template <unsigned long no, fc_bias_mode bm>
+            void add (const fc_<no,bm>& l)
+            {
+                DLIB_CASSERT(!l.is_int8(), "dnn_graph doesn't support int8 fc_ layers.");
+                DLIB_CASSERT(l.get_layer_params().size() != 0, "Run the network once before converting it to a dnn_graph.");
+                auto& n = push(graph_op_kind::fc, {current});
+                n.tensors.push_back(copy_graph_tensor(l.get_weights().get()));
+                if (bm == FC_HAS_BIAS)
+                    n.tensors.push_back(copy_graph_tensor(l.get_biases().get()));
+            }
+
+            template <unsigned long no>
+            void add (const fc_sampled_<no>& l)
+            {
+                DLIB_CASSERT(l.get_layer_params().size() != 0, "Run the network once before converting it to a dnn_graph.");
+                auto& n = push(graph_op_kind::fc, {current});
+                n.tensors.push_back(copy_graph_tensor(l.get_weights().get()));
+                n.tensors.push_back(copy_graph_tensor(l.get_biases().get()));
+            }
+
+            void add (const relu_& l)
+            {
+                if (!l.is_disabled())
+                    push(graph_op_kind::relu, {current});
+            }
+
+            void add (const prelu_& l)
+            {
+                if (!l.is_disabled())
+                    push(graph_op_kind::prelu, {current}).tensors.push_back(copy_graph_tensor(l.get_layer_params()));
+            }
+
+            void add (const leaky_relu_& l)
+            {
+                if (!l.is_disabled())
+                    push(graph_op_kind::leaky_relu, {current}).fattrs = {l.get_alpha()};
+            }
+
+            void add (const sig_& ) { push(graph_op_kind::sig, {current}); }
+            void add (const htan_& ) { push(graph_op_kind::htan, {current}); }
+            void add (const mish_& ) { push(graph_op_kind::mish, {current}); }
+            void add (const softmax_& ) { push(graph_op_kind::softmax, {current}); }
+
+            template <long nr, long nc, int sy, int sx, int py, int px>
+            void add (const max_pool_<nr,nc,sy,sx,py,px>& l)
+            {
+                push(graph_op_kind::max_pool, {current}).iattrs = {nr, nc, sy, sx, l.padding_y(), l.padding_x()};
+            }
+
+            template <long nr, long nc, int sy, int sx, int py, int px>
+            void add (const avg_pool_<nr,nc,sy,sx,py,px>& l)
+            {
+                push(graph_op_kind::avg_pool, {current}).iattrs = {nr, nc, sy, sx, l.padding_y(), l.padding_x()};
+            }
+
+            template <layer_mode mode>
+            void add (const bn_<mode>& l)
+            {
+                // In a deployed network batch normalization is just an affine transform
+                // using the running statistics, which is what affine_ computes.
+                add(affine_(l));
+            }
+
+            void add (const affine_& l)
+            {
+                if (l.is_disabled())
+                    return;
+                auto& n = push(l.get_mode() == CONV_MODE ? graph_op_kind::affine_con : graph_op_kind::affine_fc, {current});
+                n.tensors.push_back(copy_graph_tensor(l.get_gamma().get()));
+                n.tensors.push_back(copy_graph_tensor(l.get_beta().get()));
+            }
+
+            void add (const dropout_& l)
+            {
+                // Like the multiply_ layer made from a dropout_ layer for testing.
+                add(multiply_(l));
+            }
+
+            void add (const multiply_& l)
+            {
+                push(graph_op_kind::multiply, {current}).fattrs = {l.get_multiply_value()};
+            }
+
+            template <template<typename> class TAG>
+            void add (const add_prev_<TAG>& )
+            {
+                push(graph_op_kind::add_prev, {current, tag(tag_id<TAG>::id)});
+            }
+
+            template <template<typename> class TAG>
+            void add (const mult_prev_<TAG>& )
+            {
+                push(graph_op_kind::mult_prev, {current, tag(tag_id<TAG>::id)});
+            }
+
+            template <template<typename> class... TAGS>
+            void add (const concat_<TAGS...>& )
+            {
+                push(graph_op_kind::concat, {tag(tag_id<TAGS>::id)...});
+            }
+
+            template <int sy, int sx>
+            void add (const upsample_<sy,sx>& )
+            {
+                push(graph_op_kind::upsample, {current}).iattrs = {sy, sx};
+            }
+
+            std::vector<graph_node>& nodes;
+            std::map<unsigned long,long> tags;
+            long current = 0;
+        };
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    class dnn_graph
+    {
+    public:
+
+        dnn_graph (
+        ) = default;
+
+        template <typename net_type>
+        explicit dnn_graph (
+            const net_type& net
+        )
+        {
+            impl::visitor_build_graph temp(nodes);
+            temp(net);
+            output_value = nodes.size();
+            make_plan();
+        }
+
+        dnn_graph (
+            const dnn_graph& item
+        ) : nodes(item.nodes), output_value(item.output_value)
+        {
+            make_plan();
+        }
+
+        dnn_graph& operator= (
+            const dnn_graph& item
+        )
+        {
+            if (this == &item)
+                return *this;
+            nodes = item.nodes;
+            output_value = item.output_value;
+            make_plan();
+            return *this;
+        }
+
+        dnn_graph (dnn_graph&&) = default;
+        dnn_graph& operator= (dnn_graph&&) = default;
+
+        size_t num_nodes (
+        ) const { return nodes.size(); }
+
+        size_t num_steps (
+        ) const { return plan.size(); }
+
+        size_t num_buffers (
+        ) const { return buffers.size(); }
+
+        const tensor& forward (
+            const tensor& x
+        )
+        {
+            for (auto& s : plan)
+                run(s, x);
+            if (output_buffer < 0)
+                return x;
+            return buffers[output_buffer];
+        }
+
+        friend void serialize (
+            const dnn_graph& item,
+            std::ostream& out
+        )
+        {
+            serialize("dnn_graph", out);
+            serialize(item.nodes.size(), out);
+            for (auto& n : item.nodes)
+            {
+                serialize(std::string(impl::graph_op(n.kind).name), out);
+                serialize(n.inputs, out);
+                serialize(n.iattrs, out);
+                serialize(n.fattrs, out);
+                serialize(n.tensors, out);
+            }
+            serialize(item.output_value, out);
+        }
+
+        friend void deserialize (
+            dnn_graph& item,
+            std::istream& in
+        )
+        {
+            std::string version;
+            deserialize(version, in);
+            if (version != "dnn_graph")
+                throw serialization_error("Unexpected version '"+version+"' found while deserializing dlib::dnn_graph.");
+
+            size_t num;
+            deserialize(num, in);
+            std::vector<impl::graph_node> nodes(num);
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                auto& n = nodes[i];
+                std::string name;
+                deserialize(name, in);
+                deserialize(n.inputs, in);
+                deserialize(n.iattrs, in);
+                deserialize(n.fattrs, in);
+                deserialize(n.tensors, in);
+
+                const impl::graph_op_info* info = nullptr;
+                for (auto& op : impl::graph_ops())
+                {
+                    if (name == op.name)
+                        info = &op;
+                }
+                if (!info)
+                    throw serialization_error("Unknown operation '"+name+"' found while deserializing dlib::dnn_graph.");
+                n.kind = info->kind;
+                if ((info->num_inputs < 0 && n.inputs.size() == 0) ||
+                    (info->num_inputs >= 0 && n.inputs.size() != (size_t)info->num_inputs) ||
+                    n.iattrs.size() != info->num_iattrs || n.fattrs.size() != info->num_fattrs ||
+                    n.tensors.size() < info->min_tensors || n.tensors.size() > info->max_tensors)
+                    throw serialization_error("Invalid '"+name+"' operation found while deserializing dlib::dnn_graph.");
+                if (n.kind == impl::graph_op_kind::con &&
+                    (n.iattrs[5] < 0 || n.iattrs[5] > static_cast<long>(cpu::conv_activation::leaky_relu)))
+                    throw serialization_error("Invalid 'con' operation found while deserializing dlib::dnn_graph.");
+                if (!impl::graph_node_shapes_are_valid(n))
+                    throw serialization_error("The tensors of a '"+name+"' operation don't match its parameters while deserializing dlib::dnn_graph.");
+                for (auto v : n.inputs)
+                {
+                    // Nodes can only use the graph input or the outputs of earlier nodes.
+                    if (v < 0 || v > (long)i)
+                        throw serialization_error("Invalid '"+name+"' operation found while deserializing dlib::dnn_graph.");
+                }
+            }
+            long output_value;
+            deserialize(output_value, in);
+            if (output_value < 0 || output_value > (long)nodes.size())
+                throw serialization_error("Invalid output found while deserializing dlib::dnn_graph.");
+
+            item.nodes = std::move(nodes);
+            item.output_value = output_value;
+            item.make_plan();
+        }
+
+        friend std::ostream& operator<< (
+            std::ostream& out,
+            const dnn_graph& item
+        )
+        {
+            for (size_t i = 0; i < item.nodes.size(); ++i)
+            {
+                auto& n = item.nodes[i];
+                out << "value " << i+1 << " = " << impl::graph_op(n.kind).name << "(";
+                for (size_t j = 0; j < n.inputs.size(); ++j)
+                    out << (j == 0 ? "" : ", ") << "value " << n.inputs[j];
+                out << ")\n";
+            }
+            out << "output = value " << item.output_value << "\n";
+            return out;
+        }
+
+    private:
+
+        struct step
+        {
+            size_t node;
+            std::vector<long> inputs; // buffer indices, -1 is the graph input
+            long output;              // buffer index
+            cpu::conv_activation activation = cpu::conv_activation::none;
+            float activation_param = 0;
+            std::shared_ptr<tt::tensor_conv> conv;
+            std::shared_ptr<tt::pooling> pool;
+        };
+
+        void make_plan (
+        )
+        {
+            plan.clear();
+            buffers.clear();
+            const long num_values = nodes.size()+1;
+
+            // Fold relu, prelu and leaky_relu into the con before them when nothing else
+            // reads the con's output.  value_of[v] is the value that holds value v after
+            // this.
+            std::vector<long> value_of(num_values);
+            std::vector<long> num_readers(num_values, 0);
+            for (long v = 0; v < num_values; ++v)
+                value_of[v] = v;
+            for (auto& n : nodes)
+                for (auto v : n.inputs)
+                    ++num_readers[v];
+            std::vector<bool> folded(nodes.size(), false);
+            std::vector<std::pair<cpu::conv_activation,float>> activation(nodes.size(),
+                std::make_pair(cpu::conv_activation::none, 0.f));
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                auto& n = nodes[i];
+                cpu::conv_activation act;
+                float param = 0;
+                if (n.kind == impl::graph_op_kind::relu)
+                    act = cpu::conv_activation::relu;
+                else if (n.kind == impl::graph_op_kind::leaky_relu)
+                    act = cpu::conv_activation::leaky_relu, param = n.fattrs[0];
+                else if (n.kind == impl::graph_op_kind::prelu && n.tensors[0].size() == 1)
+                    act = cpu::conv_activation::prelu, param = n.tensors[0].host()[0];
+                else
+                    continue;
+                const long src = value_of[n.inputs[0]];
+                if (src == 0 || num_readers[n.inputs[0]] != 1 || n.inputs[0] == output_value)
+                    continue;
+                auto& prev = nodes[src-1];
+                if (prev.kind != impl::graph_op_kind::con || prev.iattrs[5] != 0 ||
+                    activation[src-1].first != cpu::conv_activation::none)
+                    continue;
+                activation[src-1] = std::make_pair(act, param);
+                folded[i] = true;
+                value_of[i+1] = src;
+            }
+
+            // The last step reading each value, so we know when its buffer can be reused.
+            std::vector<long> last_reader(num_values, -1);
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (folded[i])
+                    continue;
+                for (auto v : nodes[i].inputs)
+                    last_reader[value_of[v]] = i;
+            }
+            last_reader[value_of[output_value]] = nodes.size();
+
+            std::vector<long> buffer_of(num_values, -1);
+            std::vector<long> free_buffers;
+            long num_buffers = 0;
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                if (folded[i])
+                    continue;
+                auto& n = nodes[i];
+                step s;
+                s.node = i;
+                for (auto v : n.inputs)
+                    s.inputs.push_back(buffer_of[value_of[v]]);
+
+                const long src = value_of[n.inputs[0]];
+                if (impl::graph_op(n.kind).in_place && src != 0 && last_reader[src] == (long)i)
+                {
+                    // Nothing reads the input after this step so write over it.
+                    s.output = buffer_of[src];
+                }
+                else
+                {
+                    if (free_buffers.size() != 0)
+                    {
+                        s.output = free_buffers.back();
+                        free_buffers.pop_back();
+                    }
+                    else
+                    {
+                        s.output = num_buffers++;
+                    }
+                    for (auto v : n.inputs)
+                    {
+                        v = value_of[v];
+                        if (v != 0 && last_reader[v] == (long)i && buffer_of[v] >= 0)
+                        {
+                            free_buffers.push_back(buffer_of[v]);
+                            buffer_of[v] = -1;
+                        }
+                    }
+                }
+                buffer_of[i+1] = s.output;
+                if (last_reader[i+1] < 0)
+                {
+                    // Nothing reads this output, so its buffer is free again right away.
+                    free_buffers.push_back(s.output);
+                    buffer_of[i+1] = -1;
+                }
+
+                if (n.kind == impl::graph_op_kind::con)
+                {
+                    if (n.iattrs[5] != 0)
+                        activation[i] = std::make_pair(static_cast<cpu::conv_activation>(n.iattrs[5]), n.fattrs[0]);
+                    s.activation = activation[i].first;
+                    s.activation_param = activation[i].second;
+                }
+                if (n.kind == impl::graph_op_kind::con || n.kind == impl::graph_op_kind::cont)
+                    s.conv = std::make_shared<tt::tensor_conv>();
+                if (n.kind == impl::graph_op_kind::max_pool || n.kind == impl::graph_op_kind::avg_pool)
+                    s.pool = std::make_shared<tt::pooling>();
+                plan.push_back(std::move(s));
+            }
+            buffers.resize(num_buffers);
+            output_buffer = buffer_of[value_of[output_value]];
+        }
+
+        void run (
+            step& s,
+            const tensor& x
+        )
+        {
+            auto& n = nodes[s.node];
+            auto input = [&](size_t i) -> const tensor& { return s.inputs[i] < 0 ? x : buffers[s.inputs[i]]; };
+            const tensor& in = input(0);
+            resizable_tensor& out = buffers[s.output];
+            const bool in_place = is_same_object(in, out);
+            if (!in_place && impl::graph_op(n.kind).in_place)
+                out.copy_size(in);
+
+            switch (n.kind)
+            {
+                case impl::graph_op_kind::con:
+                    DLIB_CASSERT(in.k() == n.tensors[0].k()*n.iattrs[4] &&
+                        n.tensors[0].nr() <= in.nr() + 2*n.iattrs[2] && n.tensors[0].nc() <= in.nc() + 2*n.iattrs[3],
+                        "The input tensor to this con layer doesn't match the shape of its filters.");
+                    s.conv->setup(in, n.tensors[0], n.iattrs[0], n.iattrs[1], n.iattrs[2], n.iattrs[3], n.iattrs[4]);
+                    (*s.conv)(false, out, in, n.tensors[0], n.tensors[1], s.activation, s.activation_param);
+                    break;
+                case impl::graph_op_kind::cont:
+                {
+                    const tensor& filt = n.tensors[0];
+                    DLIB_CASSERT(in.k() == filt.num_samples(),
+                        "The input tensor to this cont layer doesn't match the shape of its filters.");
+                    out.set_size(in.num_samples(), filt.k()*n.iattrs[4],
+                                 n.iattrs[0]*(in.nr()-1) + filt.nr() - 2*n.iattrs[2],
+                                 n.iattrs[1]*(in.nc()-1) + filt.nc() - 2*n.iattrs[3]);
+                    s.conv->setup(out, filt, n.iattrs[0], n.iattrs[1], n.iattrs[2], n.iattrs[3], n.iattrs[4]);
+                    s.conv->get_gradient_for_data(false, in, filt, out);
+                    tt::add(1, out, 1, n.tensors[1]);
+                    break;
+                }
+                case impl::graph_op_kind::fc:
+                    DLIB_CASSERT(in.size()/in.num_samples() == (size_t)n.tensors[0].num_samples(),
+                        "The size of the input tensor to this fc layer doesn't match the size the fc layer was trained with.");
+                    out.set_size(in.num_samples(), n.tensors[0].k());
+                    tt::gemm(0, out, 1, in, false, n.tensors[0], false);
+                    if (n.tensors.size() == 2)
+                        tt::add(1, out, 1, n.tensors[1]);
+                    break;
+                case impl::graph_op_kind::relu: tt::relu(out, in); break;
+                case impl::graph_op_kind::prelu:
+                    out.copy_size(in);
+                    tt::prelu(out, in, n.tensors[0]);
+                    break;
+                case impl::graph_op_kind::leaky_relu: tt::leaky_relu(out, in, n.fattrs[0]); break;
+                case impl::graph_op_kind::sig: tt::sigmoid(out, in); break;
+                case impl::graph_op_kind::htan: tt::tanh(out, in); break;
+                case impl::graph_op_kind::mish:
+                    out.copy_size(in);
+                    tt::mish(out, in);
+                    break;
+                case impl::graph_op_kind::softmax: tt::softmax(out, in); break;
+                case impl::graph_op_kind::max_pool:
+                case impl::graph_op_kind::avg_pool:
+                {
+                    const long nr = n.iattrs[0] != 0 ? n.iattrs[0] : in.nr();
+                    const long nc = n.iattrs[1] != 0 ? n.iattrs[1] : in.nc();
+                    DLIB_CASSERT(n.iattrs[4] < nr && n.iattrs[5] < nc,
+                        "The input tensor to this pooling layer is smaller than its padding.");
+                    if (n.kind == impl::graph_op_kind::max_pool)
+                        s.pool->setup_max_pooling(nr, nc, n.iattrs[2], n.iattrs[3], n.iattrs[4], n.iattrs[5]);
+                    else
+                        s.pool->setup_avg_pooling(nr, nc, n.iattrs[2], n.iattrs[3], n.iattrs[4], n.iattrs[5]);
+                    (*s.pool)(out, in);
+                    break;
+                }
+                case impl::graph_op_kind::affine_con:
+                    DLIB_CASSERT(in.k() == n.tensors[0].k(),
+                        "The input tensor to this affine layer doesn't match the number of channels it was trained with.");
+                    tt::affine_transform_conv(out, in, n.tensors[0], n.tensors[1]);
+                    break;
+                case impl::graph_op_kind::affine_fc:
+                    DLIB_CASSERT(in.k() == n.tensors[0].k() && in.nr() == n.tensors[0].nr() && in.nc() == n.tensors[0].nc(),
+                        "The input tensor to this affine layer doesn't match the shape it was trained with.");
+                    tt::affine_transform(out, in, n.tensors[0], n.tensors[1]);
+                    break;
+                case impl::graph_op_kind::multiply: tt::affine_transform(out, in, n.fattrs[0]); break;
+                case impl::graph_op_kind::add_prev:
+                case impl::graph_op_kind::mult_prev:
+                {
+                    const tensor& t2 = input(1);
+                    out.set_size(std::max(in.num_samples(),t2.num_samples()),
+                                 std::max(in.k(),t2.k()),
+                                 std::max(in.nr(),t2.nr()),
+                                 std::max(in.nc(),t2.nc()));
+                    if (n.kind == impl::graph_op_kind::add_prev)
+                        tt::add(out, in, t2);
+                    else
+                        tt::multiply_zero_padded(false, out, in, t2);
+                    break;
+                }
+                case impl::graph_op_kind::concat:
+                {
+                    long k = 0;
+                    for (size_t i = 0; i < s.inputs.size(); ++i)
+                        k += input(i).k();
+                    out.set_size(in.num_samples(), k, in.nr(), in.nc());
+                    size_t k_offset = 0;
+                    for (size_t i = 0; i < s.inputs.size(); ++i)
+                    {
+                        const tensor& t = input(i);
+                        tt::copy_tensor(false, out, k_offset, t, 0, t.k());
+                        k_offset += t.k();
+                    }
+                    break;
+                }
+                case impl::graph_op_kind::upsample:
+                    out.set_size(in.num_samples(), in.k(), n.iattrs[0]*in.nr(), n.iattrs[1]*in.nc());
+                    tt::resize_bilinear(out, in);
+                    break;
+            }
+        }
+
+        std::vector<impl::graph_node> nodes;
+        long output_value = 0;
+
+        std::vector<step> plan;
+        std::vector<resizable_tensor> buffers;
+        long output_buffer = -1;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_GRAPH_H_
+
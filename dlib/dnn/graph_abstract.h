@@ -0,0 +1,151 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_GRAPH_ABSTRACT_H_
+#ifdef DLIB_DNn_GRAPH_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include "layers_abstract.h"
+#include <iostream>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class dnn_graph
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object is a trained network that doesn't depend on the network's C++
+                type.  It holds the layers of a network as a flat list of operations, each
+                reading the outputs of earlier operations, along with their parameters.
+                You make one from a network object and serialize it.  Any program can
+                then deserialize it and run it, without being compiled for that
+                particular network type.  So a long running server can load new models,
+                or different models, without being recompiled.
+
+                dnn_graph only does inference.  It supports these layers: con_ (including
+                grouped and fused convolutions), cont_, fc_, fc_sampled_, relu_, prelu_,
+                leaky_relu_, sig_, htan_, mish_, softmax_, max_pool_, avg_pool_, bn_,
+                affine_, dropout_, multiply_, add_prev_, mult_prev_, concat_, upsample_,
+                and any tag, skip, and repeat layers combining them.  bn_ and dropout_ become the
+                affine_ and multiply_ layers you would replace them with for testing.
+                The input layer and the loss layer are not part of the graph.  Use the
+                input layer's to_tensor() to make the graph's input, and interpret its
+                output tensor the way the loss layer's to_label() would.
+
+                When it's made or deserialized, a dnn_graph plans how to run its
+                operations.  Each relu, prelu, or leaky_relu that is the only reader of a
+                con's output is folded into that con.  Each intermediate output is then
+                assigned one of a set of buffers, which are reused as soon as the outputs
+                they hold have been read for the last time.  Operations that compute
+                their outputs element by element write over their input when nothing else
+                needs it.  The buffers keep their memory between calls to forward(), so
+                after the first call, inputs of the same size don't allocate anything.
+
+            THREAD SAFETY
+                forward() uses the buffers inside the object, so a dnn_graph can only be
+                used by one thread at a time.  Copy it to run the same model on several
+                threads at once.
+        !*/
+
+    public:
+
+        dnn_graph (
+        );
+        /*!
+            ensures
+                - #num_nodes() == 0
+                - #forward(x) returns x.
+        !*/
+
+        template <typename net_type>
+        explicit dnn_graph (
+            const net_type& net
+        );
+        /*!
+            requires
+                - net_type is an add_layer, add_loss_layer, add_tag_layer, add_skip_layer,
+                  or repeat object.
+                - net only contains the layers listed above.  Any other layer type is a
+                  compile time error.
+                - net has been run at least once, so its layers have allocated their
+                  parameters.
+                - net doesn't contain int8 layers (see quantize_int8()).
+            ensures
+                - #forward(x) computes the same output tensor as net.forward(x) would, with
+                  bn_ layers in testing mode.
+        !*/
+
+        dnn_graph (
+            const dnn_graph& item
+        );
+        /*!
+            ensures
+                - #*this is a copy of item with its own buffers.
+        !*/
+
+        dnn_graph& operator= (
+            const dnn_graph& item
+        );
+        /*!
+            ensures
+                - #*this is a copy of item with its own buffers.
+                - returns #*this
+        !*/
+
+        size_t num_nodes (
+        ) const;
+        /*!
+            ensures
+                - returns the number of operations in this graph.
+        !*/
+
+        size_t num_steps (
+        ) const;
+        /*!
+            ensures
+                - returns the number of operations forward() actually runs, i.e.
+                  num_nodes() minus the activations folded into con operations.
+        !*/
+
+        size_t num_buffers (
+        ) const;
+        /*!
+            ensures
+                - returns the number of tensors forward() uses to hold intermediate
+                  outputs.  This is usually much smaller than num_steps() since buffers
+                  are reused.
+        !*/
+
+        const tensor& forward (
+            const tensor& x
+        );
+        /*!
+            requires
+                - x has the shape the original network's input layer would produce.
+            ensures
+                - Runs the graph on x and returns the output tensor.  The returned tensor
+                  is owned by *this and is valid until the next call to forward().
+        !*/
+    };
+
+    void serialize(const dnn_graph& item, std::ostream& out);
+    void deserialize(dnn_graph& item, std::istream& in);
+    /*!
+        provides serialization support.  The format records each operation's name, its
+        inputs, and its parameters, so deserialize() doesn't need to know anything about
+        the network the graph was made from.
+    !*/
+
+    std::ostream& operator<< (std::ostream& out, const dnn_graph& item);
+    /*!
+        prints the operations in item and which values they read.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_GRAPH_ABSTRACT_H_
+
@@ -0,0 +1,104 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_INFERENCE_SERVER_H_
+#define DLIB_DNn_INFERENCE_SERVER_H_
+
+#include "inference_server_abstract.h"
+#include "batching.h"
+#include "../server.h"
+#include <functional>
+#include <string>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_inference_server : public server_http
+    {
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::output_label_type output_label_type;
+        typedef std::function<input_type(const incoming_things&)> request_decoder;
+        typedef std::function<std::string(const output_label_type&, outgoing_things&)> response_encoder;
+
+        dnn_inference_server (
+            dnn_batching_executor<net_type>& executor_,
+            const request_decoder& decode_,
+            const response_encoder& encode_,
+            const std::string& path_ = "/predict"
+        ) :
+            executor(executor_),
+            decode(decode_),
+            encode(encode_),
+            path(path_)
+        {
+            DLIB_CASSERT(decode_ != nullptr && encode_ != nullptr);
+        }
+
+        ~dnn_inference_server (
+        )
+        {
+            // stop before on_request() goes away
+            clear();
+        }
+
+        const std::string& get_path (
+        ) const { return path; }
+
+    private:
+
+        const std::string on_request (
+            const incoming_things& incoming,
+            outgoing_things& outgoing
+        )
+        {
+            if (incoming.path != path)
+            {
+                outgoing.http_return = 404;
+                outgoing.http_return_status = "Not Found";
+                return "";
+            }
+            if (incoming.request_type != "POST")
+            {
+                outgoing.http_return = 405;
+                outgoing.http_return_status = "Method Not Allowed";
+                outgoing.headers["Allow"] = "POST";
+                return "";
+            }
+
+            input_type x;
+            try
+            {
+                x = decode(incoming);
+            }
+            catch (std::exception& e)
+            {
+                outgoing.http_return = 400;
+                outgoing.http_return_status = "Bad Request";
+                outgoing.headers["Content-Type"] = "text/plain";
+                return e.what();
+            }
+
+            // Any exception from the network ends up in server_http, which reports it as
+            // an internal server error.
+            const output_label_type result = executor.submit(std::move(x)).get();
+            return encode(result, outgoing);
+        }
+
+        dnn_batching_executor<net_type>& executor;
+        const request_decoder decode;
+        const response_encoder encode;
+        const std::string path;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_INFERENCE_SERVER_H_
+
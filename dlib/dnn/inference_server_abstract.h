@@ -0,0 +1,85 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_INFERENCE_SERVER_ABSTRACT_H_
+#ifdef DLIB_DNn_INFERENCE_SERVER_ABSTRACT_H_
+
+#include "batching_abstract.h"
+#include "../server/server_http_abstract.h"
+#include <functional>
+#include <string>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class dnn_inference_server : public server_http
+    {
+        /*!
+            REQUIREMENTS ON NET_TYPE
+                NET_TYPE is an add_loss_layer object.
+
+            WHAT THIS OBJECT REPRESENTS
+                This is a web server that runs a network on the data POSTed to it.  Each
+                request is turned into a network input by a user supplied decoder, run
+                through a dnn_batching_executor, so concurrent requests share mini-batches,
+                and the output is turned into the response body by a user supplied
+                encoder.
+
+                Each request is handled by its own thread while it waits for its
+                mini-batch.  So if you use server_io_model::event_loop then give the
+                server at least as many worker threads as the executor's maximum batch
+                size, or the mini-batches can never fill up.
+
+                This header isn't included by dlib/dnn.h since it needs dlib's networking
+                code.  Include dlib/dnn/inference_server.h to use it.
+        !*/
+
+    public:
+        typedef NET_TYPE net_type;
+        typedef typename net_type::input_type input_type;
+        typedef typename net_type::output_label_type output_label_type;
+        typedef std::function<input_type(const incoming_things&)> request_decoder;
+        typedef std::function<std::string(const output_label_type&, outgoing_things&)> response_encoder;
+
+        dnn_inference_server (
+            dnn_batching_executor<net_type>& executor,
+            const request_decoder& decode,
+            const response_encoder& encode,
+            const std::string& path = "/predict"
+        );
+        /*!
+            requires
+                - decode != nullptr
+                - encode != nullptr
+                - executor outlives *this.
+            ensures
+                - #get_path() == path
+                - When running, the server answers POST requests for path like this:
+                    - x = decode(incoming).  If this throws a std::exception then the
+                      response is a 400 Bad Request error with e.what() as its body.
+                    - The response body is encode(executor(x), outgoing).  encode() can
+                      also set the response's headers, e.g. its Content-Type, through
+                      outgoing.  If the network throws then the response is a 500
+                      error.
+                - Requests for any other path get a 404 error, and other kinds of
+                  requests for path get a 405 error.
+        !*/
+
+        const std::string& get_path (
+        ) const;
+        /*!
+            ensures
+                - returns the path of the URL this server answers requests on.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_INFERENCE_SERVER_ABSTRACT_H_
+
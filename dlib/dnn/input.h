@@ -8,14 +8,137 @@
 #include "../array2d.h"
 #include "../pixel.h"
 #include "../image_processing.h"
+#include "../image_transforms/interpolation.h"
+#include "../threads/parallel_for_extension.h"
 #include <sstream>
 #include <array>
+#include <vector>
 #include "../cuda/tensor_tools.h"
 
 
 namespace dlib
 {
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class channel_to_float
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object maps an 8 bit channel value v to (v-avg)/256, the value the
+                    image input layers store in their tensors.  It looks the result up in a
+                    table, which gives bit for bit the same values as computing it and is a
+                    lot faster.
+            !*/
+        public:
+            explicit channel_to_float(float avg)
+            {
+                for (int v = 0; v < 256; ++v)
+                    values[v] = (v-avg)/256.0;
+            }
+
+            float operator() (unsigned char v) const { return values[v]; }
+
+        private:
+            std::array<float,256> values;
+        };
+
+        // Converting images is too little work per pixel to be worth splitting across
+        // threads unless there are at least this many pixels.
+        const long min_parallel_to_tensor_pixels = 1<<16;
+
+        template <typename T>
+        void for_each_row_block (
+            long num_samples,
+            long nr,
+            long nc,
+            const T& funct
+        )
+        /*!
+            ensures
+                - calls funct(i, row_begin, row_end) on disjoint row ranges of each sample
+                  i in [0,num_samples) that together cover [0,nr).  When there are enough
+                  pixels the calls are spread over default_thread_pool(), with each sample
+                  split into enough blocks to keep all the threads busy.
+        !*/
+        {
+            const long num_threads = default_thread_pool().num_threads_in_pool();
+            if (num_samples*nr*nc < min_parallel_to_tensor_pixels || num_threads <= 1)
+            {
+                for (long i = 0; i < num_samples; ++i)
+                    funct(i, 0L, nr);
+                return;
+            }
+
+            const long blocks_per_sample = std::min(nr, (2*num_threads + num_samples - 1)/num_samples);
+            parallel_for(0, num_samples*blocks_per_sample, [&](long b)
+            {
+                const long i = b/blocks_per_sample;
+                const long block = b%blocks_per_sample;
+                funct(i, nr*block/blocks_per_sample, nr*(block+1)/blocks_per_sample);
+            });
+        }
+
+        template <typename T>
+        void for_each_plane (
+            long num_planes,
+            long plane_size,
+            const T& funct
+        )
+        /*!
+            ensures
+                - calls funct(p) for each p in [0,num_planes), spread over
+                  default_thread_pool() when there are enough pixels.
+        !*/
+        {
+            if (num_planes*plane_size < min_parallel_to_tensor_pixels || num_planes <= 1 ||
+                default_thread_pool().num_threads_in_pool() <= 1)
+            {
+                for (long p = 0; p < num_planes; ++p)
+                    funct(p);
+            }
+            else
+            {
+                parallel_for(0, num_planes, funct);
+            }
+        }
+
+        template <typename image_type>
+        void rgb_image_to_planes (
+            const image_type& img,
+            long row_begin,
+            long row_end,
+            const channel_to_float& red,
+            const channel_to_float& green,
+            const channel_to_float& blue,
+            float* dest,
+            long row_stride,
+            long channel_stride
+        )
+        /*!
+            ensures
+                - writes rows [row_begin,row_end) of img into the three planes starting at
+                  dest, dest+channel_stride, and dest+2*channel_stride.
+        !*/
+        {
+            for (long r = row_begin; r < row_end; ++r)
+            {
+                float* pr = dest + r*row_stride;
+                float* pg = pr + channel_stride;
+                float* pb = pg + channel_stride;
+                for (long c = 0; c < img.nc(); ++c)
+                {
+                    const rgb_pixel temp = img(r,c);
+                    pr[c] = red(temp.red);
+                    pg[c] = green(temp.green);
+                    pb[c] = blue(temp.blue);
+                }
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <typename T>
@@ -92,27 +215,18 @@ namespace dlib
             data.set_size(std::distance(ibegin,iend), 3, nr, nc);
 
 
-            const size_t offset = nr*nc;
-            auto ptr = data.host();
+            std::vector<const input_type*> images;
             for (auto i = ibegin; i != iend; ++i)
-            {
-                for (long r = 0; r < nr; ++r)
-                {
-                    for (long c = 0; c < nc; ++c)
-                    {
-                        rgb_pixel temp = (*i)(r,c);
-                        auto p = ptr++;
-                        *p = (temp.red-avg_red)/256.0; 
-                        p += offset;
-                        *p = (temp.green-avg_green)/256.0; 
-                        p += offset;
-                        *p = (temp.blue-avg_blue)/256.0; 
-                        p += offset;
-                    }
-                }
-                ptr += offset*(data.k()-1);
-            }
+                images.push_back(&*i);
 
+            const impl::channel_to_float red(avg_red), green(avg_green), blue(avg_blue);
+            const long offset = nr*nc;
+            float* ptr = data.host_write_only();
+            impl::for_each_row_block(images.size(), nr, nc, [&](long i, long row_begin, long row_end)
+            {
+                impl::rgb_image_to_planes(*images[i], row_begin, row_end, red, green, blue,
+                    ptr + i*3*offset, nc, offset);
+            });
         }
 
         friend void serialize(const input_rgb_image& item, std::ostream& out)
@@ -221,27 +335,18 @@ namespace dlib
             data.set_size(std::distance(ibegin,iend), 3, NR, NC);
 
 
-            const size_t offset = NR*NC;
-            auto ptr = data.host();
+            std::vector<const input_type*> images;
             for (auto i = ibegin; i != iend; ++i)
-            {
-                for (size_t r = 0; r < NR; ++r)
-                {
-                    for (size_t c = 0; c < NC; ++c)
-                    {
-                        rgb_pixel temp = (*i)(r,c);
-                        auto p = ptr++;
-                        *p = (temp.red-avg_red)/256.0; 
-                        p += offset;
-                        *p = (temp.green-avg_green)/256.0; 
-                        p += offset;
-                        *p = (temp.blue-avg_blue)/256.0; 
-                        p += offset;
-                    }
-                }
-                ptr += offset*(data.k()-1);
-            }
+                images.push_back(&*i);
 
+            const impl::channel_to_float red(avg_red), green(avg_green), blue(avg_blue);
+            const long offset = NR*NC;
+            float* ptr = data.host_write_only();
+            impl::for_each_row_block(images.size(), NR, NC, [&](long i, long row_begin, long row_end)
+            {
+                impl::rgb_image_to_planes(*images[i], row_begin, row_end, red, green, blue,
+                    ptr + i*3*offset, NC, offset);
+            });
         }
 
         friend void serialize(const input_rgb_image_sized& item, std::ostream& out)
@@ -672,13 +777,61 @@ namespace dlib
                 // initialize data to the right size to contain the stuff in the iterator range.
                 data.set_size(std::distance(ibegin, iend), k, NR, NC);
 
-                // We need to zero the image before doing the pyramid, since the pyramid
-                // creation code doesn't write to all parts of the image.  We also take
+                // Normally fill_tiled_pyramid() zeros each plane as it fills it.  We take
                 // care to avoid triggering any device to hosts copies.
-                auto ptr = data.host_write_only();
-                for (size_t i = 0; i < data.size(); ++i)
-                    ptr[i] = 0;
+                if (rects.size() == 0)
+                {
+                    auto ptr = data.host_write_only();
+                    for (size_t i = 0; i < data.size(); ++i)
+                        ptr[i] = 0;
+                }
+            }
 
+            template <typename T>
+            void fill_tiled_pyramid (
+                const std::vector<rectangle>& rects,
+                resizable_tensor& data,
+                const T& fill_first_level
+            ) const
+            /*!
+                requires
+                    - rects.size() > 0
+                    - fill_first_level(i, k, dest, row_stride) writes channel k of the ith
+                      input image into the pixels dest[r*row_stride+c].
+                ensures
+                    - builds the whole tiled pyramid in data.  Each channel of each sample
+                      is zeroed, filled, and downsampled in one pass, and the passes are
+                      spread over default_thread_pool() when the tensor is big.  When
+                      using CUDA the downsampling is done on the GPU afterwards instead.
+            !*/
+            {
+                float* ptr = data.host_write_only();
+                const long plane_size = data.nr()*data.nc();
+                const long row_stride = data.nc();
+                const long k = data.k();
+                impl::for_each_plane(data.num_samples()*k, plane_size, [&](long p)
+                {
+                    // We need to zero the image before doing the pyramid, since the
+                    // pyramid creation code doesn't write to all parts of the image.
+                    float* plane = ptr + p*plane_size;
+                    std::fill(plane, plane+plane_size, 0);
+                    fill_first_level(p/k, p%k, plane + rects[0].top()*row_stride + rects[0].left(), row_stride);
+#ifndef DLIB_USE_CUDA
+                    // The same thing tt::resize_bilinear() does in create_tiled_pyramid(),
+                    // but while this plane is still in the cache.
+                    for (size_t i = 1; i < rects.size(); ++i)
+                    {
+                        auto src = sub_image(plane + rects[i-1].top()*row_stride + rects[i-1].left(),
+                            rects[i-1].height(), rects[i-1].width(), row_stride);
+                        auto dest = sub_image(plane + rects[i].top()*row_stride + rects[i].left(),
+                            rects[i].height(), rects[i].width(), row_stride);
+                        resize_image(src, dest);
+                    }
+#endif
+                });
+#ifdef DLIB_USE_CUDA
+                create_tiled_pyramid(rects, data);
+#endif
             }
 
             // now build the image pyramid into data.  This does the same thing as
@@ -730,24 +883,22 @@ namespace dlib
             if (rects.size() == 0)
                 return;
 
-            // copy the first raw image into the top part of the tiled pyramid.  We need to
-            // do this for each of the input images/samples in the tensor.
-            auto ptr = data.host_write_only();
+            std::vector<const input_type*> images;
             for (auto i = ibegin; i != iend; ++i)
+                images.push_back(&*i);
+
+            // copy the raw images into the top part of the tiled pyramid and build the
+            // rest of the pyramid below them.
+            const impl::channel_to_float gray(0);
+            this->fill_tiled_pyramid(rects, data, [&](long i, long, float* dest, long row_stride)
             {
-                auto& img = *i;
-                ptr += rects[0].top()*data.nc();
+                const auto& img = *images[i];
                 for (long r = 0; r < img.nr(); ++r)
                 {
-                    auto p = ptr+rects[0].left();
                     for (long c = 0; c < img.nc(); ++c)
-                        p[c] = (img(r,c))/256.0;
-                    ptr += data.nc();
+                        dest[r*row_stride+c] = gray(img(r,c));
                 }
-                ptr += data.nc()*(data.nr()-rects[0].bottom()-1);
-            }
-
-            this->create_tiled_pyramid(rects, data);
+            });
         }
 
         friend void serialize(const input_grayscale_image_pyramid& item, std::ostream& out)
@@ -825,44 +976,24 @@ namespace dlib
             if (rects.size() == 0)
                 return;
 
-            // copy the first raw image into the top part of the tiled pyramid.  We need to
-            // do this for each of the input images/samples in the tensor.
-            auto ptr = data.host_write_only();
+            std::vector<const input_type*> images;
             for (auto i = ibegin; i != iend; ++i)
-            {
-                auto& img = *i;
-                ptr += rects[0].top()*data.nc();
-                for (long r = 0; r < img.nr(); ++r)
-                {
-                    auto p = ptr+rects[0].left();
-                    for (long c = 0; c < img.nc(); ++c)
-                        p[c] = (img(r,c).red-avg_red)/256.0;
-                    ptr += data.nc();
-                }
-                ptr += data.nc()*(data.nr()-rects[0].bottom()-1);
-
-                ptr += rects[0].top()*data.nc();
-                for (long r = 0; r < img.nr(); ++r)
-                {
-                    auto p = ptr+rects[0].left();
-                    for (long c = 0; c < img.nc(); ++c)
-                        p[c] = (img(r,c).green-avg_green)/256.0;
-                    ptr += data.nc();
-                }
-                ptr += data.nc()*(data.nr()-rects[0].bottom()-1);
+                images.push_back(&*i);
 
-                ptr += rects[0].top()*data.nc();
+            // copy the raw images into the top part of the tiled pyramid and build the
+            // rest of the pyramid below them.
+            const impl::channel_to_float red(avg_red), green(avg_green), blue(avg_blue);
+            this->fill_tiled_pyramid(rects, data, [&](long i, long k, float* dest, long row_stride)
+            {
+                const auto& img = *images[i];
+                const impl::channel_to_float& to_float = k == 0 ? red : (k == 1 ? green : blue);
+                unsigned char rgb_pixel::*channel = k == 0 ? &rgb_pixel::red : (k == 1 ? &rgb_pixel::green : &rgb_pixel::blue);
                 for (long r = 0; r < img.nr(); ++r)
                 {
-                    auto p = ptr+rects[0].left();
                     for (long c = 0; c < img.nc(); ++c)
-                        p[c] = (img(r,c).blue-avg_blue)/256.0;
-                    ptr += data.nc();
+                        dest[r*row_stride+c] = to_float(img(r,c).*channel);
                 }
-                ptr += data.nc()*(data.nr()-rects[0].bottom()-1);
-            }
-
-            this->create_tiled_pyramid(rects, data);
+            });
         }
 
         friend void serialize(const input_rgb_image_pyramid& item, std::ostream& out)
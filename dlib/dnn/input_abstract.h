@@ -245,6 +245,8 @@ namespace dlib
                   Moreover, each color channel is normalized by having its average value
                   subtracted (according to get_avg_red(), get_avg_green(), or
                   get_avg_blue()) and then is divided by 256.0.
+                - Large batches or images are converted in parallel using
+                  default_thread_pool().
         !*/
 
 
@@ -355,6 +357,9 @@ namespace dlib
                       corresponding input image.  The tiled pyramid is created by
                       create_tiled_pyramid().
                   Moreover, each pixel is normalized, dividing them by 256.0.
+                - Each image is normalized and turned into a pyramid in one pass, and when
+                  there is enough data the images are processed in parallel using
+                  default_thread_pool().
         !*/
 
         bool image_contained_point (
@@ -543,6 +548,9 @@ namespace dlib
                   Moreover, each color channel is normalized by having its average value
                   subtracted (according to get_avg_red(), get_avg_green(), or
                   get_avg_blue()) and then is divided by 256.0.
+                - Each color channel of each image is normalized and turned into a pyramid
+                  in one pass, and when there is enough data the channels are processed in
+                  parallel using default_thread_pool().
         !*/
 
         bool image_contained_point (
@@ -34,13 +34,15 @@ namespace dlib
         int _stride_y,
         int _stride_x,
         int _padding_y = _stride_y!=1? 0 : _nr/2,
-        int _padding_x = _stride_x!=1? 0 : _nc/2
+        int _padding_x = _stride_x!=1? 0 : _nc/2,
+        int _groups = 1
         >
     class con_
     {
     public:
 
         static_assert(_num_filters > 0, "The number of filters must be > 0");
+        static_assert(_groups > 0, "The number of groups must be > 0");
         static_assert(_nr >= 0, "The number of rows in a filter must be >= 0");
         static_assert(_nc >= 0, "The number of columns in a filter must be >= 0");
         static_assert(_stride_y > 0, "The filter stride must be > 0");
@@ -85,6 +87,7 @@ namespace dlib
         long stride_x() const { return _stride_x; }
         long padding_y() const { return padding_y_; }
         long padding_x() const { return padding_x_; }
+        long groups() const { return _groups; }
 
         void set_num_filters(long num) 
         {
@@ -137,7 +140,13 @@ namespace dlib
             bias_weight_decay_multiplier(item.bias_weight_decay_multiplier),
             num_filters_(item.num_filters_),
             padding_y_(item.padding_y_),
-            padding_x_(item.padding_x_)
+            padding_x_(item.padding_x_),
+            int8_calibrating(item.int8_calibrating),
+            int8_max_abs_input(item.int8_max_abs_input),
+            int8_input_scale(item.int8_input_scale),
+            int8_filters(item.int8_filters),
+            fused_activation(item.fused_activation),
+            fused_activation_param(item.fused_activation_param)
         {
             // this->conv is non-copyable and basically stateless, so we have to write our
             // own copy to avoid trying to copy it and getting an error.
@@ -162,16 +171,108 @@ namespace dlib
             bias_learning_rate_multiplier = item.bias_learning_rate_multiplier;
             bias_weight_decay_multiplier = item.bias_weight_decay_multiplier;
             num_filters_ = item.num_filters_;
+            int8_calibrating = item.int8_calibrating;
+            int8_max_abs_input = item.int8_max_abs_input;
+            int8_input_scale = item.int8_input_scale;
+            int8_filters = item.int8_filters;
+            fused_activation = item.fused_activation;
+            fused_activation_param = item.fused_activation_param;
             return *this;
         }
 
+        void begin_int8_calibration (
+        )
+        {
+            int8_calibrating = true;
+            int8_max_abs_input = 0;
+        }
+
+        void end_int8_calibration (
+        )
+        {
+            DLIB_CASSERT(int8_calibrating, "You must call begin_int8_calibration() first.");
+            DLIB_CASSERT(_groups == 1, "Grouped con_ layers don't support int8 inference.");
+            DLIB_CASSERT(get_layer_params().size() != 0, "You must run data through the network during calibration.");
+            int8_calibrating = false;
+            int8_input_scale = int8_max_abs_input != 0 ? int8_max_abs_input/127 : 1;
+            auto f = filters(params,0);
+            int8_filters.quantize(f.host(), f.num_samples(), f.k()*f.nr()*f.nc(), false);
+            // Keep the float filters identical to what the int8 filters represent so that
+            // a network loaded from disk behaves exactly like the one that was saved.
+            int8_filters.dequantize(f.host(), false);
+        }
+
+        void disable_int8 (
+        )
+        {
+            int8_calibrating = false;
+            int8_filters.clear();
+        }
+
+        bool is_int8 (
+        ) const { return !int8_filters.empty(); }
+
+        float get_int8_input_scale (
+        ) const { return int8_input_scale; }
+
+        void fold_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        )
+        {
+            DLIB_CASSERT(get_layer_params().size() != 0);
+            DLIB_CASSERT(gamma.size() == (size_t)num_filters_ && beta.size() == (size_t)num_filters_);
+            DLIB_CASSERT(fused_activation == cpu::conv_activation::none,
+                "An affine transform can't be folded into a con_ layer after an activation has been fused into it.");
+            auto f = filters(params,0);
+            auto b = biases(params,filters.size());
+            const long filter_size = f.k()*f.nr()*f.nc();
+            float* pf = f.host();
+            float* pb = b.host();
+            const float* g = gamma.host();
+            const float* be = beta.host();
+            for (long k = 0; k < num_filters_; ++k)
+            {
+                for (long i = 0; i < filter_size; ++i)
+                    pf[k*filter_size+i] *= g[k];
+                pb[k] = pb[k]*g[k] + be[k];
+            }
+            // The scale of this layer's input doesn't change, only the filters do.
+            if (is_int8())
+            {
+                int8_filters.quantize(pf, num_filters_, filter_size, false);
+                int8_filters.dequantize(pf, false);
+            }
+        }
+
+        void fuse_activation (
+            cpu::conv_activation activation,
+            float activation_param = 0
+        )
+        {
+            fused_activation = activation;
+            fused_activation_param = activation_param;
+        }
+
+        cpu::conv_activation get_fused_activation (
+        ) const { return fused_activation; }
+
+        float get_fused_activation_param (
+        ) const { return fused_activation_param; }
+
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
             const long filt_nr = _nr!=0 ? _nr : sub.get_output().nr();
             const long filt_nc = _nc!=0 ? _nc : sub.get_output().nc();
-
-            long num_inputs = filt_nr*filt_nc*sub.get_output().k();
+            DLIB_CASSERT(sub.get_output().k()%_groups == 0 && num_filters_%_groups == 0,
+                "The number of input channels and filters of a con_ layer must be divisible by its number of groups."
+                << "\n\t input channels: " << sub.get_output().k()
+                << "\n\t num_filters:    " << num_filters_
+                << "\n\t groups:         " << _groups);
+
+            // Each filter only sees the input channels in its own group.
+            long num_inputs = filt_nr*filt_nc*sub.get_output().k()/_groups;
             long num_outputs = num_filters_;
             // allocate params for the filters and also for the filter bias values.
             params.set_size(num_inputs*num_filters_ + num_filters_);
@@ -179,7 +280,7 @@ namespace dlib
             dlib::rand rnd(std::rand());
             randomize_parameters(params, num_inputs+num_outputs, rnd);
 
-            filters = alias_tensor(num_filters_, sub.get_output().k(), filt_nr, filt_nc);
+            filters = alias_tensor(num_filters_, sub.get_output().k()/_groups, filt_nr, filt_nc);
             biases = alias_tensor(1,num_filters_);
 
             // set the initial bias values to zero
@@ -189,22 +290,49 @@ namespace dlib
         template <typename SUBNET>
         void forward(const SUBNET& sub, resizable_tensor& output)
         {
+            if (int8_calibrating)
+                int8_max_abs_input = std::max(int8_max_abs_input, max(abs(mat(sub.get_output()))));
+
+            if (is_int8())
+            {
+                cpu::int8_conv(output, sub.get_output(), int8_input_scale, int8_filters,
+                    nr(), nc(), _stride_y, _stride_x, padding_y_, padding_x_);
+                tt::add(1,output,1,biases(params,filters.size()));
+                apply_fused_activation(output);
+                return;
+            }
+
             conv.setup(sub.get_output(),
                        filters(params,0),
                        _stride_y,
                        _stride_x,
                        padding_y_,
-                       padding_x_);
+                       padding_x_,
+                       _groups);
+            // The bias (and any fused activation) is applied inside the convolution.
             conv(false, output,
                 sub.get_output(),
-                filters(params,0));
-
-            tt::add(1,output,1,biases(params,filters.size()));
+                filters(params,0),
+                biases(params,filters.size()),
+                fused_activation,
+                fused_activation_param);
         } 
 
+        template <typename SUBNET>
+        double estimate_flops(const SUBNET& sub) const
+        {
+            // One multiply and one add for each filter tap of each output value.
+            auto&& x = sub.get_output();
+            const long out_nr = 1+(x.nr()+2*padding_y_-nr())/_stride_y;
+            const long out_nc = 1+(x.nc()+2*padding_x_-nc())/_stride_x;
+            return 2.0*x.num_samples()*num_filters_*out_nr*out_nc*(x.k()/_groups)*nr()*nc();
+        }
+
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
         {
+            DLIB_CASSERT(fused_activation == cpu::conv_activation::none,
+                "A con_ layer with a fused activation can only be used for inference.");
             conv.get_gradient_for_data (true, gradient_input, filters(params,0), sub.get_gradient_input());
             // no dpoint computing the parameter gradients if they won't be used.
             if (learning_rate_multiplier != 0)
@@ -221,8 +349,23 @@ namespace dlib
 
         friend void serialize(const con_& item, std::ostream& out)
         {
-            serialize("con_4", out);
-            serialize(item.params, out);
+            if (item.is_int8())
+            {
+                // Only the int8 filters are saved, the float ones are rebuilt from them
+                // when loading.
+                serialize("con_5", out);
+                serialize(item.int8_filters, out);
+                serialize(item.int8_input_scale, out);
+                const float* b = item.params.host() + item.filters.size();
+                serialize(std::vector<float>(b, b+item.biases.size()), out);
+            }
+            else
+            {
+                // Ungrouped layers keep using the old format so older versions of dlib
+                // can still read them.
+                serialize(_groups == 1 ? "con_4" : "con_6", out);
+                serialize(item.params, out);
+            }
             serialize(item.num_filters_, out);
             serialize(_nr, out);
             serialize(_nc, out);
@@ -236,6 +379,8 @@ namespace dlib
             serialize(item.weight_decay_multiplier, out);
             serialize(item.bias_learning_rate_multiplier, out);
             serialize(item.bias_weight_decay_multiplier, out);
+            if (_groups != 1)
+                serialize(_groups, out);
         }
 
         friend void deserialize(con_& item, std::istream& in)
@@ -246,9 +391,21 @@ namespace dlib
             long nc;
             int stride_y;
             int stride_x;
-            if (version == "con_4")
+            std::vector<float> int8_biases;
+            item.int8_calibrating = false;
+            item.int8_filters.clear();
+            if (version == "con_5")
+            {
+                deserialize(item.int8_filters, in);
+                deserialize(item.int8_input_scale, in);
+                deserialize(int8_biases, in);
+            }
+            else if (version == "con_4" || version == "con_6")
             {
                 deserialize(item.params, in);
+            }
+            if (version == "con_4" || version == "con_5" || version == "con_6")
+            {
                 deserialize(item.num_filters_, in);
                 deserialize(nr, in);
                 deserialize(nc, in);
@@ -262,12 +419,25 @@ namespace dlib
                 deserialize(item.weight_decay_multiplier, in);
                 deserialize(item.bias_learning_rate_multiplier, in);
                 deserialize(item.bias_weight_decay_multiplier, in);
+                int groups = 1;
+                if (version == "con_6")
+                    deserialize(groups, in);
                 if (item.padding_y_ != _padding_y) throw serialization_error("Wrong padding_y found while deserializing dlib::con_");
                 if (item.padding_x_ != _padding_x) throw serialization_error("Wrong padding_x found while deserializing dlib::con_");
                 if (nr != _nr) throw serialization_error("Wrong nr found while deserializing dlib::con_");
                 if (nc != _nc) throw serialization_error("Wrong nc found while deserializing dlib::con_");
                 if (stride_y != _stride_y) throw serialization_error("Wrong stride_y found while deserializing dlib::con_");
                 if (stride_x != _stride_x) throw serialization_error("Wrong stride_x found while deserializing dlib::con_");
+                if (groups != _groups) throw serialization_error("Wrong groups found while deserializing dlib::con_");
+                if (version == "con_5")
+                {
+                    if (item.int8_filters.num_outputs()*item.int8_filters.num_inputs() != (long)item.filters.size() ||
+                        int8_biases.size() != item.biases.size())
+                        throw serialization_error("Corrupt int8 filters found while deserializing dlib::con_");
+                    item.params.set_size(item.filters.size() + item.biases.size());
+                    item.int8_filters.dequantize(item.params.host(), false);
+                    std::copy(int8_biases.begin(), int8_biases.end(), item.params.host()+item.filters.size());
+                }
             }
             else
             {
@@ -285,12 +455,16 @@ namespace dlib
                 << ", stride_y="<<_stride_y
                 << ", stride_x="<<_stride_x
                 << ", padding_y="<<item.padding_y_
-                << ", padding_x="<<item.padding_x_
-                << ")";
+                << ", padding_x="<<item.padding_x_;
+            if (_groups != 1)
+                out << ", groups="<<_groups;
+            out << ")";
             out << " learning_rate_mult="<<item.learning_rate_multiplier;
             out << " weight_decay_mult="<<item.weight_decay_multiplier;
             out << " bias_learning_rate_mult="<<item.bias_learning_rate_multiplier;
             out << " bias_weight_decay_mult="<<item.bias_weight_decay_multiplier;
+            if (item.is_int8())
+                out << " int8";
             return out;
         }
 
@@ -303,8 +477,10 @@ namespace dlib
                 << " stride_y='"<<_stride_y<<"'"
                 << " stride_x='"<<_stride_x<<"'"
                 << " padding_y='"<<item.padding_y_<<"'"
-                << " padding_x='"<<item.padding_x_<<"'"
-                << " learning_rate_mult='"<<item.learning_rate_multiplier<<"'"
+                << " padding_x='"<<item.padding_x_<<"'";
+            if (_groups != 1)
+                out << " groups='"<<_groups<<"'";
+            out << " learning_rate_mult='"<<item.learning_rate_multiplier<<"'"
                 << " weight_decay_mult='"<<item.weight_decay_multiplier<<"'"
                 << " bias_learning_rate_mult='"<<item.bias_learning_rate_multiplier<<"'"
                 << " bias_weight_decay_mult='"<<item.bias_weight_decay_multiplier<<"'>\n";
@@ -314,6 +490,30 @@ namespace dlib
 
     private:
 
+        void apply_fused_activation (
+            tensor& output
+        ) const
+        {
+            switch (fused_activation)
+            {
+                case cpu::conv_activation::none:
+                    break;
+                case cpu::conv_activation::relu:
+                    tt::relu(output, output);
+                    break;
+                case cpu::conv_activation::prelu:
+                    {
+                        resizable_tensor p(1);
+                        p = fused_activation_param;
+                        tt::prelu(output, output, p);
+                    }
+                    break;
+                case cpu::conv_activation::leaky_relu:
+                    tt::leaky_relu(output, output, fused_activation_param);
+                    break;
+            }
+        }
+
         resizable_tensor params;
         alias_tensor filters, biases;
 
@@ -329,6 +529,17 @@ namespace dlib
         int padding_y_;
         int padding_x_;
 
+        // State for int8 inference.  See begin_int8_calibration() and
+        // end_int8_calibration().
+        bool int8_calibrating = false;
+        float int8_max_abs_input = 0;
+        float int8_input_scale = 0;
+        cpu::int8_weights int8_filters;
+
+        // Activation applied in the convolution's epilogue, set by fuse_layers().  It
+        // isn't serialized since the activation layer it replaces still is.
+        cpu::conv_activation fused_activation = cpu::conv_activation::none;
+        float fused_activation_param = 0;
     };
 
     template <
@@ -341,6 +552,28 @@ namespace dlib
         >
     using con = add_layer<con_<num_filters,nr,nc,stride_y,stride_x>, SUBNET>;
 
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        int groups,
+        typename SUBNET
+        >
+    using grouped_con = add_layer<con_<num_filters,nr,nc,stride_y,stride_x,
+        stride_y!=1? 0 : nr/2, stride_x!=1? 0 : nc/2, groups>, SUBNET>;
+
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        typename SUBNET
+        >
+    using depthwise_con = grouped_con<num_filters,nr,nc,stride_y,stride_x,num_filters,SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -350,13 +583,15 @@ namespace dlib
         int _stride_y,
         int _stride_x,
         int _padding_y = _stride_y!=1? 0 : _nr/2,
-        int _padding_x = _stride_x!=1? 0 : _nc/2
+        int _padding_x = _stride_x!=1? 0 : _nc/2,
+        int _groups = 1
         >
     class cont_
     {
     public:
 
         static_assert(_num_filters > 0, "The number of filters must be > 0");
+        static_assert(_groups > 0, "The number of groups must be > 0");
         static_assert(_nr > 0, "The number of rows in a filter must be > 0");
         static_assert(_nc > 0, "The number of columns in a filter must be > 0");
         static_assert(_stride_y > 0, "The filter stride must be > 0");
@@ -387,6 +622,7 @@ namespace dlib
         long stride_x() const { return _stride_x; }
         long padding_y() const { return padding_y_; }
         long padding_x() const { return padding_x_; }
+        long groups() const { return _groups; }
 
         void set_num_filters(long num)
         {
@@ -470,7 +706,14 @@ namespace dlib
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
-            long num_inputs = _nr*_nc*sub.get_output().k();
+            DLIB_CASSERT(sub.get_output().k()%_groups == 0 && num_filters_%_groups == 0,
+                "The number of input channels and filters of a cont_ layer must be divisible by its number of groups."
+                << "\n\t input channels: " << sub.get_output().k()
+                << "\n\t num_filters:    " << num_filters_
+                << "\n\t groups:         " << _groups);
+
+            // Each output channel only sees the input channels in its own group.
+            long num_inputs = _nr*_nc*sub.get_output().k()/_groups;
             long num_outputs = num_filters_;
             // allocate params for the filters and also for the filter bias values.
             params.set_size(num_inputs*num_filters_ + num_filters_);
@@ -478,7 +721,7 @@ namespace dlib
             dlib::rand rnd(std::rand());
             randomize_parameters(params, num_inputs+num_outputs, rnd);
 
-            filters = alias_tensor(sub.get_output().k(), num_filters_, _nr, _nc);
+            filters = alias_tensor(sub.get_output().k(), num_filters_/_groups, _nr, _nc);
             biases = alias_tensor(1,num_filters_);
 
             // set the initial bias values to zero
@@ -492,13 +735,20 @@ namespace dlib
             unsigned int gnr = _stride_y * (sub.get_output().nr() - 1) + filt.nr() - 2 * padding_y_;
             unsigned int gnc = _stride_x * (sub.get_output().nc() - 1) + filt.nc() - 2 * padding_x_;
             unsigned int gnsamps = sub.get_output().num_samples();
-            unsigned int gk = filt.k();
+            unsigned int gk = filt.k()*_groups;
             output.set_size(gnsamps,gk,gnr,gnc);
-            conv.setup(output,filt,_stride_y,_stride_x,padding_y_,padding_x_);
+            conv.setup(output,filt,_stride_y,_stride_x,padding_y_,padding_x_,_groups);
             conv.get_gradient_for_data(false, sub.get_output(),filt,output);            
             tt::add(1,output,1,biases(params,filters.size()));
         } 
 
+        template <typename SUBNET>
+        double estimate_flops(const SUBNET& sub) const
+        {
+            // Each input value is multiplied into every filter tap and accumulated.
+            return 2.0*sub.get_output().size()*(num_filters_/_groups)*nr()*nc();
+        }
+
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
         {
@@ -519,7 +769,9 @@ namespace dlib
 
         friend void serialize(const cont_& item, std::ostream& out)
         {
-            serialize("cont_1", out);
+            // Ungrouped layers keep using the old format so older versions of dlib can
+            // still read them.
+            serialize(_groups == 1 ? "cont_1" : "cont_2", out);
             serialize(item.params, out);
             serialize(item.num_filters_, out);
             serialize(_nr, out);
@@ -534,6 +786,8 @@ namespace dlib
             serialize(item.weight_decay_multiplier, out);
             serialize(item.bias_learning_rate_multiplier, out);
             serialize(item.bias_weight_decay_multiplier, out);
+            if (_groups != 1)
+                serialize(_groups, out);
         }
 
         friend void deserialize(cont_& item, std::istream& in)
@@ -544,7 +798,7 @@ namespace dlib
             long nc;
             int stride_y;
             int stride_x;
-            if (version == "cont_1")
+            if (version == "cont_1" || version == "cont_2")
             {
                 deserialize(item.params, in);
                 deserialize(item.num_filters_, in);
@@ -560,12 +814,16 @@ namespace dlib
                 deserialize(item.weight_decay_multiplier, in);
                 deserialize(item.bias_learning_rate_multiplier, in);
                 deserialize(item.bias_weight_decay_multiplier, in);
+                int groups = 1;
+                if (version == "cont_2")
+                    deserialize(groups, in);
                 if (item.padding_y_ != _padding_y) throw serialization_error("Wrong padding_y found while deserializing dlib::con_");
                 if (item.padding_x_ != _padding_x) throw serialization_error("Wrong padding_x found while deserializing dlib::con_");
                 if (nr != _nr) throw serialization_error("Wrong nr found while deserializing dlib::con_");
                 if (nc != _nc) throw serialization_error("Wrong nc found while deserializing dlib::con_");
                 if (stride_y != _stride_y) throw serialization_error("Wrong stride_y found while deserializing dlib::con_");
                 if (stride_x != _stride_x) throw serialization_error("Wrong stride_x found while deserializing dlib::con_");
+                if (groups != _groups) throw serialization_error("Wrong groups found while deserializing dlib::cont_");
             }
             else
             {
@@ -583,8 +841,10 @@ namespace dlib
                 << ", stride_y="<<_stride_y
                 << ", stride_x="<<_stride_x
                 << ", padding_y="<<item.padding_y_
-                << ", padding_x="<<item.padding_x_
-                << ")";
+                << ", padding_x="<<item.padding_x_;
+            if (_groups != 1)
+                out << ", groups="<<_groups;
+            out << ")";
             out << " learning_rate_mult="<<item.learning_rate_multiplier;
             out << " weight_decay_mult="<<item.weight_decay_multiplier;
             out << " bias_learning_rate_mult="<<item.bias_learning_rate_multiplier;
@@ -601,8 +861,10 @@ namespace dlib
                 << " stride_y='"<<_stride_y<<"'"
                 << " stride_x='"<<_stride_x<<"'"
                 << " padding_y='"<<item.padding_y_<<"'"
-                << " padding_x='"<<item.padding_x_<<"'"
-                << " learning_rate_mult='"<<item.learning_rate_multiplier<<"'"
+                << " padding_x='"<<item.padding_x_<<"'";
+            if (_groups != 1)
+                out << " groups='"<<_groups<<"'";
+            out << " learning_rate_mult='"<<item.learning_rate_multiplier<<"'"
                 << " weight_decay_mult='"<<item.weight_decay_multiplier<<"'"
                 << " bias_learning_rate_mult='"<<item.bias_learning_rate_multiplier<<"'"
                 << " bias_weight_decay_mult='"<<item.bias_weight_decay_multiplier<<"'>\n";
@@ -637,6 +899,28 @@ namespace dlib
         >
     using cont = add_layer<cont_<num_filters,nr,nc,stride_y,stride_x>, SUBNET>;
 
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        int groups,
+        typename SUBNET
+        >
+    using grouped_cont = add_layer<cont_<num_filters,nr,nc,stride_y,stride_x,
+        stride_y!=1? 0 : nr/2, stride_x!=1? 0 : nc/2, groups>, SUBNET>;
+
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        typename SUBNET
+        >
+    using depthwise_cont = grouped_cont<num_filters,nr,nc,stride_y,stride_x,num_filters,SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -1593,6 +1877,72 @@ namespace dlib
         fc_bias_mode get_bias_mode (
         ) const { return bias_mode; }
 
+        void begin_int8_calibration (
+        )
+        {
+            int8_calibrating = true;
+            int8_max_abs_input = 0;
+        }
+
+        void end_int8_calibration (
+        )
+        {
+            DLIB_CASSERT(int8_calibrating, "You must call begin_int8_calibration() first.");
+            DLIB_CASSERT(get_layer_params().size() != 0, "You must run data through the network during calibration.");
+            int8_calibrating = false;
+            int8_input_scale = int8_max_abs_input != 0 ? int8_max_abs_input/127 : 1;
+            auto w = weights(params,0);
+            int8_weights.quantize(w.host(), num_outputs, num_inputs, true);
+            // Keep the float weights identical to what the int8 weights represent so that
+            // a network loaded from disk behaves exactly like the one that was saved.
+            int8_weights.dequantize(w.host(), true);
+        }
+
+        void disable_int8 (
+        )
+        {
+            int8_calibrating = false;
+            int8_weights.clear();
+        }
+
+        bool is_int8 (
+        ) const { return !int8_weights.empty(); }
+
+        float get_int8_input_scale (
+        ) const { return int8_input_scale; }
+
+        void fold_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        )
+        {
+            DLIB_CASSERT(get_layer_params().size() != 0);
+            DLIB_CASSERT(gamma.size() == num_outputs && beta.size() == num_outputs);
+            DLIB_CASSERT(bias_mode == FC_HAS_BIAS || max(abs(mat(beta))) == 0,
+                "Only an affine transform without a shift can be folded into a fc_ layer without biases.");
+            auto w = weights(params,0);
+            float* pw = w.host();
+            const float* g = gamma.host();
+            const float* be = beta.host();
+            for (unsigned long i = 0; i < num_inputs; ++i)
+            {
+                for (unsigned long o = 0; o < num_outputs; ++o)
+                    pw[i*num_outputs+o] *= g[o];
+            }
+            if (bias_mode == FC_HAS_BIAS)
+            {
+                float* pb = params.host() + weights.size();
+                for (unsigned long o = 0; o < num_outputs; ++o)
+                    pb[o] = pb[o]*g[o] + be[o];
+            }
+            // The scale of this layer's input doesn't change, only the weights do.
+            if (is_int8())
+            {
+                int8_weights.quantize(pw, num_outputs, num_inputs, true);
+                int8_weights.dequantize(pw, true);
+            }
+        }
+
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
@@ -1620,10 +1970,19 @@ namespace dlib
         {
             DLIB_CASSERT((long)num_inputs == sub.get_output().nr()*sub.get_output().nc()*sub.get_output().k(),
                 "The size of the input tensor to this fc layer doesn't match the size the fc layer was trained with.");
-            output.set_size(sub.get_output().num_samples(), num_outputs);
+            if (int8_calibrating)
+                int8_max_abs_input = std::max(int8_max_abs_input, max(abs(mat(sub.get_output()))));
 
-            auto w = weights(params, 0);
-            tt::gemm(0,output, 1,sub.get_output(),false, w,false);
+            if (is_int8())
+            {
+                cpu::int8_fc(output, sub.get_output(), int8_input_scale, int8_weights);
+            }
+            else
+            {
+                output.set_size(sub.get_output().num_samples(), num_outputs);
+                auto w = weights(params, 0);
+                tt::gemm(0,output, 1,sub.get_output(),false, w,false);
+            }
             if (bias_mode == FC_HAS_BIAS)
             {
                 auto b = biases(params, weights.size());
@@ -1631,6 +1990,12 @@ namespace dlib
             }
         } 
 
+        template <typename SUBNET>
+        double estimate_flops(const SUBNET& sub) const
+        {
+            return 2.0*sub.get_output().size()*num_outputs;
+        }
+
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
         {
@@ -1683,10 +2048,25 @@ namespace dlib
 
         friend void serialize(const fc_& item, std::ostream& out)
         {
-            serialize("fc_2", out);
-            serialize(item.num_outputs, out);
-            serialize(item.num_inputs, out);
-            serialize(item.params, out);
+            if (item.is_int8())
+            {
+                // Only the int8 weights are saved, the float ones are rebuilt from them
+                // when loading.
+                serialize("fc_3", out);
+                serialize(item.num_outputs, out);
+                serialize(item.num_inputs, out);
+                serialize(item.int8_weights, out);
+                serialize(item.int8_input_scale, out);
+                const float* b = item.params.host() + item.weights.size();
+                serialize(std::vector<float>(b, b+(bias_mode==FC_HAS_BIAS ? item.num_outputs : 0)), out);
+            }
+            else
+            {
+                serialize("fc_2", out);
+                serialize(item.num_outputs, out);
+                serialize(item.num_inputs, out);
+                serialize(item.params, out);
+            }
             serialize(item.weights, out);
             serialize(item.biases, out);
             serialize((int)bias_mode, out);
@@ -1700,12 +2080,24 @@ namespace dlib
         {
             std::string version;
             deserialize(version, in);
-            if (version != "fc_2")
+            if (version != "fc_2" && version != "fc_3")
                 throw serialization_error("Unexpected version '"+version+"' found while deserializing dlib::fc_.");
 
+            std::vector<float> int8_biases;
+            item.int8_calibrating = false;
+            item.int8_weights.clear();
             deserialize(item.num_outputs, in);
             deserialize(item.num_inputs, in);
-            deserialize(item.params, in);
+            if (version == "fc_3")
+            {
+                deserialize(item.int8_weights, in);
+                deserialize(item.int8_input_scale, in);
+                deserialize(int8_biases, in);
+            }
+            else
+            {
+                deserialize(item.params, in);
+            }
             deserialize(item.weights, in);
             deserialize(item.biases, in);
             int bmode = 0;
@@ -1715,6 +2107,16 @@ namespace dlib
             deserialize(item.weight_decay_multiplier, in);
             deserialize(item.bias_learning_rate_multiplier, in);
             deserialize(item.bias_weight_decay_multiplier, in);
+            if (version == "fc_3")
+            {
+                if (item.int8_weights.num_outputs() != (long)item.num_outputs ||
+                    item.int8_weights.num_inputs() != (long)item.num_inputs ||
+                    int8_biases.size() != (bias_mode==FC_HAS_BIAS ? item.num_outputs : 0))
+                    throw serialization_error("Corrupt int8 weights found while deserializing dlib::fc_");
+                item.params.set_size(item.num_inputs + (bias_mode==FC_HAS_BIAS ? 1 : 0), item.num_outputs);
+                item.int8_weights.dequantize(item.params.host(), true);
+                std::copy(int8_biases.begin(), int8_biases.end(), item.params.host()+item.weights.size());
+            }
         }
 
         friend std::ostream& operator<<(std::ostream& out, const fc_& item)
@@ -1737,6 +2139,8 @@ namespace dlib
                 out << " learning_rate_mult="<<item.learning_rate_multiplier;
                 out << " weight_decay_mult="<<item.weight_decay_multiplier;
             }
+            if (item.is_int8())
+                out << " int8";
             return out;
         }
 
@@ -1776,6 +2180,13 @@ namespace dlib
         double weight_decay_multiplier;
         double bias_learning_rate_multiplier;
         double bias_weight_decay_multiplier;
+
+        // State for int8 inference.  See begin_int8_calibration() and
+        // end_int8_calibration().
+        bool int8_calibrating = false;
+        float int8_max_abs_input = 0;
+        float int8_input_scale = 0;
+        cpu::int8_weights int8_weights;
     };
 
     template <
@@ -1790,6 +2201,307 @@ namespace dlib
         >
     using fc_no_bias = add_layer<fc_<num_outputs,FC_NO_BIAS>, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        unsigned long num_outputs_
+        >
+    class fc_sampled_
+    {
+        static_assert(num_outputs_ > 0, "The number of outputs from a fc_sampled_ layer must be > 0");
+
+    public:
+        fc_sampled_(
+        ) : num_inputs(0),
+            num_sampled(1024),
+            learning_rate_multiplier(1),
+            weight_decay_multiplier(1),
+            rnd(std::rand())
+        {}
+
+        double get_learning_rate_multiplier () const  { return learning_rate_multiplier; }
+        double get_weight_decay_multiplier () const   { return weight_decay_multiplier; }
+        void set_learning_rate_multiplier(double val) { learning_rate_multiplier = val; }
+        void set_weight_decay_multiplier(double val)  { weight_decay_multiplier  = val; }
+
+        unsigned long get_num_outputs (
+        ) const { return num_outputs_; }
+
+        unsigned long get_num_sampled (
+        ) const { return num_sampled; }
+
+        void set_num_sampled (
+            unsigned long num
+        ) { num_sampled = num; }
+
+        template <typename label_iterator>
+        void select_outputs (
+            label_iterator begin,
+            label_iterator end
+        )
+        {
+            pending.clear();
+            is_pending.resize(num_outputs_, false);
+            for (; begin != end; ++begin)
+            {
+                const unsigned long label = *begin;
+                DLIB_CASSERT(label < num_outputs_, "label: " << label << ", num_outputs: " << num_outputs_);
+                if (!is_pending[label])
+                {
+                    is_pending[label] = true;
+                    pending.push_back(label);
+                }
+            }
+
+            const unsigned long num_others = num_outputs_ - pending.size();
+            const unsigned long num_negatives = std::min(num_sampled, num_others);
+            if (2*num_negatives <= num_others)
+            {
+                // Most outputs aren't picked, so guessing finds a new one quickly.
+                while (pending.size() < num_negatives + (num_outputs_-num_others))
+                {
+                    const unsigned long o = rnd.get_integer(num_outputs_);
+                    if (!is_pending[o])
+                    {
+                        is_pending[o] = true;
+                        pending.push_back(o);
+                    }
+                }
+            }
+            else
+            {
+                // Otherwise take a random subset of the outputs that weren't picked.
+                std::vector<unsigned long> others;
+                others.reserve(num_others);
+                for (unsigned long o = 0; o < num_outputs_; ++o)
+                {
+                    if (!is_pending[o])
+                        others.push_back(o);
+                }
+                for (unsigned long i = 0; i < num_negatives; ++i)
+                {
+                    std::swap(others[i], others[i + rnd.get_integer(others.size()-i)]);
+                    pending.push_back(others[i]);
+                }
+            }
+
+            for (auto o : pending)
+                is_pending[o] = false;
+        }
+
+        const std::vector<unsigned long>& get_selected_outputs (
+        ) const { return selected; }
+
+        template <typename SUBNET>
+        void setup (const SUBNET& sub)
+        {
+            num_inputs = sub.get_output().nr()*sub.get_output().nc()*sub.get_output().k();
+            params.set_size(num_inputs+1, num_outputs_);
+
+            dlib::rand rnd(std::rand());
+            randomize_parameters(params, num_inputs+num_outputs_, rnd);
+
+            weights = alias_tensor(num_inputs, num_outputs_);
+            biases = alias_tensor(1,num_outputs_);
+            // set the initial bias values to zero
+            biases(params,weights.size()) = 0;
+        }
+
+        template <typename SUBNET>
+        void forward(const SUBNET& sub, resizable_tensor& output)
+        {
+            DLIB_CASSERT((long)num_inputs == sub.get_output().nr()*sub.get_output().nc()*sub.get_output().k(),
+                "The size of the input tensor to this fc_sampled layer doesn't match the size it was trained with.");
+
+            // The outputs picked by select_outputs() are only used for one forward pass.
+            selected.swap(pending);
+            pending.clear();
+
+            if (selected.empty())
+            {
+                output.set_size(sub.get_output().num_samples(), num_outputs_);
+                auto w = weights(params, 0);
+                tt::gemm(0,output, 1,sub.get_output(),false, w,false);
+                auto b = biases(params, weights.size());
+                tt::add(1,output,1,b);
+                return;
+            }
+
+            // Gather the columns of the weight matrix, and the biases below them, for the
+            // selected outputs into a smaller matrix and only multiply with that.
+            const unsigned long num_selected = selected.size();
+            selected_params.set_size(num_inputs+1, num_selected);
+            const float* p = params.host();
+            float* sp = selected_params.host();
+            for (unsigned long r = 0; r < num_inputs+1; ++r)
+            {
+                for (unsigned long j = 0; j < num_selected; ++j)
+                    sp[r*num_selected+j] = p[r*num_outputs_+selected[j]];
+            }
+
+            output.set_size(sub.get_output().num_samples(), num_selected);
+            auto w = alias_tensor(num_inputs, num_selected)(selected_params, 0);
+            tt::gemm(0,output, 1,sub.get_output(),false, w,false);
+            auto b = alias_tensor(1, num_selected)(selected_params, num_inputs*num_selected);
+            tt::add(1,output,1,b);
+        } 
+
+        template <typename SUBNET>
+        double estimate_flops(const SUBNET& sub) const
+        {
+            return 2.0*sub.get_output().size()*(selected.empty() ? num_outputs_ : selected.size());
+        }
+
+        template <typename SUBNET>
+        void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
+        {
+            if (selected.empty())
+            {
+                if (learning_rate_multiplier != 0)
+                {
+                    auto pw = weights(params_grad, 0);
+                    tt::gemm(0,pw, 1,sub.get_output(),true, gradient_input,false);
+                    auto pb = biases(params_grad, weights.size());
+                    tt::assign_bias_gradient(pb, gradient_input);
+                }
+                auto w = weights(params, 0);
+                tt::gemm(1,sub.get_gradient_input(), 1,gradient_input,false, w,true);
+                return;
+            }
+
+            const unsigned long num_selected = selected.size();
+            alias_tensor selected_weights(num_inputs, num_selected);
+            if (learning_rate_multiplier != 0)
+            {
+                selected_params_grad.copy_size(selected_params);
+                auto pw = selected_weights(selected_params_grad, 0);
+                tt::gemm(0,pw, 1,sub.get_output(),true, gradient_input,false);
+                auto pb = alias_tensor(1, num_selected)(selected_params_grad, selected_weights.size());
+                tt::assign_bias_gradient(pb, gradient_input);
+
+                // The outputs that weren't computed get a gradient of 0.
+                params_grad = 0;
+                float* g = params_grad.host();
+                const float* sg = selected_params_grad.host();
+                for (unsigned long r = 0; r < num_inputs+1; ++r)
+                {
+                    for (unsigned long j = 0; j < num_selected; ++j)
+                        g[r*num_outputs_+selected[j]] = sg[r*num_selected+j];
+                }
+            }
+
+            auto w = selected_weights(selected_params, 0);
+            tt::gemm(1,sub.get_gradient_input(), 1,gradient_input,false, w,true);
+        }
+
+        alias_tensor_instance get_weights()
+        {
+            return weights(params, 0);
+        }
+
+        alias_tensor_const_instance get_weights() const
+        {
+            return weights(params, 0);
+        }
+
+        alias_tensor_instance get_biases()
+        {
+            return biases(params, weights.size());
+        }
+
+        alias_tensor_const_instance get_biases() const
+        {
+            return biases(params, weights.size());
+        }
+
+        const tensor& get_layer_params() const { return params; }
+        tensor& get_layer_params() { return params; }
+
+        friend void serialize(const fc_sampled_& item, std::ostream& out)
+        {
+            serialize("fc_sampled_", out);
+            serialize(num_outputs_, out);
+            serialize(item.num_inputs, out);
+            serialize(item.num_sampled, out);
+            serialize(item.params, out);
+            serialize(item.weights, out);
+            serialize(item.biases, out);
+            serialize(item.learning_rate_multiplier, out);
+            serialize(item.weight_decay_multiplier, out);
+        }
+
+        friend void deserialize(fc_sampled_& item, std::istream& in)
+        {
+            std::string version;
+            deserialize(version, in);
+            if (version != "fc_sampled_")
+                throw serialization_error("Unexpected version '"+version+"' found while deserializing dlib::fc_sampled_.");
+
+            unsigned long num_outputs;
+            deserialize(num_outputs, in);
+            if (num_outputs != num_outputs_)
+                throw serialization_error("Wrong num_outputs found while deserializing dlib::fc_sampled_");
+            deserialize(item.num_inputs, in);
+            deserialize(item.num_sampled, in);
+            deserialize(item.params, in);
+            deserialize(item.weights, in);
+            deserialize(item.biases, in);
+            deserialize(item.learning_rate_multiplier, in);
+            deserialize(item.weight_decay_multiplier, in);
+            item.pending.clear();
+            item.selected.clear();
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const fc_sampled_& item)
+        {
+            out << "fc_sampled ("
+                << "num_outputs="<<num_outputs_
+                << ", num_sampled="<<item.num_sampled
+                << ")";
+            out << " learning_rate_mult="<<item.learning_rate_multiplier;
+            out << " weight_decay_mult="<<item.weight_decay_multiplier;
+            return out;
+        }
+
+        friend void to_xml(const fc_sampled_& item, std::ostream& out)
+        {
+            out << "<fc_sampled"
+                << " num_outputs='"<<num_outputs_<<"'"
+                << " num_sampled='"<<item.num_sampled<<"'"
+                << " learning_rate_mult='"<<item.learning_rate_multiplier<<"'"
+                << " weight_decay_mult='"<<item.weight_decay_multiplier<<"'";
+            out << ">\n";
+            out << mat(item.params);
+            out << "</fc_sampled>\n";
+        }
+
+    private:
+
+        unsigned long num_inputs;
+        unsigned long num_sampled;
+        resizable_tensor params;
+        alias_tensor weights, biases;
+        double learning_rate_multiplier;
+        double weight_decay_multiplier;
+
+        // The outputs picked by select_outputs() for the next forward pass, and the ones
+        // the last forward pass computed.  Empty means all of them.
+        std::vector<unsigned long> pending;
+        std::vector<unsigned long> selected;
+        std::vector<bool> is_pending;
+        dlib::rand rnd;
+
+        // The columns of params for the selected outputs and their gradient.
+        resizable_tensor selected_params;
+        resizable_tensor selected_params_grad;
+    };
+
+    template <
+        unsigned long num_outputs,
+        typename SUBNET
+        >
+    using fc_sampled = add_layer<fc_sampled_<num_outputs>, SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     class dropout_
@@ -2045,6 +2757,20 @@ namespace dlib
 
         layer_mode get_mode() const { return mode; }
 
+        alias_tensor_const_instance get_gamma() const { return gamma(params,0); }
+        alias_tensor_const_instance get_beta() const { return beta(params,gamma.size()); }
+
+        void disable(
+        )
+        {
+            gamma(params,0) = 1;
+            beta(params,gamma.size()) = 0;
+            disabled = true;
+        }
+
+        bool is_disabled(
+        ) const { return disabled; }
+
         inline dpoint map_input_to_output (const dpoint& p) const { return p; }
         inline dpoint map_output_to_input (const dpoint& p) const { return p; }
 
@@ -2072,6 +2798,12 @@ namespace dlib
 
         void forward_inplace(const tensor& input, tensor& output)
         {
+            if (disabled)
+            {
+                if (!is_same_object(input, output))
+                    memcpy(output, input);
+                return;
+            }
             auto g = gamma(params,0);
             auto b = beta(params,gamma.size());
             if (mode == FC_MODE)
@@ -2089,6 +2821,7 @@ namespace dlib
             auto g = gamma(params,0);
             auto b = beta(params,gamma.size());
 
+            // Note that a disabled affine_ has g == 1, so this is still correct for it.
             // We are computing the gradient of dot(gradient_input, computed_output*g + b)
             if (mode == FC_MODE)
             {
@@ -2145,6 +2878,7 @@ namespace dlib
 
             if (version != "affine_")
                 throw serialization_error("Unexpected version '"+version+"' found while deserializing dlib::affine_.");
+            item.disabled = false;
             deserialize(item.params, in);
             deserialize(item.gamma, in);
             deserialize(item.beta, in);
@@ -2178,6 +2912,7 @@ namespace dlib
         resizable_tensor params, empty_params; 
         alias_tensor gamma, beta;
         layer_mode mode;
+        bool disabled = false;
     };
 
     template <typename SUBNET>
@@ -2214,6 +2949,17 @@ namespace dlib
             tt::add(output, t1, t2);
         }
 
+        template <typename SUBNET>
+        bool can_overwrite_input(const SUBNET& sub) const
+        {
+            // The output is computed pointwise so it can be written over t1, as long as
+            // it doesn't need to be bigger than t1.
+            auto&& t1 = sub.get_output();
+            auto&& t2 = layer<tag>(sub).get_output();
+            return t2.num_samples() <= t1.num_samples() && t2.k() <= t1.k() &&
+                   t2.nr() <= t1.nr() && t2.nc() <= t1.nc();
+        }
+
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& /*params_grad*/)
         {
@@ -2315,6 +3061,17 @@ namespace dlib
             tt::multiply_zero_padded(false, output, t1, t2);
         }
 
+        template <typename SUBNET>
+        bool can_overwrite_input(const SUBNET& sub) const
+        {
+            // The output is computed pointwise so it can be written over t1, as long as
+            // it doesn't need to be bigger than t1.
+            auto&& t1 = sub.get_output();
+            auto&& t2 = layer<tag>(sub).get_output();
+            return t2.num_samples() <= t1.num_samples() && t2.k() <= t1.k() &&
+                   t2.nr() <= t1.nr() && t2.nc() <= t1.nc();
+        }
+
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& /*params_grad*/)
         {
@@ -2620,8 +3377,20 @@ namespace dlib
         {
         }
 
+        void disable(
+        ) { disabled = true; }
+
+        bool is_disabled(
+        ) const { return disabled; }
+
         void forward_inplace(const tensor& input, tensor& output)
         {
+            if (disabled)
+            {
+                if (!is_same_object(input, output))
+                    memcpy(output, input);
+                return;
+            }
             tt::relu(output, input);
         } 
 
@@ -2632,6 +3401,8 @@ namespace dlib
             tensor& 
         )
         {
+            // A disabled relu_ sits on top of a layer that already applied the relu, so
+            // the normal gradient is still the right one.
             tt::relu_gradient(data_grad, computed_output, gradient_input);
         }
 
@@ -2667,6 +3438,7 @@ namespace dlib
 
     private:
         resizable_tensor params;
+        bool disabled = false;
     };
 
 
@@ -2694,6 +3466,12 @@ namespace dlib
             params = initial_param_value;
         }
 
+        void disable(
+        ) { disabled = true; }
+
+        bool is_disabled(
+        ) const { return disabled; }
+
         template <typename SUBNET>
         void forward(
             const SUBNET& sub, 
@@ -2701,7 +3479,10 @@ namespace dlib
         )
         {
             data_output.copy_size(sub.get_output());
-            tt::prelu(data_output, sub.get_output(), params);
+            if (disabled)
+                memcpy(data_output, sub.get_output());
+            else
+                tt::prelu(data_output, sub.get_output(), params);
         }
 
         template <typename SUBNET>
@@ -2711,6 +3492,7 @@ namespace dlib
             tensor& params_grad
         )
         {
+            DLIB_CASSERT(!disabled, "A prelu_ fused into the layer below it can only be used for inference.");
             tt::prelu_gradient(sub.get_gradient_input(), sub.get_output(), 
                 gradient_input, params, params_grad);
         }
@@ -2756,6 +3538,7 @@ namespace dlib
     private:
         resizable_tensor params;
         float initial_param_value;
+        bool disabled = false;
     };
 
     template <typename SUBNET>
@@ -2781,8 +3564,20 @@ namespace dlib
         {
         }
 
+        void disable(
+        ) { disabled = true; }
+
+        bool is_disabled(
+        ) const { return disabled; }
+
         void forward_inplace(const tensor& input, tensor& output)
         {
+            if (disabled)
+            {
+                if (!is_same_object(input, output))
+                    memcpy(output, input);
+                return;
+            }
             tt::leaky_relu(output, input, alpha);
         }
 
@@ -2793,6 +3588,8 @@ namespace dlib
             tensor&
         )
         {
+            // A disabled leaky_relu_ sits on top of a layer that already applied it, so
+            // the normal gradient is still the right one.
             tt::leaky_relu_gradient(data_grad, computed_output, gradient_input, alpha);
         }
 
@@ -2834,6 +3631,7 @@ namespace dlib
     private:
         resizable_tensor params;
         float alpha;
+        bool disabled = false;
     };
 
     template <typename SUBNET>
@@ -3508,14 +4306,23 @@ namespace dlib
         }
 
         template <typename SUBNET>
-        void forward(const SUBNET& sub, resizable_tensor& output)
+        bool forward_as_view(const SUBNET& sub, alias_tensor& view, size_t& offset)
         {
-            if (aout.num_samples() != sub.get_output().num_samples())
-            {
-                aout = alias_tensor(sub.get_output().num_samples(), _k*_nr*_nc);
-                ain = alias_tensor(sub.get_output().num_samples(),  sub.get_output().size()/sub.get_output().num_samples());
-            }
+            update_aliases(sub);
+            // The extracted values are contiguous in the input, so no copy is needed,
+            // when there is only one sample or when each sample is extracted whole.
+            const long n = sub.get_output().num_samples();
+            if (n != 1 && !(_offset == 0 && (long)sub.get_output().size() == n*_k*_nr*_nc))
+                return false;
+            view = alias_tensor(n, _k, _nr, _nc);
+            offset = _offset;
+            return true;
+        }
 
+        template <typename SUBNET>
+        void forward(const SUBNET& sub, resizable_tensor& output)
+        {
+            update_aliases(sub);
             output.set_size(sub.get_output().num_samples(), _k, _nr, _nc);
             auto out = aout(output,0);
             auto in = ain(sub.get_output(),0);
@@ -3585,6 +4392,16 @@ namespace dlib
             out << "/>\n";
         }
     private:
+        template <typename SUBNET>
+        void update_aliases(const SUBNET& sub)
+        {
+            if (aout.num_samples() != sub.get_output().num_samples())
+            {
+                aout = alias_tensor(sub.get_output().num_samples(), _k*_nr*_nc);
+                ain = alias_tensor(sub.get_output().num_samples(),  sub.get_output().size()/sub.get_output().num_samples());
+            }
+        }
+
         alias_tensor aout, ain;
 
         resizable_tensor params; // unused
@@ -3599,6 +4416,129 @@ namespace dlib
         >
     using extract = add_layer<extract_<offset,k,nr,nc>, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class visitor_fuse_layers
+        {
+        public:
+            /*!
+                visit_layers() goes from the output of the network towards its input, so
+                this is run twice.  The first pass folds affine_ layers into the con_ or
+                fc_ below them.  The second fuses activations into con_ layers, looking
+                through any affine_ layers the first pass disabled.
+            !*/
+
+            visitor_fuse_layers(bool fold_affine_) : fold_affine(fold_affine_) {}
+
+            template <typename input_layer_type>
+            void operator()(size_t , input_layer_type& ) const
+            {
+                // ignore other layers
+            }
+
+            template <typename T, typename U, typename E>
+            void operator()(size_t , add_layer<T,U,E>& l) const
+            {
+                fuse(l.layer_details(), l.subnet());
+            }
+
+        private:
+
+            template <typename T, typename SUB>
+            void fuse(T&, SUB&) const
+            {
+                // ignore all other layer combinations
+            }
+
+            template <typename SUB>
+            void fuse(affine_& l, SUB& sub) const
+            {
+                if (fold_affine && !l.is_disabled() && try_fold(l, sub))
+                    l.disable();
+            }
+
+            template <typename SUB>
+            void fuse(relu_& l, SUB& sub) const
+            {
+                if (!fold_affine && !l.is_disabled() && try_fuse(sub, cpu::conv_activation::relu, 0))
+                    l.disable();
+            }
+
+            template <typename SUB>
+            void fuse(prelu_& l, SUB& sub) const
+            {
+                if (!fold_affine && !l.is_disabled() && l.get_layer_params().size() == 1 &&
+                    try_fuse(sub, cpu::conv_activation::prelu, l.get_layer_params().host()[0]))
+                    l.disable();
+            }
+
+            template <typename SUB>
+            void fuse(leaky_relu_& l, SUB& sub) const
+            {
+                if (!fold_affine && !l.is_disabled() && try_fuse(sub, cpu::conv_activation::leaky_relu, l.get_alpha()))
+                    l.disable();
+            }
+
+            template <typename SUB>
+            static bool try_fold(const affine_& , SUB& ) { return false; }
+
+            template <long nf, long nr, long nc, int sy, int sx, int py, int px, int g, typename U, typename E>
+            static bool try_fold(const affine_& l, add_layer<con_<nf,nr,nc,sy,sx,py,px,g>,U,E>& sub)
+            {
+                auto& c = sub.layer_details();
+                if (l.get_mode() != CONV_MODE || c.get_layer_params().size() == 0 ||
+                    c.get_fused_activation() != cpu::conv_activation::none)
+                    return false;
+                c.fold_affine_transform(l.get_gamma(), l.get_beta());
+                return true;
+            }
+
+            template <unsigned long no, fc_bias_mode bm, typename U, typename E>
+            static bool try_fold(const affine_& l, add_layer<fc_<no,bm>,U,E>& sub)
+            {
+                auto& f = sub.layer_details();
+                if (f.get_layer_params().size() == 0 || l.get_gamma().get().size() != f.get_num_outputs() ||
+                    (bm == FC_NO_BIAS && max(abs(mat(l.get_beta().get()))) != 0))
+                    return false;
+                f.fold_affine_transform(l.get_gamma(), l.get_beta());
+                return true;
+            }
+
+            template <typename SUB>
+            static bool try_fuse(SUB& , cpu::conv_activation , float ) { return false; }
+
+            template <typename U, typename E>
+            static bool try_fuse(add_layer<affine_,U,E>& sub, cpu::conv_activation act, float param)
+            {
+                // A disabled affine_ is the identity, so we can fuse through it.
+                return sub.layer_details().is_disabled() && try_fuse(sub.subnet(), act, param);
+            }
+
+            template <long nf, long nr, long nc, int sy, int sx, int py, int px, int g, typename U, typename E>
+            static bool try_fuse(add_layer<con_<nf,nr,nc,sy,sx,py,px,g>,U,E>& sub, cpu::conv_activation act, float param)
+            {
+                auto& c = sub.layer_details();
+                if (c.get_fused_activation() != cpu::conv_activation::none)
+                    return false;
+                c.fuse_activation(act, param);
+                return true;
+            }
+
+            bool fold_affine;
+        };
+    }
+
+    template <typename net_type>
+    void fuse_layers (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_fuse_layers(true));
+        visit_layers(net, impl::visitor_fuse_layers(false));
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
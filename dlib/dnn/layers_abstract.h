@@ -358,6 +358,71 @@ namespace dlib
             input_tensor_to_output_tensor().
         !*/
 
+        template <typename SUBNET> 
+        bool can_overwrite_input(
+            const SUBNET& sub
+        ) const;
+        /*!
+            Implementing this function is optional.  It is only used by networks that
+            have inference memory planning enabled (see
+            enable_inference_memory_planning()).  If you provide it then it must behave as
+            follows:
+
+            requires
+                - setup() has been called.
+            ensures
+                - returns true if forward(sub,output) works correctly when output is the
+                  same object as sub.get_output().  Networks with inference memory planning
+                  enabled will then run this layer in-place whenever nothing else needs
+                  sub.get_output().
+                - Layers that implement forward_inplace() are always treated as if this
+                  function returned true.
+        !*/
+
+        template <typename SUBNET> 
+        bool forward_as_view(
+            const SUBNET& sub,
+            alias_tensor& view,
+            size_t& offset
+        );
+        /*!
+            Implementing this function is optional.  It lets layers whose output is just
+            a contiguous block of their input, such as extract_, skip copying it.  If you
+            provide it then it must behave as follows:
+
+            requires
+                - setup() has been called.
+            ensures
+                - If forward(sub,output) would produce an output equal to a contiguous
+                  range of sub.get_output() then this function returns true and sets
+                  #view and #offset so that #view(sub.get_output(), #offset) is that
+                  range.  The network then uses the view as this layer's output instead
+                  of calling forward().  backward() is still called as usual.
+                - Otherwise returns false, and forward() is called.
+                - Networks with inference memory planning enabled never use views, since
+                  the memory of sub.get_output() may be reused by later layers.
+        !*/
+
+        template <typename SUBNET>
+        double estimate_flops(
+            const SUBNET& sub
+        ) const;
+        /*!
+            Implementing this function is optional.  It is only used by networks that
+            have profiling enabled (see enable_profiling()).  If you provide it then it
+            must behave as follows:
+
+            requires
+                - setup() has been called.
+            ensures
+                - returns an estimate of the number of floating point operations
+                  forward(sub,output) performs, counting a multiply-add as 2 operations.
+                  con_, cont_, and fc_ layers implement this, so the profiler reports the
+                  cost of the convolutions and matrix multiplies that dominate most
+                  networks.  Layers that don't implement it are reported as taking 0
+                  operations.
+        !*/
+
         void clean (
         );
         /*!
@@ -629,8 +694,79 @@ namespace dlib
                 - #get_layer_params().size() == (#get_weights().size() + #get_biases().size())
         !*/
 
+        void begin_int8_calibration (
+        );
+        /*!
+            ensures
+                - Puts this layer into calibration mode.  While in this mode, forward()
+                  records the largest absolute value it sees in its input tensor.
+                - #is_int8() == false
+        !*/
+
+        void end_int8_calibration (
+        );
+        /*!
+            requires
+                - begin_int8_calibration() has been called and forward() has been run on
+                  some data since then.
+            ensures
+                - Quantizes the weights to signed 8 bit integers, using one scale per
+                  output neuron, and sets #get_int8_input_scale() to the largest input
+                  magnitude seen during calibration divided by 127.
+                - #is_int8() == true
+                - The weights in get_layer_params() are replaced with their dequantized
+                  int8 values.
+                - forward() now quantizes its input using get_int8_input_scale() and runs
+                  an int8 kernel on the CPU.  Serializing this layer saves only the int8
+                  weights, which takes about 4x less space on disk.  In memory the layer
+                  keeps its float parameters as well as a 16 bit copy of the int8 weights,
+                  so it uses more RAM than before, not less.
+        !*/
+
+        void disable_int8 (
+        );
+        /*!
+            ensures
+                - #is_int8() == false
+                - Cancels any calibration in progress.
+        !*/
+
+        bool is_int8 (
+        ) const;
+        /*!
+            ensures
+                - returns true if this layer runs inference using int8 weights.  Note that
+                  backward() always uses the float parameters.
+        !*/
+
+        float get_int8_input_scale (
+        ) const;
+        /*!
+            ensures
+                - returns the scale used to quantize the input of this layer when is_int8()
+                  is true.
+        !*/
+
+        void fold_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        );
+        /*!
+            requires
+                - get_layer_params().size() != 0
+                - gamma.size() == beta.size() == get_num_outputs()
+                - if (get_bias_mode() == FC_NO_BIAS) then
+                    - all elements of beta are 0
+            ensures
+                - Scales and shifts the weights and biases so that this layer's output
+                  becomes gamma[i]*output[i] + beta[i] for each output i.  I.e. it folds an
+                  affine_ layer that follows this layer into it.
+                - if (is_int8()) then the weights are requantized.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
+        template <typename SUBNET> double estimate_flops(const SUBNET& sub) const;
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
         const tensor& get_layer_params() const; 
         tensor& get_layer_params(); 
@@ -652,6 +788,144 @@ namespace dlib
         >
     using fc_no_bias = add_layer<fc_<num_outputs,FC_NO_BIAS>, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        unsigned long num_outputs_
+        >
+    class fc_sampled_
+    {
+        /*!
+            REQUIREMENTS ON num_outputs_
+                num_outputs_ > 0
+
+            WHAT THIS OBJECT REPRESENTS
+                This is an implementation of the EXAMPLE_COMPUTATIONAL_LAYER_ interface
+                defined above.  It is a fully connected layer with biases, exactly like
+                fc_<num_outputs_,FC_HAS_BIAS>, except that it can compute just some of its
+                outputs.  It is meant for classifiers with a huge number of classes, used
+                together with loss_multiclass_log_sampled_.
+
+                When the network is run normally, e.g. by calling net(img), this layer
+                computes all num_outputs_ outputs, so the scores and labels you get at
+                inference are exact.  But during training, the loss calls select_outputs()
+                with the labels of the mini-batch before each forward pass.  The layer
+                then only computes the outputs for those labels plus get_num_sampled()
+                other outputs picked uniformly at random.  So the cost of training this
+                layer grows with get_num_sampled() rather than with num_outputs_.  The
+                outputs that weren't computed get a zero parameter gradient.
+
+                The parameters are laid out just like those of fc_, so you can copy them
+                into a fc_ layer with get_layer_params() if you like.
+        !*/
+
+    public:
+
+        fc_sampled_(
+        );
+        /*!
+            ensures
+                - #get_num_outputs() == num_outputs_
+                - #get_num_sampled() == 1024
+                - #get_learning_rate_multiplier() == 1
+                - #get_weight_decay_multiplier()  == 1
+                - #get_selected_outputs().size() == 0
+        !*/
+
+        unsigned long get_num_outputs (
+        ) const;
+        /*!
+            ensures
+                - This layer outputs column vectors that contain get_num_outputs()
+                  elements, except when only some outputs are computed during training.
+        !*/
+
+        unsigned long get_num_sampled (
+        ) const;
+        /*!
+            ensures
+                - returns the number of outputs, besides the labels of the mini-batch, that
+                  are computed during training.
+        !*/
+
+        void set_num_sampled (
+            unsigned long num
+        );
+        /*!
+            ensures
+                - #get_num_sampled() == num
+        !*/
+
+        template <typename label_iterator>
+        void select_outputs (
+            label_iterator begin,
+            label_iterator end
+        );
+        /*!
+            requires
+                - all the values in [begin,end) are < get_num_outputs().
+            ensures
+                - The next call to forward() only computes some of the outputs.  Its output
+                  tensor has one column for each of them, and afterwards
+                  get_selected_outputs() tells you which output each column holds.  They
+                  are the distinct values in [begin,end), in the order they first appear,
+                  followed by min(get_num_sampled(), get_num_outputs() - number of distinct
+                  values) other outputs picked uniformly at random.
+                - Calls to forward() after that one compute all the outputs again, unless
+                  select_outputs() is called again.
+        !*/
+
+        const std::vector<unsigned long>& get_selected_outputs (
+        ) const;
+        /*!
+            ensures
+                - returns the outputs computed by the last call to forward(), as described
+                  in select_outputs().  An empty vector means all outputs were computed.
+        !*/
+
+        double get_learning_rate_multiplier(
+        ) const;  
+        double get_weight_decay_multiplier(
+        ) const; 
+        void set_learning_rate_multiplier(
+            double val
+        );
+        void set_weight_decay_multiplier(
+            double val
+        ); 
+        /*!
+            These functions behave just like the ones in fc_.  The biases use the same
+            multipliers as the weights.
+        !*/
+
+        alias_tensor_const_instance get_weights(
+        ) const;
+        alias_tensor_instance get_weights(
+        );
+        alias_tensor_const_instance get_biases(
+        ) const;
+        alias_tensor_instance get_biases(
+        );
+        /*!
+            These functions behave just like the ones in fc_.
+        !*/
+
+        template <typename SUBNET> void setup (const SUBNET& sub);
+        template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
+        template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
+        const tensor& get_layer_params() const; 
+        tensor& get_layer_params(); 
+        /*!
+            These functions are implemented as described in the EXAMPLE_COMPUTATIONAL_LAYER_ interface.
+        !*/
+    };
+
+    template <
+        unsigned long num_outputs,
+        typename SUBNET
+        >
+    using fc_sampled = add_layer<fc_sampled_<num_outputs>, SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     struct num_con_outputs
@@ -667,7 +941,8 @@ namespace dlib
         int _stride_y,
         int _stride_x,
         int _padding_y = _stride_y!=1? 0 : _nr/2,
-        int _padding_x = _stride_x!=1? 0 : _nc/2
+        int _padding_x = _stride_x!=1? 0 : _nc/2,
+        int _groups = 1
         >
     class con_
     {
@@ -680,6 +955,7 @@ namespace dlib
                 - _stride_x > 0
                 - _padding_y >= 0
                 - _padding_x >= 0
+                - _groups > 0
                 - Also, we require that:
                     - if (_nr == 0) then
                         - _padding_y == 0
@@ -711,6 +987,15 @@ namespace dlib
                     - if (_nc == 0) then
                         - nc() == IN.nc()
                         - OUT.nc() == 1
+
+                Finally, _groups splits the input channels and the filters into _groups
+                equal sized groups, and each filter only looks at the input channels in its
+                own group.  So IN.k() and num_filters() must both be divisible by _groups,
+                and each filter has IN.k()/_groups channels.  Setting _groups ==
+                num_filters() == IN.k() gives a depthwise convolution, where each output
+                channel is computed from just one input channel.  Grouped layers are run by
+                dedicated direct kernels on the CPU rather than by a matrix multiply, and
+                they don't support int8 inference.
         !*/
 
     public:
@@ -725,6 +1010,7 @@ namespace dlib
                 - #stride_x() == _stride_x
                 - #padding_y() == _padding_y
                 - #padding_x() == _padding_x
+                - #groups() == _groups
                 - #get_learning_rate_multiplier()      == 1
                 - #get_weight_decay_multiplier()       == 1
                 - #get_bias_learning_rate_multiplier() == 1
@@ -743,6 +1029,7 @@ namespace dlib
                 - #stride_x() == _stride_x
                 - #padding_y() == _padding_y
                 - #padding_x() == _padding_x
+                - #groups() == _groups
                 - #get_learning_rate_multiplier()      == 1
                 - #get_weight_decay_multiplier()       == 1
                 - #get_bias_learning_rate_multiplier() == 1
@@ -827,6 +1114,15 @@ namespace dlib
                   sides of the image.
         !*/
 
+        long groups(
+        ) const;
+        /*!
+            ensures
+                - returns the number of groups the input channels and filters are split
+                  into.  Each filter only sees the IN.k()/groups() input channels in its
+                  own group.
+        !*/
+
         double get_learning_rate_multiplier(
         ) const;  
         /*!
@@ -903,8 +1199,107 @@ namespace dlib
                 - #get_bias_weight_decay_multiplier() == val
         !*/
 
+        void begin_int8_calibration (
+        );
+        /*!
+            ensures
+                - Puts this layer into calibration mode.  While in this mode, forward()
+                  records the largest absolute value it sees in its input tensor.
+                - #is_int8() == false
+        !*/
+
+        void end_int8_calibration (
+        );
+        /*!
+            requires
+                - begin_int8_calibration() has been called and forward() has been run on
+                  some data since then.
+            ensures
+                - Quantizes the filters to signed 8 bit integers, using one scale per
+                  output channel, and sets #get_int8_input_scale() to the largest input
+                  magnitude seen during calibration divided by 127.
+                - #is_int8() == true
+                - The filters in get_layer_params() are replaced with their dequantized
+                  int8 values.
+                - forward() now quantizes its input using get_int8_input_scale() and runs
+                  an int8 kernel on the CPU.  Serializing this layer saves only the int8
+                  filters, which takes about 4x less space on disk.  In memory the layer
+                  keeps its float parameters as well as a 16 bit copy of the int8 filters,
+                  so it uses more RAM than before, not less.
+        !*/
+
+        void disable_int8 (
+        );
+        /*!
+            ensures
+                - #is_int8() == false
+                - Cancels any calibration in progress.
+        !*/
+
+        bool is_int8 (
+        ) const;
+        /*!
+            ensures
+                - returns true if this layer runs inference using int8 filters.  Note that
+                  backward() always uses the float parameters.
+        !*/
+
+        float get_int8_input_scale (
+        ) const;
+        /*!
+            ensures
+                - returns the scale used to quantize the input of this layer when is_int8()
+                  is true.
+        !*/
+
+        void fold_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        );
+        /*!
+            requires
+                - get_layer_params().size() != 0
+                - gamma.size() == beta.size() == num_filters()
+                - get_fused_activation() == cpu::conv_activation::none
+            ensures
+                - Scales and shifts the filters and biases so that this layer's output
+                  becomes gamma[k]*output[k] + beta[k] for each channel k.  I.e. it folds an
+                  affine_ layer in CONV_MODE into this layer.
+                - if (is_int8()) then the filters are requantized.
+        !*/
+
+        void fuse_activation (
+            cpu::conv_activation activation,
+            float activation_param = 0
+        );
+        /*!
+            ensures
+                - #get_fused_activation() == activation
+                - #get_fused_activation_param() == activation_param
+                - forward() applies the activation to its output right after the bias, in
+                  the same pass over the data.  activation_param is prelu's parameter or
+                  leaky_relu's alpha.  A layer with a fused activation can only be used
+                  for inference, and the fused activation isn't serialized.
+        !*/
+
+        cpu::conv_activation get_fused_activation (
+        ) const;
+        /*!
+            ensures
+                - returns the activation applied at the end of forward().  This is
+                  cpu::conv_activation::none by default.
+        !*/
+
+        float get_fused_activation_param (
+        ) const;
+        /*!
+            ensures
+                - returns the parameter of get_fused_activation().
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
+        template <typename SUBNET> double estimate_flops(const SUBNET& sub) const;
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
         dpoint map_input_to_output(dpoint p) const;
         dpoint map_output_to_input(dpoint p) const;
@@ -926,6 +1321,31 @@ namespace dlib
         >
     using con = add_layer<con_<num_filters,nr,nc,stride_y,stride_x>, SUBNET>;
 
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        int groups,
+        typename SUBNET
+        >
+    using grouped_con = add_layer<con_<num_filters,nr,nc,stride_y,stride_x,
+        stride_y!=1? 0 : nr/2, stride_x!=1? 0 : nc/2, groups>, SUBNET>;
+
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        typename SUBNET
+        >
+    using depthwise_con = grouped_con<num_filters,nr,nc,stride_y,stride_x,num_filters,SUBNET>;
+    /*!
+        depthwise_con requires its input to have exactly num_filters channels.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -935,7 +1355,8 @@ namespace dlib
         int _stride_y,
         int _stride_x,
         int _padding_y = _stride_y!=1? 0 : _nr/2,
-        int _padding_x = _stride_x!=1? 0 : _nc/2
+        int _padding_x = _stride_x!=1? 0 : _nc/2,
+        int _groups = 1
         >
     class cont_
     {
@@ -945,6 +1366,10 @@ namespace dlib
                 Also, we require that:
                     - 0 <= _padding_y && _padding_y < _nr
                     - 0 <= _padding_x && _padding_x < _nc
+                    - IN.k() and num_filters() are divisible by _groups.  As with con_,
+                      each output channel is then only connected to the input channels in
+                      its own group, and _groups == num_filters() == IN.k() makes this a
+                      depthwise transposed convolution.
 
             WHAT THIS OBJECT REPRESENTS
                 This is an implementation of the EXAMPLE_COMPUTATIONAL_LAYER_ interface
@@ -977,6 +1402,7 @@ namespace dlib
                 - #stride_x() == _stride_x
                 - #padding_y() == _padding_y
                 - #padding_x() == _padding_x
+                - #groups() == _groups
                 - #get_learning_rate_multiplier()      == 1
                 - #get_weight_decay_multiplier()       == 1
                 - #get_bias_learning_rate_multiplier() == 1
@@ -995,6 +1421,7 @@ namespace dlib
                 - #stride_x() == _stride_x
                 - #padding_y() == _padding_y
                 - #padding_x() == _padding_x
+                - #groups() == _groups
                 - #get_learning_rate_multiplier()      == 1
                 - #get_weight_decay_multiplier()       == 1
                 - #get_bias_learning_rate_multiplier() == 1
@@ -1071,6 +1498,15 @@ namespace dlib
                   sides of the image.
         !*/
 
+        long groups(
+        ) const;
+        /*!
+            ensures
+                - returns the number of groups the input channels and filters are split
+                  into.  Each filter only sees the IN.k()/groups() input channels in its
+                  own group.
+        !*/
+
         double get_learning_rate_multiplier(
         ) const;  
         /*!
@@ -1149,6 +1585,7 @@ namespace dlib
 
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
+        template <typename SUBNET> double estimate_flops(const SUBNET& sub) const;
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
         dpoint map_input_to_output(dpoint p) const;
         dpoint map_output_to_input(dpoint p) const;
@@ -1170,6 +1607,28 @@ namespace dlib
         >
     using cont = add_layer<cont_<num_filters,nr,nc,stride_y,stride_x>, SUBNET>;
 
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        int groups,
+        typename SUBNET
+        >
+    using grouped_cont = add_layer<cont_<num_filters,nr,nc,stride_y,stride_x,
+        stride_y!=1? 0 : nr/2, stride_x!=1? 0 : nc/2, groups>, SUBNET>;
+
+    template <
+        long num_filters,
+        long nr,
+        long nc,
+        int stride_y,
+        int stride_x,
+        typename SUBNET
+        >
+    using depthwise_cont = grouped_cont<num_filters,nr,nc,stride_y,stride_x,num_filters,SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -1692,6 +2151,39 @@ namespace dlib
                 - returns the mode of this layer, either CONV_MODE or FC_MODE.  
         !*/
 
+        alias_tensor_const_instance get_gamma(
+        ) const;
+        /*!
+            ensures
+                - returns the scale applied by this layer.
+        !*/
+
+        alias_tensor_const_instance get_beta(
+        ) const;
+        /*!
+            ensures
+                - returns the shift applied by this layer.
+        !*/
+
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - Sets gamma to 1 and beta to 0 and makes this layer skip its pass over the
+                  data entirely.  fuse_layers() does this after folding the transform into
+                  the con_ or fc_ layer below it.  Only the identity parameters are
+                  serialized, so a loaded network computes the same thing but doesn't
+                  skip the pass until fuse_layers() is called again.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -2020,6 +2512,22 @@ namespace dlib
         relu_(
         );
 
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - Makes this layer pass its input through unchanged.  fuse_layers() does
+                  this after moving the relu into the con_ layer below it.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.  This state isn't serialized.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -2075,6 +2583,23 @@ namespace dlib
                 - returns the initial value of the prelu parameter. 
         !*/
 
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - Makes this layer pass its input through unchanged.  fuse_layers() does
+                  this after moving the prelu into the con_ layer below it.  A disabled
+                  prelu_ can only be used for inference.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.  This state isn't serialized.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -2124,6 +2649,22 @@ namespace dlib
                 - returns the alpha parameter of the leaky_relu
         !*/
 
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - Makes this layer pass its input through unchanged.  fuse_layers() does
+                  this after moving the leaky_relu into the con_ layer below it.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.  This state isn't serialized.
+        !*/
+
         template <typename SUBNET> void setup(const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -2358,6 +2899,7 @@ namespace dlib
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
+        template <typename SUBNET> bool can_overwrite_input(const SUBNET& sub) const;
         dpoint map_input_to_output(dpoint p) const;
         dpoint map_output_to_input(dpoint p) const;
         const tensor& get_layer_params() const; 
@@ -2432,6 +2974,7 @@ namespace dlib
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
+        template <typename SUBNET> bool can_overwrite_input(const SUBNET& sub) const;
         const tensor& get_layer_params() const; 
         tensor& get_layer_params(); 
         /*!
@@ -2792,11 +3335,17 @@ namespace dlib
                 Finally, all this means that the input tensor to this layer must have a big
                 enough size to accommodate taking a _k*_nr*_nc slice from each of its
                 samples.  
+
+                When the extracted values are contiguous in IN, i.e. when IN has only one
+                sample or when _offset == 0 and OUT_SIZE == IN_SIZE, the output is a view
+                of IN rather than a copy (see forward_as_view()).  So extracting from a
+                single sample doesn't copy anything.
         !*/
 
     public:
 
         template <typename SUBNET> void setup (const SUBNET& sub);
+        template <typename SUBNET> bool forward_as_view(const SUBNET& sub, alias_tensor& view, size_t& offset);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
         const tensor& get_layer_params() const; 
@@ -2815,6 +3364,34 @@ namespace dlib
         >
     using extract = add_layer<extract_<offset,k,nr,nc>, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename net_type
+        >
+    void fuse_layers (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Rewrites net for faster inference without changing what it computes, up to
+              floating point rounding.  Specifically:
+                - Each affine_ layer directly on top of a con_ layer (in CONV_MODE) or a
+                  fc_ layer is folded into that layer's weights and biases, and then
+                  disabled.
+                - Each relu_, prelu_, or leaky_relu_ layer directly on top of a con_
+                  layer, or on top of an affine_ disabled by the previous step, is fused
+                  into the con_ layer's convolution and then disabled.  The activation is
+                  applied while the convolution's output is still in cache.
+            - Layers whose outputs are tagged are never fused with the layers above them.
+            - After this call net can only be used for inference.  Serializing it saves an
+              ordinary network that computes the same thing, so call fuse_layers() again
+              after loading it.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
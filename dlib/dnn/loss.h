@@ -367,6 +367,146 @@ namespace dlib
     template <typename SUBNET>
     using loss_multiclass_log = add_loss_layer<loss_multiclass_log_, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    class loss_multiclass_log_sampled_
+    {
+    public:
+
+        typedef unsigned long training_label_type;
+        typedef unsigned long output_label_type;
+
+        template <
+            typename SUB_TYPE,
+            typename label_iterator
+            >
+        void to_label (
+            const tensor& input_tensor,
+            const SUB_TYPE& sub,
+            label_iterator iter
+        ) const
+        {
+            const tensor& output_tensor = sub.get_output();
+            DLIB_CASSERT(sub.sample_expansion_factor() == 1);
+            DLIB_CASSERT(output_tensor.nr() == 1 && 
+                         output_tensor.nc() == 1 );
+            DLIB_CASSERT(input_tensor.num_samples() == output_tensor.num_samples());
+            DLIB_CASSERT(sub.layer_details().get_selected_outputs().empty(),
+                "to_label() needs all the outputs of fc_sampled_, not just the sampled ones.");
+
+            for (long i = 0; i < output_tensor.num_samples(); ++i)
+            {
+                // The index of the largest output for this sample is the label.
+                *iter++ = index_of_max(rowm(mat(output_tensor),i));
+            }
+        }
+
+        template <
+            typename const_label_iterator,
+            typename SUBNET
+            >
+        void prepare_for_labels (
+            const tensor& input_tensor,
+            const_label_iterator truth, 
+            SUBNET& sub
+        ) const
+        {
+            DLIB_CASSERT(sub.sample_expansion_factor() == 1);
+            sub.layer_details().select_outputs(truth, truth + input_tensor.num_samples());
+        }
+
+        template <
+            typename const_label_iterator,
+            typename SUBNET
+            >
+        double compute_loss_value_and_gradient (
+            const tensor& input_tensor,
+            const_label_iterator truth, 
+            SUBNET& sub
+        ) const
+        {
+            const tensor& output_tensor = sub.get_output();
+            tensor& grad = sub.get_gradient_input();
+
+            DLIB_CASSERT(sub.sample_expansion_factor() == 1);
+            DLIB_CASSERT(input_tensor.num_samples() != 0);
+            DLIB_CASSERT(input_tensor.num_samples() == grad.num_samples());
+            DLIB_CASSERT(input_tensor.num_samples() == output_tensor.num_samples());
+            DLIB_CASSERT(output_tensor.nr() == 1 && 
+                         output_tensor.nc() == 1);
+            DLIB_CASSERT(grad.nr() == 1 && 
+                         grad.nc() == 1);
+
+            // fc_sampled_ puts the labels of the mini-batch first among the outputs it
+            // computed, so only the first num_samples of them can be labels.
+            const auto& selected = sub.layer_details().get_selected_outputs();
+            std::unordered_map<unsigned long,long> column;
+            for (size_t j = 0; j < std::min<size_t>(selected.size(), output_tensor.num_samples()); ++j)
+                column[selected[j]] = j;
+
+            tt::softmax(grad, output_tensor);
+
+            // The loss we output is the average loss over the mini-batch.
+            const double scale = 1.0/output_tensor.num_samples();
+            double loss = 0;
+            float* g = grad.host();
+            for (long i = 0; i < output_tensor.num_samples(); ++i)
+            {
+                long y = (long)*truth++;
+                if (!selected.empty())
+                {
+                    const auto c = column.find(y);
+                    DLIB_CASSERT(c != column.end(), "The labels given to compute_loss_value_and_gradient() "
+                        "weren't given to prepare_for_labels() first.");
+                    y = c->second;
+                }
+                DLIB_CASSERT(y < output_tensor.k(), "y: " << y << ", output_tensor.k(): " << output_tensor.k());
+                for (long k = 0; k < output_tensor.k(); ++k)
+                {
+                    const unsigned long idx = i*output_tensor.k()+k;
+                    if (k == y)
+                    {
+                        loss += scale*-safe_log(g[idx]);
+                        g[idx] = scale*(g[idx]-1);
+                    }
+                    else
+                    {
+                        g[idx] = scale*g[idx];
+                    }
+                }
+            }
+            return loss;
+        }
+
+        friend void serialize(const loss_multiclass_log_sampled_& , std::ostream& out)
+        {
+            serialize("loss_multiclass_log_sampled_", out);
+        }
+
+        friend void deserialize(loss_multiclass_log_sampled_& , std::istream& in)
+        {
+            std::string version;
+            deserialize(version, in);
+            if (version != "loss_multiclass_log_sampled_")
+                throw serialization_error("Unexpected version found while deserializing dlib::loss_multiclass_log_sampled_.");
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const loss_multiclass_log_sampled_& )
+        {
+            out << "loss_multiclass_log_sampled";
+            return out;
+        }
+
+        friend void to_xml(const loss_multiclass_log_sampled_& /*item*/, std::ostream& out)
+        {
+            out << "<loss_multiclass_log_sampled/>";
+        }
+
+    };
+
+    template <typename SUBNET>
+    using loss_multiclass_log_sampled = add_loss_layer<loss_multiclass_log_sampled_, SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     template <typename label_type>
@@ -1233,17 +1373,21 @@ namespace dlib
 
             std::vector<intermediate_detection> dets_accum;
             output_label_type final_dets;
+            box_overlap_index kept_boxes(options.overlaps_nms);
             for (long i = 0; i < output_tensor.num_samples(); ++i)
             {
                 tensor_to_dets(input_tensor, output_tensor, i, dets_accum, adjust_threshold, sub);
 
                 // Do non-max suppression
                 final_dets.clear();
+                kept_boxes.clear();
                 for (unsigned long i = 0; i < dets_accum.size(); ++i)
                 {
-                    if (overlaps_any_box_nms(final_dets, dets_accum[i].rect_bbr))
+                    const rectangle rect = dets_accum[i].rect_bbr;
+                    if (kept_boxes.overlaps_any_box(rect))
                         continue;
 
+                    kept_boxes.add(rect);
                     final_dets.push_back(mmod_rect(dets_accum[i].rect_bbr,
                                                    dets_accum[i].detection_confidence,
                                                    options.detector_windows[dets_accum[i].tensor_channel].label));
@@ -1360,18 +1504,19 @@ namespace dlib
                 // keep track of which truth boxes we have hit so far.
                 std::vector<bool> hit_truth_table(truth->size(), false);
 
-                std::vector<intermediate_detection> final_dets;
+                // The boxes that survived non-max suppression so far.
+                box_overlap_index kept_boxes(options.overlaps_nms);
                 // The point of this loop is to fill out the truth_score_hits array. 
-                for (size_t i = 0; i < dets.size() && final_dets.size() < max_num_dets; ++i)
+                for (size_t i = 0; i < dets.size() && kept_boxes.size() < max_num_dets; ++i)
                 {
-                    if (overlaps_any_box_nms(final_dets, dets[i].rect))
+                    if (kept_boxes.overlaps_any_box(dets[i].rect))
                         continue;
 
                     const auto& det_label = options.detector_windows[dets[i].tensor_channel].label;
 
                     const std::pair<double,unsigned int> hittruth = find_best_match(*truth, hit_truth_table, dets[i].rect, det_label);
 
-                    final_dets.push_back(dets[i].rect);
+                    kept_boxes.add(dets[i].rect);
 
                     const double truth_match = hittruth.first;
                     // if hit truth rect
@@ -1425,7 +1570,13 @@ namespace dlib
                 }
 
                 hit_truth_table.assign(hit_truth_table.size(), false);
-                final_dets.clear();
+                kept_boxes.clear();
+                std::vector<intermediate_detection> final_dets;
+                auto keep_detection = [&](const intermediate_detection& det)
+                {
+                    final_dets.push_back(det);
+                    kept_boxes.add(det.rect);
+                };
 
                 // Now figure out which detections jointly maximize the loss and detection score sum.  We
                 // need to take into account the fact that allowing a true detection in the output, while 
@@ -1433,7 +1584,7 @@ namespace dlib
                 // detections.
                 for (unsigned long i = 0; i < dets.size() && final_dets.size() < max_num_dets; ++i)
                 {
-                    if (overlaps_any_box_nms(final_dets, dets[i].rect))
+                    if (kept_boxes.overlaps_any_box(dets[i].rect))
                         continue;
 
                     const auto& det_label = options.detector_windows[dets[i].tensor_channel].label;
@@ -1448,7 +1599,7 @@ namespace dlib
                             if (!hit_truth_table[hittruth.second])
                             {
                                 hit_truth_table[hittruth.second] = true;
-                                final_dets.push_back(dets[i]);
+                                keep_detection(dets[i]);
                                 loss -= options.loss_per_missed_target;
 
                                 // Now account for BBR loss and gradient if appropriate.
@@ -1506,7 +1657,7 @@ namespace dlib
                             }
                             else
                             {
-                                final_dets.push_back(dets[i]);
+                                keep_detection(dets[i]);
                                 loss += options.loss_per_false_alarm;
                             }
                         }
@@ -1514,7 +1665,7 @@ namespace dlib
                     else if (!overlaps_ignore_box(*truth, dets[i].rect))
                     {
                         // didn't hit anything
-                        final_dets.push_back(dets[i]);
+                        keep_detection(dets[i]);
                         loss += options.loss_per_false_alarm;
                     }
                 }
@@ -1846,21 +1997,6 @@ namespace dlib
             return std::make_pair(match,best_idx);
         }
 
-        template <typename T>
-        inline bool overlaps_any_box_nms (
-            const std::vector<T>& rects,
-            const rectangle& rect
-        ) const
-        {
-            for (auto&& r : rects)
-            {
-                if (options.overlaps_nms(r.rect, rect))
-                    return true;
-            }
-            return false;
-        }
-
-
         mmod_options options;
 
     };
@@ -131,6 +131,36 @@ namespace dlib
                       loss gradient.
                 - returns L(input_tensor,truth,sub)
         !*/
+
+        template <
+            typename const_label_iterator,
+            typename SUBNET
+            >
+        void prepare_for_labels (
+            const tensor& input_tensor,
+            const_label_iterator truth, 
+            SUBNET& sub
+        ) const;
+        /*!
+            Implementing this function is optional.  add_loss_layer calls it with the
+            labels right before running the network forward on input_tensor, when it is
+            going to call compute_loss_value_and_gradient() with those labels.  It lets a
+            loss tell the layers in sub what the labels are, so they can restrict their
+            work to what the loss needs.  For example, loss_multiclass_log_sampled_ uses
+            it to pick which outputs fc_sampled_ computes.  If you provide it then it must
+            behave as follows:
+
+            requires
+                - SUBNET is an add_layer object, i.e. sub is the network below the loss
+                  itself rather than the SUBNET interface given to
+                  compute_loss_value_and_gradient().
+                - truth == an iterator pointing to the beginning of a range of
+                  input_tensor.num_samples()/sub.sample_expansion_factor() elements.
+                  Moreover, they must be training_label_type elements.
+            ensures
+                - The next call to sub.forward(input_tensor) produces outputs that
+                  compute_loss_value_and_gradient() can evaluate with these labels.
+        !*/
     };
 
     std::ostream& operator<<(std::ostream& out, const EXAMPLE_LOSS_LAYER_& item);
@@ -369,6 +399,106 @@ namespace dlib
     template <typename SUBNET>
     using loss_multiclass_log = add_loss_layer<loss_multiclass_log_, SUBNET>;
 
+// ----------------------------------------------------------------------------------------
+
+    class loss_multiclass_log_sampled_
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object implements the loss layer interface defined above by
+                EXAMPLE_LOSS_LAYER_.  It is loss_multiclass_log_ for problems with so
+                many labels, say hundreds of thousands, that computing the score of every
+                label for every training sample is too slow.  It must be placed right on
+                top of a fc_sampled_ layer.
+
+                During training, this loss has fc_sampled_ compute only the scores of the
+                labels in the mini-batch and of fc_sampled_::get_num_sampled() other
+                labels picked at random.  The loss is then the multiclass logistic
+                regression loss over those labels instead of over all of them, i.e.
+                sampled softmax.  Since the extra labels are sampled uniformly, no
+                correction of the scores is needed.  Every label in the mini-batch is
+                always included, so they all act as negatives for each other.  This is
+                also what compute_loss() with labels reports, so the testing loss of a
+                dnn_trainer is computed the same way.
+
+                At inference, fc_sampled_ computes all the scores, so to_label() returns
+                exactly what loss_multiclass_log_ would.  If you want the top k labels
+                instead of just the best one, run the network and sort the scores in
+                net.subnet().get_output(), e.g. with sort_index().
+        !*/
+    public:
+
+        typedef unsigned long training_label_type;
+        typedef unsigned long output_label_type;
+
+        template <
+            typename SUB_TYPE,
+            typename label_iterator
+            >
+        void to_label (
+            const tensor& input_tensor,
+            const SUB_TYPE& sub,
+            label_iterator iter
+        ) const;
+        /*!
+            This function has the same interface as EXAMPLE_LOSS_LAYER_::to_label() except
+            it has the additional calling requirements that: 
+                - sub.get_output().nr() == 1
+                - sub.get_output().nc() == 1
+                - sub.get_output().num_samples() == input_tensor.num_samples()
+                - sub.sample_expansion_factor() == 1
+                - sub.layer_details().get_selected_outputs().size() == 0, i.e. the
+                  network was run without labels.
+            and the output label is the predicted class for each classified object.  The
+            number of possible output classes is the number of outputs of the fc_sampled_
+            layer.
+        !*/
+
+        template <
+            typename const_label_iterator,
+            typename SUBNET
+            >
+        void prepare_for_labels (
+            const tensor& input_tensor,
+            const_label_iterator truth, 
+            SUBNET& sub
+        ) const;
+        /*!
+            This function has the same interface as
+            EXAMPLE_LOSS_LAYER_::prepare_for_labels() except it has the additional
+            calling requirements that: 
+                - sub.layer_details() is a fc_sampled_ object.
+                - sub.sample_expansion_factor() == 1
+                - all values pointed to by truth are < the number of outputs of the
+                  fc_sampled_ layer.
+            It calls sub.layer_details().select_outputs() with the labels.
+        !*/
+
+        template <
+            typename const_label_iterator,
+            typename SUBNET
+            >
+        double compute_loss_value_and_gradient (
+            const tensor& input_tensor,
+            const_label_iterator truth, 
+            SUBNET& sub
+        ) const;
+        /*!
+            This function has the same interface as EXAMPLE_LOSS_LAYER_::compute_loss_value_and_gradient() 
+            except it has the additional calling requirements that: 
+                - sub.get_output().nr() == 1
+                - sub.get_output().nc() == 1
+                - sub.get_output().num_samples() == input_tensor.num_samples()
+                - sub.sample_expansion_factor() == 1
+                - prepare_for_labels() was called with the same labels before the network
+                  was run, or all values pointed to by truth are < sub.get_output().k().
+        !*/
+
+    };
+
+    template <typename SUBNET>
+    using loss_multiclass_log_sampled = add_loss_layer<loss_multiclass_log_sampled_, SUBNET>;
+
 // ----------------------------------------------------------------------------------------
 
     template <typename label_type>
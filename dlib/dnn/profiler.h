@@ -0,0 +1,285 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_PROFILER_H_
+#define DLIB_DNn_PROFILER_H_
+
+#include "profiler_abstract.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class dnn_profiler
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        struct layer_stats
+        {
+            size_t index = 0;
+            std::string name;
+            std::string description;
+            unsigned long forward_calls = 0;
+            double forward_seconds = 0;
+            unsigned long backward_calls = 0;
+            double backward_seconds = 0;
+            double flops = 0;
+            size_t output_bytes = 0;
+            size_t parameter_bytes = 0;
+            size_t gradient_bytes = 0;
+        };
+
+        dnn_profiler (
+        ) : start_time(clock::now()), max_trace_events(1000000) {}
+
+        dnn_profiler(const dnn_profiler&) = delete;
+        dnn_profiler& operator=(const dnn_profiler&) = delete;
+
+        std::vector<layer_stats> get_layer_stats (
+        ) const
+        {
+            std::lock_guard<std::mutex> lock(m);
+            std::vector<layer_stats> result;
+            for (auto& s : layers)
+            {
+                if (s.name.size() != 0)
+                    result.push_back(s);
+            }
+            return result;
+        }
+
+        void clear (
+        )
+        {
+            std::lock_guard<std::mutex> lock(m);
+            for (auto& s : layers)
+            {
+                s.forward_calls = 0;
+                s.forward_seconds = 0;
+                s.backward_calls = 0;
+                s.backward_seconds = 0;
+                s.flops = 0;
+                s.output_bytes = 0;
+                s.gradient_bytes = 0;
+            }
+            events.clear();
+            start_time = clock::now();
+        }
+
+        size_t get_max_trace_events (
+        ) const { std::lock_guard<std::mutex> lock(m); return max_trace_events; }
+
+        void set_max_trace_events (
+            size_t num
+        )
+        {
+            std::lock_guard<std::mutex> lock(m);
+            max_trace_events = num;
+            if (events.size() > num)
+                events.resize(num);
+        }
+
+        size_t num_trace_events (
+        ) const { std::lock_guard<std::mutex> lock(m); return events.size(); }
+
+        void print_table (
+            std::ostream& out
+        ) const
+        {
+            const auto stats = get_layer_stats();
+            double total_seconds = 0;
+            for (auto& s : stats)
+                total_seconds += s.forward_seconds + s.backward_seconds;
+
+            std::ostringstream sout;
+            sout << std::fixed << std::left
+                 << std::setw(7) << "layer" << std::setw(14) << "name" << std::right
+                 << std::setw(10) << "fwd calls" << std::setw(13) << "fwd ms/call"
+                 << std::setw(13) << "bwd ms/call" << std::setw(9) << "time %"
+                 << std::setw(13) << "MFLOP/call" << std::setw(10) << "GFLOP/s"
+                 << std::setw(11) << "output MB" << std::setw(11) << "params MB" << "\n";
+
+            double total_fwd = 0, total_bwd = 0, total_flops = 0;
+            for (auto& s : stats)
+            {
+                const double fwd_ms = s.forward_calls ? 1000*s.forward_seconds/s.forward_calls : 0;
+                const double bwd_ms = s.backward_calls ? 1000*s.backward_seconds/s.backward_calls : 0;
+                const double flops = s.forward_calls ? s.flops/s.forward_calls : 0;
+                const double percent = total_seconds ? 100*(s.forward_seconds+s.backward_seconds)/total_seconds : 0;
+                sout << std::left << std::setw(7) << s.index << std::setw(14) << s.name << std::right
+                     << std::setw(10) << s.forward_calls
+                     << std::setprecision(3) << std::setw(13) << fwd_ms << std::setw(13) << bwd_ms
+                     << std::setprecision(1) << std::setw(9) << percent
+                     << std::setprecision(2) << std::setw(13) << flops/1e6
+                     << std::setw(10) << (s.forward_seconds ? s.flops/s.forward_seconds/1e9 : 0)
+                     << std::setw(11) << s.output_bytes/1024.0/1024.0
+                     << std::setw(11) << s.parameter_bytes/1024.0/1024.0 << "\n";
+                total_fwd += fwd_ms;
+                total_bwd += bwd_ms;
+                total_flops += flops;
+            }
+            sout << std::left << std::setw(21) << "total" << std::right << std::setw(10) << ""
+                 << std::setprecision(3) << std::setw(13) << total_fwd << std::setw(13) << total_bwd
+                 << std::setw(9) << "" << std::setprecision(2) << std::setw(13) << total_flops/1e6 << "\n";
+            out << sout.str();
+        }
+
+        void write_chrome_trace (
+            std::ostream& out
+        ) const
+        {
+            std::lock_guard<std::mutex> lock(m);
+            std::map<std::thread::id, size_t> thread_ids;
+            std::ostringstream sout;
+            sout << std::fixed << std::setprecision(3);
+            sout << "{\"traceEvents\":[";
+            for (size_t i = 0; i < events.size(); ++i)
+            {
+                const auto& e = events[i];
+                const auto& s = layers[e.layer];
+                const size_t tid = thread_ids.emplace(e.thread, thread_ids.size()).first->second;
+                if (i != 0)
+                    sout << ",";
+                sout << "\n{\"name\":\"" << s.name << "\",\"cat\":\"" << (e.backward ? "backward" : "forward")
+                     << "\",\"ph\":\"X\",\"ts\":" << e.start << ",\"dur\":" << e.duration
+                     << ",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"layer\":" << s.index;
+                if (!e.backward && e.flops != 0)
+                    sout << ",\"flops\":" << std::setprecision(0) << e.flops << std::setprecision(3);
+                sout << ",\"details\":\"" << escape_json(s.description) << "\"}}";
+            }
+            sout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+            out << sout.str();
+        }
+
+        friend std::ostream& operator<< (
+            std::ostream& out,
+            const dnn_profiler& item
+        )
+        {
+            item.print_table(out);
+            return out;
+        }
+
+        // The rest of the functions are called by the network layers.
+
+        void register_layer (
+            size_t index,
+            const std::string& description
+        )
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (layers.size() <= index)
+                layers.resize(index+1);
+            auto& s = layers[index];
+            s.index = index;
+            s.description = description;
+            s.name = description.substr(0, description.find_first_of(" \t("));
+        }
+
+        void record_forward (
+            size_t index,
+            clock::time_point start,
+            double flops,
+            size_t output_bytes,
+            size_t parameter_bytes
+        )
+        {
+            const auto stop = clock::now();
+            std::lock_guard<std::mutex> lock(m);
+            auto& s = layers[index];
+            ++s.forward_calls;
+            s.parameter_bytes = parameter_bytes;
+            s.forward_seconds += std::chrono::duration<double>(stop-start).count();
+            s.flops += flops;
+            s.output_bytes = std::max(s.output_bytes, output_bytes);
+            add_event(index, false, start, stop, flops);
+        }
+
+        void record_backward (
+            size_t index,
+            clock::time_point start,
+            size_t gradient_bytes
+        )
+        {
+            const auto stop = clock::now();
+            std::lock_guard<std::mutex> lock(m);
+            auto& s = layers[index];
+            ++s.backward_calls;
+            s.backward_seconds += std::chrono::duration<double>(stop-start).count();
+            s.gradient_bytes = std::max(s.gradient_bytes, gradient_bytes);
+            add_event(index, true, start, stop, 0);
+        }
+
+    private:
+
+        struct event
+        {
+            size_t layer;
+            bool backward;
+            double start;
+            double duration;
+            double flops;
+            std::thread::id thread;
+        };
+
+        void add_event (
+            size_t index,
+            bool backward,
+            clock::time_point start,
+            clock::time_point stop,
+            double flops
+        )
+        {
+            if (events.size() >= max_trace_events)
+                return;
+            event e;
+            e.layer = index;
+            e.backward = backward;
+            e.start = std::chrono::duration<double,std::micro>(start-start_time).count();
+            e.duration = std::chrono::duration<double,std::micro>(stop-start).count();
+            e.flops = flops;
+            e.thread = std::this_thread::get_id();
+            events.push_back(e);
+        }
+
+        static std::string escape_json (
+            const std::string& str
+        )
+        {
+            std::string result;
+            for (char c : str)
+            {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                if (c == '\t' || c == '\n')
+                    result += ' ';
+                else
+                    result += c;
+            }
+            return result;
+        }
+
+        mutable std::mutex m;
+        clock::time_point start_time;
+        size_t max_trace_events;
+        std::vector<layer_stats> layers;
+        std::vector<event> events;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_PROFILER_H_
+
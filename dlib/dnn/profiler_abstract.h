@@ -0,0 +1,164 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_PROFILER_ABSTRACT_H_
+#ifdef DLIB_DNn_PROFILER_ABSTRACT_H_
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class dnn_profiler
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object collects per layer timing, memory, and FLOP measurements from
+                a deep neural network.  You don't make these yourself, instead you call
+                enable_profiling() on a network, which returns a dnn_profiler that the
+                network's layers then record into every time they run.
+
+                The results are available as a list of layer_stats objects, as a text
+                table (by printing the profiler to a stream), or as a JSON file in the
+                Chrome trace event format, which you can open in chrome://tracing or
+                https://ui.perfetto.dev to see a timeline of every layer call.
+
+            THREAD SAFETY
+                All the member functions of this object are thread safe.  So you can
+                profile copies of a network that are run from different threads.
+        !*/
+
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        struct layer_stats
+        {
+            size_t index = 0;          // This is layer<index>(net)
+            std::string name;          // e.g. "con" or "relu"
+            std::string description;   // the layer printed with operator<<
+            unsigned long forward_calls = 0;
+            double forward_seconds = 0;    // total over all forward_calls
+            unsigned long backward_calls = 0;
+            double backward_seconds = 0;   // total over all backward_calls
+            double flops = 0;              // total over all forward_calls
+            size_t output_bytes = 0;       // largest output tensor seen
+            size_t parameter_bytes = 0;    // size of the layer's parameter tensor
+            size_t gradient_bytes = 0;     // largest gradient tensors seen during backward
+        };
+
+        dnn_profiler (
+        );
+        /*!
+            ensures
+                - #get_layer_stats().size() == 0
+                - #num_trace_events() == 0
+                - #get_max_trace_events() == 1000000
+        !*/
+
+        std::vector<layer_stats> get_layer_stats (
+        ) const;
+        /*!
+            ensures
+                - returns the measurements of every profiled layer, sorted by layer index.
+                  Layers that don't do any computation, like tag and skip layers, aren't
+                  included.
+                - output_bytes doesn't count in-place layers, since they write into the
+                  output of the layer below them.
+        !*/
+
+        void clear (
+        );
+        /*!
+            ensures
+                - Resets all the counters, times, and trace events to 0, e.g. so you can
+                  discard the measurements of warm up runs.
+        !*/
+
+        size_t num_trace_events (
+        ) const;
+        /*!
+            ensures
+                - returns the number of layer calls recorded for write_chrome_trace().
+        !*/
+
+        size_t get_max_trace_events (
+        ) const;
+        /*!
+            ensures
+                - returns the maximum number of trace events this object stores.  Once
+                  there are this many, later layer calls are still counted in
+                  get_layer_stats() but don't show up in the trace.
+        !*/
+
+        void set_max_trace_events (
+            size_t num
+        );
+        /*!
+            ensures
+                - #get_max_trace_events() == num
+                - #num_trace_events() <= num
+        !*/
+
+        void print_table (
+            std::ostream& out
+        ) const;
+        /*!
+            ensures
+                - prints a table with one row per layer to out.  It shows the average
+                  forward and backward time per call, each layer's share of the total
+                  time, the estimated MFLOP per forward call and resulting GFLOP/s, and
+                  the size of the output and parameter tensors.
+        !*/
+
+        void write_chrome_trace (
+            std::ostream& out
+        ) const;
+        /*!
+            ensures
+                - writes all the trace events to out as a JSON document in the Chrome
+                  trace event format.  Each layer call is an event named after the layer,
+                  in the "forward" or "backward" category, and the thread that made the
+                  call is the event's tid.
+        !*/
+
+        void register_layer (
+            size_t index,
+            const std::string& description
+        );
+        void record_forward (
+            size_t index,
+            clock::time_point start,
+            double flops,
+            size_t output_bytes,
+            size_t parameter_bytes
+        );
+        void record_backward (
+            size_t index,
+            clock::time_point start,
+            size_t gradient_bytes
+        );
+        /*!
+            These functions are called by the network layers to record their
+            measurements.  You don't need to call them yourself.
+        !*/
+    };
+
+    std::ostream& operator<< (
+        std::ostream& out,
+        const dnn_profiler& item
+    );
+    /*!
+        ensures
+            - calls item.print_table(out) and returns out.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_PROFILER_ABSTRACT_H_
+
@@ -0,0 +1,116 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_QUANTIZATION_H_
+#define DLIB_DNn_QUANTIZATION_H_
+
+#include "quantization_abstract.h"
+#include "core.h"
+#include "layers.h"
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class visitor_int8_calibration
+        {
+        public:
+            enum action_type { begin_calibration, end_calibration, disable };
+
+            visitor_int8_calibration(action_type action_) : action(action_) {}
+
+            template <typename input_layer_type>
+            void operator()(size_t , input_layer_type& ) const
+            {
+                // ignore other layers
+            }
+
+            template <typename T, typename U, typename E>
+            void operator()(size_t , add_layer<T,U,E>& l) const
+            {
+                apply(l.layer_details());
+            }
+
+        private:
+
+            template <typename T>
+            void apply(T&) const
+            {
+                // ignore layer detail types that don't support int8 inference
+            }
+
+            // Grouped con_ layers don't have an int8 kernel, so only ungrouped ones are
+            // matched here.
+            template <long nf, long nr, long nc, int sy, int sx, int py, int px>
+            void apply(con_<nf,nr,nc,sy,sx,py,px,1>& l) const
+            {
+                apply_impl(l);
+            }
+
+            template <unsigned long no, fc_bias_mode bm>
+            void apply(fc_<no,bm>& l) const
+            {
+                apply_impl(l);
+            }
+
+            template <typename T>
+            void apply_impl(T& l) const
+            {
+                switch (action)
+                {
+                    case begin_calibration: l.begin_int8_calibration(); break;
+                    case end_calibration: l.end_int8_calibration(); break;
+                    case disable: l.disable_int8(); break;
+                }
+            }
+
+            action_type action;
+        };
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename net_type
+        >
+    void disable_int8_inference (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_int8_calibration(impl::visitor_int8_calibration::disable));
+    }
+
+    template <
+        typename net_type,
+        typename input_type
+        >
+    void calibrate_int8_inference (
+        net_type& net,
+        const std::vector<input_type>& samples,
+        const size_t mini_batch_size = 32
+    )
+    {
+        DLIB_CASSERT(samples.size() > 0);
+        DLIB_CASSERT(mini_batch_size > 0);
+
+        disable_int8_inference(net);
+        visit_layers(net, impl::visitor_int8_calibration(impl::visitor_int8_calibration::begin_calibration));
+        resizable_tensor temp;
+        for (size_t i = 0; i < samples.size(); i += mini_batch_size)
+        {
+            auto end = samples.begin() + std::min(i+mini_batch_size, samples.size());
+            net.to_tensor(samples.begin()+i, end, temp);
+            net.forward(temp);
+        }
+        visit_layers(net, impl::visitor_int8_calibration(impl::visitor_int8_calibration::end_calibration));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_QUANTIZATION_H_
+
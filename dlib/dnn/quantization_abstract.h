@@ -0,0 +1,74 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_QUANTIZATION_ABSTRACT_H_
+#ifdef DLIB_DNn_QUANTIZATION_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include "layers_abstract.h"
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename net_type,
+        typename input_type
+        >
+    void calibrate_int8_inference (
+        net_type& net,
+        const std::vector<input_type>& samples,
+        const size_t mini_batch_size = 32
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+            - net.to_tensor() can be called on samples.
+            - samples.size() > 0
+            - mini_batch_size > 0
+        ensures
+            - Switches every con_ and fc_ layer in net to int8 inference.  This is done by
+              running all the samples through net, in batches of mini_batch_size, and
+              recording the largest absolute value each of those layers sees at its
+              input.  That value becomes the layer's input quantization scale, and the
+              layer's weights are quantized to int8 with one scale per output channel
+              (see con_::end_int8_calibration() and fc_::end_int8_calibration()).
+            - After this call, the quantized layers run their forward pass using int8
+              kernels on the CPU, and they are serialized in a compact format that stores
+              only the int8 weights.  The float parameters in net are overwritten with
+              the dequantized int8 weights so they agree with what is saved to disk.
+            - The 4x size reduction of the quantized weights only applies to the
+              serialized network.  In memory each quantized layer keeps its float
+              parameters, which backward(), get_layer_params(), and dnn_graph use, and
+              adds a copy of its weights widened to 16 bits for the int8 kernels.  So
+              the loaded network uses about 50% more RAM for those weights, not less.
+            - Other layers, including affine_ and bn_, keep running in float.  The
+              samples should therefore be run through the same network type you intend
+              to deploy, e.g. one that uses affine_ rather than bn_ layers.
+            - The samples should be representative of the data the network will see,
+              since inputs larger than anything seen during calibration are clipped.
+    !*/
+
+    template <
+        typename net_type
+        >
+    void disable_int8_inference (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Switches every con_ and fc_ layer in net back to float inference.  Note that
+              the float parameters keep the precision lost during quantization.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_QUANTIZATION_ABSTRACT_H_
+
@@ -0,0 +1,144 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_SHARED_NET_H_
+#define DLIB_DNn_SHARED_NET_H_
+
+#include "shared_net_abstract.h"
+#include "core.h"
+#include "../serialize.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class shared_net
+    {
+    public:
+        typedef NET_TYPE net_type;
+
+        explicit shared_net (
+            const net_type& net
+        ) : contexts_made(0)
+        {
+            // Snapshot the network as an in-memory mapped archive.  All the parameter
+            // tensors become aligned blocks in it, which every context then points into.
+            std::string bytes;
+            {
+                std::ostringstream sout;
+                mapped_archive_writer archive(sout);
+                std::ostream out(&archive);
+                serialize(net, out);
+                out.flush();
+                if (!out)
+                    throw serialization_error("shared_net: unable to snapshot the network.");
+                bytes = sout.str();
+            }
+            params = std::make_shared<mapped_file>(bytes.data(), bytes.size());
+        }
+
+        net_type make_context (
+        ) const
+        {
+            net_type net;
+            mapped_archive_reader archive(params);
+            std::istream in(&archive);
+            deserialize(net, in);
+            return net;
+        }
+
+        size_t num_contexts (
+        ) const
+        {
+            std::lock_guard<std::mutex> lock(m);
+            return contexts_made;
+        }
+
+        template <typename... T>
+        auto operator() (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>()(std::forward<T>(args)...))>::type
+        {
+            context_lease c(*this);
+            return (*c.net)(std::forward<T>(args)...);
+        }
+
+        template <typename... T>
+        auto process (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>().process(std::forward<T>(args)...))>::type
+        {
+            context_lease c(*this);
+            return c.net->process(std::forward<T>(args)...);
+        }
+
+        template <typename... T>
+        auto process_batch (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>().process_batch(std::forward<T>(args)...))>::type
+        {
+            context_lease c(*this);
+            return c.net->process_batch(std::forward<T>(args)...);
+        }
+
+    private:
+
+        struct context_lease
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    Takes an idle context from the pool, making a new one if there
+                    aren't any, and puts it back when destructed.
+            !*/
+            explicit context_lease (
+                const shared_net& owner_
+            ) : owner(owner_)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(owner.m);
+                    if (!owner.idle.empty())
+                    {
+                        net = std::move(owner.idle.back());
+                        owner.idle.pop_back();
+                        return;
+                    }
+                }
+                net.reset(new net_type(owner.make_context()));
+                std::lock_guard<std::mutex> lock(owner.m);
+                ++owner.contexts_made;
+            }
+
+            ~context_lease (
+            )
+            {
+                std::lock_guard<std::mutex> lock(owner.m);
+                owner.idle.push_back(std::move(net));
+            }
+
+            const shared_net& owner;
+            std::unique_ptr<net_type> net;
+        };
+
+        std::shared_ptr<mapped_file> params;
+        mutable std::mutex m;
+        mutable std::vector<std::unique_ptr<net_type>> idle;
+        mutable size_t contexts_made;
+
+        // restricted functions
+        shared_net(const shared_net&);
+        shared_net& operator=(const shared_net&);
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_SHARED_NET_H_
+
@@ -0,0 +1,133 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_SHARED_NET_ABSTRACT_H_
+#ifdef DLIB_DNn_SHARED_NET_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include "../serialize.h"
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename NET_TYPE
+        >
+    class shared_net
+    {
+        /*!
+            REQUIREMENTS ON NET_TYPE
+                NET_TYPE is an object of type add_layer, add_loss_layer, add_skip_layer, or
+                add_tag_layer.
+
+            WHAT THIS OBJECT REPRESENTS
+                This object lets many threads run a network at the same time without each
+                of them needing its own copy of the network's parameters.
+
+                A network object holds its parameters together with the state of the
+                last call to it, i.e. the outputs and gradients of every layer.  So
+                normally two threads can't use one network at the same time and you have
+                to give each thread its own copy, which duplicates all the parameters.
+                A shared_net instead holds a single, immutable copy of the parameters
+                and hands out "execution contexts".  A context is a regular network
+                object whose parameter tensors point into the shared copy.  So a context
+                only costs the memory for its layers' outputs and workspaces.
+
+                You can either call make_context() and give each of your threads its own
+                context, or simply call operator(), process() or process_batch() on the
+                shared_net from any number of threads.  Those pick an idle context from
+                an internal pool (making a new one if every context is busy), run it,
+                and put it back.
+
+                The parameters are shared by way of an in-memory mapped archive (see
+                serialize_mapped()).  So all tensors that are part of the serialized
+                network state are shared.  Anything a layer stores in another form, like
+                the int8 weights of a layer that has been calibrated for int8 inference,
+                is copied into each context.  If DLIB_USE_CUDA is defined every context
+                gets its own copy of the parameters since they need to live on the GPU.
+
+            THREAD SAFETY
+                All the member functions of this object are thread safe.  However, each
+                context returned by make_context() must only be used by one thread at a
+                time.  Contexts must also not modify their parameters, since those are
+                shared with every other context.  This means you can't train them, and
+                also that you shouldn't give more than one sample at a time to a network
+                containing bn_ layers since that updates their running statistics.
+                Replace bn_ layers with affine_ layers for inference, as usual.
+        !*/
+
+    public:
+        typedef NET_TYPE net_type;
+
+        explicit shared_net (
+            const net_type& net
+        );
+        /*!
+            ensures
+                - #*this holds a copy of the parameters of net.  net itself isn't
+                  referenced after this call, so you can modify or destroy it.
+                - #num_contexts() == 0
+        !*/
+
+        net_type make_context (
+        ) const;
+        /*!
+            ensures
+                - returns a network that is identical to the network given to this
+                  object's constructor, except that its parameters live in *this and are
+                  shared by all contexts.  The parameter memory stays alive until both
+                  *this and all the contexts are destroyed.
+        !*/
+
+        size_t num_contexts (
+        ) const;
+        /*!
+            ensures
+                - returns the number of contexts that have been created by
+                  operator(), process() and process_batch().  This is the largest number
+                  of those calls that were ever running at the same time.
+        !*/
+
+        template <typename... T>
+        auto operator() (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>()(std::forward<T>(args)...))>::type;
+        /*!
+            requires
+                - net_type is an add_loss_layer.
+            ensures
+                - runs ctx(args...) on an idle context ctx and returns a copy of the
+                  result.  E.g. net(img) returns the label for img and net(images) the
+                  labels for a std::vector of images.
+        !*/
+
+        template <typename... T>
+        auto process (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>().process(std::forward<T>(args)...))>::type;
+        /*!
+            requires
+                - net_type is an add_loss_layer.
+            ensures
+                - returns a copy of ctx.process(args...) for an idle context ctx.
+        !*/
+
+        template <typename... T>
+        auto process_batch (
+            T&&... args
+        ) const -> typename std::decay<decltype(std::declval<net_type&>().process_batch(std::forward<T>(args)...))>::type;
+        /*!
+            requires
+                - net_type is an add_loss_layer.
+            ensures
+                - returns ctx.process_batch(args...) for an idle context ctx.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_SHARED_NET_ABSTRACT_H_
+
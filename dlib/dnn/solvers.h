@@ -77,11 +77,12 @@ namespace dlib
             int _stride_y,
             int _stride_x,
             int _padding_y,
-            int _padding_x
+            int _padding_x,
+            int _groups
             >
         const tensor& operator() (
             const float learning_rate,
-            const con_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x>& l,
+            const con_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x,_groups>& l,
             const tensor& params_grad
         )
         {
@@ -96,11 +97,12 @@ namespace dlib
             int _stride_y,
             int _stride_x,
             int _padding_y,
-            int _padding_x
+            int _padding_x,
+            int _groups
             >
         const tensor& operator() (
             const float learning_rate,
-            const cont_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x>& l,
+            const cont_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x,_groups>& l,
             const tensor& params_grad
         )
         {
@@ -268,11 +270,12 @@ namespace dlib
             int _stride_y,
             int _stride_x,
             int _padding_y,
-            int _padding_x
+            int _padding_x,
+            int _groups
             >
         const tensor& operator() (
             const float learning_rate,
-            const con_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x>& l,
+            const con_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x,_groups>& l,
             const tensor& params_grad
         )
         {
@@ -287,11 +290,12 @@ namespace dlib
             int _stride_y,
             int _stride_x,
             int _padding_y,
-            int _padding_x
+            int _padding_x,
+            int _groups
             >
         const tensor& operator() (
             const float learning_rate,
-            const cont_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x>& l,
+            const cont_<_num_filters,_nr,_nc,_stride_y,_stride_x,_padding_y,_padding_x,_groups>& l,
             const tensor& params_grad
         )
         {
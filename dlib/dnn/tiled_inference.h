@@ -0,0 +1,162 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_TILED_INFERENCE_H_
+#define DLIB_DNn_TILED_INFERENCE_H_
+
+#include "tiled_inference_abstract.h"
+#include "core.h"
+#include "utilities.h"
+#include "../matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        struct tile_span
+        {
+            long start;         // first input pixel of the tile
+            long valid_begin;   // the range of pixels this tile writes into the output
+            long valid_end;
+        };
+
+        inline std::vector<tile_span> tile_spans (
+            long length,
+            long tile_size,
+            long margin
+        )
+        /*!
+            requires
+                - tile_size > 2*margin
+            ensures
+                - returns the tiles covering [0, length), each of size min(tile_size,
+                  length).  Each tile only keeps the outputs that are at least margin
+                  pixels away from its edges, except at the edges of the whole input.
+                  Together the kept ranges partition [0, length).
+        !*/
+        {
+            std::vector<tile_span> spans;
+            if (length <= tile_size)
+            {
+                spans.push_back({0, 0, length});
+                return spans;
+            }
+
+            const long step = tile_size - 2*margin;
+            long valid_begin = 0;
+            for (long start = 0; ; start += step)
+            {
+                // The last tile is moved back so it ends exactly at the edge of the input.
+                // It then overlaps its neighbor by more than 2*margin, which is fine since
+                // it only writes the outputs its neighbor didn't.
+                const bool last = start + tile_size >= length;
+                if (last)
+                    start = length - tile_size;
+                const long valid_end = last ? length : start + tile_size - margin;
+                spans.push_back({start, valid_begin, valid_end});
+                if (last)
+                    break;
+                valid_begin = valid_end;
+            }
+            return spans;
+        }
+
+        inline long round_up (
+            long value,
+            long multiple
+        )
+        {
+            return (value + multiple - 1)/multiple*multiple;
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename net_type>
+    typename net_type::output_label_type tiled_inference (
+        net_type& net,
+        const typename net_type::input_type& img,
+        long tile_size = 512,
+        size_t tiles_per_batch = 4
+    )
+    {
+        DLIB_CASSERT(tile_size > 0 && tiles_per_batch > 0);
+
+        // Find out how much context each output pixel needs and how the net's strided
+        // layers sample the input.
+        drectangle field(dpoint(0,0), dpoint(0,0));
+        impl::visitor_net_receptive_field visitor(field);
+        visitor(net);
+        const dpoint center = output_tensor_to_input_tensor(net, dpoint(0,0));
+        DLIB_CASSERT(std::isfinite(field.left()) && std::isfinite(field.right()) &&
+                     std::isfinite(field.top()) && std::isfinite(field.bottom()),
+            "tiled_inference() can't be used with networks containing layers, such as global "
+            "pooling, whose outputs depend on the whole input.");
+
+        const long align_x = std::max(1L, std::lround(visitor.max_spacing.x()/visitor.spacing.x()));
+        const long align_y = std::max(1L, std::lround(visitor.max_spacing.y()/visitor.spacing.y()));
+        const long margin_x = impl::round_up(static_cast<long>(std::ceil(std::max(
+            center.x()-field.left(), field.right()-center.x()))), align_x);
+        const long margin_y = impl::round_up(static_cast<long>(std::ceil(std::max(
+            center.y()-field.top(), field.bottom()-center.y()))), align_y);
+
+        // Tiles start at multiples of the alignment and each one keeps at least align
+        // output pixels after throwing away the margins.
+        const long tile_nc = std::max(impl::round_up(tile_size, align_x), 2*margin_x + align_x);
+        const long tile_nr = std::max(impl::round_up(tile_size, align_y), 2*margin_y + align_y);
+        const auto cols = impl::tile_spans(img.nc(), tile_nc, margin_x);
+        const auto rows = impl::tile_spans(img.nr(), tile_nr, margin_y);
+
+        typename net_type::output_label_type result(img.nr(), img.nc());
+
+        std::vector<typename net_type::input_type> batch;
+        std::vector<std::pair<impl::tile_span,impl::tile_span>> batch_spans;
+        batch.reserve(tiles_per_batch);
+        batch_spans.reserve(tiles_per_batch);
+        auto run_batch = [&]()
+        {
+            const auto labels = net(batch, tiles_per_batch);
+            for (size_t i = 0; i < labels.size(); ++i)
+            {
+                const auto& r = batch_spans[i].first;
+                const auto& c = batch_spans[i].second;
+                DLIB_CASSERT(labels[i].nr() == batch[i].nr() && labels[i].nc() == batch[i].nc(),
+                    "tiled_inference() requires a network whose output is the same size as its input."
+                    << "\n\t input size:  " << batch[i].nr() << "x" << batch[i].nc()
+                    << "\n\t output size: " << labels[i].nr() << "x" << labels[i].nc());
+                const rectangle valid(c.valid_begin, r.valid_begin, c.valid_end-1, r.valid_end-1);
+                set_subm(result, valid) = subm(labels[i], translate_rect(valid, -c.start, -r.start));
+            }
+            batch.clear();
+            batch_spans.clear();
+        };
+
+        for (const auto& r : rows)
+        {
+            for (const auto& c : cols)
+            {
+                batch.emplace_back(subm(img, rectangle(c.start, r.start,
+                    c.start + std::min(tile_nc, img.nc()) - 1,
+                    r.start + std::min(tile_nr, img.nr()) - 1)));
+                batch_spans.emplace_back(r, c);
+                if (batch.size() == tiles_per_batch)
+                    run_batch();
+            }
+        }
+        if (batch.size() != 0)
+            run_batch();
+
+        return result;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_TILED_INFERENCE_H_
+
@@ -0,0 +1,69 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_TILED_INFERENCE_ABSTRACT_H_
+#ifdef DLIB_DNn_TILED_INFERENCE_ABSTRACT_H_
+
+#include "core_abstract.h"
+#include "utilities_abstract.h"
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename net_type>
+    typename net_type::output_label_type tiled_inference (
+        net_type& net,
+        const typename net_type::input_type& img,
+        long tile_size = 512,
+        size_t tiles_per_batch = 4
+    );
+    /*!
+        requires
+            - net_type is an add_loss_layer object whose loss produces one label per input
+              pixel, e.g. loss_multiclass_log_per_pixel_, loss_binary_log_per_pixel_, or
+              loss_mean_squared_per_pixel_.  That is, net_type::input_type and
+              net_type::output_label_type are both dlib::matrix types and the network's
+              output is the same size as its input.
+            - receptive_field() must be usable with net and must return a finite rectangle.
+              So the network can't contain layers, like global pooling, whose outputs
+              depend on the whole input.
+            - tile_size > 0
+            - tiles_per_batch > 0
+        ensures
+            - Returns what net(img) returns, i.e. the per pixel labels for img, without
+              ever running the network on more than tiles_per_batch tiles of about
+              tile_size by tile_size pixels at a time.  So the memory needed by the
+              network is bounded by the tile size rather than the image size, which lets
+              you process images far too big to go through the network in one piece.
+            - img is split into overlapping tiles that all have the same size.  Each tile
+              is surrounded by a margin of context as wide as the network's
+              receptive_field().  The margin is thrown away after the tile is processed,
+              so every output pixel is computed from the same input pixels it would be
+              computed from if the whole image was given to the network.  Tiles at the
+              edges of img are kept inside img, so the network sees the same image borders
+              either way.  The result is seamless, and the only differences from net(img)
+              come from floating point rounding in the convolution routines.
+            - Tiles are placed at multiples of the network's largest downsampling factor.
+              Therefore strided layers sample every tile on the same grid they use for the
+              whole image.  The tile size is rounded up to that multiple, and to at least
+              twice the margin plus one multiple.  If img.nr() or img.nc() is not a
+              multiple of the downsampling factor, the last row or column of tiles is not
+              aligned either, and outputs near that edge may differ slightly from
+              net(img).
+            - upsample_ and resize_to_ interpolate on a grid that is stretched to fit the
+              size of their input, so their outputs depend on the size of the whole input
+              and not only on the pixels nearby.  For networks that contain them the tiles
+              only approximately match net(img).  Use cont_ layers for upsampling if you
+              need exact results.
+            - The tiles are given to the network in mini-batches of tiles_per_batch, so
+              the network processes the tiles in a batch together, just as it would
+              process a mini-batch of images.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_TILED_INFERENCE_ABSTRACT_H_
+
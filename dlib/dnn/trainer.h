@@ -6,6 +6,7 @@
 #include "trainer_abstract.h"
 #include "core.h"
 #include "solvers.h"
+#include "data_loader.h"
 #include "../statistics.h"
 #include <chrono>
 #include <fstream>
@@ -138,6 +139,14 @@ namespace dlib
             job_pipe.disable();
             stop();
             wait();
+            try
+            {
+                wait_for_pending_syncs(0);
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << "An error occurred while writing a dnn_trainer sync file: " << e.what() << std::endl;
+            }
         }
 
         net_type& get_net (
@@ -245,6 +254,16 @@ namespace dlib
             ++train_one_step_calls;
         }
 
+        void train_one_step (
+            dnn_data_loader<net_type>& loader
+        )
+        {
+            print_periodic_verbose_status();
+            sync_to_disk();
+            send_job(false, loader);
+            ++train_one_step_calls;
+        }
+
         void test_one_step (
             const std::vector<input_type>& data,
             const std::vector<training_label_type>& labels 
@@ -296,6 +315,16 @@ namespace dlib
             ++test_one_step_calls;
         }
 
+        void test_one_step (
+            dnn_data_loader<net_type>& loader
+        )
+        {
+            print_periodic_verbose_status();
+            sync_to_disk();
+            send_job(true, loader);
+            ++test_one_step_calls;
+        }
+
         void train (
             const std::vector<input_type>& data,
             const std::vector<training_label_type>& labels 
@@ -413,6 +442,7 @@ namespace dlib
             std::chrono::seconds time_between_syncs_ = std::chrono::minutes(15)
         )
         {
+            wait_for_pending_syncs(0);
             last_sync_time = std::chrono::system_clock::now();
             sync_filename = filename;
             time_between_syncs = time_between_syncs_;
@@ -429,6 +459,17 @@ namespace dlib
             return sync_filename;
         }
 
+        void set_max_pending_syncs (
+            size_t num
+        )
+        {
+            wait_for_pending_syncs(num);
+            max_pending_syncs = num;
+        }
+
+        size_t get_max_pending_syncs (
+        ) const { return max_pending_syncs; }
+
         double get_average_loss (
         ) const 
         { 
@@ -898,6 +939,12 @@ namespace dlib
             previous_loss_values_dump_amount = 400;
             test_previous_loss_values_dump_amount = 100;
 
+            loader_steps = 0;
+            loader_starved_steps = 0;
+            loader_starved_seconds = 0;
+
+            max_pending_syncs = 0;
+
             rs_test = running_stats_decayed<double>(200);
 
             start();
@@ -910,36 +957,49 @@ namespace dlib
         friend void serialize(const dnn_trainer& item, std::ostream& out)
         {
             item.wait_for_thread_to_pause();
+            item.serialize_state_before_net(out);
+            serialize(item.net, out);
+            serialize(item.devices[0]->solvers, out);
+            item.serialize_state_after_solvers(out);
+        }
+
+        // The serialized trainer state is everything written by these two functions with
+        // the net and solvers in between.  They are split up so that async syncs can
+        // write the small parts right away and only copy the net and solvers.
+        void serialize_state_before_net(std::ostream& out) const
+        {
             int version = 13;
             serialize(version, out);
 
             size_t nl = dnn_trainer::num_layers;
             serialize(nl, out);
-            serialize(item.rs, out);
-            serialize(item.rs_test, out);
-            serialize(item.previous_loss_values, out);
-            serialize(item.max_num_epochs, out);
-            serialize(item.mini_batch_size, out);
-            serialize(item.verbose, out);
-            serialize(item.net, out);
-            serialize(item.devices[0]->solvers, out);
-            serialize(item.learning_rate.load(), out);
-            serialize(item.min_learning_rate, out);
-            serialize(item.iter_without_progress_thresh.load(), out);
-            serialize(item.steps_without_progress.load(), out);
-            serialize(item.learning_rate_shrink.load(), out);
-            serialize(item.epoch_iteration, out);
-            serialize(item.epoch_pos, out);
-            serialize(item.train_one_step_calls, out);
-            serialize(item.test_one_step_calls, out);
-            serialize(item.lr_schedule, out);
-            serialize(item.lr_schedule_pos, out);
-            serialize(item.test_iter_without_progress_thresh.load(), out);
-            serialize(item.test_steps_without_progress.load(), out);
-            serialize(item.test_previous_loss_values, out);
-            serialize(item.previous_loss_values_dump_amount, out);
-            serialize(item.test_previous_loss_values_dump_amount, out);
-            serialize(item.previous_loss_values_to_keep_until_disk_sync, out);
+            serialize(rs, out);
+            serialize(rs_test, out);
+            serialize(previous_loss_values, out);
+            serialize(max_num_epochs, out);
+            serialize(mini_batch_size, out);
+            serialize(verbose, out);
+        }
+
+        void serialize_state_after_solvers(std::ostream& out) const
+        {
+            serialize(learning_rate.load(), out);
+            serialize(min_learning_rate, out);
+            serialize(iter_without_progress_thresh.load(), out);
+            serialize(steps_without_progress.load(), out);
+            serialize(learning_rate_shrink.load(), out);
+            serialize(epoch_iteration, out);
+            serialize(epoch_pos, out);
+            serialize(train_one_step_calls, out);
+            serialize(test_one_step_calls, out);
+            serialize(lr_schedule, out);
+            serialize(lr_schedule_pos, out);
+            serialize(test_iter_without_progress_thresh.load(), out);
+            serialize(test_steps_without_progress.load(), out);
+            serialize(test_previous_loss_values, out);
+            serialize(previous_loss_values_dump_amount, out);
+            serialize(test_previous_loss_values_dump_amount, out);
+            serialize(previous_loss_values_to_keep_until_disk_sync, out);
         }
         friend void deserialize(dnn_trainer& item, std::istream& in)
         {
@@ -1020,6 +1080,17 @@ namespace dlib
         void sync_to_disk (
             bool do_it_now = false
         ) 
+        {
+            save_or_reload_sync_file(do_it_now);
+            // Async syncs are only on disk once their background write finishes, so a
+            // forced sync waits for them.  This also reports any errors they hit.
+            if (do_it_now)
+                wait_for_pending_syncs(0);
+        }
+
+        void save_or_reload_sync_file (
+            bool do_it_now
+        )
         {
             // don't sync anything if we haven't updated the network since the last sync
             if (!updated_net_since_last_sync)
@@ -1045,6 +1116,8 @@ namespace dlib
                 // previously saved state in the hopes that the problem won't reoccur.
                 if (loss_increased_since_last_disk_sync()) 
                 {
+                    // The newest sync file might still be being written.
+                    wait_for_pending_syncs(0);
                     std::ifstream fin(newest_syncfile(), std::ios::binary);
                     deserialize(*this, fin);
                     sync_file_reloaded = true;
@@ -1067,6 +1140,10 @@ namespace dlib
                         drop_some_test_previous_loss_values();
                     }
                 }
+                else if (max_pending_syncs != 0)
+                {
+                    start_async_sync();
+                }
                 else
                 {
 
@@ -1083,6 +1160,108 @@ namespace dlib
             }
         }
 
+        struct sync_snapshot
+        {
+            // A copy of everything serialize(dnn_trainer) writes.  Only the net and the
+            // solvers are big, so the rest is kept already serialized.
+            std::string state_before_net;
+            net_type net;
+            std::vector<solver_type> solvers;
+            std::string state_after_solvers;
+            std::string sync_filename;
+            bool verbose = false;
+            std::atomic<bool> done{false};
+        };
+
+        void start_async_sync (
+        )
+        {
+            // Don't let more than max_pending_syncs snapshots pile up if the disk can't
+            // keep up with us.
+            wait_for_pending_syncs(max_pending_syncs-1);
+
+            auto snap = std::make_shared<sync_snapshot>();
+            std::ostringstream sout;
+            serialize_state_before_net(sout);
+            snap->state_before_net = sout.str();
+            sout.str("");
+            serialize_state_after_solvers(sout);
+            snap->state_after_solvers = sout.str();
+            // Copying the tensors is much faster than serializing them.
+            snap->net = net;
+            snap->solvers = devices[0]->solvers;
+            snap->sync_filename = sync_filename;
+            snap->verbose = verbose;
+
+            if (!sync_writer)
+                sync_writer.reset(new thread_pool(1));
+            const uint64 id = sync_writer->add_task_by_value([snap]() {
+                try
+                {
+                    write_sync_snapshot(*snap);
+                }
+                catch (...)
+                {
+                    snap->done = true;
+                    throw;
+                }
+                snap->done = true;
+            });
+            pending_syncs.push_back(std::make_pair(id, snap));
+        }
+
+        static void write_sync_snapshot (
+            const sync_snapshot& snap
+        )
+        {
+            // The tasks run one at a time and in order, so picking the file here rather
+            // than in start_async_sync() makes sure consecutive syncs alternate between
+            // the two files.
+            const std::string filename = select_oldest_file(snap.sync_filename, snap.sync_filename + "_");
+            const std::string temp_filename = filename + ".tmp";
+            {
+                std::ofstream fout(temp_filename, std::ios::binary);
+                if (!fout)
+                    throw serialization_error("Unable to open " + temp_filename + " for writing.");
+                fout.write(snap.state_before_net.data(), snap.state_before_net.size());
+                serialize(snap.net, fout);
+                serialize(snap.solvers, fout);
+                fout.write(snap.state_after_solvers.data(), snap.state_after_solvers.size());
+                fout.flush();
+                if (!fout)
+                    throw serialization_error("Error writing to " + temp_filename + ".");
+            }
+
+            // Renaming the finished file into place means a crash during the write can't
+            // leave a truncated sync file behind.  Windows won't rename onto an existing
+            // file, so in that case remove it first.
+            if (std::rename(temp_filename.c_str(), filename.c_str()) != 0)
+            {
+                std::remove(filename.c_str());
+                if (std::rename(temp_filename.c_str(), filename.c_str()) != 0)
+                    throw serialization_error("Unable to rename " + temp_filename + " to " + filename + ".");
+            }
+
+            if (snap.verbose)
+                std::cout << "Saved state to " << filename << std::endl;
+        }
+
+        void wait_for_pending_syncs (
+            size_t max_remaining
+        )
+        {
+            // Also retire any writes that already finished so their errors are reported
+            // as soon as possible.
+            while (pending_syncs.size() > max_remaining ||
+                   (pending_syncs.size() != 0 && pending_syncs.front().second->done))
+            {
+                auto next = pending_syncs.front();
+                pending_syncs.pop_front();
+                // rethrows any exception from the write
+                sync_writer->wait_for_task(next.first);
+            }
+        }
+
         std::string newest_syncfile (
         )
         {
@@ -1237,6 +1416,74 @@ namespace dlib
             send_job(test_only, dbegin, dend, nothing);
         }
 
+        void send_job (
+            bool test_only,
+            dnn_data_loader<net_type>& loader
+        )
+        {
+            propagate_exception();
+
+            const auto num_starved = loader.get_num_starved_mini_batches();
+            const double starved_seconds = loader.get_starved_seconds();
+            loader.get_next(loader_batch);
+            ++loader_steps;
+            loader_starved_steps += loader.get_num_starved_mini_batches()-num_starved;
+            loader_starved_seconds += loader.get_starved_seconds()-starved_seconds;
+
+            const size_t num = loader_batch.samples.size();
+            const size_t devs = devices.size();
+            const long long k = loader_batch.data.num_samples()/num;
+            job.t.resize(devs);
+            job.labels.resize(devs);
+            job.have_data.resize(devs);
+            job.test_only = test_only;
+
+            size_t block_size = (num+devs-1)/devs;
+
+            const auto prev_dev = dlib::cuda::get_device();
+            for (size_t i = 0; i < devs; ++i)
+            {
+                dlib::cuda::set_device(devices[i]->device_id);
+
+                // The tensor was made by the loader rather than by this network's
+                // to_tensor(), so the network doesn't know the sample expansion factor
+                // yet.  Calling to_tensor() on one sample tells it.
+                if (devices[i]->net.sample_expansion_factor() != static_cast<unsigned int>(k))
+                {
+                    resizable_tensor temp;
+                    devices[i]->net.to_tensor(loader_batch.samples.begin(), loader_batch.samples.begin()+1, temp);
+                }
+
+                size_t start = i*block_size;
+                size_t stop  = std::min(num, start+block_size);
+
+                if (start < stop)
+                {
+                    if (devs == 1)
+                    {
+                        job.t[i].swap(loader_batch.data);
+                        job.labels[i].swap(loader_batch.labels);
+                    }
+                    else
+                    {
+                        const tensor& data = loader_batch.data;
+                        alias_tensor block((stop-start)*k, data.k(), data.nr(), data.nc());
+                        job.t[i].set_size(block.num_samples(), block.k(), block.nr(), block.nc());
+                        memcpy(job.t[i], block(data, start*k*data.k()*data.nr()*data.nc()));
+                        job.labels[i].assign(loader_batch.labels.begin()+start, loader_batch.labels.begin()+stop);
+                    }
+                    job.have_data[i] = true;
+                }
+                else
+                {
+                    job.have_data[i] = false;
+                }
+            }
+
+            dlib::cuda::set_device(prev_dev);
+            job_pipe.enqueue(job);
+        }
+
         void print_progress()
         {
             if (lr_schedule.size() == 0)
@@ -1275,6 +1522,16 @@ namespace dlib
                         std::cout << "train loss: " << rpad(cast_to_string(get_average_loss()),string_pad) << "  ";
                         std::cout << "test loss: " << rpad(cast_to_string(get_average_test_loss()),string_pad) << "  ";
                     }
+                    if (loader_steps != 0)
+                    {
+                        std::ostringstream sout;
+                        sout << "loader starved: " << loader_starved_steps << "/" << loader_steps
+                             << " steps (" << std::fixed << std::setprecision(1) << loader_starved_seconds << "s)  ";
+                        std::cout << sout.str();
+                        loader_steps = 0;
+                        loader_starved_steps = 0;
+                        loader_starved_seconds = 0;
+                    }
                     print_progress();
                     clear_average_loss();
                 }
@@ -1338,6 +1595,19 @@ namespace dlib
         bool sync_file_reloaded;
         unsigned long previous_loss_values_dump_amount;
         unsigned long test_previous_loss_values_dump_amount;
+
+        // These are used by train_one_step(loader) and test_one_step(loader) and are
+        // also not serialized.
+        typename dnn_data_loader<net_type>::mini_batch loader_batch;
+        unsigned long long loader_steps;
+        unsigned long long loader_starved_steps;
+        double loader_starved_seconds;
+
+        // Used for async syncs and not serialized.  pending_syncs holds the thread_pool
+        // task id of each snapshot that is still being written.
+        size_t max_pending_syncs;
+        std::deque<std::pair<uint64, std::shared_ptr<sync_snapshot>>> pending_syncs;
+        std::unique_ptr<thread_pool> sync_writer;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -5,6 +5,7 @@
 
 #include "core_abstract.h"
 #include "solvers_abstract.h"
+#include "data_loader_abstract.h"
 #include <vector>
 #include <chrono>
 
@@ -92,6 +93,7 @@ namespace dlib
                 - #get_train_one_step_calls() == 0
                 - #get_test_one_step_calls() == 0
                 - #get_synchronization_file() == ""
+                - #get_max_pending_syncs() == 0
                 - if (cuda_extra_devices.size() > 0) then
                     - This object will use multiple graphics cards to run the learning
                       algorithms.  In particular, it will always use whatever device is
@@ -392,6 +394,37 @@ namespace dlib
                   state to.  If the return value is "" then synchronization is disabled.
         !*/
 
+        void set_max_pending_syncs (
+            size_t num
+        );
+        /*!
+            ensures
+                - #get_max_pending_syncs() == num
+                - if (num == 0) then
+                    - Syncs to the synchronization file are done synchronously.  That is,
+                      training stops while the whole trainer state is serialized to disk.
+                - else
+                    - Syncs are done asynchronously.  The trainer makes an in memory copy
+                      of its state, i.e. of the network and the solvers, and training
+                      continues while a background thread serializes the copy to a
+                      temporary file and then renames it onto the sync file.  At most num
+                      of these copies are kept in memory waiting to be written.  If a new
+                      sync is due while num are still pending then the trainer waits for
+                      the oldest one to finish.
+                    - Any error from writing a sync file is thrown by the first call that
+                      syncs to disk after the write fails.
+                - Syncs forced by get_net() or by train() finishing always wait for every
+                  pending write, so the sync files are complete once those calls return.
+        !*/
+
+        size_t get_max_pending_syncs (
+        ) const;
+        /*!
+            ensures
+                - returns the maximum number of asynchronous syncs that may be waiting to
+                  be written to disk.  0 means syncs are synchronous.
+        !*/
+
         void train (
             const std::vector<input_type>& data,
             const std::vector<training_label_type>& labels 
@@ -558,6 +591,31 @@ namespace dlib
                   accessing the network.
                 - #get_train_one_step_calls() == get_train_one_step_calls() + 1.
         !*/
+
+        void train_one_step (
+            dnn_data_loader<net_type>& loader
+        );
+        /*!
+            ensures
+                - Performs one stochastic gradient update step based on the next
+                  mini-batch from loader.get_next().  This is like calling
+                  train_one_step() with the samples and labels of that mini-batch, except
+                  that the samples have already been converted into a tensor by loader's
+                  worker threads, so the calling thread only has to wait for them if the
+                  loader isn't keeping up.
+                - If be_verbose() has been called then the periodic status messages also
+                  say how many of the mini-batches since the last message the loader
+                  wasn't able to provide in time, and how long the trainer waited for
+                  them in total.
+                - You can observe the current average loss value by calling get_average_loss().
+                - The network training will happen in another thread.  Therefore, after
+                  calling this function you should call get_net() before you touch the net
+                  object from the calling thread to ensure no other threads are still
+                  accessing the network.
+                - #get_train_one_step_calls() == get_train_one_step_calls() + 1.
+            throws
+                - any exception thrown by loader.get_next().
+        !*/
         
         double get_average_loss (
         ) const;
@@ -712,6 +770,25 @@ namespace dlib
                 - #get_test_one_step_calls() == get_test_one_step_calls() + 1.
         !*/
 
+        void test_one_step (
+            dnn_data_loader<net_type>& loader
+        );
+        /*!
+            ensures
+                - Runs the next mini-batch from loader.get_next() through the network and
+                  computes and records the loss.  This is like calling test_one_step()
+                  with the samples and labels of that mini-batch.
+                - This call does not modify network parameters.
+                - You can observe the current average loss value by calling get_average_test_loss().
+                - The computation will happen in another thread.  Therefore, after calling
+                  this function you should call get_net() before you touch the net object
+                  from the calling thread to ensure no other threads are still accessing
+                  the network.
+                - #get_test_one_step_calls() == get_test_one_step_calls() + 1.
+            throws
+                - any exception thrown by loader.get_next().
+        !*/
+
         void set_test_iterations_without_progress_threshold (
             unsigned long thresh 
         );
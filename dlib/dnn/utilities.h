@@ -271,6 +271,171 @@ namespace dlib
         return p;
     }
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class visitor_net_receptive_field
+        {
+            /*!
+                Walks the same path through the network as visitor_net_map_output_to_input
+                but maps a whole rectangle, growing it by the extent of each layer that
+                looks at a neighborhood of its input.  It also records the coarsest sample
+                spacing of any layer on the path, measured in input pixels, which is the
+                alignment a tile of the input needs so that every layer sees the same
+                sampling grid it would see when processing the whole input.
+            !*/
+        public:
+            visitor_net_receptive_field(drectangle& rect_) : rect(rect_) {}
+
+            drectangle& rect;
+            // The spacing of the current layer's output samples, in units of the spacing of
+            // the net's output samples, and the largest such spacing seen so far.
+            dpoint spacing = dpoint(1,1);
+            dpoint max_spacing = dpoint(1,1);
+
+            template<typename input_layer_type>
+            void operator()(const input_layer_type& ) 
+            {
+            }
+
+            template <typename T, typename U>
+            void operator()(const add_loss_layer<T,U>& net) 
+            {
+                (*this)(net.subnet());
+            }
+
+            template <typename T, typename U, typename E>
+            void operator()(const add_layer<T,U,E>& net) 
+            {
+                grow(net.layer_details());
+                (*this)(net.subnet());
+            }
+            template <bool B, typename T, typename U, typename E>
+            void operator()(const dimpl::subnet_wrapper<add_layer<T,U,E>,B>& net) 
+            {
+                grow(net.layer_details());
+                (*this)(net.subnet());
+            }
+
+
+            template <unsigned long ID, typename U, typename E>
+            void operator()(const add_tag_layer<ID,U,E>& net) 
+            {
+                // tag layers are an identity transform, so do nothing
+                (*this)(net.subnet());
+            }
+            template <bool is_first, unsigned long ID, typename U, typename E>
+            void operator()(const dimpl::subnet_wrapper<add_tag_layer<ID,U,E>,is_first>& net) 
+            {
+                // tag layers are an identity transform, so do nothing
+                (*this)(net.subnet());
+            }
+
+
+            template <template<typename> class TAG_TYPE, typename U>
+            void operator()(const add_skip_layer<TAG_TYPE,U>& net) 
+            {
+                (*this)(layer<TAG_TYPE>(net));
+            }
+            template <bool is_first, template<typename> class TAG_TYPE, typename SUBNET>
+            void operator()(const dimpl::subnet_wrapper<add_skip_layer<TAG_TYPE,SUBNET>,is_first>& net) 
+            {
+                (*this)(layer<TAG_TYPE>(net));
+            }
+
+        private:
+
+            template <typename layer_type>
+            void grow (
+                const layer_type& l
+            )
+            {
+                const dpoint o = l.map_output_to_input(dpoint(0,0));
+                const dpoint d = l.map_output_to_input(dpoint(1,1)) - o;
+                rect = drectangle(l.map_output_to_input(rect.tl_corner()),
+                                  l.map_output_to_input(rect.br_corner()));
+                grow_by_filter(l, d, 0);
+                spacing.x() /= d.x();
+                spacing.y() /= d.y();
+                max_spacing.x() = std::max(max_spacing.x(), spacing.x());
+                max_spacing.y() = std::max(max_spacing.y(), spacing.y());
+            }
+
+            // Layers with a filter size, i.e. con_, cont_, max_pool_ and avg_pool_.  d is
+            // the distance, in input pixels, between adjacent output samples.  A strided
+            // convolution (d > 1) reads its whole filter window in input pixels, a
+            // transposed convolution (d < 1) reaches its filter size in output pixels.
+            // Using the larger half of the filter on both sides covers even sized filters
+            // no matter which way they are offset.
+            template <typename layer_type>
+            auto grow_by_filter (
+                const layer_type& l,
+                const dpoint& d,
+                int
+            ) -> decltype(void(l.nr()), void(l.nc()))
+            {
+                grow_x(l.nc(), d.x());
+                grow_y(l.nr(), d.y());
+            }
+
+            // Every other layer either works on single pixels, in which case there is
+            // nothing to do, or resamples its input, e.g. upsample_ and resize_to_, in
+            // which case it interpolates between the neighboring input pixels.
+            template <typename layer_type>
+            void grow_by_filter (
+                const layer_type& ,
+                const dpoint& d,
+                long
+            )
+            {
+                if (d.x() < 1)
+                    grow_x(2, 1);
+                if (d.y() < 1)
+                    grow_y(2, 1);
+            }
+
+            void grow_x (long size, double d)
+            {
+                if (size == 0)
+                {
+                    // A filter size of 0 means the layer looks at the whole input.
+                    rect.left() = -std::numeric_limits<double>::infinity();
+                    rect.right() = std::numeric_limits<double>::infinity();
+                    return;
+                }
+                const double extent = (size-1-(size-1)/2)*std::min(d, 1.0);
+                rect.left() -= extent;
+                rect.right() += extent;
+            }
+
+            void grow_y (long size, double d)
+            {
+                if (size == 0)
+                {
+                    rect.top() = -std::numeric_limits<double>::infinity();
+                    rect.bottom() = std::numeric_limits<double>::infinity();
+                    return;
+                }
+                const double extent = (size-1-(size-1)/2)*std::min(d, 1.0);
+                rect.top() -= extent;
+                rect.bottom() += extent;
+            }
+        };
+    }
+
+    template <typename net_type>
+    inline drectangle receptive_field(
+        const net_type& net,
+        dpoint p
+    )
+    {
+        drectangle rect(p, p);
+        impl::visitor_net_receptive_field temp(rect);
+        temp(net);
+        return rect;
+    }
+
 // ----------------------------------------------------------------------------------------
 
     namespace impl
@@ -118,6 +118,41 @@ namespace dlib
               in the input tensor?
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename net_type>
+    drectangle receptive_field(
+        const net_type& net,
+        dpoint p  
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+            - All layers in the net must provide map_output_to_input() functions.
+        ensures
+            - Returns the part of the input tensor that can influence the value of
+              net.get_output() at the point p.  That is, this function returns a rectangle
+              containing output_tensor_to_input_tensor(net,p) that also contains every
+              input pixel the network looks at when computing that output.  Tiling large
+              inputs, as tiled_inference() does, relies on this to know how much context
+              each tile needs.
+            - Layers with nr() and nc() methods (e.g. con_, cont_, max_pool_, and
+              avg_pool_) grow the rectangle by their filter size.  Layers that resample
+              their input without a filter (e.g. upsample_) grow it by one input pixel on
+              each side, since they interpolate between neighboring pixels.  Any other
+              layer is assumed to work on each pixel independently.  For even sized filters
+              the rectangle is grown by the larger half on both sides, so the result may be
+              a pixel larger than strictly necessary.
+            - If a layer has a filter size of 0, meaning it looks at its whole input (e.g.
+              global pooling), the returned rectangle is infinitely large in that
+              dimension.
+            - Like output_tensor_to_input_tensor(), this function follows skip layers and
+              ignores any branches of the network that are not on that path.  So for
+              networks that combine branches, e.g. with concat_ or add_prev_, the result
+              only accounts for the branch the skip layers lead to.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <typename net_type>
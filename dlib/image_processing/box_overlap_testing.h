@@ -5,6 +5,9 @@
 
 #include "box_overlap_testing_abstract.h"
 #include "../geometry.h"
+#include "../uintn.h"
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 namespace dlib
@@ -207,6 +210,198 @@ namespace dlib
         return overlaps_any_box(test_box_overlap(),rects,rect);
     }
 
+// ----------------------------------------------------------------------------------------
+
+    class box_overlap_index
+    {
+    public:
+        box_overlap_index (
+        ) : box_overlap_index(test_box_overlap()) {}
+
+        explicit box_overlap_index (
+            const test_box_overlap& tester_,
+            long cell_size_ = 0
+        ) : tester(tester_), initial_cell_size(cell_size_), cell_size(cell_size_)
+        {
+            DLIB_ASSERT(cell_size_ >= 0,
+                "\t box_overlap_index::box_overlap_index(tester, cell_size)"
+                << "\n\t Invalid inputs were given to this function "
+                << "\n\t cell_size: " << cell_size_
+                );
+        }
+
+        const test_box_overlap& get_overlap_tester (
+        ) const { return tester; }
+
+        long get_cell_size (
+        ) const { return cell_size; }
+
+        size_t size (
+        ) const { return boxes.size(); }
+
+        const std::vector<rectangle>& get_boxes (
+        ) const { return boxes; }
+
+        void clear (
+        )
+        {
+            boxes.clear();
+            cells.clear();
+            large_boxes.clear();
+            cell_size = initial_cell_size;
+            num_indexed = 0;
+        }
+
+        bool overlaps_any_box (
+            const rectangle& rect
+        ) const
+        {
+            // test_box_overlap never reports boxes that don't intersect as overlapping,
+            // so we only need to look at the boxes that share a grid cell with rect.
+            if (rect.is_empty() || boxes.size() == 0)
+                return false;
+
+            for (auto i : large_boxes)
+            {
+                if (tester(boxes[i], rect))
+                    return true;
+            }
+            if (num_indexed == 0)
+                return false;
+
+            const cell_range cr = get_cell_range(rect);
+            if (cr.num_cells() > num_indexed)
+            {
+                // It's cheaper to just check every box than to visit all these cells.
+                for (auto& b : boxes)
+                {
+                    if (tester(b, rect))
+                        return true;
+                }
+                return false;
+            }
+
+            for (long y = cr.top; y <= cr.bottom; ++y)
+            {
+                for (long x = cr.left; x <= cr.right; ++x)
+                {
+                    auto c = cells.find(cell_key(x,y));
+                    if (c == cells.end())
+                        continue;
+                    for (auto i : c->second)
+                    {
+                        if (tester(boxes[i], rect))
+                            return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void add (
+            const rectangle& rect
+        )
+        {
+            boxes.push_back(rect);
+            if (rect.is_empty())
+                return;
+            if (cell_size == 0)
+                cell_size = std::max<long>(1, std::max(rect.width(), rect.height()));
+            index_box(boxes.size()-1);
+
+            // If most boxes are much bigger than the grid cells then pick a bigger cell size
+            // and rebuild the grid.
+            if (large_boxes.size() > std::max<size_t>(32, num_indexed))
+                rebuild_grid();
+        }
+
+    private:
+
+        struct cell_range
+        {
+            long left, top, right, bottom;
+            double num_cells() const { return (right-left+1.0)*(bottom-top+1.0); }
+        };
+
+        static long floor_div (
+            long x,
+            long d
+        )
+        {
+            return x >= 0 ? x/d : -((-(x+1))/d) - 1;
+        }
+
+        cell_range get_cell_range (
+            const rectangle& rect
+        ) const
+        {
+            cell_range cr;
+            cr.left = floor_div(rect.left(), cell_size);
+            cr.top = floor_div(rect.top(), cell_size);
+            cr.right = floor_div(rect.right(), cell_size);
+            cr.bottom = floor_div(rect.bottom(), cell_size);
+            return cr;
+        }
+
+        static uint64 cell_key (
+            long x,
+            long y
+        )
+        {
+            return (static_cast<uint64>(static_cast<uint32>(x))<<32) | static_cast<uint32>(y);
+        }
+
+        void index_box (
+            unsigned long i
+        )
+        {
+            const cell_range cr = get_cell_range(boxes[i]);
+            if (cr.num_cells() > max_cells_per_box)
+            {
+                large_boxes.push_back(i);
+                return;
+            }
+            for (long y = cr.top; y <= cr.bottom; ++y)
+            {
+                for (long x = cr.left; x <= cr.right; ++x)
+                    cells[cell_key(x,y)].push_back(i);
+            }
+            ++num_indexed;
+        }
+
+        void rebuild_grid (
+        )
+        {
+            std::vector<long> sizes;
+            for (auto& b : boxes)
+            {
+                if (!b.is_empty())
+                    sizes.push_back(std::max(b.width(), b.height()));
+            }
+            std::nth_element(sizes.begin(), sizes.begin()+sizes.size()/2, sizes.end());
+            cell_size = std::max(2*cell_size, sizes[sizes.size()/2]);
+
+            cells.clear();
+            large_boxes.clear();
+            num_indexed = 0;
+            for (unsigned long i = 0; i < boxes.size(); ++i)
+            {
+                if (!boxes[i].is_empty())
+                    index_box(i);
+            }
+        }
+
+        const static long max_cells_per_box = 16;
+
+        test_box_overlap tester;
+        long initial_cell_size;
+        long cell_size;
+        std::vector<rectangle> boxes;
+        std::unordered_map<uint64, std::vector<unsigned long>> cells;
+        std::vector<unsigned long> large_boxes;
+        size_t num_indexed = 0;
+    };
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -192,6 +192,123 @@ namespace dlib
             - returns overlaps_any_box(test_box_overlap(), rects, rect)
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    class box_overlap_index
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object is a set of rectangles that can quickly tell you if a new
+                rectangle overlaps any of them according to a test_box_overlap object.
+                That is, overlaps_any_box(rect) returns the same thing as
+                overlaps_any_box(get_overlap_tester(), get_boxes(), rect) but doesn't
+                compare rect against every box in the set.  Instead, the boxes are put into
+                a uniform grid and rect is only compared against boxes in the grid cells
+                it touches.  This works because test_box_overlap never considers boxes
+                that don't intersect to be overlapping.
+
+                The main use of this object is non-max suppression.  There you go over
+                detections in order of decreasing confidence and keep each one that
+                doesn't overlap a detection you already kept, like so:
+                    box_overlap_index kept(tester);
+                    for (auto& d : sorted_dets)
+                    {
+                        if (!kept.overlaps_any_box(d.rect))
+                        {
+                            kept.add(d.rect);
+                            final_dets.push_back(d);
+                        }
+                    }
+                Doing this with overlaps_any_box(tester, rects, rect) takes time quadratic
+                in the number of detections, while with this object it takes roughly
+                linear time when the detections are spread out over an image.  The
+                results are exactly the same either way.
+        !*/
+
+    public:
+        box_overlap_index (
+        );
+        /*!
+            ensures
+                - #get_overlap_tester() == test_box_overlap()
+                - #get_cell_size() == 0
+                - #size() == 0
+        !*/
+
+        explicit box_overlap_index (
+            const test_box_overlap& tester,
+            long cell_size = 0
+        );
+        /*!
+            requires
+                - cell_size >= 0
+            ensures
+                - #get_overlap_tester() == tester
+                - #get_cell_size() == cell_size
+                - #size() == 0
+                - if (cell_size == 0) then
+                    - the cell size is picked automatically when the first non-empty box
+                      is added, based on its size.
+        !*/
+
+        const test_box_overlap& get_overlap_tester (
+        ) const;
+        /*!
+            ensures
+                - returns the object used to decide if two boxes overlap.
+        !*/
+
+        long get_cell_size (
+        ) const;
+        /*!
+            ensures
+                - returns the width and height of the grid cells boxes are put into, or 0
+                  if it hasn't been picked yet.  The cell size only affects speed, not
+                  the results of overlaps_any_box().  If many boxes are much larger than
+                  the cells then add() automatically makes the cells bigger.
+        !*/
+
+        size_t size (
+        ) const;
+        /*!
+            ensures
+                - returns the number of boxes that have been added to *this.
+        !*/
+
+        const std::vector<rectangle>& get_boxes (
+        ) const;
+        /*!
+            ensures
+                - returns all the boxes added to *this, in the order they were added.
+        !*/
+
+        void clear (
+        );
+        /*!
+            ensures
+                - #size() == 0
+                - #get_cell_size() == the cell size given to the constructor.
+                - #get_overlap_tester() == get_overlap_tester()
+        !*/
+
+        bool overlaps_any_box (
+            const rectangle& rect
+        ) const;
+        /*!
+            ensures
+                - returns overlaps_any_box(get_overlap_tester(), get_boxes(), rect)
+        !*/
+
+        void add (
+            const rectangle& rect
+        );
+        /*!
+            ensures
+                - #size() == size() + 1
+                - #get_boxes().back() == rect
+        !*/
+    };
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -8,6 +8,9 @@
 #include <vector>
 #include "box_overlap_testing.h"
 #include "full_object_detection.h"
+#include "../threads/parallel_for_extension.h"
+#include <memory>
+#include <mutex>
 
 namespace dlib
 {
@@ -64,6 +67,49 @@ namespace dlib
         feature_vector_type w;
     };
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type_
+        >
+    class object_detector;
+
+    namespace impl
+    {
+        template <typename image_scanner_type>
+        class batch_detector
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object implements object_detector's batch operator().  This
+                    default version runs each image through its own copy of the detector's
+                    scanner, keeping the scanners around between calls so their buffers get
+                    reused.  Scanners that can split up the work more finely specialize
+                    this template (see scan_fhog_pyramid.h).
+            !*/
+        public:
+            template <typename image_type>
+            void operator() (
+                thread_pool& tp,
+                object_detector<image_scanner_type>& detector,
+                const std::vector<image_type>& imgs,
+                std::vector<std::vector<rect_detection> >& final_dets,
+                double adjust_threshold
+            );
+
+            void clear (
+            ) 
+            {
+                std::lock_guard<std::mutex> lock(m);
+                scanners.clear();
+            }
+
+        private:
+            std::mutex m;
+            std::vector<std::unique_ptr<image_scanner_type> > scanners;
+        };
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -177,6 +223,44 @@ namespace dlib
             double adjust_threshold = 0
         );
 
+        template <
+            typename image_type
+            >
+        void operator() (
+            thread_pool& tp,
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& final_dets,
+            double adjust_threshold = 0
+        );
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& final_dets,
+            double adjust_threshold = 0
+        ) { (*this)(default_thread_pool(), imgs, final_dets, adjust_threshold); }
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            thread_pool& tp,
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rectangle> >& final_dets,
+            double adjust_threshold = 0
+        );
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rectangle> >& final_dets,
+            double adjust_threshold = 0
+        ) { (*this)(default_thread_pool(), imgs, final_dets, adjust_threshold); }
+
         template <typename T>
         friend void serialize (
             const object_detector<T>& item,
@@ -190,23 +274,38 @@ namespace dlib
         );
 
     private:
+        friend class impl::batch_detector<image_scanner_type>;
 
-        bool overlaps_any_box (
-            const std::vector<rect_detection>& rects,
-            const dlib::rectangle& rect
-        ) const
-        {
-            for (unsigned long i = 0; i < rects.size(); ++i)
-            {
-                if (boxes_overlap(rects[i].rect, rect))
-                    return true;
-            }
-            return false;
-        }
+        template <
+            typename image_type
+            >
+        void detect (
+            image_scanner_type& scanner,
+            const image_type& img,
+            std::vector<rect_detection>& final_dets,
+            double adjust_threshold
+        ) const;
+        /*!
+            ensures
+                - runs the detector on img using the given scanner, which must have the
+                  same configuration as get_scanner().
+        !*/
+
+        void non_max_suppression (
+            std::vector<rect_detection>& dets_accum,
+            std::vector<rect_detection>& final_dets
+        ) const;
+        /*!
+            ensures
+                - #final_dets == the detections in dets_accum that survive non-max
+                  suppression, in order of decreasing confidence.
+                - dets_accum is sorted if num_detectors() > 1.
+        !*/
 
         test_box_overlap boxes_overlap;
         std::vector<processed_weight_vector<image_scanner_type> > w;
         image_scanner_type scanner;
+        impl::batch_detector<image_scanner_type> batcher;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -240,6 +339,7 @@ namespace dlib
     {
         int version = 0;
         deserialize(version, in);
+        item.batcher.clear();
         if (version == 1)
         {
             deserialize(item.scanner, in);
@@ -412,6 +512,7 @@ namespace dlib
         boxes_overlap = item.boxes_overlap;
         w = item.w;
         scanner.copy_configuration(item.scanner);
+        batcher.clear();
         return *this;
     }
 
@@ -429,6 +530,25 @@ namespace dlib
         std::vector<rect_detection>& final_dets,
         double adjust_threshold
     ) 
+    {
+        detect(scanner, img, final_dets, adjust_threshold);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    void object_detector<image_scanner_type>::
+    detect (
+        image_scanner_type& scanner,
+        const image_type& img,
+        std::vector<rect_detection>& final_dets,
+        double adjust_threshold
+    ) const
     {
         scanner.load(img);
         std::vector<std::pair<double, rectangle> > dets;
@@ -447,15 +567,30 @@ namespace dlib
             }
         }
 
-        // Do non-max suppression
+        non_max_suppression(dets_accum, final_dets);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    void object_detector<image_scanner_type>::
+    non_max_suppression (
+        std::vector<rect_detection>& dets_accum,
+        std::vector<rect_detection>& final_dets
+    ) const
+    {
         final_dets.clear();
         if (w.size() > 1)
             std::sort(dets_accum.rbegin(), dets_accum.rend());
+        box_overlap_index kept_boxes(boxes_overlap);
         for (unsigned long i = 0; i < dets_accum.size(); ++i)
         {
-            if (overlaps_any_box(final_dets, dets_accum[i].rect))
+            if (kept_boxes.overlaps_any_box(dets_accum[i].rect))
                 continue;
 
+            kept_boxes.add(dets_accum[i].rect);
             final_dets.push_back(dets_accum[i]);
         }
     }
@@ -593,6 +728,92 @@ namespace dlib
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    void object_detector<image_scanner_type>::
+    operator() (
+        thread_pool& tp,
+        const std::vector<image_type>& imgs,
+        std::vector<std::vector<rect_detection> >& final_dets,
+        double adjust_threshold
+    )
+    {
+        batcher(tp, *this, imgs, final_dets, adjust_threshold);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    void object_detector<image_scanner_type>::
+    operator() (
+        thread_pool& tp,
+        const std::vector<image_type>& imgs,
+        std::vector<std::vector<rectangle> >& final_dets,
+        double adjust_threshold
+    )
+    {
+        std::vector<std::vector<rect_detection> > dets;
+        (*this)(tp, imgs, dets, adjust_threshold);
+
+        final_dets.resize(dets.size());
+        for (unsigned long i = 0; i < dets.size(); ++i)
+        {
+            final_dets[i].resize(dets[i].size());
+            for (unsigned long j = 0; j < dets[i].size(); ++j)
+                final_dets[i][j] = dets[i][j].rect;
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename image_scanner_type>
+    template <typename image_type>
+    void impl::batch_detector<image_scanner_type>::
+    operator() (
+        thread_pool& tp,
+        object_detector<image_scanner_type>& detector,
+        const std::vector<image_type>& imgs,
+        std::vector<std::vector<rect_detection> >& final_dets,
+        double adjust_threshold
+    )
+    {
+        final_dets.resize(imgs.size());
+        parallel_for(tp, 0, imgs.size(), [&](long i)
+        {
+            // Borrow a scanner, making a new one only if all of them are in use.
+            std::unique_ptr<image_scanner_type> scanner;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (scanners.size() != 0)
+                {
+                    scanner = std::move(scanners.back());
+                    scanners.pop_back();
+                }
+            }
+            if (!scanner)
+            {
+                scanner.reset(new image_scanner_type);
+                scanner->copy_configuration(detector.scanner);
+            }
+
+            detector.detect(*scanner, imgs[i], final_dets[i], adjust_threshold);
+
+            std::lock_guard<std::mutex> lock(m);
+            scanners.push_back(std::move(scanner));
+        });
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -366,6 +366,86 @@ namespace dlib
                   it doesn't include a double valued score.  That is, it just outputs the
                   full_object_detections.
         !*/
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            thread_pool& tp,
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& dets,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs is an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - Runs the detector on all the images in imgs, using the threads in tp.
+                  The results are exactly the same as calling the single image version of
+                  operator() on each image, that is:
+                    - #dets.size() == imgs.size()
+                    - #dets[i] == the output of (*this)(imgs[i], dets[i], adjust_threshold)
+                - Buffers used to process the images are kept inside *this and reused by
+                  later calls, so this is the efficient way to process a stream of frames.
+                - For scan_fhog_pyramid based detectors (e.g. frontal_face_detector) the
+                  work is split up into (image, pyramid level) pairs, so even a batch with
+                  just one large image is spread over tp's threads.  Other scanners
+                  process each image in one thread, using a separate scanner per thread.
+                - Unlike the single image operator(), this function does not load any
+                  image into get_scanner().
+        !*/
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& dets,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs is an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - performs (*this)(default_thread_pool(), imgs, dets, adjust_threshold)
+        !*/
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            thread_pool& tp,
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rectangle> >& dets,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs is an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - This function is identical to the above batch operator() routine, except
+                  that it outputs just the bounding boxes of the detections.  That is,
+                  #dets[i] == (*this)(imgs[i], adjust_threshold).
+        !*/
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rectangle> >& dets,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs is an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - performs (*this)(default_thread_pool(), imgs, dets, adjust_threshold)
+        !*/
     };
 
 // ----------------------------------------------------------------------------------------
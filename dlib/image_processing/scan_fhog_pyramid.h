@@ -555,6 +555,27 @@ namespace dlib
 
     namespace impl
     {
+        template <
+            typename pyramid_type
+            >
+        unsigned long num_fhog_pyramid_levels (
+            rectangle rect,
+            unsigned long min_pyramid_layer_width,
+            unsigned long min_pyramid_layer_height,
+            unsigned long max_pyramid_levels
+        )
+        {
+            unsigned long levels = 0;
+            pyramid_type pyr;
+            do
+            {
+                rect = pyr.rect_down(rect);
+                ++levels;
+            } while (rect.width() >= min_pyramid_layer_width && rect.height() >= min_pyramid_layer_height &&
+                levels < max_pyramid_levels);
+            return levels;
+        }
+
         template <
             typename pyramid_type,
             typename image_type,
@@ -572,17 +593,10 @@ namespace dlib
             unsigned long max_pyramid_levels
         )
         {
-            unsigned long levels = 0;
-            rectangle rect = get_rect(img);
-
             // figure out how many pyramid levels we should be using based on the image size
+            const unsigned long levels = num_fhog_pyramid_levels<pyramid_type>(get_rect(img),
+                min_pyramid_layer_width, min_pyramid_layer_height, max_pyramid_levels);
             pyramid_type pyr;
-            do
-            {
-                rect = pyr.rect_down(rect);
-                ++levels;
-            } while (rect.width() >= min_pyramid_layer_width && rect.height() >= min_pyramid_layer_height &&
-                levels < max_pyramid_levels);
 
             if (feats.max_size() < levels)
                 feats.set_max_size(levels);
@@ -758,6 +772,51 @@ namespace dlib
             return a.first < b.first;
         }
 
+        template <
+            typename pyramid_type,
+            typename feature_extractor_type,
+            typename fhog_filterbank
+            >
+        void detect_from_fhog_pyramid_level (
+            const array<array2d<float> >& feats,
+            const unsigned long level,
+            const feature_extractor_type& fe,
+            const fhog_filterbank& w,
+            const double thresh,
+            const unsigned long det_box_height,
+            const unsigned long det_box_width,
+            const int cell_size,
+            const int filter_rows_padding,
+            const int filter_cols_padding,
+            array2d<float>& saliency_image,
+            std::vector<std::pair<double, rectangle> >& dets
+        ) 
+        /*!
+            ensures
+                - appends the detections found in the given level of an fhog pyramid to
+                  dets, in raster scan order.
+        !*/
+        {
+            pyramid_type pyr;
+            const rectangle area = apply_filters_to_fhog(w, feats, saliency_image);
+
+            // now search the saliency image for any detections
+            for (long r = area.top(); r <= area.bottom(); ++r)
+            {
+                for (long c = area.left(); c <= area.right(); ++c)
+                {
+                    // if we found a detection
+                    if (saliency_image[r][c] >= thresh)
+                    {
+                        rectangle rect = fe.feats_to_image(centered_rect(point(c,r),det_box_width,det_box_height), 
+                            cell_size, filter_rows_padding, filter_cols_padding);
+                        rect = pyr.rect_up(rect, level);
+                        dets.push_back(std::make_pair(saliency_image[r][c], rect));
+                    }
+                }
+            }
+        }
+
         template <
             typename pyramid_type,
             typename feature_extractor_type,
@@ -779,28 +838,13 @@ namespace dlib
             dets.clear();
 
             array2d<float> saliency_image;
-            pyramid_type pyr;
 
             // for all pyramid levels
             for (unsigned long l = 0; l < feats.size(); ++l)
             {
-                const rectangle area = apply_filters_to_fhog(w, feats[l], saliency_image);
-
-                // now search the saliency image for any detections
-                for (long r = area.top(); r <= area.bottom(); ++r)
-                {
-                    for (long c = area.left(); c <= area.right(); ++c)
-                    {
-                        // if we found a detection
-                        if (saliency_image[r][c] >= thresh)
-                        {
-                            rectangle rect = fe.feats_to_image(centered_rect(point(c,r),det_box_width,det_box_height), 
-                                cell_size, filter_rows_padding, filter_cols_padding);
-                            rect = pyr.rect_up(rect, l);
-                            dets.push_back(std::make_pair(saliency_image[r][c], rect));
-                        }
-                    }
-                }
+                detect_from_fhog_pyramid_level<pyramid_type>(feats[l], l, fe, w, thresh,
+                    det_box_height, det_box_width, cell_size, filter_rows_padding,
+                    filter_cols_padding, saliency_image, dets);
             }
 
             std::sort(dets.rbegin(), dets.rend(), compare_pair_rect);
@@ -1213,6 +1257,170 @@ namespace dlib
 
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <
+            typename Pyramid_type,
+            typename feature_extractor_type
+            >
+        class batch_detector<scan_fhog_pyramid<Pyramid_type,feature_extractor_type> >
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This is the batch detector for scan_fhog_pyramid.  Rather than giving
+                    each image to one thread, it schedules each (image, pyramid level) pair
+                    as its own work item, since the HOG extraction and filtering for
+                    different levels are independent.  Only downsampling the image pyramid
+                    is done per image.  The pyramid images and HOG feature buffers are
+                    kept between calls.
+            !*/
+        public:
+            typedef scan_fhog_pyramid<Pyramid_type,feature_extractor_type> scanner_type;
+
+            template <typename image_type>
+            void operator() (
+                thread_pool& tp,
+                object_detector<scanner_type>& detector,
+                const std::vector<image_type>& imgs,
+                std::vector<std::vector<rect_detection> >& final_dets,
+                double adjust_threshold
+            )
+            {
+                typedef typename image_traits<image_type>::pixel_type pixel_type;
+                const scanner_type& scanner = detector.get_scanner();
+                const feature_extractor_type& fe = scanner.get_feature_extractor();
+                const int cell_size = scanner.get_cell_size();
+                const unsigned long width = scanner.get_fhog_window_width();
+                const unsigned long height = scanner.get_fhog_window_height();
+                const unsigned long det_box_width = width - 2*scanner.get_padding();
+                const unsigned long det_box_height = height - 2*scanner.get_padding();
+
+                std::lock_guard<std::mutex> lock(m);
+
+                // Build the image pyramids.  Level l of image i is pyramids[i][l-1].
+                pyramid_images<pixel_type>* cache = dynamic_cast<pyramid_images<pixel_type>*>(pyramid_cache.get());
+                if (!cache)
+                {
+                    cache = new pyramid_images<pixel_type>();
+                    pyramid_cache.reset(cache);
+                }
+                array<array<array2d<pixel_type> > >& pyramids = cache->levels;
+                if (pyramids.max_size() < imgs.size())
+                    pyramids.set_max_size(imgs.size());
+                pyramids.set_size(imgs.size());
+                if (feats.max_size() < imgs.size())
+                    feats.set_max_size(imgs.size());
+                feats.set_size(imgs.size());
+                parallel_for(tp, 0, imgs.size(), [&](long i)
+                {
+                    const unsigned long levels = num_fhog_pyramid_levels<Pyramid_type>(get_rect(imgs[i]),
+                        scanner.get_min_pyramid_layer_width(), scanner.get_min_pyramid_layer_height(),
+                        scanner.get_max_pyramid_levels());
+                    if (feats[i].max_size() < levels)
+                        feats[i].set_max_size(levels);
+                    feats[i].set_size(levels);
+                    if (pyramids[i].max_size() < levels-1)
+                        pyramids[i].set_max_size(levels-1);
+                    pyramids[i].set_size(levels-1);
+
+                    Pyramid_type pyr;
+                    if (levels > 1)
+                        pyr(imgs[i], pyramids[i][0]);
+                    for (unsigned long l = 1; l+1 < levels; ++l)
+                        pyr(pyramids[i][l-1], pyramids[i][l]);
+                });
+
+                // Now extract HOG features and run the filters on each pyramid level.
+                std::vector<std::pair<unsigned long,unsigned long> > items;
+                for (unsigned long i = 0; i < imgs.size(); ++i)
+                {
+                    for (unsigned long l = 0; l < feats[i].size(); ++l)
+                        items.push_back(std::make_pair(i,l));
+                }
+                const unsigned long num_detectors = detector.num_detectors();
+                std::vector<std::vector<std::vector<std::pair<double, rectangle> > > > level_dets(items.size());
+                parallel_for(tp, 0, items.size(), [&](long j)
+                {
+                    const unsigned long i = items[j].first;
+                    const unsigned long l = items[j].second;
+                    if (l == 0)
+                        fe(imgs[i], feats[i][l], cell_size, height, width);
+                    else
+                        fe(pyramids[i][l-1], feats[i][l], cell_size, height, width);
+
+                    array2d<float> saliency_image;
+                    level_dets[j].resize(num_detectors);
+                    for (unsigned long d = 0; d < num_detectors; ++d)
+                    {
+                        const double thresh = detector.get_processed_w(d).w(scanner.get_num_dimensions());
+                        detect_from_fhog_pyramid_level<Pyramid_type>(feats[i][l], l, fe,
+                            detector.get_processed_w(d).get_detect_argument(), thresh+adjust_threshold,
+                            det_box_height, det_box_width, cell_size, height, width,
+                            saliency_image, level_dets[j][d]);
+                    }
+                });
+
+                // Finally, gather up the detections for each image and do non-max
+                // suppression the same way the single image operator() does.
+                final_dets.resize(imgs.size());
+                unsigned long first_item = 0;
+                std::vector<std::pair<double, rectangle> > dets;
+                std::vector<rect_detection> dets_accum;
+                for (unsigned long i = 0; i < imgs.size(); ++i)
+                {
+                    dets_accum.clear();
+                    for (unsigned long d = 0; d < num_detectors; ++d)
+                    {
+                        dets.clear();
+                        for (unsigned long l = 0; l < feats[i].size(); ++l)
+                        {
+                            const std::vector<std::pair<double, rectangle> >& temp = level_dets[first_item+l][d];
+                            dets.insert(dets.end(), temp.begin(), temp.end());
+                        }
+                        std::sort(dets.rbegin(), dets.rend(), compare_pair_rect);
+
+                        const double thresh = detector.get_processed_w(d).w(scanner.get_num_dimensions());
+                        for (unsigned long j = 0; j < dets.size(); ++j)
+                        {
+                            rect_detection temp;
+                            temp.detection_confidence = dets[j].first-thresh;
+                            temp.weight_index = d;
+                            temp.rect = dets[j].second;
+                            dets_accum.push_back(temp);
+                        }
+                    }
+                    detector.non_max_suppression(dets_accum, final_dets[i]);
+                    first_item += feats[i].size();
+                }
+            }
+
+            void clear (
+            ) 
+            {
+                std::lock_guard<std::mutex> lock(m);
+                feats.clear();
+                pyramid_cache.reset();
+            }
+
+        private:
+            // The pixel type of the pyramid images depends on the images given to
+            // operator(), so they are held through this base class.
+            struct pyramid_images_base { virtual ~pyramid_images_base() {} };
+            template <typename pixel_type>
+            struct pyramid_images : pyramid_images_base
+            {
+                array<array<array2d<pixel_type> > > levels;
+            };
+
+            std::mutex m;
+            array<array<array<array2d<float> > > > feats;
+            std::unique_ptr<pyramid_images_base> pyramid_cache;
+        };
+    }
+
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
 
@@ -12,6 +12,8 @@
 #include "draw.h"
 #include "interpolation.h"
 #include "../simd.h"
+#include "../threads/parallel_for_extension.h"
+#include <vector>
 
 namespace dlib
 {
@@ -490,6 +492,19 @@ namespace dlib
             }
         }
 
+    // ------------------------------------------------------------------------------------
+
+        inline bool use_threads_for_fhog (
+            thread_pool& tp,
+            long nr,
+            long nc
+        )
+        {
+            // Small images, such as the upper levels of an image pyramid, are done in the
+            // calling thread since they are too cheap to be worth splitting up.
+            return tp.num_threads_in_pool() > 1 && nr*nc >= 256*256;
+        }
+
     // ------------------------------------------------------------------------------------
 
         template <
@@ -497,6 +512,7 @@ namespace dlib
             typename out_type
             >
         void impl_extract_fhog_features_cell_size_1(
+            thread_pool& tp,
             const image_type& img_, 
             out_type& hog, 
             int filter_rows_padding,
@@ -556,9 +572,256 @@ namespace dlib
             const int visible_nr = img.nr()-1;
             const int visible_nc = img.nc()-1;
 
+            const bool use_threads = use_threads_for_fhog(tp, img.nr(), img.nc());
+
             // First populate the gradient histograms
+            auto populate_rows = [&](long begin, long end)
+            {
+                for (int y = begin; y < end; y++) 
+                {
+                    int x;
+                    for (x = 1; x < visible_nc - 7; x += 8)
+                    {
+                        // v will be the length of the gradient vectors.
+                        simd8f grad_x, grad_y, v;
+                        get_gradient(y, x, img, grad_x, grad_y, v);
+
+                        float _vv[8];
+                        v.store(_vv);
+
+                        // Now snap the gradient to one of 18 orientations
+                        simd8f best_dot = 0;
+                        simd8f best_o = 0;
+                        for (int o = 0; o < 9; o++)
+                        {
+                            simd8f dot = grad_x*directions[o](0) + grad_y*directions[o](1);
+                            simd8f_bool cmp = dot>best_dot;
+                            best_dot = select(cmp, dot, best_dot);
+                            dot *= -1;
+                            best_o = select(cmp, o, best_o);
+
+                            cmp = dot > best_dot;
+                            best_dot = select(cmp, dot, best_dot);
+                            best_o = select(cmp, o + 9, best_o);
+                        }
+
+                        int32 _best_o[8]; simd8i(best_o).store(_best_o);
+
+                        norm[y][x + 0] = _vv[0];
+                        norm[y][x + 1] = _vv[1];
+                        norm[y][x + 2] = _vv[2];
+                        norm[y][x + 3] = _vv[3];
+                        norm[y][x + 4] = _vv[4];
+                        norm[y][x + 5] = _vv[5];
+                        norm[y][x + 6] = _vv[6];
+                        norm[y][x + 7] = _vv[7];
+
+                        angle[y][x + 0] = _best_o[0];
+                        angle[y][x + 1] = _best_o[1];
+                        angle[y][x + 2] = _best_o[2];
+                        angle[y][x + 3] = _best_o[3];
+                        angle[y][x + 4] = _best_o[4];
+                        angle[y][x + 5] = _best_o[5];
+                        angle[y][x + 6] = _best_o[6];
+                        angle[y][x + 7] = _best_o[7];
+                    }
+                    // Now process the right columns that don't fit into simd registers.
+                    for (; x < visible_nc; x++) 
+                    {
+                        matrix<float,2,1> grad;
+                        float v;
+                        get_gradient(y,x,img,grad,v);
+
+                        // snap to one of 18 orientations
+                        float best_dot = 0;
+                        int best_o = 0;
+                        for (int o = 0; o < 9; o++) 
+                        {
+                            const float dot = dlib::dot(directions[o], grad);
+                            if (dot > best_dot) 
+                            {
+                                best_dot = dot;
+                                best_o = o;
+                            } 
+                            else if (-dot > best_dot) 
+                            {
+                                best_dot = -dot;
+                                best_o = o+9;
+                            }
+                        }
+
+                        norm[y][x] = v;
+                        angle[y][x] = best_o;
+                    }
+                }
+            };
+            if (use_threads)
+                parallel_for_blocked(tp, 1, visible_nr, populate_rows);
+            else
+                populate_rows(1, visible_nr);
+
+            const float eps = 0.0001;
+            // compute features
+            auto emit_rows = [&](long begin, long end)
+            {
+                for (int y = begin; y < end; y++) 
+                {
+                    const int yy = y+padding_rows_offset; 
+                    for (int x = 0; x < hog_nc; x++) 
+                    {
+                        const simd4f z1(norm[y+1][x+1],
+                                        norm[y][x+1], 
+                                        norm[y+1][x],  
+                                        norm[y][x]);
+
+                        const simd4f z2(norm[y+1][x+2],
+                                        norm[y][x+2],
+                                        norm[y+1][x+1],
+                                        norm[y][x+1]);
+
+                        const simd4f z3(norm[y+2][x+1],
+                                        norm[y+1][x+1],
+                                        norm[y+2][x],
+                                        norm[y+1][x]);
+
+                        const simd4f z4(norm[y+2][x+2],
+                                        norm[y+1][x+2],
+                                        norm[y+2][x+1],
+                                        norm[y+1][x+1]);
+
+                        const simd4f temp0 = std::sqrt(norm[y+1][x+1]);
+                        const simd4f nn = 0.2*sqrt(z1+z2+z3+z4+eps);
+                        const simd4f n = 0.1/nn;
+
+                        simd4f t = 0;
+
+                        const int xx = x+padding_cols_offset; 
+
+                        simd4f h0 = min(temp0,nn)*n;
+                        const float vv = sum(h0);
+                        set_hog(hog,angle[y+1][x+1],xx,yy,   vv);
+                        t += h0;
+
+                        t *= 2*0.2357;
+
+                        // contrast-insensitive features
+                        set_hog(hog,angle[y+1][x+1]%9+18,xx,yy, vv);
+
+
+                        float temp[4];
+                        t.store(temp);
+
+                        // texture features
+                        set_hog(hog,27,xx,yy, temp[0]);
+                        set_hog(hog,28,xx,yy, temp[1]);
+                        set_hog(hog,29,xx,yy, temp[2]);
+                        set_hog(hog,30,xx,yy, temp[3]);
+                    }
+                }
+            };
+            if (use_threads)
+                parallel_for_blocked(tp, 0, hog_nr, emit_rows);
+            else
+                emit_rows(0, hog_nr);
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        struct fhog_column_weights
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object holds the horizontal part of the bilinear interpolation
+                    impl_extract_fhog_features() uses when a pixel votes into the
+                    histograms of the cells around it.  That part only depends on the pixel
+                    column, so we compute it once per image instead of once per pixel.  For
+                    each column x, ixp[x] is the hist column of the left cell and vx0[x] and
+                    vx1[x] are the weights of the right and left cells respectively.
+            !*/
+
+            fhog_column_weights (
+                const int cell_size,
+                const int visible_nc
+            ) : ixp(std::max(visible_nc,1)), vx0(std::max(visible_nc,1)), vx1(std::max(visible_nc,1))
+            {
+                // The columns handled by the simd8f loop in populate_fhog_histograms() and
+                // the leftover columns on the right have always used slightly different
+                // formulas, so we reproduce each of them exactly here.
+                int x;
+                for (x = 1; x < visible_nc - 7; x += 8)
+                {
+                    simd8f xx(x, x + 1, x + 2, x + 3, x + 4, x + 5, x + 6, x + 7);
+                    simd8f xp = (xx + 0.5) / (float)cell_size + 0.5;
+                    simd8i ixp_ = simd8i(xp);
+                    simd8f vx0_ = xp - ixp_;
+                    simd8f vx1_ = 1.0f - vx0_;
+                    ixp_.store(&ixp[x]);
+                    vx0_.store(&vx0[x]);
+                    vx1_.store(&vx1[x]);
+                }
+                for (; x < visible_nc; x++) 
+                {
+                    const float xp = ((double)x + 0.5) / (double)cell_size - 0.5;
+                    const int ixp_ = (int)std::floor(xp);
+                    vx0[x] = xp - ixp_;
+                    vx1[x] = 1.0 - vx0[x];
+                    ixp[x] = ixp_+1;
+                }
+            }
+
+            std::vector<int32> ixp;
+            std::vector<float> vx0;
+            std::vector<float> vx1;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        template <
+            typename image_type
+            >
+        void populate_fhog_histograms (
+            const image_type& img,
+            const matrix<float,2,1>* directions,
+            const fhog_column_weights& cols,
+            const int cell_size,
+            const int visible_nr,
+            const int visible_nc,
+            array2d<matrix<float,18,1> >& hist,
+            const long row_begin,
+            const long row_end
+        )
+        /*!
+            requires
+                - directions is the array of 9 orientation unit vectors used by
+                  impl_extract_fhog_features().
+                - cols == fhog_column_weights(cell_size, visible_nc)
+                - 0 <= row_begin <= row_end <= hist.nr()
+            ensures
+                - Adds the gradient magnitude of each pixel in img into the 4 histogram
+                  cells around it, skipping any cell that isn't in one of the rows
+                  [row_begin, row_end) of hist.
+                - Every cell gets its votes in the same order no matter how the rows of
+                  hist are split into ranges.  So filling disjoint row bands of hist in
+                  parallel produces bit for bit the same histograms as one call covering
+                  all the rows.  The only cost is that pixels on the boundary between two
+                  bands have their gradients computed twice.
+        !*/
+        {
             for (int y = 1; y < visible_nr; y++) 
             {
+                const float yp = ((float)y+0.5)/(float)cell_size - 0.5;
+                const int iyp = (int)std::floor(yp);
+                const float vy0 = yp - iyp;
+                const float vy1 = 1.0 - vy0;
+
+                // Each pixel in this row votes into hist rows iyp+1 and iyp+2.
+                const bool do_top = row_begin <= iyp+1 && iyp+1 < row_end;
+                const bool do_bottom = row_begin <= iyp+2 && iyp+2 < row_end;
+                if (!do_top && !do_bottom)
+                    continue;
+                matrix<float,18,1>* const top = &hist[iyp+1][0];
+                matrix<float,18,1>* const bottom = &hist[iyp+1+1][0];
+
                 int x;
                 for (x = 1; x < visible_nc - 7; x += 8)
                 {
@@ -566,8 +829,13 @@ namespace dlib
                     simd8f grad_x, grad_y, v;
                     get_gradient(y, x, img, grad_x, grad_y, v);
 
-                    float _vv[8];
-                    v.store(_vv);
+                    // We will use bilinear interpolation to add into the histogram bins.
+                    // The horizontal weights were computed ahead of time by cols.
+                    simd8f vx0, vx1;
+                    vx0.load(&cols.vx0[x]);
+                    vx1.load(&cols.vx1[x]);
+
+                    v = sqrt(v);
 
                     // Now snap the gradient to one of 18 orientations
                     simd8f best_dot = 0;
@@ -585,30 +853,48 @@ namespace dlib
                         best_o = select(cmp, o + 9, best_o);
                     }
 
+
+                    // Add the gradient magnitude, v, to 4 histograms around pixel using
+                    // bilinear interpolation.
+                    vx1 *= v;
+                    vx0 *= v;
+                    // The amounts for each bin
+                    simd8f v11 = vy1*vx1;
+                    simd8f v01 = vy0*vx1;
+                    simd8f v10 = vy1*vx0;
+                    simd8f v00 = vy0*vx0;
+
                     int32 _best_o[8]; simd8i(best_o).store(_best_o);
+                    const int32* _ixp = &cols.ixp[x];
+                    float _v11[8];    v11.store(_v11);
+                    float _v01[8];    v01.store(_v01);
+                    float _v10[8];    v10.store(_v10);
+                    float _v00[8];    v00.store(_v00);
 
-                    norm[y][x + 0] = _vv[0];
-                    norm[y][x + 1] = _vv[1];
-                    norm[y][x + 2] = _vv[2];
-                    norm[y][x + 3] = _vv[3];
-                    norm[y][x + 4] = _vv[4];
-                    norm[y][x + 5] = _vv[5];
-                    norm[y][x + 6] = _vv[6];
-                    norm[y][x + 7] = _vv[7];
-
-                    angle[y][x + 0] = _best_o[0];
-                    angle[y][x + 1] = _best_o[1];
-                    angle[y][x + 2] = _best_o[2];
-                    angle[y][x + 3] = _best_o[3];
-                    angle[y][x + 4] = _best_o[4];
-                    angle[y][x + 5] = _best_o[5];
-                    angle[y][x + 6] = _best_o[6];
-                    angle[y][x + 7] = _best_o[7];
+                    // Each cell only ever gets votes from one row of hist, so doing the
+                    // top row and then the bottom row doesn't change the order in which
+                    // any cell receives its votes.
+                    if (do_top)
+                    {
+                        for (int i = 0; i < 8; ++i)
+                        {
+                            top[_ixp[i]](_best_o[i]) += _v11[i];
+                            top[_ixp[i] + 1](_best_o[i]) += _v10[i];
+                        }
+                    }
+                    if (do_bottom)
+                    {
+                        for (int i = 0; i < 8; ++i)
+                        {
+                            bottom[_ixp[i]](_best_o[i]) += _v01[i];
+                            bottom[_ixp[i] + 1](_best_o[i]) += _v00[i];
+                        }
+                    }
                 }
                 // Now process the right columns that don't fit into simd registers.
                 for (; x < visible_nc; x++) 
                 {
-                    matrix<float,2,1> grad;
+                    matrix<float, 2, 1> grad;
                     float v;
                     get_gradient(y,x,img,grad,v);
 
@@ -630,66 +916,220 @@ namespace dlib
                         }
                     }
 
-                    norm[y][x] = v;
-                    angle[y][x] = best_o;
+                    v = std::sqrt(v);
+                    // add to 4 histograms around pixel using bilinear interpolation
+                    const int ixp = cols.ixp[x];
+                    const float vx0 = cols.vx0[x];
+                    const float vx1 = cols.vx1[x];
+
+                    if (do_top)
+                    {
+                        top[ixp](best_o) += vy1*vx1*v;
+                        top[ixp+1](best_o) += vy1*vx0*v;
+                    }
+                    if (do_bottom)
+                    {
+                        bottom[ixp](best_o) += vy0*vx1*v;
+                        bottom[ixp+1](best_o) += vy0*vx0*v;
+                    }
                 }
             }
+        }
 
+    // ------------------------------------------------------------------------------------
+
+        template <
+            typename out_type
+            >
+        void emit_fhog_row (
+            const array2d<matrix<float,18,1> >& hist,
+            const array2d<float>& norm,
+            out_type& hog,
+            const int y,
+            const int hog_nc,
+            const int padding_rows_offset,
+            const int padding_cols_offset
+        )
+        /*!
+            ensures
+                - Normalizes the histograms of the cells in row y of the HOG image and
+                  writes the resulting 31 features of each cell into hog.
+        !*/
+        {
             const float eps = 0.0001;
-            // compute features
-            for (int y = 0; y < hog_nr; y++) 
+            const int yy = y+padding_rows_offset; 
+            int x = 0;
+            // Do two cells at a time.  The low 4 lanes of each simd8f hold exactly what
+            // the simd4f code below would compute for cell x and the high 4 lanes what it
+            // would compute for cell x+1.  So the output is the same either way.
+            for (; x + 1 < hog_nc; x += 2)
             {
-                const int yy = y+padding_rows_offset; 
-                for (int x = 0; x < hog_nc; x++) 
+                const simd8f z1(norm[y+1][x+1],
+                                norm[y][x+1], 
+                                norm[y+1][x],  
+                                norm[y][x],
+                                norm[y+1][x+2],
+                                norm[y][x+2], 
+                                norm[y+1][x+1],  
+                                norm[y][x+1]);
+
+                const simd8f z2(norm[y+1][x+2],
+                                norm[y][x+2],
+                                norm[y+1][x+1],
+                                norm[y][x+1],
+                                norm[y+1][x+3],
+                                norm[y][x+3],
+                                norm[y+1][x+2],
+                                norm[y][x+2]);
+
+                const simd8f z3(norm[y+2][x+1],
+                                norm[y+1][x+1],
+                                norm[y+2][x],
+                                norm[y+1][x],
+                                norm[y+2][x+2],
+                                norm[y+1][x+2],
+                                norm[y+2][x+1],
+                                norm[y+1][x+1]);
+
+                const simd8f z4(norm[y+2][x+2],
+                                norm[y+1][x+2],
+                                norm[y+2][x+1],
+                                norm[y+1][x+1],
+                                norm[y+2][x+3],
+                                norm[y+1][x+3],
+                                norm[y+2][x+2],
+                                norm[y+1][x+2]);
+
+                const simd8f nn = 0.2*sqrt(z1+z2+z3+z4+eps);
+                const simd8f n = 0.1/nn;
+
+                simd8f t = 0;
+
+                const int xx = x+padding_cols_offset; 
+                const matrix<float,18,1>& ha = hist[y+1+1][x+1+1];
+                const matrix<float,18,1>& hb = hist[y+1+1][x+1+1+1];
+
+                // contrast-sensitive features
+                for (int o = 0; o < 18; o+=3) 
+                {
+                    simd8f temp0(simd4f(ha(o)),   simd4f(hb(o)));
+                    simd8f temp1(simd4f(ha(o+1)), simd4f(hb(o+1)));
+                    simd8f temp2(simd4f(ha(o+2)), simd4f(hb(o+2)));
+                    simd8f h0 = min(temp0,nn)*n;
+                    simd8f h1 = min(temp1,nn)*n;
+                    simd8f h2 = min(temp2,nn)*n;
+                    set_hog(hog,o,xx,yy,     sum(h0.low()));
+                    set_hog(hog,o+1,xx,yy,   sum(h1.low()));
+                    set_hog(hog,o+2,xx,yy,   sum(h2.low()));
+                    set_hog(hog,o,xx+1,yy,   sum(h0.high()));
+                    set_hog(hog,o+1,xx+1,yy, sum(h1.high()));
+                    set_hog(hog,o+2,xx+1,yy, sum(h2.high()));
+                    t += h0+h1+h2;
+                }
+
+                t *= 2*0.2357;
+
+                // contrast-insensitive features
+                for (int o = 0; o < 9; o+=3) 
                 {
-                    const simd4f z1(norm[y+1][x+1],
-                                    norm[y][x+1], 
-                                    norm[y+1][x],  
-                                    norm[y][x]);
+                    simd8f temp0(simd4f(ha(o)   + ha(o+9)),   simd4f(hb(o)   + hb(o+9)));
+                    simd8f temp1(simd4f(ha(o+1) + ha(o+9+1)), simd4f(hb(o+1) + hb(o+9+1)));
+                    simd8f temp2(simd4f(ha(o+2) + ha(o+9+2)), simd4f(hb(o+2) + hb(o+9+2)));
+                    simd8f h0 = min(temp0,nn)*n;
+                    simd8f h1 = min(temp1,nn)*n;
+                    simd8f h2 = min(temp2,nn)*n;
+                    set_hog(hog,o+18,xx,yy,     sum(h0.low()));
+                    set_hog(hog,o+18+1,xx,yy,   sum(h1.low()));
+                    set_hog(hog,o+18+2,xx,yy,   sum(h2.low()));
+                    set_hog(hog,o+18,xx+1,yy,   sum(h0.high()));
+                    set_hog(hog,o+18+1,xx+1,yy, sum(h1.high()));
+                    set_hog(hog,o+18+2,xx+1,yy, sum(h2.high()));
+                }
 
-                    const simd4f z2(norm[y+1][x+2],
-                                    norm[y][x+2],
-                                    norm[y+1][x+1],
-                                    norm[y][x+1]);
 
-                    const simd4f z3(norm[y+2][x+1],
-                                    norm[y+1][x+1],
-                                    norm[y+2][x],
-                                    norm[y+1][x]);
+                float temp[8];
+                t.store(temp);
 
-                    const simd4f z4(norm[y+2][x+2],
-                                    norm[y+1][x+2],
-                                    norm[y+2][x+1],
-                                    norm[y+1][x+1]);
+                // texture features
+                set_hog(hog,27,xx,yy, temp[0]);
+                set_hog(hog,28,xx,yy, temp[1]);
+                set_hog(hog,29,xx,yy, temp[2]);
+                set_hog(hog,30,xx,yy, temp[3]);
+                set_hog(hog,27,xx+1,yy, temp[4]);
+                set_hog(hog,28,xx+1,yy, temp[5]);
+                set_hog(hog,29,xx+1,yy, temp[6]);
+                set_hog(hog,30,xx+1,yy, temp[7]);
+            }
+            // Now do the last cell if there is an odd number of them.
+            for (; x < hog_nc; x++) 
+            {
+                const simd4f z1(norm[y+1][x+1],
+                                norm[y][x+1], 
+                                norm[y+1][x],  
+                                norm[y][x]);
 
-                    const simd4f temp0 = std::sqrt(norm[y+1][x+1]);
-                    const simd4f nn = 0.2*sqrt(z1+z2+z3+z4+eps);
-                    const simd4f n = 0.1/nn;
+                const simd4f z2(norm[y+1][x+2],
+                                norm[y][x+2],
+                                norm[y+1][x+1],
+                                norm[y][x+1]);
 
-                    simd4f t = 0;
+                const simd4f z3(norm[y+2][x+1],
+                                norm[y+1][x+1],
+                                norm[y+2][x],
+                                norm[y+1][x]);
 
-                    const int xx = x+padding_cols_offset; 
+                const simd4f z4(norm[y+2][x+2],
+                                norm[y+1][x+2],
+                                norm[y+2][x+1],
+                                norm[y+1][x+1]);
 
-                    simd4f h0 = min(temp0,nn)*n;
-                    const float vv = sum(h0);
-                    set_hog(hog,angle[y+1][x+1],xx,yy,   vv);
-                    t += h0;
+                const simd4f nn = 0.2*sqrt(z1+z2+z3+z4+eps);
+                const simd4f n = 0.1/nn;
 
-                    t *= 2*0.2357;
+                simd4f t = 0;
 
-                    // contrast-insensitive features
-                    set_hog(hog,angle[y+1][x+1]%9+18,xx,yy, vv);
+                const int xx = x+padding_cols_offset; 
 
+                // contrast-sensitive features
+                for (int o = 0; o < 18; o+=3) 
+                {
+                    simd4f temp0(hist[y+1+1][x+1+1](o));
+                    simd4f temp1(hist[y+1+1][x+1+1](o+1));
+                    simd4f temp2(hist[y+1+1][x+1+1](o+2));
+                    simd4f h0 = min(temp0,nn)*n;
+                    simd4f h1 = min(temp1,nn)*n;
+                    simd4f h2 = min(temp2,nn)*n;
+                    set_hog(hog,o,xx,yy,   sum(h0));
+                    set_hog(hog,o+1,xx,yy, sum(h1));
+                    set_hog(hog,o+2,xx,yy, sum(h2));
+                    t += h0+h1+h2;
+                }
 
-                    float temp[4];
-                    t.store(temp);
+                t *= 2*0.2357;
 
-                    // texture features
-                    set_hog(hog,27,xx,yy, temp[0]);
-                    set_hog(hog,28,xx,yy, temp[1]);
-                    set_hog(hog,29,xx,yy, temp[2]);
-                    set_hog(hog,30,xx,yy, temp[3]);
+                // contrast-insensitive features
+                for (int o = 0; o < 9; o+=3) 
+                {
+                    simd4f temp0 = hist[y+1+1][x+1+1](o)   + hist[y+1+1][x+1+1](o+9);
+                    simd4f temp1 = hist[y+1+1][x+1+1](o+1) + hist[y+1+1][x+1+1](o+9+1);
+                    simd4f temp2 = hist[y+1+1][x+1+1](o+2) + hist[y+1+1][x+1+1](o+9+2);
+                    simd4f h0 = min(temp0,nn)*n;
+                    simd4f h1 = min(temp1,nn)*n;
+                    simd4f h2 = min(temp2,nn)*n;
+                    set_hog(hog,o+18,xx,yy, sum(h0));
+                    set_hog(hog,o+18+1,xx,yy, sum(h1));
+                    set_hog(hog,o+18+2,xx,yy, sum(h2));
                 }
+
+
+                float temp[4];
+                t.store(temp);
+
+                // texture features
+                set_hog(hog,27,xx,yy, temp[0]);
+                set_hog(hog,28,xx,yy, temp[1]);
+                set_hog(hog,29,xx,yy, temp[2]);
+                set_hog(hog,30,xx,yy, temp[3]);
             }
         }
 
@@ -700,6 +1140,7 @@ namespace dlib
             typename out_type
             >
         void impl_extract_fhog_features(
+            thread_pool& tp,
             const image_type& img_, 
             out_type& hog, 
             int cell_size,
@@ -758,7 +1199,7 @@ namespace dlib
 
             if (cell_size == 1)
             {
-                impl_extract_fhog_features_cell_size_1(img_,hog,filter_rows_padding,filter_cols_padding);
+                impl_extract_fhog_features_cell_size_1(tp,img_,hog,filter_rows_padding,filter_cols_padding);
                 return;
             }
 
@@ -816,233 +1257,56 @@ namespace dlib
 
             const int visible_nr = std::min((long)cells_nr*cell_size,img.nr())-1;
             const int visible_nc = std::min((long)cells_nc*cell_size,img.nc())-1;
+            const fhog_column_weights cols(cell_size, visible_nc);
 
-            // First populate the gradient histograms
-            for (int y = 1; y < visible_nr; y++) 
-            {
-                const float yp = ((float)y+0.5)/(float)cell_size - 0.5;
-                const int iyp = (int)std::floor(yp);
-                const float vy0 = yp - iyp;
-                const float vy1 = 1.0 - vy0;
-                int x;
-                for (x = 1; x < visible_nc - 7; x += 8)
-                {
-                    simd8f xx(x, x + 1, x + 2, x + 3, x + 4, x + 5, x + 6, x + 7);
-                    // v will be the length of the gradient vectors.
-                    simd8f grad_x, grad_y, v;
-                    get_gradient(y, x, img, grad_x, grad_y, v);
-
-                    // We will use bilinear interpolation to add into the histogram bins.
-                    // So first we precompute the values needed to determine how much each
-                    // pixel votes into each bin.
-                    simd8f xp = (xx + 0.5) / (float)cell_size + 0.5;
-                    simd8i ixp = simd8i(xp);
-                    simd8f vx0 = xp - ixp;
-                    simd8f vx1 = 1.0f - vx0;
-
-                    v = sqrt(v);
-
-                    // Now snap the gradient to one of 18 orientations
-                    simd8f best_dot = 0;
-                    simd8f best_o = 0;
-                    for (int o = 0; o < 9; o++)
-                    {
-                        simd8f dot = grad_x*directions[o](0) + grad_y*directions[o](1);
-                        simd8f_bool cmp = dot>best_dot;
-                        best_dot = select(cmp, dot, best_dot);
-                        dot *= -1;
-                        best_o = select(cmp, o, best_o);
-
-                        cmp = dot > best_dot;
-                        best_dot = select(cmp, dot, best_dot);
-                        best_o = select(cmp, o + 9, best_o);
-                    }
-
+            const bool use_threads = use_threads_for_fhog(tp, img.nr(), img.nc());
 
-                    // Add the gradient magnitude, v, to 4 histograms around pixel using
-                    // bilinear interpolation.
-                    vx1 *= v;
-                    vx0 *= v;
-                    // The amounts for each bin
-                    simd8f v11 = vy1*vx1;
-                    simd8f v01 = vy0*vx1;
-                    simd8f v10 = vy1*vx0;
-                    simd8f v00 = vy0*vx0;
-
-                    int32 _best_o[8]; simd8i(best_o).store(_best_o);
-                    int32 _ixp[8];    ixp.store(_ixp);
-                    float _v11[8];    v11.store(_v11);
-                    float _v01[8];    v01.store(_v01);
-                    float _v10[8];    v10.store(_v10);
-                    float _v00[8];    v00.store(_v00);
+            // First populate the gradient histograms of the hist rows in [row_begin,
+            // row_end) and then compute the energy in each of those blocks by summing over
+            // orientations.  
+            auto populate_band = [&](long row_begin, long row_end)
+            {
+                populate_fhog_histograms(img, directions, cols, cell_size, visible_nr,
+                    visible_nc, hist, row_begin, row_end);
 
-                    hist[iyp + 1][_ixp[0]](_best_o[0]) += _v11[0];
-                    hist[iyp + 1 + 1][_ixp[0]](_best_o[0]) += _v01[0];
-                    hist[iyp + 1][_ixp[0] + 1](_best_o[0]) += _v10[0];
-                    hist[iyp + 1 + 1][_ixp[0] + 1](_best_o[0]) += _v00[0];
-
-                    hist[iyp + 1][_ixp[1]](_best_o[1]) += _v11[1];
-                    hist[iyp + 1 + 1][_ixp[1]](_best_o[1]) += _v01[1];
-                    hist[iyp + 1][_ixp[1] + 1](_best_o[1]) += _v10[1];
-                    hist[iyp + 1 + 1][_ixp[1] + 1](_best_o[1]) += _v00[1];
-
-                    hist[iyp + 1][_ixp[2]](_best_o[2]) += _v11[2];
-                    hist[iyp + 1 + 1][_ixp[2]](_best_o[2]) += _v01[2];
-                    hist[iyp + 1][_ixp[2] + 1](_best_o[2]) += _v10[2];
-                    hist[iyp + 1 + 1][_ixp[2] + 1](_best_o[2]) += _v00[2];
-
-                    hist[iyp + 1][_ixp[3]](_best_o[3]) += _v11[3];
-                    hist[iyp + 1 + 1][_ixp[3]](_best_o[3]) += _v01[3];
-                    hist[iyp + 1][_ixp[3] + 1](_best_o[3]) += _v10[3];
-                    hist[iyp + 1 + 1][_ixp[3] + 1](_best_o[3]) += _v00[3];
-
-                    hist[iyp + 1][_ixp[4]](_best_o[4]) += _v11[4];
-                    hist[iyp + 1 + 1][_ixp[4]](_best_o[4]) += _v01[4];
-                    hist[iyp + 1][_ixp[4] + 1](_best_o[4]) += _v10[4];
-                    hist[iyp + 1 + 1][_ixp[4] + 1](_best_o[4]) += _v00[4];
-
-                    hist[iyp + 1][_ixp[5]](_best_o[5]) += _v11[5];
-                    hist[iyp + 1 + 1][_ixp[5]](_best_o[5]) += _v01[5];
-                    hist[iyp + 1][_ixp[5] + 1](_best_o[5]) += _v10[5];
-                    hist[iyp + 1 + 1][_ixp[5] + 1](_best_o[5]) += _v00[5];
-
-                    hist[iyp + 1][_ixp[6]](_best_o[6]) += _v11[6];
-                    hist[iyp + 1 + 1][_ixp[6]](_best_o[6]) += _v01[6];
-                    hist[iyp + 1][_ixp[6] + 1](_best_o[6]) += _v10[6];
-                    hist[iyp + 1 + 1][_ixp[6] + 1](_best_o[6]) += _v00[6];
-
-                    hist[iyp + 1][_ixp[7]](_best_o[7]) += _v11[7];
-                    hist[iyp + 1 + 1][_ixp[7]](_best_o[7]) += _v01[7];
-                    hist[iyp + 1][_ixp[7] + 1](_best_o[7]) += _v10[7];
-                    hist[iyp + 1 + 1][_ixp[7] + 1](_best_o[7]) += _v00[7];
-                }
-                // Now process the right columns that don't fit into simd registers.
-                for (; x < visible_nc; x++) 
+                // norm[r][c] is the energy of hist[r+1][c+1]
+                const long norm_end = std::min<long>(row_end-1, cells_nr);
+                for (long r = std::max<long>(row_begin-1, 0); r < norm_end; ++r)
                 {
-                    matrix<float, 2, 1> grad;
-                    float v;
-                    get_gradient(y,x,img,grad,v);
-
-                    // snap to one of 18 orientations
-                    float best_dot = 0;
-                    int best_o = 0;
-                    for (int o = 0; o < 9; o++) 
+                    for (int c = 0; c < cells_nc; ++c)
                     {
-                        const float dot = dlib::dot(directions[o], grad);
-                        if (dot > best_dot) 
-                        {
-                            best_dot = dot;
-                            best_o = o;
-                        } 
-                        else if (-dot > best_dot) 
+                        for (int o = 0; o < 9; o++) 
                         {
-                            best_dot = -dot;
-                            best_o = o+9;
+                            norm[r][c] += (hist[r+1][c+1](o) + hist[r+1][c+1](o+9)) * (hist[r+1][c+1](o) + hist[r+1][c+1](o+9));
                         }
                     }
-
-                    v = std::sqrt(v);
-                    // add to 4 histograms around pixel using bilinear interpolation
-                    const float xp = ((double)x + 0.5) / (double)cell_size - 0.5;
-                    const int ixp = (int)std::floor(xp);
-                    const float vx0 = xp - ixp;
-                    const float vx1 = 1.0 - vx0;
-
-                    hist[iyp+1][ixp+1](best_o) += vy1*vx1*v;
-                    hist[iyp+1+1][ixp+1](best_o) += vy0*vx1*v;
-                    hist[iyp+1][ixp+1+1](best_o) += vy1*vx0*v;
-                    hist[iyp+1+1][ixp+1+1](best_o) += vy0*vx0*v;
                 }
-            }
-
-            // compute energy in each block by summing over orientations
-            for (int r = 0; r < cells_nr; ++r)
+            };
+            if (use_threads)
             {
-                for (int c = 0; c < cells_nc; ++c)
+                // The pixels on the boundary between two bands get their gradients
+                // computed by both bands, so we use just one band per thread.
+                const long num_bands = std::max<long>(1, std::min<long>(tp.num_threads_in_pool(), hist.nr()/4));
+                parallel_for(tp, 0, num_bands, [&](long i)
                 {
-                    for (int o = 0; o < 9; o++) 
-                    {
-                        norm[r][c] += (hist[r+1][c+1](o) + hist[r+1][c+1](o+9)) * (hist[r+1][c+1](o) + hist[r+1][c+1](o+9));
-                    }
-                }
+                    populate_band(hist.nr()*i/num_bands, hist.nr()*(i+1)/num_bands);
+                }, 1);
+            }
+            else
+            {
+                populate_band(0, hist.nr());
             }
 
-            const float eps = 0.0001;
             // compute features
-            for (int y = 0; y < hog_nr; y++) 
+            auto emit_rows = [&](long begin, long end)
             {
-                const int yy = y+padding_rows_offset; 
-                for (int x = 0; x < hog_nc; x++) 
-                {
-                    const simd4f z1(norm[y+1][x+1],
-                                    norm[y][x+1], 
-                                    norm[y+1][x],  
-                                    norm[y][x]);
-
-                    const simd4f z2(norm[y+1][x+2],
-                                    norm[y][x+2],
-                                    norm[y+1][x+1],
-                                    norm[y][x+1]);
-
-                    const simd4f z3(norm[y+2][x+1],
-                                    norm[y+1][x+1],
-                                    norm[y+2][x],
-                                    norm[y+1][x]);
-
-                    const simd4f z4(norm[y+2][x+2],
-                                    norm[y+1][x+2],
-                                    norm[y+2][x+1],
-                                    norm[y+1][x+1]);
-
-                    const simd4f nn = 0.2*sqrt(z1+z2+z3+z4+eps);
-                    const simd4f n = 0.1/nn;
-
-                    simd4f t = 0;
-
-                    const int xx = x+padding_cols_offset; 
-
-                    // contrast-sensitive features
-                    for (int o = 0; o < 18; o+=3) 
-                    {
-                        simd4f temp0(hist[y+1+1][x+1+1](o));
-                        simd4f temp1(hist[y+1+1][x+1+1](o+1));
-                        simd4f temp2(hist[y+1+1][x+1+1](o+2));
-                        simd4f h0 = min(temp0,nn)*n;
-                        simd4f h1 = min(temp1,nn)*n;
-                        simd4f h2 = min(temp2,nn)*n;
-                        set_hog(hog,o,xx,yy,   sum(h0));
-                        set_hog(hog,o+1,xx,yy, sum(h1));
-                        set_hog(hog,o+2,xx,yy, sum(h2));
-                        t += h0+h1+h2;
-                    }
-
-                    t *= 2*0.2357;
-
-                    // contrast-insensitive features
-                    for (int o = 0; o < 9; o+=3) 
-                    {
-                        simd4f temp0 = hist[y+1+1][x+1+1](o)   + hist[y+1+1][x+1+1](o+9);
-                        simd4f temp1 = hist[y+1+1][x+1+1](o+1) + hist[y+1+1][x+1+1](o+9+1);
-                        simd4f temp2 = hist[y+1+1][x+1+1](o+2) + hist[y+1+1][x+1+1](o+9+2);
-                        simd4f h0 = min(temp0,nn)*n;
-                        simd4f h1 = min(temp1,nn)*n;
-                        simd4f h2 = min(temp2,nn)*n;
-                        set_hog(hog,o+18,xx,yy, sum(h0));
-                        set_hog(hog,o+18+1,xx,yy, sum(h1));
-                        set_hog(hog,o+18+2,xx,yy, sum(h2));
-                    }
-
-
-                    float temp[4];
-                    t.store(temp);
-
-                    // texture features
-                    set_hog(hog,27,xx,yy, temp[0]);
-                    set_hog(hog,28,xx,yy, temp[1]);
-                    set_hog(hog,29,xx,yy, temp[2]);
-                    set_hog(hog,30,xx,yy, temp[3]);
-                }
-            }
+                for (long y = begin; y < end; ++y)
+                    emit_fhog_row(hist, norm, hog, y, hog_nc, padding_rows_offset, padding_cols_offset);
+            };
+            if (use_threads)
+                parallel_for_blocked(tp, 0, hog_nr, emit_rows);
+            else
+                emit_rows(0, hog_nr);
         }
 
     // ------------------------------------------------------------------------------------
@@ -1081,6 +1345,7 @@ namespace dlib
         typename mm2
         >
     void extract_fhog_features(
+        thread_pool& tp,
         const image_type& img, 
         dlib::array<array2d<T,mm1>,mm2>& hog, 
         int cell_size = 8,
@@ -1088,7 +1353,7 @@ namespace dlib
         int filter_cols_padding = 1
     ) 
     {
-        impl_fhog::impl_extract_fhog_features(img, hog, cell_size, filter_rows_padding, filter_cols_padding);
+        impl_fhog::impl_extract_fhog_features(tp, img, hog, cell_size, filter_rows_padding, filter_cols_padding);
         // If the image is too small then the above function outputs an empty feature map.
         // But to make things very uniform in usage we require the output to still have the
         // 31 planes (but they are just empty).
@@ -1096,6 +1361,40 @@ namespace dlib
             hog.resize(31);
     }
 
+    template <
+        typename image_type, 
+        typename T, 
+        typename mm1, 
+        typename mm2
+        >
+    void extract_fhog_features(
+        const image_type& img, 
+        dlib::array<array2d<T,mm1>,mm2>& hog, 
+        int cell_size = 8,
+        int filter_rows_padding = 1,
+        int filter_cols_padding = 1
+    ) 
+    {
+        extract_fhog_features(default_thread_pool(), img, hog, cell_size, filter_rows_padding, filter_cols_padding);
+    }
+
+    template <
+        typename image_type, 
+        typename T, 
+        typename mm
+        >
+    void extract_fhog_features(
+        thread_pool& tp,
+        const image_type& img, 
+        array2d<matrix<T,31,1>,mm>& hog, 
+        int cell_size = 8,
+        int filter_rows_padding = 1,
+        int filter_cols_padding = 1
+    ) 
+    {
+        impl_fhog::impl_extract_fhog_features(tp, img, hog, cell_size, filter_rows_padding, filter_cols_padding);
+    }
+
     template <
         typename image_type, 
         typename T, 
@@ -1109,7 +1408,7 @@ namespace dlib
         int filter_cols_padding = 1
     ) 
     {
-        impl_fhog::impl_extract_fhog_features(img, hog, cell_size, filter_rows_padding, filter_cols_padding);
+        extract_fhog_features(default_thread_pool(), img, hog, cell_size, filter_rows_padding, filter_cols_padding);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 #include "../array2d/array2d_kernel_abstract.h"
 #include "../array/array_kernel_abstract.h"
 #include "../image_processing/generic_image.h"
+#include "../threads/thread_pool_extension_abstract.h"
 
 namespace dlib
 {
@@ -70,6 +71,9 @@ namespace dlib
             - for all valid r and c:
                 - #hog[r][c] == the FHOG vector describing the cell centered at the pixel location 
                   fhog_to_image(point(c,r),cell_size,filter_rows_padding,filter_cols_padding) in img.
+            - Large images are split into bands of rows which are processed in parallel
+              by the threads in default_thread_pool().  The output does not depend on
+              the number of threads.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -110,6 +114,57 @@ namespace dlib
                 - #hog[i].nc() == hog[0].nc()
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type, 
+        typename T, 
+        typename mm
+        >
+    void extract_fhog_features(
+        thread_pool& tp,
+        const image_type& img, 
+        array2d<matrix<T,31,1>,mm>& hog, 
+        int cell_size = 8,
+        int filter_rows_padding = 1,
+        int filter_cols_padding = 1
+    );
+    /*!
+        requires
+            - the requires clause of extract_fhog_features(img,hog,cell_size,filter_rows_padding,filter_cols_padding)
+              is satisfied.
+        ensures
+            - This function is identical to the above interlaced version of
+              extract_fhog_features() except that it uses the threads in tp rather than
+              default_thread_pool().  The results are bit for bit the same regardless of
+              tp.num_threads_in_pool().
+    !*/
+
+    template <
+        typename image_type, 
+        typename T, 
+        typename mm1, 
+        typename mm2
+        >
+    void extract_fhog_features(
+        thread_pool& tp,
+        const image_type& img, 
+        dlib::array<array2d<T,mm1>,mm2>& hog, 
+        int cell_size = 8,
+        int filter_rows_padding = 1,
+        int filter_cols_padding = 1
+    );
+    /*!
+        requires
+            - the requires clause of extract_fhog_features(img,hog,cell_size,filter_rows_padding,filter_cols_padding)
+              is satisfied.
+        ensures
+            - This function is identical to the above planar version of
+              extract_fhog_features() except that it uses the threads in tp rather than
+              default_thread_pool().  The results are bit for bit the same regardless of
+              tp.num_threads_in_pool().
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -1884,6 +1884,10 @@ namespace dlib
             // objects have compatible serialization formats.
             serialize(-item.nr(),out);
             serialize(-item.nc(),out);
+            // In a mapped archive row major matrices are stored as one raw block.
+            if (is_same_type<l,row_major_layout>::value &&
+                ser_helper::try_write_block(item.size() != 0 ? &item(0,0) : (const T*)0, item.size(), out))
+                return;
             for (long r = 0; r < item.nr(); ++r)
             {
                 for (long c = 0; c < item.nc(); ++c)
@@ -1929,6 +1933,9 @@ namespace dlib
                 throw serialization_error("Error while deserializing a dlib::matrix.  Invalid columns");
 
             item.set_size(nr,nc);
+            if (is_same_type<l,row_major_layout>::value &&
+                ser_helper::try_read_block(item.size() != 0 ? &item(0,0) : (T*)0, item.size(), in))
+                return;
             for (long r = 0; r < nr; ++r)
             {
                 for (long c = 0; c < nc; ++c)
@@ -7,6 +7,9 @@
 #include "matrix.h"
 #include "matrix_utilities.h"
 #include "../enable_if.h"
+#include "../simd.h"
+#include "../threads/parallel_for_extension.h"
+#include <vector>
 
 namespace dlib
 {
@@ -61,6 +64,216 @@ namespace dlib
         matrix_assign_default(dest, lhs*rhs, 1, true);
     }
 
+// ------------------------------------------------------------------------------------
+
+    namespace ma
+    {
+        /*
+            What follows is a GEMM for float matrices in the style of GotoBLAS.  The
+            product is split into blocks of gemm_mc rows, gemm_kc inner dimension elements,
+            and gemm_nc columns.  For each block the relevant parts of lhs and rhs are
+            copied ("packed") into contiguous buffers laid out in the exact order the
+            micro-kernel reads them, which computes a gemm_mr by gemm_nr tile of the
+            result entirely in SIMD registers.  Packing also means lhs and rhs can be any
+            matrix expression, since each of their elements is only read a few times.
+        */
+        const long gemm_mr = 4;
+        const long gemm_nr = 16;
+        const long gemm_kc = 256;
+        const long gemm_mc = 64;
+        const long gemm_nc = 512;
+
+        template <typename EXP>
+        void gemm_pack_lhs (
+            float* packed,
+            const EXP& lhs,
+            long row,
+            long num_rows,
+            long col,
+            long num_cols
+        )
+        {
+            // Strips of gemm_mr rows, each stored column by column, with the last strip
+            // padded with zeros.
+            for (long r = 0; r < num_rows; r += gemm_mr)
+            {
+                const long rows = std::min(gemm_mr, num_rows-r);
+                for (long c = 0; c < num_cols; ++c)
+                {
+                    long i = 0;
+                    for (; i < rows; ++i)
+                        *packed++ = lhs(row+r+i, col+c);
+                    for (; i < gemm_mr; ++i)
+                        *packed++ = 0;
+                }
+            }
+        }
+
+        template <typename EXP>
+        void gemm_pack_rhs (
+            float* packed,
+            const EXP& rhs,
+            long row,
+            long num_rows,
+            long col,
+            long num_cols
+        )
+        {
+            // Strips of gemm_nr columns, each stored row by row, with the last strip
+            // padded with zeros.
+            for (long c = 0; c < num_cols; c += gemm_nr)
+            {
+                const long cols = std::min(gemm_nr, num_cols-c);
+                for (long r = 0; r < num_rows; ++r)
+                {
+                    long i = 0;
+                    for (; i < cols; ++i)
+                        *packed++ = rhs(row+r, col+c+i);
+                    for (; i < gemm_nr; ++i)
+                        *packed++ = 0;
+                }
+            }
+        }
+
+        inline void gemm_micro_kernel (
+            const float* a,
+            const float* b,
+            long k,
+            float* c
+        )
+        /*!
+            ensures
+                - c is a row major gemm_mr by gemm_nr matrix.  This function sets it to the
+                  product of the packed lhs strip a and the packed rhs strip b.
+        !*/
+        {
+            simd8f c00(0), c01(0), c10(0), c11(0), c20(0), c21(0), c30(0), c31(0);
+            simd8f b0, b1;
+            for (long i = 0; i < k; ++i, a += gemm_mr, b += gemm_nr)
+            {
+                b0.load(b);
+                b1.load(b+8);
+                simd8f a0(a[0]);
+                c00 += a0*b0;
+                c01 += a0*b1;
+                simd8f a1(a[1]);
+                c10 += a1*b0;
+                c11 += a1*b1;
+                simd8f a2(a[2]);
+                c20 += a2*b0;
+                c21 += a2*b1;
+                simd8f a3(a[3]);
+                c30 += a3*b0;
+                c31 += a3*b1;
+            }
+            c00.store(c);    c01.store(c+8);
+            c10.store(c+16); c11.store(c+24);
+            c20.store(c+32); c21.store(c+40);
+            c30.store(c+48); c31.store(c+56);
+        }
+
+        template <
+            typename matrix_dest_type,
+            typename EXP1,
+            typename EXP2
+            >
+        void gemm_block (
+            matrix_dest_type& dest,
+            const EXP1& lhs,
+            const EXP2& rhs,
+            const rectangle& area
+        )
+        /*!
+            ensures
+                - performs dest += lhs*rhs for the part of dest inside area.
+        !*/
+        {
+            const long num_rows = area.height();
+            const long num_cols = area.width();
+            std::vector<float> packed_lhs(((num_rows+gemm_mr-1)/gemm_mr)*gemm_mr*gemm_kc);
+            std::vector<float> packed_rhs(((num_cols+gemm_nr-1)/gemm_nr)*gemm_nr*gemm_kc);
+            float tile[gemm_mr*gemm_nr];
+            for (long k = 0; k < lhs.nc(); k += gemm_kc)
+            {
+                const long kc = std::min(gemm_kc, lhs.nc()-k);
+                gemm_pack_rhs(&packed_rhs[0], rhs, k, kc, area.left(), num_cols);
+                gemm_pack_lhs(&packed_lhs[0], lhs, area.top(), num_rows, k, kc);
+                for (long c = 0; c < num_cols; c += gemm_nr)
+                {
+                    const float* b = &packed_rhs[0] + (c/gemm_nr)*gemm_nr*kc;
+                    const long cols = std::min(gemm_nr, num_cols-c);
+                    for (long r = 0; r < num_rows; r += gemm_mr)
+                    {
+                        gemm_micro_kernel(&packed_lhs[0] + (r/gemm_mr)*gemm_mr*kc, b, kc, tile);
+                        const long rows = std::min(gemm_mr, num_rows-r);
+                        for (long i = 0; i < rows; ++i)
+                        {
+                            for (long j = 0; j < cols; ++j)
+                                dest(area.top()+r+i, area.left()+c+j) += tile[i*gemm_nr+j];
+                        }
+                    }
+                }
+            }
+        }
+
+        template <
+            typename matrix_dest_type,
+            typename EXP1,
+            typename EXP2
+            >
+        typename disable_if_c<is_same_type<typename EXP1::type,float>::value && is_same_type<typename EXP2::type,float>::value, bool>::type
+        packed_matrix_multiply (
+            matrix_dest_type& ,
+            const EXP1& ,
+            const EXP2& 
+        )
+        {
+            // The packed GEMM is only implemented for float.
+            return false;
+        }
+
+        template <
+            typename matrix_dest_type,
+            typename EXP1,
+            typename EXP2
+            >
+        typename enable_if_c<is_same_type<typename EXP1::type,float>::value && is_same_type<typename EXP2::type,float>::value, bool>::type
+        packed_matrix_multiply (
+            matrix_dest_type& dest,
+            const EXP1& lhs,
+            const EXP2& rhs
+        )
+        /*!
+            ensures
+                - performs dest += lhs*rhs and returns true.
+        !*/
+        {
+            const long row_blocks = (lhs.nr()+gemm_mc-1)/gemm_mc;
+            const long col_blocks = (rhs.nc()+gemm_nc-1)/gemm_nc;
+            auto do_block = [&](long i)
+            {
+                const long r = (i/col_blocks)*gemm_mc;
+                const long c = (i%col_blocks)*gemm_nc;
+                gemm_block(dest, lhs, rhs, rectangle(c, r,
+                        std::min(c+gemm_nc, rhs.nc())-1, std::min(r+gemm_mc, lhs.nr())-1));
+            };
+
+            // Only bother with threads if there is enough work to amortize their
+            // overhead.  Each block of dest is written by exactly one thread.
+            const double flops = 2.0*lhs.nr()*lhs.nc()*rhs.nc();
+            if (row_blocks*col_blocks > 1 && flops > 4e6 && default_thread_pool().num_threads_in_pool() > 1)
+            {
+                parallel_for(0, row_blocks*col_blocks, do_block);
+            }
+            else
+            {
+                for (long i = 0; i < row_blocks*col_blocks; ++i)
+                    do_block(i);
+            }
+            return true;
+        }
+    }
+
 // ------------------------------------------------------------------------------------
 
     template <
@@ -82,7 +295,7 @@ namespace dlib
         {
             matrix_assign_default(dest, lhs*rhs, 1, true);
         }
-        else
+        else if (!ma::packed_matrix_multiply(dest, lhs, rhs))
         {
             // if the lhs and rhs matrices are big enough we should use a cache friendly
             // algorithm that computes the matrix multiply in blocks.  
@@ -7,6 +7,10 @@
 #include "matrix_utilities.h"
 #include "../hash.h"
 #include "../algs.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #ifdef DLIB_USE_MKL_FFT
 #include <mkl_dfti.h>
@@ -100,6 +104,512 @@ namespace dlib
             }
         }
 
+    // ------------------------------------------------------------------------------------
+
+        /*
+            The code above only handles sizes that are powers of two.  What follows is a
+            mixed-radix FFT for sizes of the form 2^a*3^b*5^c, which uses a recursive
+            decimation in time algorithm with radix 2, 3, 4, and 5 butterflies.  Any other
+            size is handled with Bluestein's algorithm, which turns a size n DFT into a
+            circular convolution that is evaluated with power of two FFTs.  The twiddle
+            factors and chirps for a size are computed once, put in an immutable fft_plan,
+            and kept in a global cache so repeated transforms of the same size don't
+            recompute them.
+        */
+
+        template <typename T>
+        class fft_plan
+        {
+        public:
+            explicit fft_plan (
+                long n
+            );
+            /*!
+                requires
+                    - n > 0
+                ensures
+                    - #size() == n
+            !*/
+
+            long size (
+            ) const { return n; }
+
+            void transform (
+                const std::complex<T>* in,
+                std::complex<T>* out,
+                bool do_backward_fft
+            ) const;
+            /*!
+                requires
+                    - in and out point to arrays of size() elements.
+                    - in != out
+                ensures
+                    - #out == the DFT of in, or the unnormalized inverse DFT if
+                      do_backward_fft == true.  This is the same transform fft1d_inplace()
+                      computes.
+                    - This function is threadsafe.
+            !*/
+
+        private:
+
+            void forward (
+                const std::complex<T>* in,
+                std::complex<T>* out
+            ) const;
+
+            void work (
+                std::complex<T>* out,
+                const std::complex<T>* in,
+                long fstride,
+                const long* f
+            ) const;
+
+            void butterfly2 (std::complex<T>* out, long fstride, long m) const;
+            void butterfly3 (std::complex<T>* out, long fstride, long m) const;
+            void butterfly4 (std::complex<T>* out, long fstride, long m) const;
+            void butterfly5 (std::complex<T>* out, long fstride, long m) const;
+
+            static std::complex<T> unit_phasor (
+                long double numerator,
+                long double denominator
+            )
+            {
+                // returns exp(-2*pi*i*numerator/denominator), computed in long double so
+                // the float plans are as accurate as possible.
+                const long double arg = -6.283185307179586476925286766559L*numerator/denominator;
+                return std::complex<T>(std::cos(arg), std::sin(arg));
+            }
+
+            long n;
+            // Pairs of (radix, remaining size) describing each stage of the mixed-radix
+            // FFT.  Empty if Bluestein's algorithm is used.
+            std::vector<long> factors;
+            std::vector<std::complex<T> > tw;
+
+            // Bluestein's algorithm state.
+            std::vector<std::complex<T> > chirp;
+            std::vector<std::complex<T> > chirp_fft;
+            std::shared_ptr<const fft_plan> conv_plan;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename plan_type>
+        std::shared_ptr<const plan_type> get_fft_plan (
+            long n
+        )
+        /*!
+            ensures
+                - returns a plan_type(n) object, reusing a previously made one if possible.
+                - This function is threadsafe.
+        !*/
+        {
+            static std::mutex m;
+            static std::map<long, std::shared_ptr<const plan_type> > plans;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                auto i = plans.find(n);
+                if (i != plans.end())
+                    return i->second;
+            }
+
+            // Make the plan without holding the lock since making a Bluestein plan calls
+            // get_fft_plan() to get the plan for the convolution.
+            auto plan = std::make_shared<const plan_type>(n);
+
+            std::lock_guard<std::mutex> lock(m);
+            // Don't let the cache grow without bound if someone transforms lots of
+            // different sizes.  Anyone still using a plan holds a shared_ptr to it.
+            if (plans.size() >= 64)
+                plans.clear();
+            return plans.insert(std::make_pair(n, plan)).first->second;
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        fft_plan<T>::
+        fft_plan (
+            long n_
+        ) : n(n_)
+        {
+            // The factoring loop below never ends for n == 0.
+            DLIB_CASSERT(n > 0, "n: " << n);
+            long remaining = n;
+            const long radixes[] = {4, 2, 3, 5};
+            for (long p : radixes)
+            {
+                while (remaining%p == 0)
+                {
+                    remaining /= p;
+                    factors.push_back(p);
+                    factors.push_back(remaining);
+                }
+            }
+
+            if (remaining == 1)
+            {
+                tw.resize(n);
+                for (long i = 0; i < n; ++i)
+                    tw[i] = unit_phasor(i, n);
+            }
+            else
+            {
+                factors.clear();
+
+                // Bluestein's algorithm uses nk = (k*k + n*n - (k-n)*(k-n))/2 to write the
+                // DFT as a convolution with the chirp exp(-pi*i*k*k/n).
+                long conv_size = 1;
+                while (conv_size < 2*n-1)
+                    conv_size *= 2;
+
+                chirp.resize(n);
+                for (long k = 0; k < n; ++k)
+                {
+                    // k*k mod 2n, since the chirp has period 2n, avoids losing precision
+                    // for large k.
+                    const long kk = static_cast<long>((static_cast<long long>(k)*k)%(2*n));
+                    chirp[k] = unit_phasor(kk, 2*n);
+                }
+
+                conv_plan = get_fft_plan<fft_plan>(conv_size);
+                std::vector<std::complex<T> > b(conv_size);
+                b[0] = std::conj(chirp[0]);
+                for (long k = 1; k < n; ++k)
+                    b[k] = b[conv_size-k] = std::conj(chirp[k]);
+                chirp_fft.resize(conv_size);
+                conv_plan->transform(&b[0], &chirp_fft[0], false);
+                // fold the normalization of the inverse FFT into the filter
+                for (auto& v : chirp_fft)
+                    v /= static_cast<T>(conv_size);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        void fft_plan<T>::
+        transform (
+            const std::complex<T>* in,
+            std::complex<T>* out,
+            bool do_backward_fft
+        ) const
+        {
+            if (!do_backward_fft)
+            {
+                forward(in, out);
+            }
+            else
+            {
+                // The inverse DFT is conj(DFT(conj(x))).
+                std::vector<std::complex<T> > temp(in, in+n);
+                for (auto& v : temp)
+                    v = std::conj(v);
+                forward(&temp[0], out);
+                for (long i = 0; i < n; ++i)
+                    out[i] = std::conj(out[i]);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        void fft_plan<T>::
+        forward (
+            const std::complex<T>* in,
+            std::complex<T>* out
+        ) const
+        {
+            if (n == 1)
+            {
+                out[0] = in[0];
+            }
+            else if (factors.size() != 0)
+            {
+                work(out, in, 1, &factors[0]);
+            }
+            else
+            {
+                const long conv_size = conv_plan->size();
+                std::vector<std::complex<T> > a(conv_size), a_fft(conv_size);
+                for (long k = 0; k < n; ++k)
+                    a[k] = in[k]*chirp[k];
+                conv_plan->transform(&a[0], &a_fft[0], false);
+                for (long k = 0; k < conv_size; ++k)
+                    a_fft[k] *= chirp_fft[k];
+                conv_plan->transform(&a_fft[0], &a[0], true);
+                for (long k = 0; k < n; ++k)
+                    out[k] = a[k]*chirp[k];
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        void fft_plan<T>::
+        work (
+            std::complex<T>* out,
+            const std::complex<T>* in,
+            long fstride,
+            const long* f
+        ) const
+        {
+            // Split the input into p interleaved sub-sequences of length m, transform
+            // them into consecutive blocks of out, and then combine the blocks with
+            // radix p butterflies.
+            const long p = f[0];
+            const long m = f[1];
+            std::complex<T>* const out_end = out + p*m;
+            std::complex<T>* const out_begin = out;
+            if (m == 1)
+            {
+                for (; out != out_end; ++out, in += fstride)
+                    *out = *in;
+            }
+            else
+            {
+                for (; out != out_end; out += m, in += fstride)
+                    work(out, in, fstride*p, f+2);
+            }
+
+            switch (p)
+            {
+                case 2: butterfly2(out_begin, fstride, m); break;
+                case 3: butterfly3(out_begin, fstride, m); break;
+                case 4: butterfly4(out_begin, fstride, m); break;
+                case 5: butterfly5(out_begin, fstride, m); break;
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        void fft_plan<T>::
+        butterfly2 (
+            std::complex<T>* out,
+            long fstride,
+            long m
+        ) const
+        {
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> t = out[k+m]*tw[k*fstride];
+                out[k+m] = out[k] - t;
+                out[k] += t;
+            }
+        }
+
+        template <typename T>
+        void fft_plan<T>::
+        butterfly3 (
+            std::complex<T>* out,
+            long fstride,
+            long m
+        ) const
+        {
+            const T sin60 = static_cast<T>(0.866025403784438646763723170752936L);
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> x1 = out[k+m]*tw[k*fstride];
+                const std::complex<T> x2 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> sum = x1 + x2;
+                const std::complex<T> diff = sin60*(x1 - x2);
+                const std::complex<T> a = out[k] - static_cast<T>(0.5)*sum;
+                out[k] += sum;
+                // a -/+ i*diff
+                out[k+m]   = std::complex<T>(a.real() + diff.imag(), a.imag() - diff.real());
+                out[k+2*m] = std::complex<T>(a.real() - diff.imag(), a.imag() + diff.real());
+            }
+        }
+
+        template <typename T>
+        void fft_plan<T>::
+        butterfly4 (
+            std::complex<T>* out,
+            long fstride,
+            long m
+        ) const
+        {
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> x1 = out[k+m]*tw[k*fstride];
+                const std::complex<T> x2 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> x3 = out[k+3*m]*tw[3*k*fstride];
+                const std::complex<T> t0 = out[k] + x2;
+                const std::complex<T> t1 = out[k] - x2;
+                const std::complex<T> t2 = x1 + x3;
+                const std::complex<T> t3 = x1 - x3;
+                out[k]     = t0 + t2;
+                out[k+2*m] = t0 - t2;
+                // t1 -/+ i*t3
+                out[k+m]   = std::complex<T>(t1.real() + t3.imag(), t1.imag() - t3.real());
+                out[k+3*m] = std::complex<T>(t1.real() - t3.imag(), t1.imag() + t3.real());
+            }
+        }
+
+        template <typename T>
+        void fft_plan<T>::
+        butterfly5 (
+            std::complex<T>* out,
+            long fstride,
+            long m
+        ) const
+        {
+            // ya == exp(-2*pi*i/5), yb == exp(-4*pi*i/5)
+            const std::complex<T> ya = tw[fstride*m];
+            const std::complex<T> yb = tw[2*fstride*m];
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> x0 = out[k];
+                const std::complex<T> x1 = out[k+m]*tw[k*fstride];
+                const std::complex<T> x2 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> x3 = out[k+3*m]*tw[3*k*fstride];
+                const std::complex<T> x4 = out[k+4*m]*tw[4*k*fstride];
+
+                const std::complex<T> s14 = x1 + x4;
+                const std::complex<T> d14 = x1 - x4;
+                const std::complex<T> s23 = x2 + x3;
+                const std::complex<T> d23 = x2 - x3;
+
+                out[k] = x0 + s14 + s23;
+
+                const std::complex<T> a1 = x0 + ya.real()*s14 + yb.real()*s23;
+                const std::complex<T> b1(d14.imag()*ya.imag() + d23.imag()*yb.imag(),
+                                        -d14.real()*ya.imag() - d23.real()*yb.imag());
+                out[k+m]   = a1 - b1;
+                out[k+4*m] = a1 + b1;
+
+                const std::complex<T> a2 = x0 + yb.real()*s14 + ya.real()*s23;
+                const std::complex<T> b2(-d14.imag()*yb.imag() + d23.imag()*ya.imag(),
+                                         d14.real()*yb.imag() - d23.real()*ya.imag());
+                out[k+2*m] = a2 + b2;
+                out[k+3*m] = a2 - b2;
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        class real_fft_plan
+        {
+            /*!
+                This object computes the DFT of a real sequence of even length n with a
+                complex FFT of length n/2, by treating the even and odd samples as the real
+                and imaginary parts of a complex sequence.  Odd lengths fall back to a full
+                complex FFT.
+            !*/
+        public:
+            explicit real_fft_plan (
+                long n_
+            ) : n(n_)
+            {
+                DLIB_CASSERT(n > 0, "n: " << n);
+                if (n%2 == 0)
+                {
+                    plan = get_fft_plan<fft_plan<T> >(n/2);
+                    tw.resize(n/2+1);
+                    for (long k = 0; k <= n/2; ++k)
+                    {
+                        const long double arg = -6.283185307179586476925286766559L*k/n;
+                        tw[k] = std::complex<T>(std::cos(arg), std::sin(arg));
+                    }
+                }
+                else
+                {
+                    plan = get_fft_plan<fft_plan<T> >(n);
+                }
+            }
+
+            long size (
+            ) const { return n; }
+
+            void forward (
+                const T* in,
+                std::complex<T>* out
+            ) const
+            /*!
+                requires
+                    - in points to size() elements and out to size()/2+1 elements.
+                ensures
+                    - #out == the first size()/2+1 elements of the DFT of in.
+            !*/
+            {
+                if (n%2 != 0)
+                {
+                    std::vector<std::complex<T> > x(in, in+n), temp(n);
+                    plan->transform(&x[0], &temp[0], false);
+                    std::copy(temp.begin(), temp.begin()+n/2+1, out);
+                    return;
+                }
+
+                const long h = n/2;
+                std::vector<std::complex<T> > z(h), zf(h);
+                for (long j = 0; j < h; ++j)
+                    z[j] = std::complex<T>(in[2*j], in[2*j+1]);
+                plan->transform(&z[0], &zf[0], false);
+                for (long k = 0; k <= h; ++k)
+                {
+                    const std::complex<T> zk = zf[k%h];
+                    const std::complex<T> zc = std::conj(zf[(h-k)%h]);
+                    const std::complex<T> even = static_cast<T>(0.5)*(zk + zc);
+                    // (zk - zc)/(2i)
+                    const std::complex<T> d = static_cast<T>(0.5)*(zk - zc);
+                    const std::complex<T> odd(d.imag(), -d.real());
+                    out[k] = even + tw[k]*odd;
+                }
+            }
+
+            void backward (
+                const std::complex<T>* in,
+                T* out
+            ) const
+            /*!
+                requires
+                    - in points to size()/2+1 elements and out to size() elements.
+                ensures
+                    - #out == the unnormalized inverse DFT of the Hermitian symmetric
+                      sequence whose first size()/2+1 elements are given by in.
+            !*/
+            {
+                if (n%2 != 0)
+                {
+                    std::vector<std::complex<T> > x(n), temp(n);
+                    std::copy(in, in+n/2+1, x.begin());
+                    for (long k = n/2+1; k < n; ++k)
+                        x[k] = std::conj(in[n-k]);
+                    plan->transform(&x[0], &temp[0], true);
+                    for (long j = 0; j < n; ++j)
+                        out[j] = temp[j].real();
+                    return;
+                }
+
+                const long h = n/2;
+                std::vector<std::complex<T> > z(h), zt(h);
+                for (long k = 0; k < h; ++k)
+                {
+                    const std::complex<T> xk = in[k];
+                    const std::complex<T> xc = std::conj(in[h-k]);
+                    const std::complex<T> even = xk + xc;
+                    const std::complex<T> odd = (xk - xc)*std::conj(tw[k]);
+                    // even + i*odd
+                    z[k] = std::complex<T>(even.real() - odd.imag(), even.imag() + odd.real());
+                }
+                plan->transform(&z[0], &zt[0], true);
+                // even and odd are twice the DFTs of the even and odd samples, which
+                // scales the length h inverse transform to match a length n one.
+                for (long j = 0; j < h; ++j)
+                {
+                    out[2*j] = zt[j].real();
+                    out[2*j+1] = zt[j].imag();
+                }
+            }
+
+        private:
+            long n;
+            std::shared_ptr<const fft_plan<T> > plan;
+            std::vector<std::complex<T> > tw;
+        };
+
     // ------------------------------------------------------------------------------------
 
         template <typename T>
@@ -107,7 +617,9 @@ namespace dlib
         {
             /*!
                 The point of this object is to cache the twiddle values so we don't
-                recompute them over and over inside R8TX().
+                recompute them over and over inside R8TX().  It also holds on to the
+                fft_plan for sizes that aren't a power of two, so transforming all the rows
+                of a matrix only looks the plan up once.
             !*/
         public:
 
@@ -152,8 +664,18 @@ namespace dlib
                 return &data[p][0];
             }
 
+            const fft_plan<T>& get_plan (
+                long n
+            )
+            {
+                if (!plan || plan->size() != n)
+                    plan = get_fft_plan<fft_plan<T> >(n);
+                return *plan;
+            }
+
         private:
             std::vector<std::vector<std::complex<T> > > data;
+            std::shared_ptr<const fft_plan<T> > plan;
         };
 
     // ----------------------------------------------------------------------------------------
@@ -226,16 +748,16 @@ namespace dlib
         /*!
             requires
                 - is_vector(data) == true
-                - is_power_of_two(data.size()) == true
             ensures
                 - This routine replaces the input std::complex<double> vector by its finite
                   discrete complex fourier transform if do_backward_fft==true.  It replaces
                   the input std::complex<double> vector by its finite discrete complex
                   inverse fourier transform if do_backward_fft==false.
 
-                  The implementation is a radix-2 FFT, but with faster shortcuts for
-                  radix-4 and radix-8. It performs as many radix-8 iterations as possible,
-                  and then finishes with a radix-2 or -4 iteration if needed.
+                  For power of two sizes the implementation is a radix-2 FFT, but with
+                  faster shortcuts for radix-4 and radix-8. It performs as many radix-8
+                  iterations as possible, and then finishes with a radix-2 or -4 iteration
+                  if needed.  Other sizes are handed to an fft_plan.
         !*/
         {
             COMPILE_TIME_ASSERT((is_same_type<double,T>::value || is_same_type<float,T>::value || is_same_type<long double,T>::value ));
@@ -243,6 +765,13 @@ namespace dlib
             if (data.size() == 0)
                 return;
 
+            if (!is_power_of_two(data.size()))
+            {
+                const std::vector<std::complex<T> > temp(&data(0), &data(0)+data.size());
+                cs.get_plan(data.size()).transform(&temp[0], &data(0), do_backward_fft);
+                return;
+            }
+
             std::complex<T>* const b = &data(0);
             int L[16],L1,L2,L3,L4,L5,L6,L7,L8,L9,L10,L11,L12,L13,L14,L15;
             int j1,j2,j3,j4,j5,j6,j7,j8,j9,j10,j11,j12,j13,j14;
@@ -366,16 +895,6 @@ namespace dlib
             bool do_backward_fft
         )
         {
-            // make sure requires clause is not broken
-            DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-                "\t matrix fft(data)"
-                << "\n\t The number of rows and columns must be powers of two."
-                << "\n\t data.nr(): "<< data.nr()
-                << "\n\t data.nc(): "<< data.nc()
-                << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-                << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
             if (data.size() == 0)
                 return;
 
@@ -411,15 +930,6 @@ namespace dlib
     {
         // You have to give a complex matrix
         COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix fft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
 
         if (data.nr() == 1 || data.nc() == 1)
         {
@@ -441,15 +951,6 @@ namespace dlib
     {
         // You have to give a complex matrix
         COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix ifft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
 
         matrix<typename EXP::type> temp;
         if (data.size() == 0)
@@ -475,16 +976,6 @@ namespace dlib
     typename enable_if_c<NR==1||NC==1>::type fft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
     // Note that we don't divide the outputs by data.size() so this isn't quite the inverse.
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void fft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         impl::twiddles<T> cs;
         impl::fft1d_inplace(data, false, cs);
     }
@@ -493,16 +984,6 @@ namespace dlib
     typename disable_if_c<NR==1||NC==1>::type fft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
     // Note that we don't divide the outputs by data.size() so this isn't quite the inverse.
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void fft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         impl::fft2d_inplace(data, false);
     }
 
@@ -511,16 +992,6 @@ namespace dlib
     template < typename T, long NR, long NC, typename MM, typename L >
     typename enable_if_c<NR==1||NC==1>::type ifft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void ifft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         impl::twiddles<T> cs;
         impl::fft1d_inplace(data, true, cs);
     }
@@ -528,17 +999,118 @@ namespace dlib
     template < typename T, long NR, long NC, typename MM, typename L >
     typename disable_if_c<NR==1||NC==1>::type ifft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
     {
+        impl::fft2d_inplace(data, true);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<std::complex<typename EXP::type> > rfft (const matrix_exp<EXP>& data)
+    {
+        typedef typename EXP::type T;
+        // You have to give a real matrix
+        COMPILE_TIME_ASSERT((is_same_type<double,T>::value || is_same_type<float,T>::value || is_same_type<long double,T>::value ));
+
+        matrix<std::complex<T> > out;
+        if (data.size() == 0)
+            return out;
+
+        if (data.nr() == 1 || data.nc() == 1)
+        {
+            const matrix<T,0,1> x = reshape_to_column_vector(data);
+            if (data.nc() == 1)
+                out.set_size(x.size()/2+1, 1);
+            else
+                out.set_size(1, x.size()/2+1);
+            impl::get_fft_plan<impl::real_fft_plan<T> >(x.size())->forward(&x(0), &out(0));
+        }
+        else
+        {
+            // Do the real transform of each row and then a complex transform of each
+            // column of the result.  Like the complex 2D FFT, this is done in double
+            // precision.
+            out.set_size(data.nr(), data.nc()/2+1);
+            const auto plan = impl::get_fft_plan<impl::real_fft_plan<double> >(data.nc());
+            matrix<double,1,0> row;
+            matrix<std::complex<double>,1,0> row_out(out.nc());
+            for (long r = 0; r < data.nr(); ++r)
+            {
+                row = matrix_cast<double>(rowm(data,r));
+                plan->forward(&row(0), &row_out(0));
+                set_rowm(out,r) = matrix_cast<std::complex<T> >(row_out);
+            }
+
+            matrix<std::complex<double> > buff;
+            impl::twiddles<double> cs;
+            for (long c = 0; c < out.nc(); ++c)
+            {
+                buff = matrix_cast<std::complex<double> >(colm(out,c));
+                impl::fft1d_inplace(buff, false, cs);
+                set_colm(out,c) = matrix_cast<std::complex<T> >(buff);
+            }
+        }
+        return out;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data,
+        long n
+    )
+    {
+        typedef typename EXP::type::value_type T;
+        // You have to give a complex matrix
+        COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
         // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void ifft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
+        DLIB_CASSERT(n > 0 && ((data.nc() == 1 && data.nr() == n/2+1) || (data.nc() != 1 && data.nc() == n/2+1)),
+            "\t matrix irfft(data, n)"
+            << "\n\t data must hold the first n/2+1 frequencies of the transformed dimension."
             << "\n\t data.nr(): "<< data.nr()
             << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
+            << "\n\t n:         "<< n
             );
 
-        impl::fft2d_inplace(data, true);
+        matrix<T> out;
+        if (data.size() == 0)
+            return out;
+
+        if (data.nr() == 1 || data.nc() == 1)
+        {
+            const matrix<std::complex<T>,0,1> x = reshape_to_column_vector(data);
+            if (data.nc() == 1)
+                out.set_size(n, 1);
+            else
+                out.set_size(1, n);
+            impl::get_fft_plan<impl::real_fft_plan<T> >(n)->backward(&x(0), &out(0));
+            out /= n;
+        }
+        else
+        {
+            // Undo the column transforms and then the real row transforms.
+            matrix<std::complex<double> > temp = matrix_cast<std::complex<double> >(data);
+            matrix<std::complex<double> > buff;
+            impl::twiddles<double> cs;
+            for (long c = 0; c < temp.nc(); ++c)
+            {
+                buff = colm(temp,c);
+                impl::fft1d_inplace(buff, true, cs);
+                set_colm(temp,c) = buff;
+            }
+
+            out.set_size(data.nr(), n);
+            const auto plan = impl::get_fft_plan<impl::real_fft_plan<double> >(n);
+            matrix<std::complex<double>,1,0> row;
+            matrix<double,1,0> row_out(n);
+            for (long r = 0; r < temp.nr(); ++r)
+            {
+                row = rowm(temp,r);
+                plan->backward(&row(0), &row_out(0));
+                set_rowm(out,r) = matrix_cast<T>(row_out/out.size());
+            }
+        }
+        return out;
     }
 
 // ----------------------------------------------------------------------------------------
@@ -559,16 +1131,6 @@ namespace dlib
         const matrix<std::complex<double>,NR,NC,MM,L>& data
     )
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix fft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         if (data.size() == 0)
             return data;
 
@@ -591,16 +1153,6 @@ namespace dlib
         const matrix<std::complex<double>,NR,NC,MM,L>& data
     )
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix ifft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         if (data.size() == 0)
             return data;
 
@@ -653,16 +1205,6 @@ namespace dlib
         const matrix<std::complex<double>,NR,NC,MM,L>& data,
         bool do_backward_fft)
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix fft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         if (data.size() == 0)
             return data;
 
@@ -724,16 +1266,6 @@ namespace dlib
         bool do_backward_fft
     )
     {
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void ifft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
         if (data.size() == 0)
             return;
 
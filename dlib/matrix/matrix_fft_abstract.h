@@ -29,8 +29,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<> that itself contains double, float, or long double.
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - Computes the 1 or 2 dimensional discrete Fourier transform of the given data
               matrix and returns it.  In particular, we return a matrix D such that:
@@ -40,6 +38,12 @@ namespace dlib
                 - starting with D(0,0), D contains progressively higher frequency components
                   of the input data.
                 - ifft(D) == D
+            - data can have any number of rows and columns.  Powers of two are the
+              fastest, followed by sizes with no prime factors other than 2, 3, and 5.
+              Any other size is handled with Bluestein's algorithm, which costs a few
+              power of two FFTs of at least twice the size.
+            - The twiddle factors for sizes that aren't a power of two are computed once
+              and cached, so repeatedly transforming data of the same size is efficient.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -51,8 +55,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<> that itself contains double, float, or long double.
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - Computes the 1 or 2 dimensional inverse discrete Fourier transform of the
               given data vector and returns it.  In particular, we return a matrix D such
@@ -77,8 +79,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<> that itself contains double, float, or long double.
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - This function is identical to fft() except that it does the FFT in-place.
               That is, after this function executes we will have:
@@ -100,8 +100,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<> that itself contains double, float, or long double.
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - This function is identical to ifft() except that it does the inverse FFT
               in-place.  That is, after this function executes we will have:
@@ -110,6 +108,60 @@ namespace dlib
                   inverse transformation.  
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<std::complex<typename EXP::type> > rfft (
+        const matrix_exp<EXP>& data
+    );
+    /*!
+        requires
+            - data contains real elements of type float, double, or long double.
+        ensures
+            - Computes the Fourier transform of a real valued matrix.  Since the transform
+              of real data is Hermitian symmetric, only the non-redundant half of it is
+              computed, which takes about half the time of fft(complex_matrix(data)).  In
+              particular, we return a matrix D such that:
+                - if (data is a column vector) then
+                    - D.nr() == data.nr()/2+1
+                    - D.nc() == 1
+                    - D == rowm(fft(complex_matrix(data)), range(0, D.nr()-1))
+                - else if (data is a row vector) then
+                    - D.nr() == 1
+                    - D.nc() == data.nc()/2+1
+                    - D == colm(fft(complex_matrix(data)), range(0, D.nc()-1))
+                - else
+                    - D.nr() == data.nr()
+                    - D.nc() == data.nc()/2+1
+                    - D == colm(fft(complex_matrix(data)), range(0, D.nc()-1))
+                - irfft(D, data.size() or data.nc()) == data
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data,
+        long n
+    );
+    /*!
+        requires
+            - data contains elements of type std::complex<> that itself contains double, float, or long double.
+            - n > 0
+            - if (data.nc() == 1) then
+                - data.nr() == n/2+1
+            - else
+                - data.nc() == n/2+1
+        ensures
+            - This is the inverse of rfft().  It treats data as the first n/2+1 frequencies
+              of a Hermitian symmetric spectrum and returns the real matrix whose
+              transform it is.  That is, if data is a column vector we return a column
+              vector of n elements, if it's a row vector we return a row vector of n
+              elements, and otherwise a data.nr() by n matrix.
+            - n is needed since rfft() maps both 2*k and 2*k+1 elements to k+1 frequencies.
+            - irfft(rfft(X), X.size() or X.nc()) == X
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -56,6 +56,13 @@
     Finally, you can chain as many objects together using the << and >> operators as you
     like.
 
+    If you are going to load a large object, like a big matrix or a deep neural network,
+    many times then you can save it as a mapped archive instead:
+        serialize_mapped("your_file.dat") << some_object << another_object;
+    You read it back exactly the same way, deserialize("your_file.dat") >> some_object, since
+    deserialize() recognizes mapped archives and otherwise reads the regular format.  See
+    the MAPPED ARCHIVES section below for details.
+
 
     This file provides serialization support to the following object types:
         - The C++ base types (NOT including pointer types)
@@ -111,6 +118,31 @@
         flag.  
 
 
+    MAPPED ARCHIVES
+        A file written by serialize_mapped() contains the same serialization stream as
+        one written by serialize(), except that dense arrays of numbers are stored as
+        raw, 64 byte aligned, little endian blocks rather than element by element.
+        This is done for std::vector, row major dlib::matrix objects and tensors
+        holding arithmetic types other than bool.  deserialize(filename) memory maps
+        such files and loads those arrays with a single memcpy().  Tensors skip even
+        that when CUDA isn't in use, and instead point directly into the mapping, which
+        is kept alive as long as any of them do.  The mapping is private, so modifying
+        such a tensor never changes the file.
+        
+        The file starts with the 8 bytes "dlibmap1" and is zero padded to 64 bytes.
+        Then comes a sequence of records.  Each record starts with two little endian
+        uint64 values: the record type and the number of bytes in its payload.  Type 1
+        records hold a piece of the serialization stream.  Type 2 records hold a block,
+        whose payload starts at the next multiple of 64 bytes from the start of the
+        file.  A block is referenced from the stream simply by being the next record
+        after the stream bytes that precede it, so objects must be read back in the
+        order they were written, just like with regular serialization.
+
+        Mapped archives can only be read using deserialize(filename), or an istream
+        using a mapped_archive_reader, since the blocks are not part of the stream
+        itself.
+
+
     INTEGRAL SERIALIZATION FORMAT
         All C++ integral types (except the char types) are serialized to the following
         format:
@@ -163,6 +195,14 @@
 #include "unicode.h"
 #include "byte_orderer.h"
 #include "float_details.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
 
 namespace dlib
 {
@@ -692,6 +732,526 @@ namespace dlib
         deserialize_floating_point(item,in);
     }
 
+// ----------------------------------------------------------------------------------------
+
+    class mapped_file
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object holds the contents of a file in memory.  On POSIX systems the
+                file is mapped with mmap() so pages are only read from disk when they are
+                touched and are shared with the OS's page cache.  Elsewhere the whole file
+                is read into a buffer.  Either way data() is aligned to at least 64 bytes.
+
+                The mapping is private.  That is, you may write to data() but the writes
+                are only visible to this object and never change the file.
+
+                You can also make a mapped_file from bytes that are already in memory, in
+                which case they are copied into a buffer owned by this object.  This is
+                useful for reading a mapped archive that was written to a std::ostream.
+        !*/
+    public:
+
+        explicit mapped_file (
+            const std::string& filename
+        ) : ptr(0), length(0)
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            std::FILE* f = std::fopen(filename.c_str(), "rb");
+            if (!f)
+                throw serialization_error("Unable to open " + filename + " for reading.");
+            if (std::fseek(f, 0, SEEK_END) != 0 || std::ftell(f) < 0)
+            {
+                std::fclose(f);
+                throw serialization_error("Unable to get the size of " + filename + ".");
+            }
+            length = static_cast<size_t>(std::ftell(f));
+            if (length != 0)
+            {
+                void* p = ::mmap(0, length, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(f), 0);
+                if (p == MAP_FAILED)
+                {
+                    std::fclose(f);
+                    throw serialization_error("Unable to memory map " + filename + ".");
+                }
+                ptr = static_cast<char*>(p);
+                // We are about to read all of it, so ask the OS to start reading ahead.
+                ::madvise(p, length, MADV_WILLNEED);
+            }
+            std::fclose(f);
+#else
+            std::ifstream fin(filename.c_str(), std::ios::binary);
+            if (!fin)
+                throw serialization_error("Unable to open " + filename + " for reading.");
+            fin.seekg(0, std::ios::end);
+            length = static_cast<size_t>(fin.tellg());
+            fin.seekg(0);
+            buffer.reset(new char[length+64]);
+            ptr = buffer.get() + (64 - reinterpret_cast<std::uintptr_t>(buffer.get())%64)%64;
+            if (!fin.read(ptr, length))
+                throw serialization_error("Unable to read " + filename + ".");
+#endif
+        }
+
+        mapped_file (
+            const char* data_,
+            size_t size_
+        ) : ptr(0), length(size_)
+        {
+            buffer.reset(new char[length+64]);
+            ptr = buffer.get() + (64 - reinterpret_cast<std::uintptr_t>(buffer.get())%64)%64;
+            std::memcpy(ptr, data_, length);
+        }
+
+        ~mapped_file (
+        )
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if (ptr && !buffer)
+                ::munmap(ptr, length);
+#endif
+        }
+
+        char* data (
+        ) const { return ptr; }
+
+        size_t size (
+        ) const { return length; }
+
+    private:
+        char* ptr;
+        size_t length;
+        std::unique_ptr<char[]> buffer;
+
+        // restricted functions
+        mapped_file(const mapped_file&);
+        mapped_file& operator=(const mapped_file&);
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    namespace ser_helper
+    {
+        // Every mapped archive starts with this, followed by zero padding out to
+        // mapped_archive_header_size bytes.
+        const char mapped_archive_magic[8] = {'d','l','i','b','m','a','p','1'};
+        const size_t mapped_archive_header_size = 64;
+        const size_t mapped_archive_alignment = 64;
+
+        // The two kinds of records that follow the header.
+        const uint64 mapped_archive_stream_record = 1;
+        const uint64 mapped_archive_block_record = 2;
+
+        inline bool is_mapped_archive_header (
+            const char* data,
+            size_t size
+        )
+        {
+            return size >= sizeof(mapped_archive_magic) &&
+                std::equal(data, data+sizeof(mapped_archive_magic), mapped_archive_magic);
+        }
+
+        inline void reverse_elements (
+            char* data,
+            size_t num,
+            size_t elem_size
+        )
+        /*!
+            ensures
+                - reverses the bytes of each of the num elem_size sized elements in data.
+                  That is, converts between little endian and the host's byte order on a
+                  big endian host.
+        !*/
+        {
+            for (size_t i = 0; i < num; ++i, data += elem_size)
+                std::reverse(data, data+elem_size);
+        }
+
+        template <typename T>
+        struct is_mappable_type
+        {
+            // The types stored as raw blocks in a mapped archive.  bool is left out since
+            // its size and representation vary between compilers.
+            const static bool value = std::is_arithmetic<T>::value && !std::is_same<T,bool>::value;
+        };
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    class mapped_archive_writer : public std::streambuf
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This is the stream buffer behind serialize_mapped().  Everything written
+                to it through an ostream is regular dlib serialization output and is
+                stored in stream records.  In addition, serialize() routines that hold
+                large arrays of numbers check if their ostream is using a
+                mapped_archive_writer and, if so, call write_block() to store the array
+                as a raw, aligned, little endian block instead of encoding each element.
+                See the MAPPED ARCHIVES section at the top of this file for the layout.
+
+                The archive is written either to a file or to another ostream, e.g. a
+                std::ostringstream if you want to keep it in memory.
+        !*/
+    public:
+
+        explicit mapped_archive_writer (
+            const std::string& filename
+        ) : file(filename.c_str(), std::ios::binary), fout(file), pos(0)
+        {
+            if (!fout)
+                throw serialization_error("Unable to open " + filename + " for writing.");
+            write_header();
+        }
+
+        explicit mapped_archive_writer (
+            std::ostream& out
+        ) : fout(out), pos(0)
+        {
+            write_header();
+        }
+
+        ~mapped_archive_writer (
+        )
+        {
+            sync();
+        }
+
+        template <typename T>
+        void write_block (
+            const T* data,
+            size_t num
+        )
+        /*!
+            requires
+                - ser_helper::is_mappable_type<T>::value == true
+                - data points to num elements
+            ensures
+                - stores the num elements of data as the next block in the archive.  A
+                  mapped_archive_reader gets them back by calling read_block<T>(num) at
+                  the same point in the stream.
+            throws
+                - serialization_error if the block can't be written.
+        !*/
+        {
+            static_assert(ser_helper::is_mappable_type<T>::value, "Only arrays of numbers can be stored as blocks.");
+            if (sync() != 0)
+                throw serialization_error("Error writing to a mapped archive.");
+
+            const size_t bytes = num*sizeof(T);
+            write_record_header(ser_helper::mapped_archive_block_record, bytes);
+            const char zeros[ser_helper::mapped_archive_alignment] = {};
+            write_raw(zeros, (ser_helper::mapped_archive_alignment - pos%ser_helper::mapped_archive_alignment)%ser_helper::mapped_archive_alignment);
+
+            if (bo.host_is_little_endian())
+            {
+                write_raw(reinterpret_cast<const char*>(data), bytes);
+            }
+            else
+            {
+                std::vector<char> temp;
+                const size_t chunk = 4096;
+                for (size_t i = 0; i < num; i += chunk)
+                {
+                    const size_t n = std::min(chunk, num-i);
+                    temp.assign(reinterpret_cast<const char*>(data+i), reinterpret_cast<const char*>(data+i+n));
+                    ser_helper::reverse_elements(&temp[0], n, sizeof(T));
+                    write_raw(&temp[0], temp.size());
+                }
+            }
+
+            if (!fout)
+                throw serialization_error("Error writing to a mapped archive.");
+        }
+
+    protected:
+
+        virtual int_type overflow (
+            int_type c
+        )
+        {
+            if (c != traits_type::eof())
+                pending.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        virtual std::streamsize xsputn (
+            const char* s,
+            std::streamsize n
+        )
+        {
+            pending.append(s, static_cast<size_t>(n));
+            return n;
+        }
+
+        virtual int sync (
+        )
+        {
+            // Stream output is buffered until it's flushed or a block is written.  Then
+            // it goes to the file as one stream record.
+            if (!pending.empty())
+            {
+                write_record_header(ser_helper::mapped_archive_stream_record, pending.size());
+                write_raw(pending.data(), pending.size());
+                pending.clear();
+            }
+            fout.flush();
+            return fout ? 0 : -1;
+        }
+
+    private:
+
+        void write_header (
+        )
+        {
+            char header[ser_helper::mapped_archive_header_size] = {};
+            std::copy(ser_helper::mapped_archive_magic, ser_helper::mapped_archive_magic+8, header);
+            write_raw(header, sizeof(header));
+        }
+
+        void write_record_header (
+            uint64 type,
+            uint64 size
+        )
+        {
+            bo.host_to_little(type);
+            bo.host_to_little(size);
+            write_raw(reinterpret_cast<const char*>(&type), sizeof(type));
+            write_raw(reinterpret_cast<const char*>(&size), sizeof(size));
+        }
+
+        void write_raw (
+            const char* data,
+            size_t size
+        )
+        {
+            fout.write(data, size);
+            pos += size;
+        }
+
+        std::ofstream file;
+        std::ostream& fout;
+        uint64 pos;
+        std::string pending;
+        byte_orderer bo;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    class mapped_archive_reader : public std::streambuf
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This is the stream buffer used by deserialize() to read a mapped archive
+                written by serialize_mapped().  The archive is memory mapped and an
+                istream using this buffer reads the stream records straight out of the
+                mapping.  deserialize() routines that used write_block() call
+                read_block() to get a pointer to their data inside the mapping.  The
+                pointer keeps the mapping alive, so they can even keep using that memory
+                rather than copying it.
+
+                The mapped_file is only ever read by this object.  So many readers may
+                share one mapped_file, even from different threads.
+        !*/
+    public:
+
+        explicit mapped_archive_reader (
+            const std::shared_ptr<mapped_file>& file_
+        ) : file(file_), pos(ser_helper::mapped_archive_header_size)
+        {
+            if (file->size() < ser_helper::mapped_archive_header_size ||
+                !ser_helper::is_mapped_archive_header(file->data(), file->size()))
+                throw serialization_error("This file is not a dlib mapped archive.");
+            setg(file->data(), file->data(), file->data());
+        }
+
+        const std::shared_ptr<mapped_file>& get_file (
+        ) const { return file; }
+
+        template <typename T>
+        std::shared_ptr<T> read_block (
+            size_t num
+        )
+        /*!
+            requires
+                - ser_helper::is_mappable_type<T>::value == true
+            ensures
+                - reads the next block from the archive, which must have been written
+                  by write_block() with num elements of type T, and returns a pointer to
+                  its elements in the host's byte order.  On little endian hosts this
+                  points into the mapped file, and shares ownership of it.  On big
+                  endian hosts it points to a byte swapped copy.
+            throws
+                - serialization_error if the next thing in the archive isn't such a block.
+        !*/
+        {
+            static_assert(ser_helper::is_mappable_type<T>::value, "Only arrays of numbers can be stored as blocks.");
+            // Blocks are written right after flushing the stream, so if the last stream
+            // record hasn't been fully consumed the reader and writer disagree about
+            // what's in the file.
+            uint64 type, size;
+            if (gptr() != egptr() || !read_record_header(type, size) ||
+                type != ser_helper::mapped_archive_block_record || size != num*sizeof(T))
+            {
+                throw serialization_error("Unexpected data found while reading a block from a mapped archive.");
+            }
+
+            pos += (ser_helper::mapped_archive_alignment - pos%ser_helper::mapped_archive_alignment)%ser_helper::mapped_archive_alignment;
+            if (pos > file->size() || file->size() - pos < size)
+                throw serialization_error("Unexpected end of file while reading a block from a mapped archive.");
+
+            char* data = file->data() + pos;
+            pos += size;
+            setg(data+size, data+size, data+size);
+            if (bo.host_is_little_endian())
+                return std::shared_ptr<T>(file, reinterpret_cast<T*>(data));
+
+            std::shared_ptr<T> temp(new T[num], std::default_delete<T[]>());
+            std::memcpy(temp.get(), data, size);
+            ser_helper::reverse_elements(reinterpret_cast<char*>(temp.get()), num, sizeof(T));
+            return temp;
+        }
+
+    protected:
+
+        virtual int_type underflow (
+        )
+        {
+            // Move on to the next stream record.  Hitting a block here means someone
+            // is reading the stream differently from how it was written, so we report
+            // that as the end of the stream.
+            uint64 type, size;
+            while (gptr() == egptr())
+            {
+                const size_t record_start = pos;
+                if (!read_record_header(type, size))
+                    return traits_type::eof();
+                if (type != ser_helper::mapped_archive_stream_record || file->size() - pos < size)
+                {
+                    pos = record_start;
+                    return traits_type::eof();
+                }
+                char* data = file->data() + pos;
+                pos += size;
+                setg(data, data, data+size);
+            }
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+
+        bool read_record_header (
+            uint64& type,
+            uint64& size
+        )
+        {
+            if (pos > file->size() || file->size() - pos < 2*sizeof(uint64))
+                return false;
+            std::memcpy(&type, file->data()+pos, sizeof(type));
+            std::memcpy(&size, file->data()+pos+sizeof(type), sizeof(size));
+            bo.little_to_host(type);
+            bo.little_to_host(size);
+            pos += 2*sizeof(uint64);
+            return true;
+        }
+
+        std::shared_ptr<mapped_file> file;
+        size_t pos;
+        byte_orderer bo;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    namespace ser_helper
+    {
+        inline mapped_archive_writer* get_mapped_archive (
+            std::ostream& out
+        )
+        /*!
+            ensures
+                - if (out is writing a mapped archive) then
+                    - returns the archive's writer
+                - else
+                    - returns 0
+        !*/
+        {
+            return dynamic_cast<mapped_archive_writer*>(out.rdbuf());
+        }
+
+        inline mapped_archive_reader* get_mapped_archive (
+            std::istream& in
+        )
+        /*!
+            ensures
+                - if (in is reading a mapped archive) then
+                    - returns the archive's reader
+                - else
+                    - returns 0
+        !*/
+        {
+            return dynamic_cast<mapped_archive_reader*>(in.rdbuf());
+        }
+
+        template <typename T>
+        typename enable_if<is_mappable_type<T>,bool>::type try_write_block (
+            const T* data,
+            size_t num,
+            std::ostream& out
+        )
+        /*!
+            ensures
+                - if (out is writing a mapped archive and T can be stored in a block) then
+                    - writes the num elements in data to the archive as a block
+                    - returns true
+                - else
+                    - returns false, in which case the caller should serialize the
+                      elements the usual way.
+        !*/
+        {
+            mapped_archive_writer* archive = get_mapped_archive(out);
+            if (!archive)
+                return false;
+            archive->write_block(data, num);
+            return true;
+        }
+
+        template <typename T>
+        typename disable_if<is_mappable_type<T>,bool>::type try_write_block (
+            const T* ,
+            size_t ,
+            std::ostream& 
+        ) { return false; }
+
+        template <typename T>
+        typename enable_if<is_mappable_type<T>,bool>::type try_read_block (
+            T* data,
+            size_t num,
+            std::istream& in
+        )
+        /*!
+            ensures
+                - This is the reverse of try_write_block().  If in is reading a mapped
+                  archive and T can be stored in a block then it copies the next block
+                  into data and returns true.  Otherwise returns false.
+        !*/
+        {
+            mapped_archive_reader* archive = get_mapped_archive(in);
+            if (!archive)
+                return false;
+            const std::shared_ptr<T> block = archive->read_block<T>(num);
+            if (num != 0)
+                std::memcpy(data, block.get(), num*sizeof(T));
+            return true;
+        }
+
+        template <typename T>
+        typename disable_if<is_mappable_type<T>,bool>::type try_read_block (
+            T* ,
+            size_t ,
+            std::istream& 
+        ) { return false; }
+    }
+
 // ----------------------------------------------------------------------------------------
 // prototypes
 
@@ -1027,6 +1587,8 @@ namespace dlib
             const unsigned long size = static_cast<unsigned long>(item.size());
 
             serialize(size,out); 
+            if (ser_helper::try_write_block(item.data(), item.size(), out))
+                return;
             for (unsigned long i = 0; i < item.size(); ++i)
                 serialize(item[i],out);
         }
@@ -1045,6 +1607,8 @@ namespace dlib
             unsigned long size;
             deserialize(size,in); 
             item.resize(size);
+            if (ser_helper::try_read_block(item.data(), item.size(), in))
+                return;
             for (unsigned long i = 0; i < size; ++i)
                 deserialize(item[i],in);
         }
@@ -1566,6 +2130,35 @@ namespace dlib
         std::shared_ptr<std::ofstream> fout;
     };
 
+    class proxy_serialize_mapped 
+    {
+    public:
+        explicit proxy_serialize_mapped (
+            const std::string& filename
+        ) : filename(filename) 
+        {
+            archive.reset(new mapped_archive_writer(filename));
+            fout.reset(new std::ostream(archive.get()));
+        }
+
+        template <typename T>
+        inline proxy_serialize_mapped& operator<<(const T& item)
+        {
+            serialize(item, *fout);
+            // Flush so the file holds complete objects once this returns and so we can
+            // report any write errors.
+            fout->flush();
+            if (!(*fout))
+                throw serialization_error("Error writing to " + filename + ".");
+            return *this;
+        }
+
+    private:
+        std::string filename;
+        std::shared_ptr<mapped_archive_writer> archive;
+        std::shared_ptr<std::ostream> fout;
+    };
+
     class proxy_deserialize 
     {
     public:
@@ -1573,15 +2166,28 @@ namespace dlib
             const std::string& filename
         )  : filename(filename)
         {
-            fin.reset(new std::ifstream(filename.c_str(), std::ios::binary));
-            if (!(*fin))
+            std::unique_ptr<std::ifstream> file(new std::ifstream(filename.c_str(), std::ios::binary));
+            if (!(*file))
                 throw serialization_error("Unable to open " + filename + " for reading.");
 
             // read the file header into a buffer and then seek back to the start of the
             // file.
-            fin->read(file_header,4);
-            fin->clear();
-            fin->seekg(0);
+            char header[sizeof(ser_helper::mapped_archive_magic)] = {};
+            file->read(header,sizeof(header));
+            std::copy(header, header+4, file_header);
+            if (ser_helper::is_mapped_archive_header(header, file->gcount()))
+            {
+                // Files written by serialize_mapped() are memory mapped and read in place.
+                file.reset();
+                archive.reset(new mapped_archive_reader(std::make_shared<mapped_file>(filename)));
+                fin.reset(new std::istream(archive.get()));
+            }
+            else
+            {
+                file->clear();
+                file->seekg(0);
+                fin.reset(file.release());
+            }
         }
 
         template <typename T>
@@ -1642,7 +2248,8 @@ namespace dlib
 
         int objects_read = 0;
         std::string filename;
-        std::shared_ptr<std::ifstream> fin;
+        std::shared_ptr<mapped_archive_reader> archive;
+        std::shared_ptr<std::istream> fin;
 
         // We don't need to look at the file header.  However, it's here because people
         // keep posting questions to the dlib forums asking why they get file load errors.
@@ -1670,6 +2277,8 @@ namespace dlib
     { return proxy_serialize(filename); }
     inline proxy_deserialize deserialize(const std::string& filename)
     { return proxy_deserialize(filename); }
+    inline proxy_serialize_mapped serialize_mapped(const std::string& filename)
+    { return proxy_serialize_mapped(filename); }
 
 // ----------------------------------------------------------------------------------------
 
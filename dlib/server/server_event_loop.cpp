@@ -0,0 +1,411 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_SERVER_EVENT_LOOP_CPp_
+#define DLIB_SERVER_EVENT_LOOP_CPp_
+
+#include "server_event_loop.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace dlib
+{
+    namespace impl
+    {
+
+    // ------------------------------------------------------------------------------------
+
+        namespace
+        {
+            unsigned long event_loop_threads (
+                unsigned long num_worker_threads
+            )
+            {
+                if (num_worker_threads != 0)
+                    return num_worker_threads;
+                return std::max(1u, std::thread::hardware_concurrency());
+            }
+        }
+
+#ifdef __linux__
+
+    // ------------------------------------------------------------------------------------
+
+        struct server_event_loop::connection_state
+        {
+            connection_state (
+                connection* con_,
+                unsigned long graceful_close_timeout_
+            ) :
+                con(con_),
+                fd(con_->get_socket_descriptor()),
+                graceful_close_timeout(graceful_close_timeout_),
+                out_pos(0),
+                close_after_write(false),
+                is_closing(false)
+            {}
+
+            connection* const con;
+            const int fd;
+            const unsigned long graceful_close_timeout;
+
+            // bytes received but not yet consumed by on_message()
+            std::string in;
+            // bytes waiting to be sent, out[out_pos] is the next one to go
+            std::string out;
+            size_t out_pos;
+            // true once on_message() asked for the connection to be closed
+            bool close_after_write;
+            // true once we have called shutdown_outgoing() and are waiting for the
+            // other side to close its end, or for close_deadline to pass.
+            bool is_closing;
+            std::chrono::steady_clock::time_point close_deadline;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        server_event_loop::
+        server_event_loop (
+            const message_length_function& get_message_length_,
+            const message_function& on_message_,
+            const release_function& release_,
+            unsigned long num_worker_threads
+        ) :
+            get_message_length(get_message_length_),
+            on_message(on_message_),
+            release(release_),
+            epoll_fd(-1),
+            stop(false),
+            workers(event_loop_threads(num_worker_threads))
+        {
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd == -1)
+                throw socket_error("server_event_loop: unable to create an epoll instance");
+
+            loop_thread.reset(new thread_function(make_mfp(*this,&server_event_loop::run)));
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        server_event_loop::
+        ~server_event_loop (
+        )
+        {
+            stop = true;
+            loop_thread.reset();
+            workers.wait_for_all_tasks();
+
+            // Anything still here is sitting idle in epoll.  Normally the server has
+            // already shut these down and waited for them to be released.
+            std::vector<connection_state*> left;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                left.assign(states.begin(), states.end());
+            }
+            for (auto state : left)
+            {
+                state->con->shutdown();
+                finish(state);
+            }
+
+            ::close(epoll_fd);
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        add (
+            connection* con,
+            unsigned long graceful_close_timeout
+        )
+        {
+            connection_state* state = new connection_state(con, graceful_close_timeout);
+            try
+            {
+                std::lock_guard<std::mutex> lock(m);
+                states.insert(state);
+            }
+            catch (...)
+            {
+                delete state;
+                throw;
+            }
+
+            epoll_event ev;
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.ptr = state;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, state->fd, &ev) == -1)
+            {
+                // We can't watch this connection, so just close it.
+                con->shutdown();
+                finish(state);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        run (
+        )
+        {
+            std::vector<epoll_event> events(256);
+            auto last_sweep = std::chrono::steady_clock::now();
+            while (!stop)
+            {
+                // Wake up every so often to check stop and the close deadlines.
+                const int num = epoll_wait(epoll_fd, &events[0], events.size(), 100);
+                for (int i = 0; i < num; ++i)
+                {
+                    connection_state* state = static_cast<connection_state*>(events[i].data.ptr);
+                    workers.add_task_by_value([this,state]() { service(state); });
+                }
+
+                // Connections we are closing only get graceful_close_timeout milliseconds
+                // for the other side to hang up.  After that we shut them down, which
+                // makes epoll report them and service() then finishes them.
+                const auto now = std::chrono::steady_clock::now();
+                if (now - last_sweep > std::chrono::milliseconds(100))
+                {
+                    last_sweep = now;
+                    std::lock_guard<std::mutex> lock(m);
+                    for (auto state : closing)
+                    {
+                        if (state->close_deadline <= now)
+                            state->con->shutdown();
+                    }
+                }
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        service (
+            connection_state* state
+        )
+        {
+            // Read everything that is available right now.
+            char buf[16*1024];
+            bool peer_closed = false;
+            while (true)
+            {
+                const ssize_t num = ::recv(state->fd, buf, sizeof(buf), MSG_DONTWAIT);
+                if (num > 0)
+                {
+                    // Anything that arrives after we decided to close is thrown away.
+                    if (!state->is_closing && !state->close_after_write)
+                        state->in.append(buf, num);
+                    if (num < (ssize_t)sizeof(buf))
+                        break;
+                }
+                else if (num == 0)
+                {
+                    peer_closed = true;
+                    break;
+                }
+                else if (errno == EINTR)
+                {
+                    continue;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                else
+                {
+                    finish(state);
+                    return;
+                }
+            }
+
+            if (state->is_closing)
+            {
+                if (peer_closed || std::chrono::steady_clock::now() >= state->close_deadline)
+                    finish(state);
+                else
+                    rearm(state, false);
+                return;
+            }
+
+            // Process all the complete messages we have, unless the other side isn't
+            // reading its responses, in which case we wait for it to catch up.
+            const size_t max_pending_output = 1024*1024;
+            size_t begin = 0;
+            while (!state->close_after_write && state->out.size() - state->out_pos < max_pending_output)
+            {
+                const size_t len = get_message_length(state->in.data()+begin, state->in.size()-begin);
+                if (len == 0)
+                    break;
+
+                std::string response;
+                bool keep_open = false;
+                try
+                {
+                    keep_open = on_message(*state->con, state->in.data()+begin, len, response);
+                }
+                catch (...)
+                {
+                    keep_open = false;
+                }
+                state->out += response;
+                begin += len;
+                if (!keep_open)
+                    state->close_after_write = true;
+            }
+            state->in.erase(0, begin);
+
+            // Now send as much of the output as the socket will take.
+            while (state->out_pos < state->out.size())
+            {
+                const ssize_t num = ::send(state->fd, state->out.data()+state->out_pos,
+                    state->out.size()-state->out_pos, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (num >= 0)
+                {
+                    state->out_pos += num;
+                }
+                else if (errno == EINTR)
+                {
+                    continue;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                else
+                {
+                    finish(state);
+                    return;
+                }
+            }
+
+            if (state->out_pos == state->out.size())
+            {
+                state->out.clear();
+                state->out_pos = 0;
+
+                if (state->close_after_write || peer_closed)
+                    begin_close(state, peer_closed);
+                else
+                    rearm(state, false);
+            }
+            else
+            {
+                // If the other side hung up we can still finish sending it what it asked
+                // for, but we shouldn't wait to read anything more from it.
+                if (peer_closed)
+                    state->close_after_write = true;
+                rearm(state, true);
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        rearm (
+            connection_state* state,
+            bool want_write
+        )
+        {
+            epoll_event ev;
+            ev.events = (want_write ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+            ev.data.ptr = state;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, state->fd, &ev) == -1)
+                finish(state);
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        begin_close (
+            connection_state* state,
+            bool peer_closed
+        )
+        {
+            // This is what close_gracefully() does, except that we wait for the other side
+            // to hang up in the event loop rather than by blocking a thread in read().
+            state->con->shutdown_outgoing();
+            if (peer_closed || state->graceful_close_timeout == 0)
+            {
+                finish(state);
+                return;
+            }
+
+            state->is_closing = true;
+            state->in.clear();
+            state->close_deadline = std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(state->graceful_close_timeout);
+            {
+                std::lock_guard<std::mutex> lock(m);
+                closing.insert(state);
+            }
+            rearm(state, false);
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        void server_event_loop::
+        finish (
+            connection_state* state
+        )
+        {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, state->fd, 0);
+            {
+                std::lock_guard<std::mutex> lock(m);
+                states.erase(state);
+                closing.erase(state);
+            }
+            connection* con = state->con;
+            delete state;
+            release(*con);
+        }
+
+    // ------------------------------------------------------------------------------------
+
+#else // __linux__
+
+    // ------------------------------------------------------------------------------------
+
+        struct server_event_loop::connection_state {};
+
+        server_event_loop::
+        server_event_loop (
+            const message_length_function& get_message_length_,
+            const message_function& on_message_,
+            const release_function& release_,
+            unsigned long num_worker_threads
+        ) :
+            get_message_length(get_message_length_),
+            on_message(on_message_),
+            release(release_),
+            epoll_fd(-1),
+            stop(false),
+            workers(event_loop_threads(num_worker_threads))
+        {
+            throw socket_error("server_io_model::event_loop is only supported on Linux");
+        }
+
+        server_event_loop::~server_event_loop() {}
+        void server_event_loop::add(connection*, unsigned long) {}
+        void server_event_loop::run() {}
+        void server_event_loop::service(connection_state*) {}
+        void server_event_loop::rearm(connection_state*, bool) {}
+        void server_event_loop::begin_close(connection_state*, bool) {}
+        void server_event_loop::finish(connection_state*) {}
+
+    // ------------------------------------------------------------------------------------
+
+#endif // __linux__
+
+    }
+}
+
+#endif // DLIB_SERVER_EVENT_LOOP_CPp_
+
@@ -0,0 +1,149 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_SERVER_EVENT_LOOp_
+#define DLIB_SERVER_EVENT_LOOp_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "../threads.h"
+#include "../sockets.h"
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class server_event_loop
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This is the epoll based I/O core used by servers running in
+                    server_io_model::event_loop mode.  Connections given to add() are
+                    watched by a single thread sitting in epoll_wait().  When one of them
+                    has data, one of a fixed pool of worker threads reads everything that
+                    is available, cuts it into messages with get_message_length(), hands
+                    each message to on_message() and sends the responses back.  So an idle
+                    keep-alive connection costs a file descriptor and a small buffer
+                    rather than a whole thread.
+
+                    Connections are registered with EPOLLONESHOT.  Therefore at most one
+                    worker touches a connection at any time and the messages on a
+                    connection are processed in the order they arrived.
+
+                    This object is only implemented on Linux.  Everywhere else the
+                    constructor throws.
+            !*/
+
+        public:
+
+            typedef std::function<size_t(const char* data, size_t size)> message_length_function;
+            typedef std::function<bool(connection& con, const char* data, size_t size, std::string& response)> message_function;
+            typedef std::function<void(connection& con)> release_function;
+
+            server_event_loop (
+                const message_length_function& get_message_length,
+                const message_function& on_message,
+                const release_function& release,
+                unsigned long num_worker_threads
+            );
+            /*!
+                requires
+                    - get_message_length(data,size) returns the number of bytes at the
+                      front of data that make up the next message, or 0 if more bytes are
+                      needed to tell.  It must not return a number > size.
+                    - on_message(con,data,size,response) processes one message from con
+                      and stores the bytes to send back into response.  It returns false
+                      if con should be closed once response has been sent.
+                    - release(con) deletes con.  It is called exactly once for each
+                      connection given to add(), after the connection has been closed
+                      gracefully and removed from the event loop.
+                ensures
+                    - #num_worker_threads() == num_worker_threads, or the number of
+                      hardware threads if num_worker_threads == 0.
+                throws
+                    - dlib::socket_error if the event loop can't be created.
+            !*/
+
+            ~server_event_loop (
+            );
+            /*!
+                ensures
+                    - Stops the event loop, waits for the workers and releases any
+                      connections still in the loop.
+            !*/
+
+            void add (
+                connection* con,
+                unsigned long graceful_close_timeout
+            );
+            /*!
+                ensures
+                    - The event loop takes over servicing con.  Once the connection is
+                      done (either side closed it or on_message() returned false) it is
+                      closed the same way close_gracefully(con,graceful_close_timeout)
+                      would close it and then given to release().
+            !*/
+
+            unsigned long num_worker_threads (
+            ) const { return workers.num_threads_in_pool(); }
+
+        private:
+
+            struct connection_state;
+
+            void run (
+            );
+
+            void service (
+                connection_state* state
+            );
+
+            void rearm (
+                connection_state* state,
+                bool want_write
+            );
+
+            void begin_close (
+                connection_state* state,
+                bool peer_closed
+            );
+
+            void finish (
+                connection_state* state
+            );
+
+            message_length_function get_message_length;
+            message_function on_message;
+            release_function release;
+
+            int epoll_fd;
+            std::atomic<bool> stop;
+            std::mutex m;
+            std::unordered_set<connection_state*> states;
+            std::unordered_set<connection_state*> closing;
+            thread_pool workers;
+            std::unique_ptr<thread_function> loop_thread;
+
+            // restricted functions
+            server_event_loop(const server_event_loop&);
+            server_event_loop& operator=(const server_event_loop&);
+        };
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#ifdef NO_MAKEFILE
+#include "server_event_loop.cpp"
+#endif
+
+#endif // DLIB_SERVER_EVENT_LOOp_
+
@@ -4,6 +4,7 @@
 #define DLIB_SERVER_HTTP_CPp_
 
 #include "server_http.h"
+#include <algorithm>
 
 namespace dlib
 {
@@ -149,6 +150,65 @@ namespace dlib
                     in.get();
             }
         }
+
+        size_t http_message_length (
+            const char* data,
+            size_t size,
+            unsigned long max_content_length
+        )
+        /*!
+            ensures
+                - returns the number of bytes at the front of data that make up the next
+                  HTTP request, or 0 if we need more data to tell.
+                - Malformed or oversized requests are reported as being just their
+                  headers (or everything we have) so that parse_http_request() gets to
+                  see them and report the error to the client.
+        !*/
+        {
+            const char terminator[] = "\r\n\r\n";
+            const char* const end = data + size;
+            const char* header_end = std::search(data, end, terminator, terminator+4);
+            if (header_end == end)
+            {
+                const size_t max_header_size = 1024*1024;
+                return size > max_header_size ? size : 0;
+            }
+            const size_t header_size = header_end + 4 - data;
+
+            // find the Content-Length header, if any
+            unsigned long content_length = 0;
+            const char* line = data;
+            while (line < header_end)
+            {
+                const char* line_end = std::find(line, header_end, '\n');
+                const std::string field(line, line_end);
+                if (field.size() > 15 && strings_equal_ignore_case(field, "Content-Length:", 15))
+                {
+                    std::istringstream sin(field.substr(15));
+                    sin >> content_length;
+                    if (!sin || content_length > max_content_length)
+                        return header_size;
+                }
+                line = line_end + 1;
+            }
+
+            if (size - header_size < content_length)
+                return 0;
+            return header_size + content_length;
+        }
+
+        bool client_wants_keep_alive (
+            const incoming_things& incoming
+        )
+        {
+            const std::string& connection = incoming.headers["Connection"];
+            if (strings_equal_ignore_case(connection, "close"))
+                return false;
+            if (strings_equal_ignore_case(connection, "keep-alive"))
+                return true;
+            // HTTP/1.1 connections are persistent unless the client says otherwise.
+            return strings_equal_ignore_case(incoming.protocol, "HTTP/1.1", 8);
+        }
     }
 
 // ----------------------------------------------------------------------------------------
@@ -397,6 +457,98 @@ namespace dlib
         write_http_response(out, outgoing, std::string("Error processing request: ") + e.what());
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void server_http::
+    set_io_model (
+        server_io_model model,
+        unsigned long num_worker_threads
+    )
+    {
+        // make sure requires clause is not broken
+        DLIB_CASSERT( 
+            this->is_running() == false,
+            "\tvoid server_http::set_io_model"
+            << "\n\tis_running() == " << this->is_running() 
+            << "\n\tthis: " << this
+            );
+
+        auto_mutex lock(http_class_mutex);
+        io_model = model;
+        num_event_loop_threads = num_worker_threads;
+        event_loop.reset();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void server_http::
+    on_connect_async (
+        connection& new_connection,
+        unsigned long graceful_close_timeout
+    )
+    {
+        impl::server_event_loop* loop;
+        {
+            auto_mutex lock(http_class_mutex);
+            if (!event_loop)
+            {
+                event_loop.reset(new impl::server_event_loop(
+                    [this](const char* data, size_t size) 
+                    { return http_impl::http_message_length(data, size, get_max_content_length()); },
+                    [this](connection& con, const char* data, size_t size, std::string& response) 
+                    { return on_http_message(con, data, size, response); },
+                    [this](connection& con) { release_async_connection(con); },
+                    num_event_loop_threads));
+            }
+            loop = event_loop.get();
+        }
+        loop->add(&new_connection, graceful_close_timeout);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    bool server_http::
+    on_http_message (
+        connection& con,
+        const char* data,
+        size_t size,
+        std::string& response
+    )
+    {
+        std::istringstream in(std::string(data, size));
+        std::ostringstream out;
+        bool keep_alive = false;
+        try
+        {
+            incoming_things incoming(con.get_foreign_ip(), con.get_local_ip(), 
+                con.get_foreign_port(), con.get_local_port());
+            outgoing_things outgoing;
+
+            parse_http_request(in, incoming, get_max_content_length());
+            read_body(in, incoming);
+            keep_alive = http_impl::client_wants_keep_alive(incoming);
+            const std::string& result = on_request(incoming, outgoing);
+            if (strings_equal_ignore_case(outgoing.headers["Connection"], "close"))
+                keep_alive = false;
+            outgoing.headers["Connection"] = keep_alive ? "keep-alive" : "close";
+            write_http_response(out, outgoing, result);
+        }
+        catch (http_parse_error& e)
+        {
+            dlog << LERROR << "Error processing request from: " << con.get_foreign_ip() << " - " << e.what();
+            keep_alive = false;
+            write_http_response(out, e);
+        }
+        catch (std::exception& e)
+        {
+            dlog << LERROR << "Error processing request from: " << con.get_foreign_ip() << " - " << e.what();
+            keep_alive = false;
+            write_http_response(out, e);
+        }
+        response = out.str();
+        return keep_alive;
+    }
+
 // ----------------------------------------------------------------------------------------
 
     const logger server_http::dlog("dlib.server_http");
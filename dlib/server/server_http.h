@@ -13,6 +13,7 @@
 #include "../logger.h"
 #include "../string.h"
 #include "server_iostream.h"
+#include "server_event_loop.h"
 
 #ifdef  __INTEL_COMPILER
 // ignore the bogus warning about hiding on_connect()
@@ -165,11 +166,19 @@ namespace dlib
 
     public:
 
-        server_http()
+        server_http() : io_model(server_io_model::thread_per_connection), num_event_loop_threads(0)
         {
             max_content_length = 10*1024*1024; // 10MB
         }
 
+        ~server_http(
+        )
+        {
+            // The event loop calls back into this object, so stop the server while we
+            // still exist.
+            server::clear();
+        }
+
         unsigned long get_max_content_length (
         ) const 
         { 
@@ -185,6 +194,18 @@ namespace dlib
             max_content_length = max_length;
         }
 
+        void set_io_model (
+            server_io_model model,
+            unsigned long num_worker_threads = 0
+        );
+
+        server_io_model get_io_model (
+        ) const
+        {
+            auto_mutex lock(http_class_mutex);
+            return io_model;
+        }
+
 
     private:
         virtual const std::string on_request (
@@ -225,8 +246,32 @@ namespace dlib
             }
         }
 
+        virtual bool uses_event_loop (
+        ) const { return get_io_model() == server_io_model::event_loop; }
+
+        virtual void on_connect_async (
+            connection& new_connection,
+            unsigned long graceful_close_timeout
+        );
+
+        bool on_http_message (
+            connection& con,
+            const char* data,
+            size_t size,
+            std::string& response
+        );
+        /*!
+            ensures
+                - This is the event loop version of on_connect().  It processes the one
+                  HTTP request in data and puts the response into response.  Returns
+                  true if the connection should be kept open for more requests.
+        !*/
+
         mutex http_class_mutex;
         unsigned long max_content_length;
+        server_io_model io_model;
+        unsigned long num_event_loop_threads;
+        std::unique_ptr<impl::server_event_loop> event_loop;
         const static logger dlog;
     };
 
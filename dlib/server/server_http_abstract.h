@@ -249,6 +249,18 @@ namespace dlib
                 client you may do so by setting the "Content-Type" header to whatever you like. 
                 However, setting this field manually is not necessary as it will default to 
                 "text/html" if you don't explicitly set it to something.
+
+            IO MODELS
+                By default every connection gets its own thread, serves a single request
+                and is then closed.  If you call set_io_model(server_io_model::event_loop)
+                then the connections are instead multiplexed by an epoll based event loop
+                over a fixed pool of worker threads and HTTP keep-alive is supported.
+                That is, a connection is left open after a response whenever the client
+                asked for it (the HTTP/1.1 default, or "Connection: keep-alive" for
+                HTTP/1.0) and you didn't set outgoing.headers["Connection"] to "close".
+                Requests pipelined on one connection are answered in order.  This lets a
+                single server handle tens of thousands of concurrent connections.  The
+                event_loop model is only available on Linux.
         !*/
 
     public:
@@ -258,6 +270,7 @@ namespace dlib
         /*!
             ensures
                 - #get_max_content_length() == 10*1024*1024
+                - #get_io_model() == server_io_model::thread_per_connection
         !*/
 
         unsigned long get_max_content_length (
@@ -278,6 +291,32 @@ namespace dlib
                 - #get_max_content_length() == max_length
         !*/
 
+        void set_io_model (
+            server_io_model model,
+            unsigned long num_worker_threads = 0
+        );
+        /*!
+            requires
+                - is_running() == false
+            ensures
+                - #get_io_model() == model
+                - if (model == server_io_model::event_loop) then
+                    - requests are processed by num_worker_threads threads, or by
+                      std::thread::hardware_concurrency() threads if num_worker_threads
+                      is 0.  This bounds the number of on_request() calls running at
+                      once, independent of the number of open connections.
+                    - on platforms other than Linux the server stops and start()
+                      throws dlib::socket_error when the first connection arrives.
+        !*/
+
+        server_io_model get_io_model (
+        ) const;
+        /*!
+            ensures
+                - returns the way this server services its connections.  See the IO
+                  MODELS section above for details.
+        !*/
+
     private:
 
         virtual const std::string on_request (
@@ -287,7 +326,8 @@ namespace dlib
         /*!
             requires
                 - on_request() is called when there is an HTTP GET or POST request to be serviced 
-                - on_request() is run in its own thread 
+                - on_request() is run in its own thread, or in one of the event loop's
+                  worker threads if get_io_model() == server_io_model::event_loop
                 - is_running() == true 
                 - the number of current on_request() functions running < get_max_connection() 
                 - in incoming: 
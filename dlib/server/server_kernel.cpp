@@ -344,69 +344,98 @@ namespace dlib
             cons_mutex.unlock();
 
 
-            // make a param structure
-            param* temp = 0;
-            try{
-            temp = new param (
-                            *this,
-                            *client,
-                            get_graceful_close_timeout() 
-                            );
-            } catch (...) 
+            // If the derived class services its connections with an event loop then
+            // hand this one over to it.  Otherwise it gets a thread of its own.
+            if (uses_event_loop())
             {
-                sock.reset();
-                delete client;
-                running_mutex.lock();
-                running = false;
-                running_signaler.broadcast();
-                running_mutex.unlock();
-                clear(); 
-                throw;
-            }
-
+                // Connections in the event loop count against max_connections just like
+                // threads do.  release_async_connection() undoes this.
+                thread_count_mutex.lock();
+                ++thread_count;
+                thread_count_mutex.unlock();
 
-            // if create_new_thread failed
-            if (!create_new_thread(service_connection,temp))
+                try{ on_connect_async(*client, get_graceful_close_timeout()); }
+                catch (...)
+                {
+                    sock.reset();
+                    release_async_connection(*client);
+                    running_mutex.lock();
+                    running = false;
+                    running_signaler.broadcast();
+                    running_mutex.unlock();
+                    clear(); 
+                    throw;
+                }
+            }
+            else
             {
-                delete temp;
-                // close the listening socket
-                sock.reset();
-
-                // close the new connection and remove it from cons
-                cons_mutex.lock();
-                connection* ctemp;
-                if (cons.is_member(client))
+                // make a param structure
+                param* temp = 0;
+                try{
+                temp = new param (
+                                *this,
+                                *client,
+                                get_graceful_close_timeout() 
+                                );
+                } catch (...) 
                 {
-                    cons.remove(client,ctemp);
+                    sock.reset();
+                    delete client;
+                    running_mutex.lock();
+                    running = false;
+                    running_signaler.broadcast();
+                    running_mutex.unlock();
+                    clear(); 
+                    throw;
                 }
-                delete client;
-                cons_mutex.unlock();
 
 
-                // signal that the listener has closed
-                running_mutex.lock();
-                running = false;
-                running_signaler.broadcast();
-                running_mutex.unlock();
+                // if create_new_thread failed
+                if (!create_new_thread(service_connection,temp))
+                {
+                    delete temp;
+                    // close the listening socket
+                    sock.reset();
+
+                    // close the new connection and remove it from cons
+                    cons_mutex.lock();
+                    connection* ctemp;
+                    if (cons.is_member(client))
+                    {
+                        cons.remove(client,ctemp);
+                    }
+                    delete client;
+                    cons_mutex.unlock();
 
-                // make sure the object is cleared
-                clear();
 
-                // throw the exception
-                throw dlib::thread_error(
-                    ECREATE_THREAD,
-                    "error occurred in server::start()\nunable to start thread"
-                    );    
-            }
-            // if we made the new thread then update thread_count
-            else
-            {
-                // increment the thread count
-                thread_count_mutex.lock();
-                ++thread_count;
-                if (thread_count == 0)
-                    thread_count_zero.broadcast();
-                thread_count_mutex.unlock();
+                    // signal that the listener has closed
+                    running_mutex.lock();
+                    running = false;
+                    running_signaler.broadcast();
+                    running_mutex.unlock();
+
+                    // make sure the object is cleared
+                    clear();
+
+                    // throw the exception
+                    throw dlib::thread_error(
+                        ECREATE_THREAD,
+                        "error occurred in server::start()\nunable to start thread"
+                        );    
+                }
+                // if we made the new thread then update thread_count
+                else
+                {
+                    // increment the thread count
+                    thread_count_mutex.lock();
+                    ++thread_count;
+                    if (thread_count == 0)
+                        thread_count_zero.broadcast();
+                    thread_count_mutex.unlock();
+                }
+
+
+            
             }
 
 
@@ -545,6 +574,31 @@ namespace dlib
         listening_ip_mutex.unlock();
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void server::
+    release_async_connection (
+        connection& con
+    )
+    {
+        // remove this connection from cons and delete it
+        cons_mutex.lock();
+        connection* temp;
+        if (cons.is_member(&con))
+            cons.remove(&con,temp);
+        cons_mutex.unlock();
+
+        delete &con;
+
+        // decrement the thread count and signal if it is now zero
+        thread_count_mutex.lock();
+        --thread_count;
+        thread_count_signaler.broadcast();
+        if (thread_count == 0)
+            thread_count_zero.broadcast();
+        thread_count_mutex.unlock();
+    }
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
     // static member function definitions
@@ -24,6 +24,12 @@ namespace dlib
     class server_http;
     class server_iostream;
 
+    enum class server_io_model
+    {
+        thread_per_connection,
+        event_loop
+    };
+
     class server
     {
 
@@ -158,6 +164,38 @@ namespace dlib
             unsigned long get_graceful_close_timeout (
             ) const;
 
+        protected:
+
+            virtual bool uses_event_loop (
+            ) const { return false; }
+            /*!
+                ensures
+                    - returns true if new connections should be given to
+                      on_connect_async() rather than each getting a thread which calls
+                      on_connect().
+            !*/
+
+            virtual void on_connect_async (
+                connection& ,
+                unsigned long 
+            ) {}
+            /*!
+                ensures
+                    - takes over servicing new_connection.  When done with it the
+                      derived class closes it gracefully and then calls
+                      release_async_connection(new_connection).
+            !*/
+
+            void release_async_connection (
+                connection& con
+            );
+            /*!
+                requires
+                    - con was given to on_connect_async() and hasn't been released yet.
+                ensures
+                    - removes con from the set of open connections and deletes it.
+            !*/
+
         private:
 
             void start_async_helper (
@@ -10,6 +10,22 @@
 
 namespace dlib
 {
+    enum class server_io_model
+    {
+        thread_per_connection,
+        event_loop
+    };
+    /*!
+        This enum selects how a server services its connections.  With
+        thread_per_connection every connection gets its own thread which runs
+        on_connect().  With event_loop the connections are watched by an epoll based
+        event loop and serviced by a fixed pool of worker threads.  Only server types
+        that frame their traffic into messages, like server_http, can support the
+        event_loop model.  It is only available on Linux.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
     class server
     {
 
@@ -265,6 +281,49 @@ namespace dlib
                       connection.  This is the timeout value given to close_gracefully().
             !*/
 
+        protected:
+
+            virtual bool uses_event_loop (
+            ) const { return false; }
+            /*!
+                ensures
+                    - returns true if new connections should be given to
+                      on_connect_async() rather than each getting its own thread that
+                      calls on_connect().
+                    - returns false by default.
+            !*/
+
+            virtual void on_connect_async (
+                connection& new_connection,
+                unsigned long graceful_close_timeout
+            ) {}
+            /*!
+                requires
+                    - uses_event_loop() == true
+                    - is_running() == true
+                    - the number of current connections < get_max_connection()
+                    - graceful_close_timeout == get_graceful_close_timeout()
+                ensures
+                    - takes over servicing new_connection and returns without blocking.
+                    - when the derived class is done with new_connection it closes it
+                      gracefully and then calls release_async_connection(new_connection).
+                    - new_connection counts towards get_max_connections() until it is
+                      released and clear() waits for it to be released.
+                throws
+                    - any exception.  In that case new_connection is closed and the
+                      server stops, just as if accept() had failed.
+            !*/
+
+            void release_async_connection (
+                connection& con
+            );
+            /*!
+                requires
+                    - con was given to on_connect_async() and hasn't been released yet.
+                ensures
+                    - removes con from the set of open connections and deletes it.
+            !*/
+
         private:
 
             virtual void on_connect (
@@ -0,0 +1,193 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_SIMD_MATh_Hh_
+#define DLIB_SIMD_MATh_Hh_
+
+#include "simd4f.h"
+#include "simd8f.h"
+#include <cstring>
+#include <limits>
+
+/*
+    This file defines exp(), log(), and tanh() for simd4f and simd8f.  They are vectorized
+    versions of the single precision routines from the Cephes math library, so they use
+    only the basic simd operations and work with every instruction set simd4f and simd8f
+    support.  Their errors, measured against the double precision std:: functions over
+    every float in the stated ranges, are:
+        - exp(x):  relative error < 2.5e-7 (about 2 ulp) for -87.3 <= x <= 88.3.  Inputs
+          below -87.33 give 0 and inputs above 88.37 give +infinity.
+        - log(x):  absolute error < 1.2e-7 for 0.5 <= x <= 2 and relative error < 2e-7
+          (about 2 ulp) for all other normal floats.  log(0) == -infinity, log of a
+          negative number is NaN, and log(infinity) == infinity.  Denormal inputs are
+          treated as if they were the smallest normal float.
+        - tanh(x): absolute error < 1.5e-7 and relative error < 3e-7 for all x.
+    NaN inputs give NaN outputs.
+*/
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace simd_math_impl
+    {
+        template <typename T> struct traits;
+        template <> struct traits<simd4f> { typedef simd4i int_type; const static int size = 4; };
+        template <> struct traits<simd8f> { typedef simd8i int_type; const static int size = 8; };
+
+        template <typename T>
+        inline typename traits<T>::int_type as_int (
+            const T& x
+        )
+        {
+            // Compilers turn this into a register move or nothing at all.
+            const int size = traits<T>::size;
+            float f[size];
+            int32 i[size];
+            x.store(f);
+            std::memcpy(i, f, sizeof(f));
+            typename traits<T>::int_type result;
+            result.load(i);
+            return result;
+        }
+
+        template <typename T>
+        inline T as_float (
+            const typename traits<T>::int_type& x
+        )
+        {
+            const int size = traits<T>::size;
+            int32 i[size];
+            float f[size];
+            x.store(i);
+            std::memcpy(f, i, sizeof(i));
+            T result;
+            result.load(f);
+            return result;
+        }
+
+        template <typename T>
+        inline T round_to_int (
+            const T& x
+        )
+        {
+            // Round to nearest by truncating x+0.5 and fixing up negative numbers.  This
+            // is faster than floor() when SSE4 isn't available.
+            typedef typename traits<T>::int_type I;
+            const T t = x + 0.5f;
+            const T r = T(I(t));
+            return select(r > t, r - 1, r);
+        }
+
+        template <typename T>
+        inline T exp (
+            const T& x_
+        )
+        {
+            typedef typename traits<T>::int_type I;
+            const float hi = 88.3762626647949f;
+            const float lo = -87.3365447504f;
+            T x = min(max(x_, lo), hi);
+
+            // exp(x) == 2^n * exp(x - n*log(2))
+            const T n = round_to_int(x*1.44269504088896341f);
+            x = x - n*0.693359375f;
+            x = x - n*(-2.12194440e-4f);
+
+            T y = 1.9875691500e-4f;
+            y = y*x + 1.3981999507e-3f;
+            y = y*x + 8.3334519073e-3f;
+            y = y*x + 4.1665795894e-2f;
+            y = y*x + 1.6666665459e-1f;
+            y = y*x + 5.0000001201e-1f;
+            y = y*(x*x) + x + 1;
+
+            // Build 2^n directly from its bits.
+            const T pow2n = as_float<T>((I(n) + 127) << 23);
+            T result = y*pow2n;
+
+            result = select(x_ > hi, std::numeric_limits<float>::infinity(), result);
+            result = select(x_ < lo, 0, result);
+            return select(x_ != x_, x_, result);
+        }
+
+        template <typename T>
+        inline T log (
+            const T& x_
+        )
+        {
+            typedef typename traits<T>::int_type I;
+            const T x = max(x_, std::numeric_limits<float>::min());
+
+            // Split x into m*2^e where 0.5 <= m < 1.
+            const I bits = as_int(x);
+            T e = T(((bits >> 23) & 0xff) - 126);
+            T m = as_float<T>((bits & 0x007fffff) | 0x3f000000);
+
+            // Shift m into [sqrt(0.5), sqrt(2)) so the polynomial is only evaluated near 1.
+            const auto small = m < 0.707106781186547524f;
+            e = e - select(small, 1, 0);
+            m = m - 1 + select(small, m, 0);
+
+            const T z = m*m;
+            T y = 7.0376836292e-2f;
+            y = y*m - 1.1514610310e-1f;
+            y = y*m + 1.1676998740e-1f;
+            y = y*m - 1.2420140846e-1f;
+            y = y*m + 1.4249322787e-1f;
+            y = y*m - 1.6668057665e-1f;
+            y = y*m + 2.0000714765e-1f;
+            y = y*m - 2.4999993993e-1f;
+            y = y*m + 3.3333331174e-1f;
+            y = y*m*z;
+            y = y + e*(-2.12194440e-4f);
+            y = y - 0.5f*z;
+            T result = m + y + e*0.693359375f;
+
+            result = select(x_ == std::numeric_limits<float>::infinity(), x_, result);
+            result = select(x_ == 0, -std::numeric_limits<float>::infinity(), result);
+            result = select(x_ < 0, std::numeric_limits<float>::quiet_NaN(), result);
+            return select(x_ != x_, x_, result);
+        }
+
+        template <typename T>
+        inline T tanh (
+            const T& x
+        )
+        {
+            const T ax = max(x, 0-x);
+
+            // Near 0 use a polynomial since 1 - 2/(exp(2x)+1) loses precision there.
+            const T z = x*x;
+            T small = -5.70498872745e-3f;
+            small = small*z + 2.06390887954e-2f;
+            small = small*z - 5.37397155531e-2f;
+            small = small*z + 1.33314422036e-1f;
+            small = small*z - 3.33332819422e-1f;
+            small = small*z*x + x;
+
+            T big = 1 - 2/(exp(ax+ax) + 1);
+            big = select(x < 0, 0-big, big);
+
+            const T result = select(ax < 0.625f, small, big);
+            return select(x != x, x, result);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    inline simd4f exp (const simd4f& x) { return simd_math_impl::exp(x); }
+    inline simd8f exp (const simd8f& x) { return simd_math_impl::exp(x); }
+
+    inline simd4f log (const simd4f& x) { return simd_math_impl::log(x); }
+    inline simd8f log (const simd8f& x) { return simd_math_impl::log(x); }
+
+    inline simd4f tanh (const simd4f& x) { return simd_math_impl::tanh(x); }
+    inline simd8f tanh (const simd8f& x) { return simd_math_impl::tanh(x); }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_SIMD_MATh_Hh_
+
@@ -13,6 +13,8 @@
 #include "../set.h"
 #include <netinet/tcp.h>
 #include <string.h>
+#include <algorithm>
+#include <limits>
 
 
 
@@ -291,6 +293,23 @@ namespace dlib
 
 #endif // __CYGWIN__
 
+// ----------------------------------------------------------------------------------------
+
+    namespace
+    {
+        int poll_timeout (
+            unsigned long timeout
+        )
+        /*!
+            ensures
+                - returns timeout (in milliseconds) as an argument suitable for poll().
+        !*/
+        {
+            const unsigned long max_timeout = std::numeric_limits<int>::max();
+            return static_cast<int>(std::min(timeout, max_timeout));
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     connection::
@@ -452,22 +471,17 @@ namespace dlib
         unsigned long timeout
     ) const
     {
-        fd_set read_set;
-        // initialize read_set
-        FD_ZERO(&read_set);
-
-        // add the listening socket to read_set
-        FD_SET(connection_socket, &read_set);
+        // We use poll() rather than select() since select() can't handle descriptors
+        // >= FD_SETSIZE, which busy servers easily go past.
+        pollfd pfd;
+        pfd.fd = connection_socket;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
 
-        // setup a timeval structure
-        timeval time_to_wait;
-        time_to_wait.tv_sec = static_cast<long>(timeout/1000);
-        time_to_wait.tv_usec = static_cast<long>((timeout%1000)*1000);
+        // wait on poll
+        int status = poll(&pfd, 1, poll_timeout(timeout));
 
-        // wait on select
-        int status = select(connection_socket+1,&read_set,0,0,&time_to_wait);
-
-        // if select timed out or there was an error
+        // if poll timed out or there was an error
         if (status <= 0)
             return false;
         
@@ -554,40 +568,31 @@ namespace dlib
         sockaddr_in incomingAddr;
         dsocklen_t length = sizeof(sockaddr_in);
 
-        // implement timeout with select if timeout is > 0
+        // implement timeout with poll if timeout is > 0
         if (timeout > 0)
         {
 
-            fd_set read_set;
-            // initialize read_set
-            FD_ZERO(&read_set);
-
-            // add the listening socket to read_set
-            FD_SET(listening_socket, &read_set);
+            pollfd pfd;
+            pfd.fd = listening_socket;
+            pfd.events = POLLIN;
 
-            timeval time_to_wait;
-
-
-            // loop on select so if its interupted then we can start it again
+            // loop on poll so if its interupted then we can start it again
             while (true)
             {
+                pfd.revents = 0;
 
-                // setup a timeval structure
-                time_to_wait.tv_sec = static_cast<long>(timeout/1000);
-                time_to_wait.tv_usec = static_cast<long>((timeout%1000)*1000);
-
-                // wait on select
-                int status = select(listening_socket+1,&read_set,0,0,&time_to_wait);
+                // wait on poll
+                int status = poll(&pfd, 1, poll_timeout(timeout));
 
-                // if select timed out
+                // if poll timed out
                 if (status == 0)
                     return TIMEOUT;
                 
-                // if select returned an error
+                // if poll returned an error
                 if (status == -1)
                 {
-                    // if select was interupted or the connection was aborted
-                    // then go back to select
+                    // if poll was interupted or the connection was aborted
+                    // then go back to poll
                     if (errno == EINTR || 
                         errno == ECONNABORTED || 
 #ifdef EPROTO
@@ -24,6 +24,7 @@
 #ifndef HPUX
 #include <sys/select.h>
 #endif
+#include <poll.h>
 #include <arpa/inet.h>
 #include <signal.h>
 #include <inttypes.h>
@@ -7,8 +7,10 @@
 #include <cstdlib>
 #include <ctime>
 #include <vector>
+#include <set>
 #include <random>
 #include <numeric>
+#include <thread>
 #include "../dnn.h"
 
 #include "tester.h"
@@ -217,6 +219,74 @@ namespace
 #endif
     }
 
+    void test_cpu_activations()
+    {
+        // The CPU activations use vectorized approximations of exp() and tanh(), so
+        // check them against the std:: functions.  The second tensor is big enough to be
+        // split across threads and has a size that isn't a multiple of the SIMD width.
+        print_spinner();
+        for (auto size : {std::array<long,4>{{2,3,4,5}}, std::array<long,4>{{7,6,43,47}}})
+        {
+            resizable_tensor src(size[0],size[1],size[2],size[3]), dest, grad, gradient_input;
+            tt::tensor_rand rnd(0);
+            dest.copy_size(src);
+            gradient_input.copy_size(src);
+            rnd.fill_gaussian(src, 0, 5);
+            rnd.fill_gaussian(gradient_input);
+            const matrix<double> x = matrix_cast<double>(mat(src));
+
+            cpu::sigmoid(dest, src);
+            DLIB_TEST(max(abs(mat(dest) - matrix_cast<float>(1/(1+exp(-x))))) < 1e-6);
+            cpu::tanh(dest, src);
+            DLIB_TEST(max(abs(mat(dest) - matrix_cast<float>(tanh(x)))) < 1e-6);
+            cpu::mish(dest, src);
+            DLIB_TEST(max(abs(mat(dest) - matrix_cast<float>(pointwise_multiply(x, tanh(log(1+exp(x))))))) < 1e-5);
+
+            // mish_gradient() is checked against the same formula evaluated in double.
+            grad.copy_size(src);
+            grad = 0;
+            cpu::mish_gradient(grad, src, gradient_input);
+            for (size_t i = 0; i < src.size(); ++i)
+            {
+                const double v = src.host()[i];
+                const double e = std::exp(v);
+                const double delta = 2*e + e*e + 2;
+                const double omega = 4*(v + 1) + 4*e*e + e*e*e + e*(4*v + 6);
+                double g = e*omega/(delta*delta);
+                if (v >= 8) g = 1;
+                if (v <= -8) g = 0;
+                DLIB_TEST(std::abs(grad.host()[i] - gradient_input.host()[i]*g) < 1e-5);
+            }
+
+            cpu::leaky_relu(dest, src, 0.1);
+            DLIB_TEST(max(abs(mat(dest) - matrix_cast<float>(pointwise_multiply(x, 0.1 + 0.9*(x>0))))) < 1e-6);
+
+            cpu::softmax(dest, src);
+            for (long n = 0; n < src.num_samples(); ++n)
+            {
+                for (long r = 0; r < src.nr(); ++r)
+                {
+                    for (long c = 0; c < src.nc(); ++c)
+                    {
+                        matrix<double> e(src.k(),1);
+                        for (long k = 0; k < src.k(); ++k)
+                            e(k) = std::exp(x(n, (k*src.nr()+r)*src.nc()+c));
+                        e /= sum(e);
+                        for (long k = 0; k < src.k(); ++k)
+                            DLIB_TEST(std::abs(mat(dest)(n, (k*src.nr()+r)*src.nc()+c) - e(k)) < 1e-6);
+                    }
+                }
+            }
+
+            cpu::softmax_all(dest, src);
+            for (long n = 0; n < src.num_samples(); ++n)
+            {
+                const matrix<double> e = exp(rowm(x,n) - max(rowm(x,n)));
+                DLIB_TEST(max(abs(rowm(mat(dest),n) - matrix_cast<float>(e/sum(e)))) < 1e-6);
+            }
+        }
+    }
+
     void test_mish()
     {
 #ifdef DLIB_USE_CUDA
@@ -239,7 +309,7 @@ namespace
         dest2 = 2;
         cuda::mish(dest1, src);
         cpu::mish(dest2, src);
-        DLIB_TEST_MSG(max(abs(mat(dest1) - mat(dest2))) < 1e-7, max(abs(mat(dest1) - mat(dest2))));
+        DLIB_TEST_MSG(max(abs(mat(dest1) - mat(dest2))) < 1e-6, max(abs(mat(dest1) - mat(dest2))));
 #endif // DLIB_USE_CUDA
     }
 
@@ -855,6 +925,443 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_cpu_conv_algorithms()
+    {
+        // Every specialized convolution algorithm should give the same results as the
+        // plain img2col+GEMM one, for any shape it supports.
+        dlib::rand prnd;
+        tt::tensor_rand rnd;
+        for (int iter = 0; iter < 100; ++iter)
+        {
+            print_spinner();
+            const long filter_size = (iter%2 == 0) ? 3 : 1;
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                prnd.get_random_32bit_number()%8+1,
+                prnd.get_random_32bit_number()%15+3,
+                prnd.get_random_32bit_number()%15+3
+            );
+            resizable_tensor filters(prnd.get_random_32bit_number()%8+1, data.k(), filter_size, filter_size);
+            rnd.fill_uniform(data);
+            rnd.fill_uniform(filters);
+            const int padding = (filter_size == 3) ? prnd.get_random_32bit_number()%3 : 0;
+
+            cpu::tensor_conv ref, conv;
+            ref.force_algorithm(cpu::conv_algorithm::img2col_gemm);
+            ref.setup(data, filters, 1, 1, padding, padding);
+            conv.setup(data, filters, 1, 1, padding, padding);
+            for (auto algo : {cpu::conv_algorithm::direct_1x1, cpu::conv_algorithm::winograd_3x3, cpu::conv_algorithm::automatic})
+            {
+                conv.force_algorithm(algo);
+                resizable_tensor output1, output2;
+                ref(false, output1, data, filters);
+                conv(false, output2, data, filters);
+                DLIB_TEST(ref.get_last_algorithm() == cpu::conv_algorithm::img2col_gemm);
+                if (algo != cpu::conv_algorithm::automatic)
+                    DLIB_TEST((conv.get_last_algorithm() == algo) == (filter_size == (algo == cpu::conv_algorithm::direct_1x1 ? 1 : 3)));
+                DLIB_TEST_MSG(max(abs(mat(output1)-mat(output2))) < 1e-4, max(abs(mat(output1)-mat(output2))));
+
+                ref(true, output1, data, filters);
+                conv(true, output2, data, filters);
+                DLIB_TEST_MSG(max(abs(mat(output1)-mat(output2))) < 1e-4, max(abs(mat(output1)-mat(output2))));
+            }
+
+            resizable_tensor gi, data_gradient1, data_gradient2, filter_gradient1, filter_gradient2;
+            gi.set_size(data.num_samples(), filters.num_samples(), data.nr()+2*padding-filter_size+1, data.nc()+2*padding-filter_size+1);
+            rnd.fill_uniform(gi);
+            data_gradient1.copy_size(data);
+            data_gradient2.copy_size(data);
+            filter_gradient1.copy_size(filters);
+            filter_gradient2.copy_size(filters);
+            for (bool add_to : {false, true})
+            {
+                ref.get_gradient_for_data(add_to, gi, filters, data_gradient1);
+                conv.get_gradient_for_data(add_to, gi, filters, data_gradient2);
+                DLIB_TEST(max(abs(mat(data_gradient1)-mat(data_gradient2))) < 1e-4);
+                ref.get_gradient_for_filters(add_to, gi, data, filter_gradient1);
+                conv.get_gradient_for_filters(add_to, gi, data, filter_gradient2);
+                DLIB_TEST(max(abs(mat(filter_gradient1)-mat(filter_gradient2))) < 1e-3);
+            }
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    resizable_tensor expand_grouped_filters (
+        const tensor& filters,
+        long groups
+    )
+    {
+        // Returns the dense filters that behave like the given grouped ones.  That is,
+        // they are zero wherever a filter and an input channel aren't in the same group.
+        resizable_tensor dense(filters.num_samples(), filters.k()*groups, filters.nr(), filters.nc());
+        dense = 0;
+        const long per_group = filters.num_samples()/groups;
+        const long filter_size = filters.k()*filters.nr()*filters.nc();
+        for (long o = 0; o < filters.num_samples(); ++o)
+        {
+            const long g = o/per_group;
+            std::copy(filters.host()+o*filter_size, filters.host()+(o+1)*filter_size,
+                dense.host()+o*dense.k()*filters.nr()*filters.nc() + g*filter_size);
+        }
+        return dense;
+    }
+
+    void test_grouped_conv()
+    {
+        // The direct grouped kernels should match img2col+GEMM run on the equivalent
+        // dense filters, and their gradients should match central differences.
+        dlib::rand prnd;
+        tt::tensor_rand rnd;
+        for (int iter = 0; iter < 60; ++iter)
+        {
+            print_spinner();
+            const long groups = prnd.get_random_32bit_number()%3+2;
+            // Every third iteration is a depthwise convolution.
+            const long in_per_group = (iter%3 == 0) ? 1 : prnd.get_random_32bit_number()%3+1;
+            const long out_per_group = (iter%3 == 0) ? 1 : prnd.get_random_32bit_number()%3+1;
+            const long filter_nr = 1 + 2*(prnd.get_random_32bit_number()%3);
+            const long filter_nc = 1 + 2*(prnd.get_random_32bit_number()%3);
+            const int stride_y = prnd.get_random_32bit_number()%2+1;
+            const int stride_x = prnd.get_random_32bit_number()%2+1;
+            const int padding_y = prnd.get_random_32bit_number()%(filter_nr/2+1);
+            const int padding_x = prnd.get_random_32bit_number()%(filter_nc/2+1);
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                groups*in_per_group,
+                prnd.get_random_32bit_number()%13+5,
+                prnd.get_random_32bit_number()%13+5
+            );
+            resizable_tensor filters(groups*out_per_group, in_per_group, filter_nr, filter_nc);
+            rnd.fill_uniform(data);
+            rnd.fill_uniform(filters);
+            const resizable_tensor dense = expand_grouped_filters(filters, groups);
+
+            cpu::tensor_conv ref, conv;
+            ref.force_algorithm(cpu::conv_algorithm::img2col_gemm);
+            ref.setup(data, dense, stride_y, stride_x, padding_y, padding_x);
+            conv.setup(data, filters, stride_y, stride_x, padding_y, padding_x, groups);
+
+            resizable_tensor output1, output2;
+            for (bool add_to : {false, true})
+            {
+                ref(add_to, output1, data, dense);
+                conv(add_to, output2, data, filters);
+                DLIB_TEST(conv.get_last_algorithm() == cpu::conv_algorithm::direct_grouped);
+                DLIB_TEST_MSG(max(abs(mat(output1)-mat(output2))) < 1e-4, max(abs(mat(output1)-mat(output2))));
+            }
+
+            resizable_tensor gi, data_gradient1, data_gradient2, dense_gradient, filter_gradient;
+            gi.copy_size(output1);
+            rnd.fill_uniform(gi);
+            data_gradient1.copy_size(data);
+            data_gradient2.copy_size(data);
+            dense_gradient.copy_size(dense);
+            filter_gradient.copy_size(filters);
+            for (bool add_to : {false, true})
+            {
+                ref.get_gradient_for_data(add_to, gi, dense, data_gradient1);
+                conv.get_gradient_for_data(add_to, gi, filters, data_gradient2);
+                DLIB_TEST(max(abs(mat(data_gradient1)-mat(data_gradient2))) < 1e-4);
+            }
+            ref.get_gradient_for_filters(false, gi, data, dense_gradient);
+            conv.get_gradient_for_filters(false, gi, data, filter_gradient);
+            // The dense filters also get gradients outside the groups, so mask those out.
+            resizable_tensor ones;
+            ones.copy_size(filters);
+            ones = 1;
+            const matrix<float> in_group = pointwise_multiply(mat(dense_gradient), mat(expand_grouped_filters(ones,groups)));
+            DLIB_TEST(max(abs(mat(expand_grouped_filters(filter_gradient,groups))-in_group)) < 1e-3);
+
+            // Check a few gradient values against central differences of sum(output*gi).
+            // The convolution is linear so a large eps is fine, but the sum needs to be done
+            // in double precision.
+            auto f = [&]() {
+                conv(false, output2, data, filters);
+                return sum(pointwise_multiply(matrix_cast<double>(mat(output2)), matrix_cast<double>(mat(gi))));
+            };
+            const float eps = 0.25;
+            conv.get_gradient_for_data(false, gi, filters, data_gradient2);
+            for (int i = 0; i < 5; ++i)
+            {
+                const size_t idx = prnd.get_random_32bit_number()%data.size();
+                const float old = data.host()[idx];
+                data.host()[idx] = old+eps; const double f1 = f();
+                data.host()[idx] = old-eps; const double f2 = f();
+                data.host()[idx] = old;
+                const double numeric = (f1-f2)/(2*eps);
+                DLIB_TEST_MSG(std::abs(numeric-data_gradient2.host()[idx]) < 1e-2*std::max(1.0,std::abs(numeric)),
+                    numeric << " " << data_gradient2.host()[idx]);
+            }
+            for (int i = 0; i < 5; ++i)
+            {
+                const size_t idx = prnd.get_random_32bit_number()%filters.size();
+                const float old = filters.host()[idx];
+                filters.host()[idx] = old+eps; const double f1 = f();
+                filters.host()[idx] = old-eps; const double f2 = f();
+                filters.host()[idx] = old;
+                const double numeric = (f1-f2)/(2*eps);
+                DLIB_TEST_MSG(std::abs(numeric-filter_gradient.host()[idx]) < 1e-2*std::max(1.0,std::abs(numeric)),
+                    numeric << " " << filter_gradient.host()[idx]);
+            }
+        }
+    }
+
+    void copy_grouped_params (
+        const tensor& grouped,
+        tensor& dense,
+        long filter_samples,
+        long num_biases,
+        long groups
+    )
+    {
+        // Copies the 3x3 filters and biases of a grouped layer into a dense one.
+        const long filters_size = grouped.size()-num_biases;
+        alias_tensor filters(filter_samples, filters_size/(filter_samples*9), 3, 3);
+        const resizable_tensor dense_filters = expand_grouped_filters(filters(grouped,0), groups);
+        DLIB_TEST(dense_filters.size()+num_biases == dense.size());
+        std::copy(dense_filters.begin(), dense_filters.end(), dense.begin());
+        std::copy(grouped.begin()+filters_size, grouped.end(), dense.begin()+dense_filters.size());
+    }
+
+    void test_grouped_con_layers()
+    {
+        print_spinner();
+        // grouped con_ and cont_ layers should give the same outputs as dense ones whose
+        // filters are zero outside of each group.
+        using grouped_net = depthwise_con<6,3,3,1,1,grouped_cont<6,3,3,2,2,3,grouped_con<6,3,3,2,2,2,con<4,1,1,1,1,input<matrix<float>>>>>>;
+        using dense_net = con<6,3,3,1,1,cont<6,3,3,2,2,con<6,3,3,2,2,con<4,1,1,1,1,input<matrix<float>>>>>>;
+
+        dlib::rand prnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 3; ++i)
+        {
+            matrix<float> img(13,14);
+            for (auto& v : img)
+                v = prnd.get_random_gaussian();
+            samples.push_back(img);
+        }
+
+        grouped_net gnet;
+        dense_net dnet;
+        resizable_tensor x;
+        gnet.to_tensor(samples.begin(), samples.end(), x);
+        dnet.to_tensor(samples.begin(), samples.end(), x);
+        gnet.forward(x);
+        dnet.forward(x);
+        DLIB_TEST(layer<0>(gnet).layer_details().groups() == 6);
+        DLIB_TEST(layer<1>(gnet).layer_details().groups() == 3);
+        DLIB_TEST(layer<2>(gnet).layer_details().groups() == 2);
+        DLIB_TEST(layer<0>(gnet).layer_details().get_layer_params().size() == 6*9+6);
+
+        // con_ filters are num_filters x k/groups, cont_ filters are k x num_filters/groups.
+        copy_grouped_params(layer<0>(gnet).layer_details().get_layer_params(), layer<0>(dnet).layer_details().get_layer_params(), 6, 6, 6);
+        copy_grouped_params(layer<1>(gnet).layer_details().get_layer_params(), layer<1>(dnet).layer_details().get_layer_params(), 6, 6, 3);
+        copy_grouped_params(layer<2>(gnet).layer_details().get_layer_params(), layer<2>(dnet).layer_details().get_layer_params(), 6, 6, 2);
+        layer<3>(dnet).layer_details().get_layer_params() = mat(layer<3>(gnet).layer_details().get_layer_params());
+
+        const matrix<float> expected = mat(dnet.forward(x));
+        const matrix<float> out = mat(gnet.forward(x));
+        DLIB_TEST_MSG(max(abs(out-expected)) < 1e-4, max(abs(out-expected)));
+
+        // Round trip through serialization.
+        std::ostringstream sout;
+        gnet.clean();
+        serialize(gnet, sout);
+        grouped_net gnet2;
+        std::istringstream sin(sout.str());
+        deserialize(gnet2, sin);
+        gnet2.to_tensor(samples.begin(), samples.end(), x);
+        DLIB_TEST(max(abs(mat(gnet2.forward(x))-out)) == 0);
+
+        std::ostringstream sout2;
+        sout2 << gnet;
+        DLIB_TEST(sout2.str().find("groups=6") != std::string::npos);
+
+        // A grouped layer can't be loaded into one with a different number of groups.
+        dense_net dnet2;
+        std::istringstream sin2(sout.str());
+        bool threw = false;
+        try { deserialize(dnet2, sin2); }
+        catch (serialization_error&) { threw = true; }
+        DLIB_TEST(threw);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_int8_quantization()
+    {
+        print_spinner();
+        using net_type = loss_multiclass_log<fc<10,relu<con<8,3,3,1,1,relu<con<6,5,5,2,2,input<matrix<float>>>>>>>>;
+        net_type net;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 20; ++i)
+        {
+            matrix<float> img(16,16);
+            for (auto& v : img)
+                v = rnd.get_random_gaussian();
+            samples.push_back(img);
+        }
+
+        resizable_tensor x;
+        net.to_tensor(samples.begin(), samples.end(), x);
+        const matrix<float> float_out = mat(net.subnet().forward(x));
+        std::ostringstream float_sout;
+        net.clean();
+        serialize(net, float_sout);
+
+        calibrate_int8_inference(net, samples, 7);
+        DLIB_TEST(layer<1>(net).layer_details().is_int8());
+        DLIB_TEST(layer<3>(net).layer_details().is_int8());
+        DLIB_TEST(layer<5>(net).layer_details().is_int8());
+
+        const matrix<float> int8_out = mat(net.subnet().forward(x));
+        const double err = max(abs(int8_out-float_out))/max(abs(float_out));
+        dlog << LINFO << "int8 relative error: " << err;
+        DLIB_TEST_MSG(err < 0.05, err);
+
+        // The quantized network should save about 4x smaller and come back exactly the
+        // same as it was saved.
+        std::ostringstream int8_sout;
+        net.clean();
+        serialize(net, int8_sout);
+        dlog << LINFO << "float size: " << float_sout.str().size() << ", int8 size: " << int8_sout.str().size();
+        DLIB_TEST(int8_sout.str().size()*3 < float_sout.str().size());
+
+        net_type net2;
+        std::istringstream sin(int8_sout.str());
+        deserialize(net2, sin);
+        DLIB_TEST(layer<1>(net2).layer_details().is_int8());
+        DLIB_TEST(layer<5>(net2).layer_details().is_int8());
+        DLIB_TEST(max(abs(mat(net2.subnet().forward(x))-int8_out)) == 0);
+        DLIB_TEST(max(abs(mat(layer<1>(net2).layer_details().get_layer_params()) -
+                          mat(layer<1>(net).layer_details().get_layer_params()))) == 0);
+
+        // Going back to float should give the same answers, up to the precision lost in
+        // the weights, since they are now exactly representable in int8.
+        disable_int8_inference(net2);
+        DLIB_TEST(!layer<1>(net2).layer_details().is_int8());
+        const double err2 = max(abs(mat(net2.subnet().forward(x))-float_out))/max(abs(float_out));
+        DLIB_TEST_MSG(err2 < 0.05, err2);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_fused_conv_epilogue()
+    {
+        // Applying the bias and activation inside cpu::tensor_conv must give exactly the
+        // same outputs as doing them in separate passes.
+        dlib::rand prnd;
+        tt::tensor_rand rnd;
+        for (int iter = 0; iter < 40; ++iter)
+        {
+            print_spinner();
+            const long filter_size = (iter%3 == 0) ? 1 : 3;
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                prnd.get_random_32bit_number()%6+1, 9, 11);
+            resizable_tensor filters(prnd.get_random_32bit_number()%6+1, data.k(), filter_size, filter_size);
+            resizable_tensor biases(1, filters.num_samples());
+            rnd.fill_uniform(data);
+            rnd.fill_uniform(filters);
+            rnd.fill_uniform(biases);
+            // Center everything on 0 so the activations see negative values.
+            data = mat(data)-0.5;
+            filters = mat(filters)-0.5;
+            biases = mat(biases)-0.5;
+            resizable_tensor param(1);
+            param = 0.2;
+            const int padding = filter_size/2;
+
+            for (auto algo : {cpu::conv_algorithm::img2col_gemm, cpu::conv_algorithm::direct_1x1, cpu::conv_algorithm::winograd_3x3})
+            {
+                for (auto act : {cpu::conv_activation::none, cpu::conv_activation::relu,
+                        cpu::conv_activation::prelu, cpu::conv_activation::leaky_relu})
+                {
+                    cpu::tensor_conv conv;
+                    conv.force_algorithm(algo);
+                    conv.setup(data, filters, 1, 1, padding, padding);
+                    resizable_tensor expected, out;
+                    conv(false, expected, data, filters);
+                    cpu::add(1, expected, 1, biases);
+                    if (act == cpu::conv_activation::relu)
+                        cpu::relu(expected, expected);
+                    else if (act == cpu::conv_activation::prelu)
+                        cpu::prelu(expected, expected, param);
+                    else if (act == cpu::conv_activation::leaky_relu)
+                        cpu::leaky_relu(expected, expected, 0.2f);
+
+                    conv(false, out, data, filters, biases, act, 0.2f);
+                    DLIB_TEST(max(abs(mat(out)-mat(expected))) == 0);
+                }
+            }
+        }
+    }
+
+    void test_fuse_layers()
+    {
+        print_spinner();
+        using train_net = loss_multiclass_log<fc<5,bn_fc<fc<8,leaky_relu<bn_con<con<4,1,1,1,1,
+                          prelu<bn_con<con<6,3,3,1,1,relu<bn_con<con<5,3,3,2,2,input<matrix<float>>>>>>>>>>>>>>>;
+        using test_net = loss_multiclass_log<fc<5,affine<fc<8,leaky_relu<affine<con<4,1,1,1,1,
+                          prelu<affine<con<6,3,3,1,1,relu<affine<con<5,3,3,2,2,input<matrix<float>>>>>>>>>>>>>>>;
+
+        dlib::rand prnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 8; ++i)
+        {
+            matrix<float> img(15,15);
+            for (auto& v : img)
+                v = prnd.get_random_gaussian();
+            samples.push_back(img);
+        }
+
+        // Run a batch through the bn_ layers so their running statistics aren't trivial.
+        train_net net;
+        resizable_tensor x;
+        net.to_tensor(samples.begin(), samples.end(), x);
+        net.subnet().forward(x);
+        tt::tensor_rand rnd;
+        visit_layer_parameters(net, [&](size_t, tensor& t) { rnd.fill_uniform(t); });
+        net.subnet().forward(x);
+
+        test_net anet = net;
+        const matrix<float> expected = mat(anet.subnet().forward(x));
+
+        test_net fused = anet;
+        fuse_layers(fused);
+        DLIB_TEST(layer<2>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<4>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<5>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<7>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<8>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<10>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<11>(fused).layer_details().is_disabled());
+        DLIB_TEST(layer<6>(fused).layer_details().get_fused_activation() == cpu::conv_activation::leaky_relu);
+        DLIB_TEST(layer<9>(fused).layer_details().get_fused_activation() == cpu::conv_activation::prelu);
+        DLIB_TEST(layer<12>(fused).layer_details().get_fused_activation() == cpu::conv_activation::relu);
+
+        const matrix<float> out = mat(fused.subnet().forward(x));
+        const double err = max(abs(out-expected))/max(abs(expected));
+        dlog << LINFO << "fused network relative error: " << err;
+        DLIB_TEST_MSG(err < 1e-5, err);
+
+        // Fusing twice shouldn't change anything.
+        fuse_layers(fused);
+        DLIB_TEST(max(abs(mat(fused.subnet().forward(x))-out)) == 0);
+
+        // A saved fused network is an ordinary network that computes the same thing.
+        std::ostringstream sout;
+        serialize(fused, sout);
+        test_net loaded;
+        std::istringstream sin(sout.str());
+        deserialize(loaded, sin);
+        DLIB_TEST(!layer<10>(loaded).layer_details().is_disabled());
+        DLIB_TEST(layer<12>(loaded).layer_details().get_fused_activation() == cpu::conv_activation::none);
+        DLIB_TEST(max(abs(mat(loaded.subnet().forward(x))-out)) == 0);
+    }
+
 // ----------------------------------------------------------------------------------------
 
 #ifdef DLIB_USE_CUDA
@@ -1880,6 +2387,12 @@ namespace
             auto res = test_layer(l);
             DLIB_TEST_MSG(res, res);
         }
+        {
+            print_spinner();
+            fc_sampled_<5> l;
+            auto res = test_layer(l);
+            DLIB_TEST_MSG(res, res);
+        }
         {
             print_spinner();
             relu_ l;
@@ -3348,6 +3861,227 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_loss_multiclass_log_sampled()
+    {
+        print_spinner();
+
+        const long num_classes = 30;
+        using net_type = loss_multiclass_log_sampled<fc_sampled<num_classes,input<matrix<float>>>>;
+        net_type net;
+        layer<1>(net).layer_details().set_num_sampled(4);
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> x(6, matrix<float>(3,1));
+        for (auto& m : x)
+            for (auto& v : m)
+                v = rnd.get_random_gaussian();
+        const std::vector<unsigned long> y = {7, 2, 7, 29, 0, 2};
+
+        const double loss = net.compute_parameter_gradients(x.begin(), x.end(), y.begin());
+
+        // The labels come first, without repeats, then 4 other outputs.
+        const auto& fc = layer<1>(net).layer_details();
+        const std::vector<unsigned long> selected = fc.get_selected_outputs();
+        DLIB_TEST(selected.size() == 8);
+        DLIB_TEST(selected[0] == 7 && selected[1] == 2 && selected[2] == 29 && selected[3] == 0);
+        DLIB_TEST(std::set<unsigned long>(selected.begin(), selected.end()).size() == 8);
+        DLIB_TEST(layer<1>(net).get_output().k() == 8);
+
+        // Compare against the multiclass log loss over just the selected outputs.
+        const matrix<float> params = mat(fc.get_layer_params());
+        matrix<float> X(x.size(), 4);
+        for (size_t i = 0; i < x.size(); ++i)
+            set_rowm(X, i) = join_rows(trans(x[i]), ones_matrix<float>(1,1));
+        matrix<float> W(4, selected.size());
+        for (size_t j = 0; j < selected.size(); ++j)
+            set_colm(W, j) = colm(params, selected[j]);
+        matrix<float> G = X*W;
+        double expected_loss = 0;
+        for (long i = 0; i < G.nr(); ++i)
+        {
+            matrix<float,1,0> p = exp(rowm(G,i) - max(rowm(G,i)));
+            p /= sum(p);
+            const long c = std::find(selected.begin(), selected.end(), y[i]) - selected.begin();
+            expected_loss -= std::log(p(c))/G.nr();
+            p(c) -= 1;
+            set_rowm(G,i) = p/G.nr();
+        }
+        const matrix<float> expected_grad = trans(X)*G;
+        DLIB_TEST(std::abs(loss - expected_loss) < 1e-5);
+
+        const matrix<float> grad = mat(layer<1>(net).get_parameter_gradient());
+        DLIB_TEST(grad.nr() == 4 && grad.nc() == num_classes);
+        for (long j = 0; j < num_classes; ++j)
+        {
+            const auto s = std::find(selected.begin(), selected.end(), (unsigned long)j);
+            if (s == selected.end())
+                DLIB_TEST(max(abs(colm(grad,j))) == 0);
+            else
+                DLIB_TEST(max(abs(colm(grad,j) - colm(expected_grad, s-selected.begin()))) < 1e-5);
+        }
+
+        // Without labels all the outputs are computed, so the labels are exact.
+        const std::vector<unsigned long> labels = net(x);
+        DLIB_TEST(layer<1>(net).get_output().k() == num_classes);
+        DLIB_TEST(fc.get_selected_outputs().empty());
+        const matrix<float> scores = X*params;
+        for (size_t i = 0; i < x.size(); ++i)
+            DLIB_TEST(labels[i] == (unsigned long)index_of_max(rowm(scores,i)));
+
+        // When there aren't enough other outputs to sample, all of them are used.
+        layer<1>(net).layer_details().set_num_sampled(1000);
+        net.compute_loss(x.begin(), x.end(), y.begin());
+        DLIB_TEST(fc.get_selected_outputs().size() == num_classes);
+        DLIB_TEST(std::set<unsigned long>(fc.get_selected_outputs().begin(), fc.get_selected_outputs().end()).size() == num_classes);
+
+        // A network trained with sampled outputs learns the labels.
+        std::vector<matrix<float>> samples;
+        std::vector<unsigned long> sample_labels;
+        for (int i = 0; i < 300; ++i)
+        {
+            matrix<float> m(3,1);
+            for (auto& v : m)
+                v = rnd.get_random_gaussian();
+            samples.push_back(m);
+            sample_labels.push_back((m(0)>0) + 2*(m(1)>0) + 20*(m(2)>0));
+        }
+        net_type net2;
+        layer<1>(net2).layer_details().set_num_sampled(3);
+        dnn_trainer<net_type> trainer(net2, sgd(0, 0.9));
+        trainer.set_learning_rate(0.1);
+        trainer.set_min_learning_rate(0.01);
+        trainer.set_mini_batch_size(20);
+        trainer.set_max_num_epochs(100);
+        trainer.train(samples, sample_labels);
+        const std::vector<unsigned long> predicted = net2(samples);
+        int num_right = 0;
+        for (size_t i = 0; i < samples.size(); ++i)
+            num_right += predicted[i] == sample_labels[i];
+        DLIB_TEST_MSG(num_right > 0.95*samples.size(), num_right);
+
+        std::ostringstream sout;
+        serialize(net2, sout);
+        net_type net3;
+        std::istringstream sin(sout.str());
+        deserialize(net3, sin);
+        DLIB_TEST(net3(samples) == predicted);
+
+        // dnn_graph treats it as a fc_ layer.
+        resizable_tensor temp;
+        net2.to_tensor(samples.begin(), samples.end(), temp);
+        dnn_graph g(net2);
+        DLIB_TEST(max(abs(mat(g.forward(temp)) - mat(net2.subnet().forward(temp)))) < 1e-5);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename pyramid_input, typename image_type>
+    resizable_tensor reference_pyramid_to_tensor (
+        const pyramid_input& input,
+        const std::vector<image_type>& images,
+        const float avg[3]
+    )
+    {
+        // Build the pyramid one step at a time, like the input layers used to.
+        resizable_tensor data;
+        input.to_tensor(images.begin(), images.end(), data);
+        const auto rects = data.annotation().template get<std::vector<rectangle>>();
+        data = 0;
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            for (long k = 0; k < data.k(); ++k)
+            {
+                float* plane = data.host() + (i*data.k()+k)*data.nr()*data.nc();
+                for (long r = 0; r < images[i].nr(); ++r)
+                {
+                    for (long c = 0; c < images[i].nc(); ++c)
+                    {
+                        rgb_pixel p;
+                        assign_pixel(p, images[i](r,c));
+                        const unsigned char v = k == 0 ? p.red : (k == 1 ? p.green : p.blue);
+                        plane[(r+rects[0].top())*data.nc() + c+rects[0].left()] = (v-avg[k])/256.0;
+                    }
+                }
+            }
+        }
+        for (size_t i = 1; i < rects.size(); ++i)
+        {
+            alias_tensor src(data.num_samples(), data.k(), rects[i-1].height(), rects[i-1].width());
+            alias_tensor dest(data.num_samples(), data.k(), rects[i].height(), rects[i].width());
+            auto asrc = src(data, data.nc()*rects[i-1].top() + rects[i-1].left());
+            auto adest = dest(data, data.nc()*rects[i].top() + rects[i].left());
+            tt::resize_bilinear(adest, data.nc(), data.nr()*data.nc(), asrc, data.nc(), data.nr()*data.nc());
+        }
+        return data;
+    }
+
+    void test_input_to_tensor()
+    {
+        print_spinner();
+        dlib::rand rnd;
+        auto random_images = [&](size_t num, long nr, long nc)
+        {
+            std::vector<matrix<rgb_pixel>> images(num);
+            for (auto& img : images)
+            {
+                img.set_size(nr, nc);
+                for (auto& p : img)
+                    p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+            }
+            return images;
+        };
+
+        // Both small inputs and ones big enough to be split across threads must give
+        // exactly the values the input layers are defined to produce.
+        for (long size : {7, 300})
+        {
+            for (size_t num : {1, 3})
+            {
+                const auto images = random_images(num, size, size+5);
+                const float avg[3] = {120.5f, 101, 99.25f};
+                input_rgb_image input(avg[0], avg[1], avg[2]);
+                resizable_tensor data;
+                input.to_tensor(images.begin(), images.end(), data);
+                DLIB_TEST(data.num_samples() == (long)num && data.k() == 3 && data.nr() == size && data.nc() == size+5);
+                const float* ptr = data.host();
+                bool same = true;
+                for (size_t i = 0; i < num; ++i)
+                {
+                    for (long r = 0; r < size; ++r)
+                    {
+                        for (long c = 0; c < size+5; ++c)
+                        {
+                            const rgb_pixel p = images[i](r,c);
+                            const long idx = ((i*3)*size + r)*(size+5) + c;
+                            same = same && ptr[idx] == (float)((p.red-avg[0])/256.0);
+                            same = same && ptr[idx + size*(size+5)] == (float)((p.green-avg[1])/256.0);
+                            same = same && ptr[idx + 2*size*(size+5)] == (float)((p.blue-avg[2])/256.0);
+                        }
+                    }
+                }
+                DLIB_TEST(same);
+
+                input_rgb_image_pyramid<pyramid_down<6>> pyr(avg[0], avg[1], avg[2]);
+                pyr.to_tensor(images.begin(), images.end(), data);
+                const resizable_tensor expected = reference_pyramid_to_tensor(pyr, images, avg);
+                DLIB_TEST(data.num_samples() == (long)num && data.k() == 3);
+                DLIB_TEST(max(abs(mat(data) - mat(expected))) == 0);
+
+                std::vector<matrix<unsigned char>> gray(num);
+                for (size_t i = 0; i < num; ++i)
+                    assign_image(gray[i], images[i]);
+                const float zero[3] = {0, 0, 0};
+                input_grayscale_image_pyramid<pyramid_down<3>> gpyr;
+                gpyr.to_tensor(gray.begin(), gray.end(), data);
+                const resizable_tensor gexpected = reference_pyramid_to_tensor(gpyr, gray, zero);
+                DLIB_TEST(data.num_samples() == (long)num && data.k() == 1);
+                DLIB_TEST(max(abs(mat(data) - mat(gexpected))) == 0);
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     void test_tensor_resize_bilinear(long samps, long k, long nr, long nc,  long onr, long onc)
@@ -3496,6 +4230,810 @@ namespace
         dlib::deserialize(net2, in);
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_mapped_archive_net()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<3,relu<bn_con<con<4,3,3,1,1,input<matrix<float>>>>>>>;
+        net_type net;
+        matrix<float> img = matrix_cast<float>(randm(8,8));
+        resizable_tensor x;
+        net.to_tensor(&img, &img+1, x);
+        const matrix<float> out = mat(net.subnet().forward(x));
+
+        dlib::serialize_mapped("mapped_net.dat") << net << std::string("after");
+
+        net_type net2;
+        std::string after;
+        dlib::deserialize("mapped_net.dat") >> net2 >> after;
+        DLIB_TEST(after == "after");
+        DLIB_TEST(max(abs(mat(net2.subnet().forward(x)) - out)) == 0);
+
+        // The loaded weights are private to net2.  Changing them doesn't touch the file.
+        tensor& params = layer<1>(net2).layer_details().get_layer_params();
+        params = 0;
+        net_type net3;
+        dlib::deserialize("mapped_net.dat") >> net3;
+        DLIB_TEST(max(abs(mat(net3.subnet().forward(x)) - out)) == 0);
+        DLIB_TEST(max(abs(mat(net2.subnet().forward(x)) - out)) != 0);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_shared_net()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<5,relu<affine<con<4,3,3,1,1,input<matrix<float>>>>>>>;
+        net_type net;
+        std::vector<matrix<float>> images(20);
+        for (auto& img : images)
+            img = matrix_cast<float>(randm(9,9));
+        // run it once so the layers are set up
+        std::vector<unsigned long> labels = net(images);
+        std::vector<matrix<float,0,1>> probs;
+        for (auto& img : images)
+        {
+            resizable_tensor x;
+            net.to_tensor(&img, &img+1, x);
+            probs.push_back(mat(net.subnet().forward(x)));
+        }
+
+        shared_net<net_type> snet(net);
+        DLIB_TEST(snet.num_contexts() == 0);
+        net = net_type();
+
+        // Contexts compute the same thing as the original network and share their
+        // parameters with each other.
+        net_type ctx1 = snet.make_context();
+        net_type ctx2 = snet.make_context();
+        DLIB_TEST(ctx1(images) == labels);
+        DLIB_TEST(ctx2(images) == labels);
+#ifndef DLIB_USE_CUDA
+        DLIB_TEST(layer<1>(ctx1).layer_details().get_layer_params().host() ==
+                  layer<1>(ctx2).layer_details().get_layer_params().host());
+        DLIB_TEST(layer<4>(ctx1).layer_details().get_layer_params().host() ==
+                  layer<4>(ctx2).layer_details().get_layer_params().host());
+#endif
+
+        // Lots of threads can use the shared_net at once.
+        std::vector<std::thread> threads;
+        std::vector<int> ok(4, 1);
+        for (size_t t = 0; t < ok.size(); ++t)
+        {
+            threads.emplace_back([&,t]() {
+                for (int iter = 0; iter < 10; ++iter)
+                {
+                    for (size_t i = 0; i < images.size(); ++i)
+                    {
+                        if (snet(images[i]) != labels[i])
+                            ok[t] = 0;
+                    }
+                    if (snet(images, 7) != labels)
+                        ok[t] = 0;
+                    if (snet.process_batch(images, 3) != labels)
+                        ok[t] = 0;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        for (auto v : ok)
+            DLIB_TEST(v == 1);
+        DLIB_TEST(1 <= snet.num_contexts() && snet.num_contexts() <= ok.size());
+
+        // the contexts made before are still fine
+        resizable_tensor x;
+        ctx1.to_tensor(&images[3], &images[3]+1, x);
+        DLIB_TEST(max(abs(mat(ctx1.subnet().forward(x)) - probs[3])) < 1e-6);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename SUBNET> using imp_block = relu<add_prev1<con<4,3,3,1,1,relu<con<4,3,3,1,1,tag1<SUBNET>>>>>>;
+
+    void test_inference_memory_planning()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<3,avg_pool_everything<
+            mult_prev2<sig<con<4,1,1,1,1,
+            tag2<repeat<3,imp_block,
+            relu<con<4,3,3,1,1,
+            input<matrix<float>>>>>>>>>>>>;
+        net_type net;
+        std::vector<matrix<float>> images;
+        images.push_back(matrix_cast<float>(randm(9,9)));
+        images.push_back(matrix_cast<float>(randm(13,11)));
+        images.push_back(matrix_cast<float>(randm(5,5)));
+        images.push_back(matrix_cast<float>(randm(9,9)));
+        std::vector<matrix<float>> batch(6);
+        for (auto& img : batch)
+            img = matrix_cast<float>(randm(7,8));
+        net(images[0]);
+
+        net_type planned = net;
+        enable_inference_memory_planning(planned);
+
+        // Planned networks compute the same thing, whatever order the input sizes come in.
+        for (int iter = 0; iter < 2; ++iter)
+        {
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                resizable_tensor x;
+                net.to_tensor(&images[i], &images[i]+1, x);
+                const matrix<float> expected = mat(net.subnet().forward(x));
+                DLIB_TEST(max(abs(mat(planned.subnet().forward(x)) - expected)) < 1e-5);
+            }
+        }
+        DLIB_TEST(planned(batch) == net(batch));
+
+        // Only the outputs that layers further up could still need are kept.
+        DLIB_TEST(layer<1>(planned).get_output().size() != 0);
+        DLIB_TEST(layer<2>(planned).get_output().size() == 0);
+        DLIB_TEST(layer<2>(net).get_output().size() != 0);
+
+        // Copies share the spare tensors but can still run at the same time.
+        resizable_tensor x1;
+        net.to_tensor(&images[1], &images[1]+1, x1);
+        const matrix<float> expected1 = mat(net.subnet().forward(x1));
+        net_type planned2 = planned;
+        std::vector<std::thread> threads;
+        std::vector<int> ok(2, 1);
+        for (size_t t = 0; t < ok.size(); ++t)
+        {
+            threads.emplace_back([&,t]() {
+                net_type& n = t == 0 ? planned : planned2;
+                for (int i = 0; i < 20; ++i)
+                {
+                    resizable_tensor x;
+                    n.to_tensor(&images[1], &images[1]+1, x);
+                    if (max(abs(mat(n.subnet().forward(x)) - expected1)) > 1e-5)
+                        ok[t] = 0;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        for (auto v : ok)
+            DLIB_TEST(v == 1);
+        DLIB_TEST(planned2(batch) == net(batch));
+
+        disable_inference_memory_planning(planned);
+        DLIB_TEST(planned(batch) == net(batch));
+        DLIB_TEST(layer<2>(planned).get_output().size() != 0);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_data_loader()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<2,input<matrix<float,0,1>>>>;
+        net_type net;
+
+        // The label says which side of the line x == y a point is on.
+        auto load_sample = [](matrix<float,0,1>& x, unsigned long& label, dlib::rand& rnd)
+        {
+            x = {(float)rnd.get_random_gaussian(), (float)rnd.get_random_gaussian()};
+            label = x(0) > x(1) ? 1 : 0;
+        };
+
+        {
+            dnn_data_loader<net_type> loader(net, 16, load_sample, 2, 3);
+            DLIB_TEST(loader.get_mini_batch_size() == 16);
+            DLIB_TEST(loader.num_threads() == 2);
+            DLIB_TEST(loader.get_max_queued_mini_batches() == 3);
+
+            dnn_data_loader<net_type>::mini_batch batch;
+            for (int iter = 0; iter < 10; ++iter)
+            {
+                loader.get_next(batch);
+                DLIB_TEST(batch.samples.size() == 16);
+                DLIB_TEST(batch.labels.size() == 16);
+                resizable_tensor expected;
+                net.to_tensor(batch.samples.begin(), batch.samples.end(), expected);
+                DLIB_TEST(max(abs(mat(expected)-mat(batch.data))) == 0);
+                for (size_t i = 0; i < batch.samples.size(); ++i)
+                    DLIB_TEST(batch.labels[i] == (batch.samples[i](0) > batch.samples[i](1) ? 1u : 0u));
+            }
+            DLIB_TEST(loader.get_num_mini_batches() == 10);
+            DLIB_TEST(loader.get_num_starved_mini_batches() <= 10);
+            DLIB_TEST(loader.get_starved_seconds() >= 0);
+
+            dnn_trainer<net_type> trainer(net, sgd(0,0.9));
+            trainer.set_learning_rate(0.1);
+            for (int i = 0; i < 200; ++i)
+                trainer.train_one_step(loader);
+            trainer.test_one_step(loader);
+            DLIB_TEST(trainer.get_train_one_step_calls() == 200);
+            DLIB_TEST(trainer.get_test_one_step_calls() == 1);
+            trainer.get_net();
+            DLIB_TEST(loader.get_num_mini_batches() == 211);
+        }
+
+        std::vector<matrix<float,0,1>> samples;
+        std::vector<unsigned long> labels;
+        dlib::rand rnd;
+        for (int i = 0; i < 200; ++i)
+        {
+            samples.emplace_back();
+            labels.emplace_back();
+            load_sample(samples.back(), labels.back(), rnd);
+        }
+        const auto predicted = net(samples);
+        int num_right = 0;
+        for (size_t i = 0; i < samples.size(); ++i)
+            num_right += predicted[i] == labels[i];
+        DLIB_TEST_MSG(num_right > 190, num_right);
+
+        // Errors in the load function come out of get_next().
+        std::atomic<int> calls(0);
+        dnn_data_loader<net_type> loader(net, 4, [&](matrix<float,0,1>& x, unsigned long& label, dlib::rand& rnd)
+        {
+            if (++calls > 20)
+                throw dlib::error("bad sample");
+            load_sample(x, label, rnd);
+        }, 1);
+        dnn_data_loader<net_type>::mini_batch batch;
+        for (int i = 0; i < 5; ++i)
+            loader.get_next(batch);
+        for (int i = 0; i < 2; ++i)
+        {
+            try
+            {
+                loader.get_next(batch);
+                DLIB_TEST_MSG(false, "get_next() should have thrown");
+            }
+            catch (dlib::error& e)
+            {
+                DLIB_TEST(e.info == "bad sample");
+            }
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_async_sync()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<2,relu<fc<8,input<matrix<float,0,1>>>>>>;
+        std::vector<matrix<float,0,1>> samples;
+        std::vector<unsigned long> labels;
+        dlib::rand rnd;
+        for (int i = 0; i < 64; ++i)
+        {
+            samples.push_back({(float)rnd.get_random_gaussian(), (float)rnd.get_random_gaussian()});
+            labels.push_back(samples.back()(0) > samples.back()(1) ? 1 : 0);
+        }
+
+        const std::string filename = "dnn_async_sync_test.dat";
+        std::remove(filename.c_str());
+        std::remove((filename+"_").c_str());
+
+        net_type net;
+        {
+            dnn_trainer<net_type> trainer(net, sgd(0,0.9));
+            DLIB_TEST(trainer.get_max_pending_syncs() == 0);
+            trainer.set_max_pending_syncs(2);
+            DLIB_TEST(trainer.get_max_pending_syncs() == 2);
+            // Sync after every step so the background writes overlap with training.
+            trainer.set_synchronization_file(filename, std::chrono::seconds(0));
+            for (int i = 0; i < 30; ++i)
+                trainer.train_one_step(samples, labels);
+            trainer.get_net();
+            DLIB_TEST(file_exists(filename));
+            DLIB_TEST(file_exists(filename+"_"));
+            DLIB_TEST(!file_exists(filename+".tmp"));
+            DLIB_TEST(!file_exists(filename+"_.tmp"));
+        }
+
+        // The newest sync file should hold the final state of the trainer.
+        net_type net2;
+        {
+            dnn_trainer<net_type> trainer(net2, sgd(0,0.9));
+            trainer.set_synchronization_file(filename, std::chrono::seconds(0));
+            DLIB_TEST(trainer.get_train_one_step_calls() == 30);
+        }
+        DLIB_TEST(max(abs(mat(layer<1>(net).layer_details().get_layer_params()) -
+                          mat(layer<1>(net2).layer_details().get_layer_params()))) == 0);
+        DLIB_TEST(max(abs(mat(layer<3>(net).layer_details().get_layer_params()) -
+                          mat(layer<3>(net2).layer_details().get_layer_params()))) == 0);
+        std::remove(filename.c_str());
+        std::remove((filename+"_").c_str());
+
+        // Errors from the background writes come out of the next sync.
+        net_type net3;
+        dnn_trainer<net_type> trainer(net3, sgd(0,0.9));
+        trainer.set_max_pending_syncs(1);
+        trainer.set_synchronization_file("no_such_directory/dnn_async_sync_test.dat", std::chrono::seconds(0));
+        trainer.train_one_step(samples, labels);
+        trainer.train_one_step(samples, labels);
+        bool threw = false;
+        try { trainer.get_net(); }
+        catch (serialization_error&) { threw = true; }
+        DLIB_TEST(threw);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_tiled_inference()
+    {
+        print_spinner();
+
+        using net_type = loss_mean_squared_per_pixel<
+            con<1,1,1,1,1,
+            relu<cont<6,2,2,2,2,
+            relu<con<6,3,3,1,1,
+            max_pool<2,2,2,2,
+            relu<con<6,5,5,1,1,
+            input<matrix<float>>>>>>>>>>>;
+        net_type net;
+
+        // Walking back from the output: the cont halves the coordinates and adds half a
+        // pixel on each side, the 3x3 con adds 1, the pooling doubles the range and adds
+        // 1, and the 5x5 con adds 2.
+        DLIB_TEST(receptive_field(net, dpoint(0,0)) == drectangle(-6,-6,6,6));
+        DLIB_TEST(receptive_field(net, dpoint(10,4)) == drectangle(4,-2,16,10));
+
+        dlib::rand rnd;
+        matrix<float> img(90, 74);
+        for (auto& v : img)
+            v = rnd.get_random_gaussian();
+
+        const matrix<float> whole = net(img);
+        for (long tile_size : {1, 24, 33, 200})
+        {
+            for (size_t batch : {1, 3})
+            {
+                const matrix<float> tiled = tiled_inference(net, img, tile_size, batch);
+                DLIB_TEST(tiled.nr() == whole.nr() && tiled.nc() == whole.nc());
+                DLIB_TEST_MSG(max(abs(tiled-whole)) < 1e-4*max(abs(whole)), 
+                    tile_size << " " << batch << " " << max(abs(tiled-whole)));
+            }
+        }
+
+        // Labels that need an argmax come out the same too.
+        using class_net_type = loss_multiclass_log_per_pixel<
+            con<3,1,1,1,1,
+            relu<con<6,3,3,1,1,
+            input<matrix<float>>>>>>;
+        class_net_type class_net;
+        const matrix<uint16_t> labels = class_net(img);
+        const matrix<uint16_t> tiled_labels = tiled_inference(class_net, img, 16, 2);
+        DLIB_TEST(labels.nr() == tiled_labels.nr() && labels.nc() == tiled_labels.nc());
+        long num_different = 0;
+        for (long r = 0; r < labels.nr(); ++r)
+            for (long c = 0; c < labels.nc(); ++c)
+                num_different += labels(r,c) != tiled_labels(r,c);
+        DLIB_TEST(num_different <= 2);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename SUBNET> using graph_block = relu<add_prev2<bn_con<con<6,3,3,1,1,tag2<SUBNET>>>>>;
+
+    template <template<typename> class DROPOUT>
+    using graph_net_type = loss_multiclass_log<fc<5,DROPOUT<htan<fc<7,
+            prelu<max_pool<2,2,2,2,
+            leaky_relu<con<4,3,3,1,1,
+            concat2<tag3,tag4,
+            tag4<con<3,1,1,1,1,skip1<
+            tag3<repeat<2,graph_block,
+            relu<tag1<con<6,3,3,1,1,
+            input<matrix<float>>>>>>>>>>>>>>>>>>>>;
+
+    float max_graph_error (
+        dnn_graph& graph,
+        const tensor& expected,
+        const tensor& x
+    )
+    {
+        const tensor& out = graph.forward(x);
+        if (out.num_samples() != expected.num_samples() || out.k() != expected.k() ||
+            out.nr() != expected.nr() || out.nc() != expected.nc())
+            return std::numeric_limits<float>::infinity();
+        return max(abs(mat(out)-mat(expected)));
+    }
+
+    bool single_node_graph_loads (
+        const std::string& name,
+        const std::vector<long>& iattrs,
+        const std::vector<float>& fattrs,
+        const std::vector<std::vector<long>>& shapes
+    )
+    {
+        // Writes a graph with one operation, reading the graph input, in the format
+        // serialize(dnn_graph) uses.  The tensors have the given shapes, with missing
+        // trailing dimensions set to 1.
+        std::vector<resizable_tensor> tensors(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            if (shapes[i].size() == 0)
+                continue;
+            std::vector<long> dims = shapes[i];
+            dims.resize(4, 1);
+            tensors[i].set_size(dims[0], dims[1], dims[2], dims[3]);
+            tensors[i] = 0;
+        }
+        std::ostringstream sout;
+        serialize("dnn_graph", sout);
+        serialize(size_t(1), sout);
+        serialize(name, sout);
+        serialize(std::vector<long>{0}, sout);
+        serialize(iattrs, sout);
+        serialize(fattrs, sout);
+        serialize(tensors, sout);
+        serialize(1L, sout);
+
+        std::istringstream sin(sout.str());
+        dnn_graph graph;
+        try { deserialize(graph, sin); }
+        catch (serialization_error&) { return false; }
+        return true;
+    }
+
+    void test_dnn_graph_validation()
+    {
+        print_spinner();
+
+        using tensors = std::vector<std::vector<long>>;
+        const std::vector<long> con_attrs = {1,1,1,1,1,0};
+        const std::vector<long> cont_attrs = {1,1,1,1,1};
+        const std::vector<long> pool_attrs = {2,2,2,2,0,0};
+
+        // Well formed operations load.
+        DLIB_TEST(single_node_graph_loads("con", con_attrs, {0}, tensors{{4,3,3,3}, {1,4}}));
+        DLIB_TEST(single_node_graph_loads("cont", cont_attrs, {}, tensors{{3,4,3,3}, {1,4}}));
+        DLIB_TEST(single_node_graph_loads("fc", {}, {}, tensors{{10,5}, {1,5}}));
+        DLIB_TEST(single_node_graph_loads("fc", {}, {}, tensors{{10,5}}));
+        DLIB_TEST(single_node_graph_loads("prelu", {}, {}, tensors{{1}}));
+        DLIB_TEST(single_node_graph_loads("max_pool", pool_attrs, {}, tensors{}));
+        DLIB_TEST(single_node_graph_loads("affine_con", {}, {}, tensors{{1,3}, {1,3}}));
+        DLIB_TEST(single_node_graph_loads("affine_fc", {}, {}, tensors{{1,3,4,4}, {1,3,4,4}}));
+        DLIB_TEST(single_node_graph_loads("upsample", {2,2}, {}, tensors{}));
+
+        // Tensors that don't agree with each other or with the attributes are rejected
+        // instead of being handed to the kernels.
+        DLIB_TEST(!single_node_graph_loads("con", con_attrs, {0}, tensors{{4,3,3,3}, {1,5}}));
+        DLIB_TEST(!single_node_graph_loads("con", con_attrs, {0}, tensors{{4,3,3,3}, {1,4,2,1}}));
+        DLIB_TEST(!single_node_graph_loads("con", con_attrs, {0}, tensors{{4,3,1,1}, {1,4}}));
+        DLIB_TEST(!single_node_graph_loads("con", {1,1,1,1,3,0}, {0}, tensors{{4,3,3,3}, {1,4}}));
+        DLIB_TEST(!single_node_graph_loads("con", {0,1,1,1,1,0}, {0}, tensors{{4,3,3,3}, {1,4}}));
+        DLIB_TEST(!single_node_graph_loads("con", con_attrs, {0}, tensors{{}, {}}));
+        DLIB_TEST(!single_node_graph_loads("cont", cont_attrs, {}, tensors{{3,4,3,3}, {1,3}}));
+        DLIB_TEST(!single_node_graph_loads("fc", {}, {}, tensors{{10,5}, {1,4}}));
+        DLIB_TEST(!single_node_graph_loads("fc", {}, {}, tensors{{10,5,2,1}}));
+        DLIB_TEST(!single_node_graph_loads("prelu", {}, {}, tensors{{2}}));
+        DLIB_TEST(!single_node_graph_loads("max_pool", {2,2,0,2,0,0}, {}, tensors{}));
+        DLIB_TEST(!single_node_graph_loads("avg_pool", {2,2,2,2,2,0}, {}, tensors{}));
+        DLIB_TEST(!single_node_graph_loads("affine_con", {}, {}, tensors{{1,3}, {1,4}}));
+        DLIB_TEST(!single_node_graph_loads("affine_con", {}, {}, tensors{{1,3,2,2}, {1,3,2,2}}));
+        DLIB_TEST(!single_node_graph_loads("affine_fc", {}, {}, tensors{{1,3,4,4}, {1,3,4,3}}));
+        DLIB_TEST(!single_node_graph_loads("upsample", {0,2}, {}, tensors{}));
+    }
+
+    void test_dnn_graph()
+    {
+        print_spinner();
+
+        graph_net_type<dropout> net;
+
+        tt::tensor_rand rnd(0);
+        resizable_tensor batch(8,1,12,10), x(1,1,12,10), x2(2,1,12,10);
+        rnd.fill_gaussian(batch);
+        rnd.fill_gaussian(x);
+        rnd.fill_gaussian(x2);
+        // Only to_tensor() sets up the sample expansion factor forward() needs.
+        matrix<float> img(12,10);
+        resizable_tensor temp;
+        net.to_tensor(&img, &img+1, temp);
+        // A forward pass on a batch updates the bn_ layers' running statistics.
+        net.subnet().forward(batch);
+        net.subnet().forward(batch);
+        // dropout_ drops random outputs during forward(), the graph does what multiply_
+        // does after training instead.
+        graph_net_type<multiply> test_net(net);
+        test_net.to_tensor(&img, &img+1, temp);
+        resizable_tensor expected = test_net.subnet().forward(x);
+
+        dnn_graph graph(net);
+        // 5 con, 2 bn, 2 add_prev, 3 relu, a concat, max_pool, prelu, 2 fc, htan and dropout
+        DLIB_TEST_MSG(graph.num_nodes() == 20, graph.num_nodes());
+        // The leaky_relu is folded into its con.  The first relu isn't, since skip1 also
+        // reads the output of the con below it.
+        DLIB_TEST_MSG(graph.num_steps() == 19, graph.num_steps());
+        DLIB_TEST(graph.num_buffers() < graph.num_steps());
+        DLIB_TEST(max_graph_error(graph, expected, x) < 1e-5);
+        // Running it again reuses the buffers and gives the same answer.
+        DLIB_TEST(max_graph_error(graph, expected, x) < 1e-5);
+
+        // The serialized graph can be loaded without knowing the network type.
+        std::ostringstream sout;
+        serialize(graph, sout);
+        std::istringstream sin(sout.str());
+        dnn_graph graph2;
+        deserialize(graph2, sin);
+        DLIB_TEST(graph2.num_steps() == graph.num_steps());
+        DLIB_TEST(max_graph_error(graph2, expected, x) < 1e-5);
+        // A truncated file is rejected.
+        std::istringstream truncated(sout.str().substr(0, sout.str().size()/2));
+        bool truncated_threw = false;
+        try { dnn_graph g; deserialize(g, truncated); }
+        catch (serialization_error&) { truncated_threw = true; }
+        DLIB_TEST(truncated_threw);
+
+        // Each sample of a batch gives the same output it gives on its own.
+        dnn_graph graph3(graph2);
+        const resizable_tensor out = graph3.forward(x2);
+        for (long i = 0; i < 2; ++i)
+        {
+            alias_tensor sample(1,x2.k(),x2.nr(),x2.nc());
+            resizable_tensor xi;
+            xi = sample(x2, i*sample.size());
+            alias_tensor out_sample(1,out.k(),out.nr(),out.nc());
+            DLIB_TEST(max(abs(mat(out_sample(out, i*out_sample.size())) - mat(test_net.subnet().forward(xi)))) < 1e-5);
+        }
+
+        using net2_type = loss_mean_squared_per_pixel<con<1,1,1,1,1,
+            softmax<mish<upsample<2,avg_pool<2,2,2,2,
+            mult_prev1<sig<con<4,1,1,1,1,tag1<
+            cont<4,3,3,1,1,
+            grouped_con<4,3,3,1,1,2,con<4,3,3,1,1,
+            input<matrix<float>>>>>>>>>>>>>>>;
+        net2_type net2;
+        resizable_tensor y(2,1,16,14);
+        rnd.fill_gaussian(y);
+        net2.to_tensor(&img, &img+1, temp);
+        expected = net2.subnet().forward(y);
+        dnn_graph g2(net2);
+        DLIB_TEST(g2.num_nodes() == 11);
+        DLIB_TEST(max_graph_error(g2, expected, y) < 1e-5);
+
+        // Activations already fused by fuse_layers() are kept.
+        using net3_type = loss_multiclass_log<fc<3,relu<con<5,3,3,1,1,input<matrix<float>>>>>>;
+        net3_type net3;
+        net3.to_tensor(&img, &img+1, temp);
+        net3.subnet().forward(x);
+        fuse_layers(net3);
+        expected = net3.subnet().forward(x);
+        dnn_graph g3(net3);
+        DLIB_TEST(g3.num_nodes() == 2);
+        DLIB_TEST(max_graph_error(g3, expected, x) < 1e-5);
+
+        std::istringstream bad("junk");
+        bool threw = false;
+        try { deserialize(g3, bad); }
+        catch (serialization_error&) { threw = true; }
+        DLIB_TEST(threw);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_extract_view()
+    {
+        print_spinner();
+
+        using net_type = relu<extract<3,2,2,2,con<3,3,3,1,1,input<matrix<float>>>>>;
+        net_type net;
+        tt::tensor_rand rnd;
+
+        matrix<float> img(4,4);
+        img = 0;
+        resizable_tensor x;
+        net.to_tensor(&img, &img+1, x);
+
+        for (long n : {1, 2, 1})
+        {
+            x.set_size(n, 1, 4, 4);
+            rnd.fill_gaussian(x);
+            net.forward(x);
+
+            const tensor& in = layer<2>(net).get_output();
+            const tensor& ext = layer<1>(net).get_output();
+            const long in_size = in.k()*in.nr()*in.nc();
+            DLIB_TEST(ext.num_samples() == n && ext.k() == 2 && ext.nr() == 2 && ext.nc() == 2);
+            // A single sample is extracted without copying anything.
+            if (n == 1)
+                DLIB_TEST(ext.host() == in.host() + 3);
+            for (long i = 0; i < n; ++i)
+            {
+                for (long j = 0; j < 8; ++j)
+                {
+                    const float v = in.host()[i*in_size+3+j];
+                    DLIB_TEST(ext.host()[i*8+j] == v);
+                    // The relu on top can't run in-place since that would change the
+                    // con's output.
+                    DLIB_TEST(net.get_output().host()[i*8+j] == std::max(v, 0.0f));
+                }
+            }
+
+            // Copies hold their own output rather than a view into the original.
+            net_type net2(net);
+            const tensor& ext2 = layer<1>(net2).get_output();
+            DLIB_TEST(ext2.host() != ext.host());
+            DLIB_TEST(max(abs(mat(ext2)-mat(ext))) == 0);
+        }
+
+        // Gradients flow back through the view the same way they flow back through the
+        // copy made when there are two samples.
+        x.set_size(1, 1, 4, 4);
+        rnd.fill_gaussian(x);
+        resizable_tensor g(1, 2, 2, 2);
+        rnd.fill_gaussian(g);
+        net.forward(x);
+        net.back_propagate_error(x, g);
+        const resizable_tensor grad1 = layer<2>(net).get_parameter_gradient();
+
+        resizable_tensor x2(2, 1, 4, 4), g2(2, 2, 2, 2);
+        std::copy(x.begin(), x.end(), x2.begin());
+        std::copy(x.begin(), x.end(), x2.begin()+x.size());
+        std::copy(g.begin(), g.end(), g2.begin());
+        std::copy(g.begin(), g.end(), g2.begin()+g.size());
+        net.forward(x2);
+        net.back_propagate_error(x2, g2);
+        const resizable_tensor grad2 = layer<2>(net).get_parameter_gradient();
+        DLIB_TEST(max(abs(mat(grad2) - 2*mat(grad1))) < 1e-5);
+        DLIB_TEST(max(abs(mat(grad1))) > 0);
+
+        // A whole sample is extracted without a copy too.
+        using net_type2 = extract<0,3,4,4,con<3,3,3,1,1,input<matrix<float>>>>;
+        net_type2 net3;
+        net3.to_tensor(&img, &img+1, x);
+        x.set_size(2, 1, 4, 4);
+        rnd.fill_gaussian(x);
+        net3.forward(x);
+        DLIB_TEST(net3.get_output().host() == layer<1>(net3).get_output().host());
+        DLIB_TEST(net3.get_output().num_samples() == 2 && net3.get_output().k() == 3);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_profiling()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<3,relu<
+            repeat<2,imp_block,
+            con<4,3,3,2,2,
+            input<matrix<float>>>>>>>;
+        net_type net;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> images(2);
+        for (auto& img : images)
+            img = matrix_cast<float>(gaussian_randm(10,12,rnd.get_random_32bit_number()));
+        const std::vector<unsigned long> labels = {0, 2};
+        resizable_tensor x;
+        net.to_tensor(images.begin(), images.end(), x);
+        net.forward(x);
+        const matrix<float> expected = mat(net.subnet().get_output());
+
+        auto profiler = enable_profiling(net);
+        net.forward(x);
+        DLIB_TEST(max(abs(mat(net.subnet().get_output())-expected)) == 0);
+        net.compute_parameter_gradients(x, labels.begin());
+        net.forward(x);
+
+        const auto stats = profiler->get_layer_stats();
+        // fc, relu, 2 blocks of 5 layers, and con.
+        DLIB_TEST(stats.size() == 13);
+        for (auto& s : stats)
+        {
+            DLIB_TEST(s.forward_calls == 3);
+            DLIB_TEST(s.backward_calls == 1);
+            DLIB_TEST(s.forward_seconds >= 0);
+        }
+        DLIB_TEST(stats[0].index == 1);
+        DLIB_TEST(stats[0].name == "fc");
+        DLIB_TEST(stats[1].name == "relu");
+        DLIB_TEST(stats.back().name == "con");
+        DLIB_TEST(stats.back().index == net_type::num_layers-2);
+
+        // The first con layer makes a 4x4x5 output from 1 input channel with a 3x3
+        // filter, and the fc layer maps 80 inputs to 3 outputs, for 2 samples each.
+        DLIB_TEST(stats.back().flops == 3*2.0*(2*4*4*5)*(1*3*3));
+        DLIB_TEST(stats.back().output_bytes == 2*4*4*5*sizeof(float));
+        DLIB_TEST(stats.back().parameter_bytes == layer<net_type::num_layers-2>(net).layer_details().get_layer_params().size()*sizeof(float));
+        DLIB_TEST(stats[0].flops == 3*2.0*2*80*3);
+        // The relu at the top of the repeat block is computed in-place.
+        DLIB_TEST(stats[2].name == "relu");
+        DLIB_TEST(stats[2].output_bytes == 0);
+        DLIB_TEST(stats[2].flops == 0);
+
+        std::ostringstream sout;
+        sout << *profiler;
+        const std::string table = sout.str();
+        DLIB_TEST(table.find("add_prev1") != std::string::npos);
+        DLIB_TEST(std::count(table.begin(), table.end(), '\n') == 15);
+
+        DLIB_TEST(profiler->num_trace_events() == 13*4);
+        sout.str("");
+        profiler->write_chrome_trace(sout);
+        const std::string trace = sout.str();
+        DLIB_TEST(trace.compare(0, 16, "{\"traceEvents\":[") == 0);
+        DLIB_TEST(std::count(trace.begin(), trace.end(), '\n') == 13*4+2);
+        DLIB_TEST(trace.find("\"cat\":\"backward\"") != std::string::npos);
+
+        profiler->set_max_trace_events(10);
+        net_type copy = net;
+        copy.forward(x);
+        DLIB_TEST(profiler->get_layer_stats()[0].forward_calls == 4);
+        DLIB_TEST(profiler->num_trace_events() == 10);
+
+        profiler->clear();
+        DLIB_TEST(profiler->get_layer_stats()[0].forward_calls == 0);
+        DLIB_TEST(profiler->num_trace_events() == 0);
+
+        disable_profiling(net);
+        net.forward(x);
+        DLIB_TEST(profiler->get_layer_stats()[0].forward_calls == 0);
+        DLIB_TEST(max(abs(mat(net.subnet().get_output())-expected)) == 0);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_batching_executor()
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<5,relu<fc<8,input<matrix<float,0,1>>>>>>;
+        net_type net;
+        std::vector<matrix<float,0,1>> samples;
+        for (int i = 0; i < 40; ++i)
+            samples.push_back(matrix_cast<float>(gaussian_randm(6,1,i)));
+        const std::vector<unsigned long> expected = net(samples);
+
+        {
+            // With a long delay only full batches are run, so 8 requests make exactly 2
+            // batches and don't have to wait for the delay.
+            dnn_batching_executor<net_type> executor(net, 4, std::chrono::seconds(60));
+            DLIB_TEST(executor.get_max_batch_size() == 4);
+            DLIB_TEST(executor.get_max_delay() == std::chrono::seconds(60));
+            std::vector<std::future<unsigned long>> results;
+            for (int i = 0; i < 8; ++i)
+                results.push_back(executor.submit(samples[i]));
+            for (int i = 0; i < 8; ++i)
+                DLIB_TEST(results[i].get() == expected[i]);
+            DLIB_TEST(executor.get_num_requests() == 8);
+            DLIB_TEST(executor.get_num_batches() == 2);
+            DLIB_TEST(executor.get_average_batch_size() == 4);
+
+            // The destructor finishes requests that are still waiting for a batch.
+            results.clear();
+            results.push_back(executor.submit(samples[8]));
+            results.push_back(executor.submit(samples[9]));
+        }
+
+        // A partial batch runs once its first request has waited the max delay.
+        dnn_batching_executor<net_type> executor(net, 64, std::chrono::milliseconds(5));
+        DLIB_TEST(executor(samples[3]) == expected[3]);
+        DLIB_TEST(executor.get_num_batches() == 1);
+
+        // Many threads calling at once all get their own answers.
+        std::vector<std::thread> threads;
+        std::atomic<int> num_wrong(0);
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&,t]() {
+                for (size_t i = t; i < samples.size(); i += 4)
+                {
+                    if (executor(samples[i]) != expected[i])
+                        ++num_wrong;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        DLIB_TEST(num_wrong == 0);
+        DLIB_TEST(executor.get_num_requests() == 41);
+        DLIB_TEST(executor.get_num_batches() <= 41);
+    }
+
 // ----------------------------------------------------------------------------------------
 
     void test_loss_dot()
@@ -3742,11 +5280,18 @@ namespace
             test_avg_pool(4,5,3,1,2,4);
             test_avg_pool(4,4,2,2,1,3);
             test_avg_pool(4,5,40,50,0,1);
+            test_cpu_conv_algorithms();
+            test_grouped_conv();
+            test_grouped_con_layers();
+            test_int8_quantization();
+            test_fused_conv_epilogue();
+            test_fuse_layers();
             test_tanh();
             test_softmax();
             test_softmax_all();
             test_sigmoid();
             test_mish();
+            test_cpu_activations();
             test_leaky_relu();
             test_batch_normalize();
             test_batch_normalize_conv();
@@ -3771,7 +5316,20 @@ namespace
             test_loss_multiclass_per_pixel_with_noise_and_pixels_to_ignore();
             test_loss_multiclass_per_pixel_weighted();
             test_loss_multiclass_log_weighted();
+            test_loss_multiclass_log_sampled();
+            test_input_to_tensor();
             test_serialization();
+            test_mapped_archive_net();
+            test_shared_net();
+            test_inference_memory_planning();
+            test_data_loader();
+            test_async_sync();
+            test_tiled_inference();
+            test_dnn_graph();
+            test_dnn_graph_validation();
+            test_extract_view();
+            test_profiling();
+            test_batching_executor();
             test_loss_dot();
             test_loss_multimulticlass_log();
             test_loss_mmod();
@@ -76,6 +76,26 @@ namespace
             std::vector<rectangle> dets = detector(images[0]);
             DLIB_TEST(dets.size() == 3);
 
+            // The batch interface should find the same faces.  Include a flipped copy of
+            // the image so the detector's different weight vectors see some action.
+            std::vector<matrix<unsigned char> > imgs(2, mat(images[0]));
+            imgs[1] = fliplr(imgs[1]);
+            std::vector<std::vector<rect_detection> > batch_dets;
+            detector(imgs, batch_dets);
+            DLIB_TEST(batch_dets.size() == 2);
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+            {
+                std::vector<rect_detection> serial_dets;
+                detector(imgs[i], serial_dets);
+                DLIB_TEST(batch_dets[i].size() == serial_dets.size());
+                for (unsigned long j = 0; j < serial_dets.size() && j < batch_dets[i].size(); ++j)
+                {
+                    DLIB_TEST(batch_dets[i][j].rect == serial_dets[j].rect);
+                    DLIB_TEST(batch_dets[i][j].weight_index == serial_dets[j].weight_index);
+                    DLIB_TEST(batch_dets[i][j].detection_confidence == serial_dets[j].detection_confidence);
+                }
+            }
+
 
             /*
             // visualize the detections
@@ -154,6 +154,139 @@ namespace
         test_real_compile_time_sized_ffts<1,16>();
     }
 
+// ----------------------------------------------------------------------------------------
+
+    matrix<complex<double> > naive_dft (
+        const matrix<complex<double> >& m
+    )
+    {
+        // 2D DFT computed directly from the definition, as D*m*E where D and E are DFT
+        // matrices.
+        const double pi = 3.1415926535897932385;
+        matrix<complex<double> > D(m.nr(),m.nr()), E(m.nc(),m.nc());
+        for (long r = 0; r < D.nr(); ++r)
+            for (long c = 0; c < D.nc(); ++c)
+                D(r,c) = std::polar(1.0, -2*pi*((r*c)%D.nr())/D.nr());
+        for (long r = 0; r < E.nr(); ++r)
+            for (long c = 0; c < E.nc(); ++c)
+                E(r,c) = std::polar(1.0, -2*pi*((r*c)%E.nr())/E.nr());
+        return D*m*E;
+    }
+
+    void test_arbitrary_size_ffts()
+    {
+        // Sizes that exercise the radix 2, 3, 4, and 5 code paths, their combinations,
+        // and Bluestein's algorithm for everything else.
+        const long sizes[] = {1, 2, 3, 5, 6, 7, 9, 10, 12, 15, 17, 25, 30, 45, 60, 97, 100, 120, 127, 243, 250, 625, 1000, 1009};
+        for (long n : sizes)
+        {
+            print_spinner();
+            const matrix<complex<double> > m1 = rand_complex(n,1);
+            const matrix<complex<float> > fm1 = matrix_cast<complex<float> >(m1);
+            const matrix<complex<double> > truth = naive_dft(m1);
+            const double scale = sum(norm(truth));
+
+            DLIB_TEST_MSG(sum(norm(fft(m1)-truth))/scale < 1e-24, n << ": " << sum(norm(fft(m1)-truth))/scale);
+            DLIB_TEST_MSG(sum(norm(matrix_cast<complex<double> >(fft(fm1))-truth))/scale < 1e-11, n);
+            DLIB_TEST(max(norm(ifft(fft(m1))-m1)) < 1e-16);
+            DLIB_TEST(max(norm(ifft(fft(fm1))-fm1)) < 1e-7);
+            DLIB_TEST(max(norm(trans(fft(trans(m1)))-truth)) < 1e-16*scale);
+
+            matrix<complex<double> > temp = m1;
+            fft_inplace(temp);
+            DLIB_TEST(max(norm(temp-fft(m1))) == 0);
+            ifft_inplace(temp);
+            DLIB_TEST(max(norm(temp/n-m1)) < 1e-16);
+        }
+
+        for (long nr : {3, 6, 7, 16})
+        {
+            for (long nc : {5, 9, 11, 32})
+            {
+                print_spinner();
+                const matrix<complex<double> > m1 = rand_complex(nr,nc);
+                const matrix<complex<float> > fm1 = matrix_cast<complex<float> >(m1);
+                const matrix<complex<double> > truth = naive_dft(m1);
+                const double scale = sum(norm(truth));
+
+                DLIB_TEST(sum(norm(fft(m1)-truth))/scale < 1e-24);
+                DLIB_TEST(sum(norm(matrix_cast<complex<double> >(fft(fm1))-truth))/scale < 1e-11);
+                DLIB_TEST(max(norm(ifft(fft(m1))-m1)) < 1e-16);
+
+                matrix<complex<double> > temp = m1;
+                fft_inplace(temp);
+                DLIB_TEST(max(norm(temp-fft(m1))) < 1e-16*scale);
+                ifft_inplace(temp);
+                DLIB_TEST(max(norm(temp/temp.size()-m1)) < 1e-16);
+            }
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_rfft()
+    {
+        for (long nr : {1, 2, 5, 8, 12})
+        {
+            for (long nc : {1, 2, 3, 7, 8, 10, 16, 17, 30})
+            {
+                print_spinner();
+                const matrix<double> m1 = real(rand_complex(nr,nc));
+                const matrix<float> fm1 = matrix_cast<float>(m1);
+                const matrix<complex<double> > full = fft(complex_matrix(m1));
+                const double scale = sum(norm(full));
+
+                const matrix<complex<double> > half = rfft(m1);
+                const matrix<complex<float> > fhalf = rfft(fm1);
+                if (nc == 1)
+                {
+                    DLIB_TEST(half.nr() == nr/2+1 && half.nc() == 1);
+                    DLIB_TEST(max(norm(half - rowm(full, range(0,half.nr()-1)))) < 1e-16*scale);
+                    DLIB_TEST(max(norm(matrix_cast<complex<double> >(fhalf) - rowm(full, range(0,half.nr()-1)))) < 1e-10*scale);
+                    DLIB_TEST(max(abs(irfft(half, nr) - m1)) < 1e-12);
+                    DLIB_TEST(max(abs(irfft(fhalf, nr) - fm1)) < 1e-4);
+                }
+                else
+                {
+                    DLIB_TEST(half.nr() == nr && half.nc() == nc/2+1);
+                    DLIB_TEST(max(norm(half - colm(full, range(0,half.nc()-1)))) < 1e-16*scale);
+                    DLIB_TEST(max(norm(matrix_cast<complex<double> >(fhalf) - colm(full, range(0,half.nc()-1)))) < 1e-10*scale);
+                    DLIB_TEST(max(abs(irfft(half, nc) - m1)) < 1e-12);
+                    DLIB_TEST(max(abs(irfft(fhalf, nc) - fm1)) < 1e-4);
+                }
+            }
+        }
+
+        // row vectors are transformed along their length
+        const matrix<double,1,0> row = trans(real(rand_complex(9,1)));
+        const matrix<complex<double> > half = rfft(row);
+        DLIB_TEST(half.nr() == 1 && half.nc() == 5);
+        DLIB_TEST(max(norm(half - colm(fft(complex_matrix(row)), range(0,4)))) < 1e-20);
+        const matrix<double> row2 = irfft(half, 9);
+        DLIB_TEST(row2.nr() == 1 && row2.nc() == 9);
+        DLIB_TEST(max(abs(row2 - row)) < 1e-12);
+
+        // the smallest sizes
+        matrix<complex<double>,0,1> one(1);
+        one = complex<double>(3,0);
+        matrix<double> x = irfft(one, 1);
+        DLIB_TEST(x.nr() == 1 && x.nc() == 1);
+        DLIB_TEST(std::abs(x(0) - 3) < 1e-12);
+        matrix<complex<double>,0,1> two(2);
+        two = complex<double>(3,0), complex<double>(1,0);
+        x = irfft(two, 2);
+        DLIB_TEST(x.nr() == 2 && x.nc() == 1);
+        DLIB_TEST(std::abs(x(0) - 2) < 1e-12);
+        DLIB_TEST(std::abs(x(1) - 1) < 1e-12);
+        DLIB_TEST(max(abs(irfft(rfft(x), 2) - x)) < 1e-12);
+
+        // n == 0 is rejected rather than making a plan for an empty transform
+        bool got_error = false;
+        try { irfft(one, 0); }
+        catch (fatal_error&) { got_error = true; }
+        DLIB_TEST(got_error);
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class test_fft : public tester
@@ -171,6 +304,8 @@ namespace
             test_against_saved_good_ffts();
             test_random_ffts();
             test_random_real_ffts();
+            test_arbitrary_size_ffts();
+            test_rfft();
         }
     } a;
 
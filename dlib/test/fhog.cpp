@@ -117,6 +117,64 @@ namespace
             }
         }
 
+        template <typename image_type>
+        void test_threaded_fhog_on (
+            const image_type& img
+        )
+        {
+            // The output is supposed to be bit for bit the same no matter how many threads
+            // are used.
+            thread_pool tp1(1), tp3(3), tp8(8);
+            for (int cell_size : {1, 3, 8})
+            {
+                print_spinner();
+                array2d<matrix<float,31,1> > vhog1, vhog3, vhog8;
+                extract_fhog_features(tp1, img, vhog1, cell_size, 3, 4);
+                extract_fhog_features(tp3, img, vhog3, cell_size, 3, 4);
+                extract_fhog_features(tp8, img, vhog8, cell_size, 3, 4);
+                DLIB_TEST(vhog1.nr() == vhog3.nr() && vhog1.nc() == vhog3.nc());
+                DLIB_TEST(vhog1.nr() == vhog8.nr() && vhog1.nc() == vhog8.nc());
+                for (long r = 0; r < vhog1.nr(); ++r)
+                {
+                    for (long c = 0; c < vhog1.nc(); ++c)
+                    {
+                        DLIB_TEST(vhog1[r][c] == vhog3[r][c]);
+                        DLIB_TEST(vhog1[r][c] == vhog8[r][c]);
+                    }
+                }
+
+                dlib::array<array2d<float> > hog1, hog8;
+                extract_fhog_features(tp1, img, hog1, cell_size);
+                extract_fhog_features(tp8, img, hog8, cell_size);
+                DLIB_TEST(hog1.size() == 31 && hog8.size() == 31);
+                for (unsigned long o = 0; o < hog1.size(); ++o)
+                {
+                    DLIB_TEST(mat(hog1[o]) == mat(hog8[o]));
+                }
+            }
+        }
+
+        void test_threaded_fhog()
+        {
+            array2d<rgb_pixel> img(311, 427);
+            dlib::rand rnd;
+            for (long r = 0; r < img.nr(); ++r)
+            {
+                for (long c = 0; c < img.nc(); ++c)
+                {
+                    // smooth structure plus some noise
+                    img[r][c].red = static_cast<unsigned char>(128 + 100*std::sin(r*0.05 + c*0.02)) + rnd.get_random_8bit_number()%16;
+                    img[r][c].green = static_cast<unsigned char>((r*3 + c)%256);
+                    img[r][c].blue = rnd.get_random_8bit_number();
+                }
+            }
+            array2d<unsigned char> gimg;
+            assign_image(gimg, img);
+
+            test_threaded_fhog_on(img);
+            test_threaded_fhog_on(gimg);
+        }
+
         void test_point_transforms()
         {
             dlib::rand rnd;
@@ -158,6 +216,7 @@ namespace
         {
             test_point_transforms();
             test_on_small();
+            test_threaded_fhog();
 
             print_spinner();
             // load the testing data
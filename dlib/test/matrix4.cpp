@@ -1086,6 +1086,50 @@ namespace
 
     }
 
+    void test_packed_gemm()
+    {
+        // default_matrix_multiply() uses a packed GEMM for float matrices.  Check it
+        // against a double precision reference for sizes that don't divide evenly into
+        // its blocks and for operands that are matrix expressions.
+        dlib::rand rnd;
+        const long sizes[][3] = {{1,1,1}, {5,7,3}, {67,33,300}, {130,515,17}, {64,600,257}};
+        for (auto& size : sizes)
+        {
+            matrix<float> a(size[0],size[2]), b(size[2],size[1]);
+            for (auto& v : a) v = rnd.get_random_float()-0.5f;
+            for (auto& v : b) v = rnd.get_random_float()-0.5f;
+            const matrix<double> ref = matrix_cast<double>(a)*matrix_cast<double>(b);
+            const double tol = 1e-5*size[2];
+
+            // default_matrix_multiply() adds to dest.
+            matrix<float> c(a.nr(), b.nc());
+            c = 1;
+            default_matrix_multiply(c, a, b);
+            DLIB_TEST_MSG(max(abs(matrix_cast<double>(c) - ref - 1)) < tol, max(abs(matrix_cast<double>(c) - ref - 1)));
+
+            const matrix<float> at = trans(a);
+            c = 0;
+            default_matrix_multiply(c, trans(at), b);
+            DLIB_TEST(max(abs(matrix_cast<double>(c) - ref)) < tol);
+
+            matrix<float> big_b(b.nr()+3, b.nc()+2);
+            big_b = 0;
+            set_subm(big_b, 3, 2, b.nr(), b.nc()) = b;
+            c = 0;
+            default_matrix_multiply(c, a, subm(big_b, 3, 2, b.nr(), b.nc()));
+            DLIB_TEST(max(abs(matrix_cast<double>(c) - ref)) < tol);
+
+            matrix<float,0,0,default_memory_manager,column_major_layout> ccol(a.nr(), b.nc());
+            ccol = 0;
+            default_matrix_multiply(ccol, a, b);
+            DLIB_TEST(max(abs(matrix_cast<double>(ccol) - ref)) < tol);
+
+            // and the usual expression syntax still gives the right answer
+            c = a*b;
+            DLIB_TEST(max(abs(matrix_cast<double>(c) - ref)) < tol);
+        }
+    }
+
     class matrix_tester : public tester
     {
     public:
@@ -1110,6 +1154,7 @@ namespace
 
             test_complex();
             test_linpiece();
+            test_packed_gemm();
         }
     } a;
 
@@ -7,6 +7,7 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
 #include "tester.h"
 #include <dlib/pixel.h>
 #include <dlib/svm_threaded.h>
@@ -368,6 +369,60 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename detector_type,
+        typename image_array_type
+        >
+    void validate_batch_detection (
+        detector_type& detector,
+        const image_array_type& images
+    )
+    {
+        // The batch operator() should give exactly the same output as running the images
+        // through the detector one at a time.
+        std::vector<matrix<unsigned char> > imgs;
+        for (unsigned long i = 0; i < images.size(); ++i)
+            imgs.push_back(mat(images[i]));
+        // include an image too small to hold any pyramid levels beyond the first
+        imgs.push_back(matrix<unsigned char>(20,20));
+        imgs.back() = 0;
+
+        thread_pool tp(3);
+        for (int iter = 0; iter < 3; ++iter)
+        {
+            // The detector reuses its buffers between calls, so make sure it copes with
+            // images of different sizes and fewer images than last time.
+            if (iter == 1)
+                std::reverse(imgs.begin(), imgs.end());
+            else if (iter == 2)
+                imgs.pop_back();
+
+            std::vector<std::vector<rect_detection> > dets;
+            detector(tp, imgs, dets, -0.5);
+            DLIB_TEST(dets.size() == imgs.size());
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+            {
+                std::vector<rect_detection> truth;
+                detector(imgs[i], truth, -0.5);
+                DLIB_TEST(dets[i].size() == truth.size());
+                for (unsigned long j = 0; j < truth.size() && j < dets[i].size(); ++j)
+                {
+                    DLIB_TEST(dets[i][j].rect == truth[j].rect);
+                    DLIB_TEST(dets[i][j].weight_index == truth[j].weight_index);
+                    DLIB_TEST(dets[i][j].detection_confidence == truth[j].detection_confidence);
+                }
+            }
+
+            std::vector<std::vector<rectangle> > rects;
+            detector(imgs, rects);
+            DLIB_TEST(rects.size() == imgs.size());
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+                DLIB_TEST(rects[i] == detector(imgs[i]));
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     void test_fhog_pyramid (
@@ -406,6 +461,8 @@ namespace
             validate_some_object_detector_stuff(images, detector, 1e-6);
         }
 
+        validate_batch_detection(detector, images);
+
         {
             std::vector<object_detector<image_scanner_type> > detectors;
             detectors.push_back(detector);
@@ -473,6 +530,8 @@ namespace
 
             validate_some_object_detector_stuff(images, detector);
         }
+
+        validate_batch_detection(detector, images);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -993,6 +1052,70 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_box_overlap_index (
+    )
+    {
+        print_spinner();
+        dlib::rand rnd;
+        const test_box_overlap testers[] = {test_box_overlap(), test_box_overlap(0.1, 0.9), test_box_overlap(0,0), test_box_overlap(0.9, 1)};
+        for (int iter = 0; iter < 40; ++iter)
+        {
+            const test_box_overlap& tester = testers[iter%4];
+            // Mix up boxes of very different sizes, some with negative coordinates, and
+            // some empty ones.
+            std::vector<rectangle> rects;
+            const long num = rnd.get_random_32bit_number()%2000;
+            for (long i = 0; i < num; ++i)
+            {
+                const long size = 1 + (rnd.get_random_32bit_number()%(i%10 == 0 ? 600 : 40));
+                const point p(rnd.get_integer_in_range(-300, 1000), rnd.get_integer_in_range(-300, 1000));
+                if (rnd.get_random_double() < 0.01)
+                    rects.push_back(rectangle(p.x(), p.y(), p.x()-1, p.y()));
+                else
+                    rects.push_back(centered_rect(p, size, size + rnd.get_integer_in_range(-size/2, size/2+1)));
+            }
+
+            // Non-max suppression with the index and with a linear scan must agree exactly.
+            box_overlap_index index(tester, iter%3 == 0 ? 1 : 0);
+            std::vector<rectangle> kept;
+            for (auto& r : rects)
+            {
+                const bool overlaps = overlaps_any_box(tester, kept, r);
+                DLIB_TEST(index.overlaps_any_box(r) == overlaps);
+                if (!overlaps)
+                {
+                    index.add(r);
+                    kept.push_back(r);
+                }
+            }
+            DLIB_TEST(index.get_boxes() == kept);
+            DLIB_TEST(index.size() == kept.size());
+
+            // Now put everything in and query with new boxes.
+            index.clear();
+            for (auto& r : rects)
+                index.add(r);
+            DLIB_TEST(index.get_boxes() == rects);
+            for (int i = 0; i < 200; ++i)
+            {
+                const long size = 1 + rnd.get_random_32bit_number()%300;
+                const rectangle r = centered_rect(point(rnd.get_integer_in_range(-300, 1000), rnd.get_integer_in_range(-300, 1000)), size, size);
+                DLIB_TEST(index.overlaps_any_box(r) == overlaps_any_box(tester, rects, r));
+            }
+        }
+
+        box_overlap_index index;
+        DLIB_TEST(index.get_cell_size() == 0);
+        DLIB_TEST(!index.overlaps_any_box(rectangle(0,0,10,10)));
+        index.add(rectangle(0,0,9,19));
+        DLIB_TEST(index.get_cell_size() == 20);
+        DLIB_TEST(index.overlaps_any_box(rectangle(1,1,9,19)));
+        DLIB_TEST(!index.overlaps_any_box(rectangle(10,0,19,19)));
+        DLIB_TEST(!index.overlaps_any_box(rectangle()));
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class object_detector_tester : public tester
@@ -1007,6 +1130,7 @@ namespace
         void perform_test (
         )
         {
+            test_box_overlap_index();
             test_fhog_pyramid();
             test_1_boxes();
             test_1_poly_nn_boxes();
@@ -1028,6 +1028,82 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_mapped_archive()
+    {
+        dlib::rand rnd;
+        matrix<float> big(301,203);
+        for (auto& v : big)
+            v = rnd.get_random_gaussian();
+        matrix<double,0,0,default_memory_manager,column_major_layout> cm = randm(7,5);
+        matrix<int,3,2> fixed = {1,-2,3,-4,5,-6};
+        matrix<float> empty;
+        std::vector<int64> ints = {1, -2, 3, 1LL<<40};
+        std::vector<std::string> strings = {"one", "two", "three"};
+        std::vector<double> no_doubles;
+        std::map<std::string, std::vector<float>> nested = {{"a", {1,2,3}}, {"b", {}}, {"c", {4}}};
+
+        dlib::serialize_mapped("mapped_archive.dat") << big << cm << fixed << empty << ints
+            << std::string("some text") << strings << no_doubles << nested << 42;
+
+        // the file starts with the mapped archive header
+        {
+            ifstream fin("mapped_archive.dat", ios::binary);
+            char header[8];
+            fin.read(header, 8);
+            DLIB_TEST(std::string(header, 8) == "dlibmap1");
+        }
+
+        matrix<float> big2;
+        matrix<double,0,0,default_memory_manager,column_major_layout> cm2;
+        matrix<int,3,2> fixed2;
+        matrix<float> empty2 = ones_matrix<float>(2,2);
+        std::vector<int64> ints2;
+        std::vector<std::string> strings2;
+        std::vector<double> no_doubles2 = {1};
+        std::map<std::string, std::vector<float>> nested2;
+        std::string text;
+        int number = 0;
+        dlib::deserialize("mapped_archive.dat") >> big2 >> cm2 >> fixed2 >> empty2 >> ints2
+            >> text >> strings2 >> no_doubles2 >> nested2 >> number;
+
+        DLIB_TEST(big2 == big);
+        DLIB_TEST(cm2 == cm);
+        DLIB_TEST(fixed2 == fixed);
+        DLIB_TEST(empty2.size() == 0);
+        DLIB_TEST(ints2 == ints);
+        DLIB_TEST(text == "some text");
+        DLIB_TEST(strings2 == strings);
+        DLIB_TEST(no_doubles2.size() == 0);
+        DLIB_TEST(nested2 == nested);
+        DLIB_TEST(number == 42);
+
+        // Reading past the end or reading the wrong types is an error, not a crash.
+        {
+            proxy_deserialize fin = dlib::deserialize("mapped_archive.dat");
+            fin >> big2;
+            DLIB_TEST_MSG(big2 == big, "objects can be read one at a time");
+        }
+        bool threw = false;
+        try { dlib::deserialize("mapped_archive.dat") >> big2 >> cm2 >> fixed2 >> empty2 >> ints2
+            >> text >> strings2 >> no_doubles2 >> nested2 >> number >> number; }
+        catch (serialization_error&) { threw = true; }
+        DLIB_TEST(threw);
+        threw = false;
+        try { dlib::deserialize("mapped_archive.dat") >> text; }
+        catch (serialization_error&) { threw = true; }
+        DLIB_TEST(threw);
+
+        // The regular format still works through the same deserialize() call.
+        dlib::serialize("mapped_archive.dat") << big << strings;
+        big2.set_size(0,0);
+        strings2.clear();
+        dlib::deserialize("mapped_archive.dat") >> big2 >> strings2;
+        DLIB_TEST(big2 == big);
+        DLIB_TEST(strings2 == strings);
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class serialize_tester : public tester
@@ -1056,6 +1132,7 @@ namespace
             test_array2d_and_matrix_serialization();
             test_strings();
             test_std_array();
+            test_mapped_archive();
         }
     } a;
 
@@ -0,0 +1,397 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#include <dlib/server.h>
+#include <dlib/sockets.h>
+#include <dlib/misc_api.h>
+#include <dlib/dnn.h>
+#include <dlib/dnn/inference_server.h>
+
+#include "tester.h"
+
+namespace
+{
+    using namespace test;
+    using namespace dlib;
+    using namespace std;
+
+    dlib::logger dlog("test.server_http");
+
+// ----------------------------------------------------------------------------------------
+
+    class echo_server : public server_http
+    {
+        const std::string on_request (
+            const incoming_things& incoming,
+            outgoing_things& outgoing
+        )
+        {
+            if (incoming.path == "/close")
+                outgoing.headers["Connection"] = "close";
+            if (incoming.path == "/throw")
+                throw dlib::error("on_request threw");
+
+            return incoming.request_type + " " + incoming.path + " q=" + incoming.queries["q"] +
+                " body=" + incoming.body;
+        }
+    };
+
+    struct http_response
+    {
+        int code = 0;
+        std::string headers;
+        std::string body;
+    };
+
+    bool read_response (
+        connection& con,
+        std::string& buf,
+        http_response& resp
+    )
+    /*!
+        ensures
+            - reads one HTTP response from con into resp.  buf holds any bytes received
+              past the end of it.  Returns false if the connection closed first.
+    !*/
+    {
+        char temp[4096];
+        size_t header_end;
+        while ((header_end = buf.find("\r\n\r\n")) == std::string::npos)
+        {
+            const long num = con.read(temp, sizeof(temp), 10000);
+            if (num <= 0)
+                return false;
+            buf.append(temp, num);
+        }
+        resp.headers = buf.substr(0, header_end+4);
+        istringstream sin(resp.headers);
+        string protocol;
+        sin >> protocol >> resp.code;
+
+        unsigned long content_length = 0;
+        const size_t pos = resp.headers.find("Content-Length: ");
+        if (pos != std::string::npos)
+            content_length = string_cast<unsigned long>(resp.headers.substr(pos+16, resp.headers.find("\r\n", pos)-pos-16));
+
+        while (buf.size() < header_end+4+content_length)
+        {
+            const long num = con.read(temp, sizeof(temp), 10000);
+            if (num <= 0)
+                return false;
+            buf.append(temp, num);
+        }
+        resp.body = buf.substr(header_end+4, content_length);
+        buf.erase(0, header_end+4+content_length);
+        return true;
+    }
+
+    bool is_closed_by_server (
+        connection& con
+    )
+    {
+        char ch;
+        return con.read(&ch, 1, 10000) == 0;
+    }
+
+    void send (
+        connection& con,
+        const std::string& data
+    )
+    {
+        DLIB_TEST(con.write(data.data(), data.size()) == (long)data.size());
+    }
+
+    int start_server (
+        server_http& srv
+    )
+    {
+        srv.set_listening_ip("127.0.0.1");
+        srv.start_async();
+        while (srv.get_listening_port() == 0)
+            dlib::sleep(1);
+        return srv.get_listening_port();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_single_requests (
+        server_io_model model
+    )
+    {
+        print_spinner();
+        echo_server srv;
+        srv.set_io_model(model, 2);
+        const int port = start_server(srv);
+
+        // one request per connection, the way it has always worked
+        for (int i = 0; i < 3; ++i)
+        {
+            std::unique_ptr<connection> con(connect("127.0.0.1", port));
+            send(*con, "GET /a?q=" + cast_to_string(i) + " HTTP/1.0\r\n\r\n");
+            std::string buf;
+            http_response resp;
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST(resp.code == 200);
+            DLIB_TEST_MSG(resp.body == "GET /a?q=" + cast_to_string(i) + " q=" + cast_to_string(i) + " body=", resp.body);
+            DLIB_TEST(is_closed_by_server(*con));
+        }
+
+        // a POST with a body
+        {
+            std::unique_ptr<connection> con(connect("127.0.0.1", port));
+            send(*con, "POST /p HTTP/1.0\r\nContent-Length: 5\r\n\r\nhello");
+            std::string buf;
+            http_response resp;
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST_MSG(resp.body == "POST /p q= body=hello", resp.body);
+        }
+
+        // exceptions in on_request() are reported to the client
+        {
+            std::unique_ptr<connection> con(connect("127.0.0.1", port));
+            send(*con, "GET /throw HTTP/1.0\r\n\r\n");
+            std::string buf;
+            http_response resp;
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST(resp.code == 500);
+            DLIB_TEST(is_closed_by_server(*con));
+        }
+
+        // requests that are too big are refused
+        {
+            srv.set_max_content_length(10);
+            std::unique_ptr<connection> con(connect("127.0.0.1", port));
+            send(*con, "POST /p HTTP/1.0\r\nContent-Length: 11\r\n\r\nhello world");
+            std::string buf;
+            http_response resp;
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST(resp.code == 413);
+            DLIB_TEST(is_closed_by_server(*con));
+            srv.set_max_content_length(10*1024*1024);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_inference_server (
+        server_io_model model
+    )
+    {
+        print_spinner();
+
+        using net_type = loss_multiclass_log<fc<5,relu<fc<8,input<matrix<float,0,1>>>>>>;
+        net_type net;
+        const int num_clients = 8;
+        std::vector<unsigned long> expected;
+        for (int c = 0; c < num_clients; ++c)
+            expected.push_back(net(matrix<float,0,1>({(float)c, 1, -2})));
+        // The batch only runs once all the clients' requests are queued, so the
+        // number of batches doesn't depend on how the client threads get scheduled.
+        dnn_batching_executor<net_type> executor(net, num_clients, std::chrono::seconds(60));
+
+        // Requests are 3 numbers separated by spaces and responses are the label.
+        auto decode = [](const incoming_things& incoming)
+        {
+            matrix<float,0,1> x(3);
+            istringstream sin(incoming.body);
+            for (auto& v : x)
+            {
+                if (!(sin >> v))
+                    throw dlib::error("expected 3 numbers");
+            }
+            return x;
+        };
+        auto encode = [](const unsigned long& label, outgoing_things& outgoing)
+        {
+            outgoing.headers["Content-Type"] = "text/plain";
+            return cast_to_string(label);
+        };
+        dnn_inference_server<net_type> srv(executor, decode, encode);
+        DLIB_TEST(srv.get_path() == "/predict");
+        srv.set_io_model(model, 8);
+        const int port = start_server(srv);
+
+        std::vector<std::thread> clients;
+        std::vector<int> ok(num_clients, 0);
+        std::atomic<int> num_connected(0);
+        for (int c = 0; c < num_clients; ++c)
+        {
+            clients.emplace_back([&,c]() {
+                std::unique_ptr<connection> con(connect("127.0.0.1", port));
+                // wait until every client is connected before sending anything
+                ++num_connected;
+                while (num_connected < num_clients)
+                    std::this_thread::yield();
+                const std::string body = cast_to_string(c) + " 1 -2";
+                const std::string request = "POST /predict HTTP/1.0\r\nContent-Length: " +
+                    cast_to_string(body.size()) + "\r\n\r\n" + body;
+                std::string buf;
+                http_response resp;
+                if (con->write(request.data(), request.size()) == (long)request.size() &&
+                    read_response(*con, buf, resp) && resp.code == 200)
+                {
+                    ok[c] = resp.body == cast_to_string(expected[c]);
+                }
+            });
+        }
+        for (auto& t : clients)
+            t.join();
+        for (auto v : ok)
+            DLIB_TEST(v == 1);
+        DLIB_TEST(executor.get_num_requests() == num_clients);
+        DLIB_TEST(executor.get_num_batches() == 1);
+
+        const std::vector<std::pair<std::string,int>> errors = {
+            {"POST /predict HTTP/1.0\r\nContent-Length: 3\r\n\r\n1 2", 400},
+            {"GET /predict HTTP/1.0\r\n\r\n", 405},
+            {"POST /other HTTP/1.0\r\nContent-Length: 5\r\n\r\n1 2 3", 404}
+        };
+        for (auto& e : errors)
+        {
+            std::unique_ptr<connection> con(connect("127.0.0.1", port));
+            send(*con, e.first);
+            std::string buf;
+            http_response resp;
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST_MSG(resp.code == e.second, resp.code);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_keep_alive (
+    )
+    {
+        print_spinner();
+        echo_server srv;
+        srv.set_io_model(server_io_model::event_loop, 3);
+        DLIB_TEST(srv.get_io_model() == server_io_model::event_loop);
+        const int port = start_server(srv);
+
+        std::unique_ptr<connection> con(connect("127.0.0.1", port));
+        std::string buf;
+        http_response resp;
+
+        // several requests, one after the other, on the same connection
+        for (int i = 0; i < 5; ++i)
+        {
+            send(*con, "GET /k?q=" + cast_to_string(i) + " HTTP/1.1\r\nHost: x\r\n\r\n");
+            DLIB_TEST(read_response(*con, buf, resp));
+            DLIB_TEST(resp.code == 200);
+            DLIB_TEST(resp.headers.find("Connection: keep-alive") != std::string::npos);
+            DLIB_TEST_MSG(resp.body == "GET /k?q=" + cast_to_string(i) + " q=" + cast_to_string(i) + " body=", resp.body);
+        }
+
+        // pipelined requests, sent in pieces, come back in order
+        const std::string reqs =
+            "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+            "GET /b?q=2 HTTP/1.1\r\n\r\n"
+            "POST /c HTTP/1.1\r\ncontent-length: 4\r\n\r\nwxyz";
+        for (size_t i = 0; i < reqs.size(); i += 7)
+        {
+            send(*con, reqs.substr(i, 7));
+            dlib::sleep(1);
+        }
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST_MSG(resp.body == "POST /a q= body=abc", resp.body);
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST_MSG(resp.body == "GET /b?q=2 q=2 body=", resp.body);
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST_MSG(resp.body == "POST /c q= body=wxyz", resp.body);
+
+        // HTTP/1.0 clients have to ask for keep-alive
+        send(*con, "GET /d HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST(resp.headers.find("Connection: keep-alive") != std::string::npos);
+
+        // and then the server closes the connection if told to
+        send(*con, "GET /close HTTP/1.1\r\n\r\n");
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST(resp.headers.find("Connection: close") != std::string::npos);
+        DLIB_TEST(is_closed_by_server(*con));
+
+        con.reset(connect("127.0.0.1", port));
+        send(*con, "GET /e HTTP/1.1\r\nConnection: close\r\n\r\n");
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST(is_closed_by_server(*con));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_many_connections (
+    )
+    {
+        print_spinner();
+        echo_server srv;
+        srv.set_io_model(server_io_model::event_loop, 2);
+        const int port = start_server(srv);
+
+        // Lots of open connections are serviced by just 2 worker threads.
+        std::vector<std::unique_ptr<connection>> cons;
+        for (int i = 0; i < 300; ++i)
+            cons.emplace_back(connect("127.0.0.1", port));
+
+        for (int round = 0; round < 3; ++round)
+        {
+            for (size_t i = 0; i < cons.size(); ++i)
+                send(*cons[i], "GET /m?q=" + cast_to_string(i) + " HTTP/1.1\r\n\r\n");
+            for (size_t i = 0; i < cons.size(); ++i)
+            {
+                std::string buf;
+                http_response resp;
+                DLIB_TEST(read_response(*cons[i], buf, resp));
+                DLIB_TEST(resp.body == "GET /m?q=" + cast_to_string(i) + " q=" + cast_to_string(i) + " body=");
+            }
+        }
+
+        // clear() shuts down the idle keep-alive connections and returns.
+        srv.clear();
+        DLIB_TEST(srv.is_running() == false);
+        for (auto& con : cons)
+            DLIB_TEST(is_closed_by_server(*con));
+
+        // and the server can be started again
+        srv.set_io_model(server_io_model::event_loop, 2);
+        const int port2 = start_server(srv);
+        std::unique_ptr<connection> con(connect("127.0.0.1", port2));
+        send(*con, "GET /again HTTP/1.1\r\n\r\n");
+        std::string buf;
+        http_response resp;
+        DLIB_TEST(read_response(*con, buf, resp));
+        DLIB_TEST(resp.body == "GET /again q= body=");
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    class server_http_tester : public tester
+    {
+    public:
+        server_http_tester (
+        ) :
+            tester ("test_server_http",
+                    "Runs tests on the server_http object.")
+        {}
+
+        void perform_test (
+        )
+        {
+            test_single_requests(server_io_model::thread_per_connection);
+            test_inference_server(server_io_model::thread_per_connection);
+#ifdef __linux__
+            test_single_requests(server_io_model::event_loop);
+            test_inference_server(server_io_model::event_loop);
+            test_keep_alive();
+            test_many_connections();
+#endif
+        }
+    } a;
+
+}
+
@@ -6,6 +6,9 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <atomic>
+#include <vector>
+#include <thread>
 #include <dlib/misc_api.h>
 #include <dlib/threads.h>
 #include <dlib/any.h>
@@ -83,12 +86,107 @@ namespace
 
         void perform_test (
         )
+        {
+            test_pool(thread_pool_scheduler::shared_queue);
+            test_pool(thread_pool_scheduler::work_stealing);
+            test_nested_tasks(thread_pool_scheduler::shared_queue);
+            test_nested_tasks(thread_pool_scheduler::work_stealing);
+            test_thread_pool_scope();
+        }
+
+        void test_thread_pool_scope (
+        )
+        {
+            print_spinner();
+            thread_pool* const global_pool = &default_thread_pool();
+            {
+                thread_pool tp(2);
+                thread_pool_scope scope(tp);
+                DLIB_TEST(&scope.get_thread_pool() == &tp);
+                DLIB_TEST(&default_thread_pool() == &tp);
+
+                // work nested inside the scoped pool's tasks stays in that pool
+                std::vector<thread_pool*> seen(100, nullptr);
+                parallel_for(0, (long)seen.size(), [&](long i) { seen[i] = &default_thread_pool(); });
+                for (auto p : seen)
+                    DLIB_TEST(p == &tp);
+
+                // other threads aren't affected
+                thread_pool* other = nullptr;
+                std::thread t([&]() { other = &default_thread_pool(); });
+                t.join();
+                DLIB_TEST(other == global_pool);
+
+                {
+                    thread_pool_scope serial(0);
+                    DLIB_TEST(&default_thread_pool() == &serial.get_thread_pool());
+                    DLIB_TEST(default_thread_pool().num_threads_in_pool() == 0);
+                    const auto id = std::this_thread::get_id();
+                    std::atomic<long> num_elsewhere(0);
+                    parallel_for(0, 100, [&](long) { if (std::this_thread::get_id() != id) ++num_elsewhere; });
+                    DLIB_TEST(num_elsewhere == 0);
+                    auto f = dlib::async([]() { return std::this_thread::get_id(); });
+                    DLIB_TEST(f.get() == id);
+                }
+                DLIB_TEST(&default_thread_pool() == &tp);
+
+                {
+                    thread_pool_scope capped(3);
+                    DLIB_TEST(default_thread_pool().num_threads_in_pool() == 3);
+                    std::atomic<long> total(0);
+                    parallel_for(0, 10000, [&](long i) { total += i; });
+                    DLIB_TEST(total == 49995000);
+                }
+                DLIB_TEST(&default_thread_pool() == &tp);
+            }
+            DLIB_TEST(&default_thread_pool() == global_pool);
+        }
+
+        void test_nested_tasks (
+            thread_pool_scheduler sched
+        )
+        {
+            // Tasks that submit more tasks to the same pool and then wait on them must
+            // not deadlock, even when there are many more tasks than threads.
+            for (int num_threads = 0; num_threads < 5; ++num_threads)
+            {
+                print_spinner();
+                thread_pool tp(num_threads, sched);
+                DLIB_TEST(tp.get_scheduler() == sched);
+                DLIB_TEST(tp.num_threads_in_pool() == (unsigned long)num_threads);
+                DLIB_TEST(tp.is_task_thread() == (num_threads == 0));
+
+                std::vector<long> sums(50, 0);
+                for (long i = 0; i < (long)sums.size(); ++i)
+                {
+                    tp.add_task_by_value([&tp,&sums,i]() {
+                        std::vector<long> parts(20, 0);
+                        for (long j = 0; j < (long)parts.size(); ++j)
+                            tp.add_task_by_value([&parts,i,j]() { parts[j] = i*j; });
+                        tp.wait_for_all_tasks();
+                        for (auto v : parts)
+                            sums[i] += v;
+                    });
+                }
+                tp.wait_for_all_tasks();
+                for (long i = 0; i < (long)sums.size(); ++i)
+                    DLIB_TEST(sums[i] == i*190);
+
+                std::atomic<long> total(0);
+                parallel_for(tp, 0, 10000, [&](long i) { total += i; });
+                DLIB_TEST(total == 49995000);
+            }
+        }
+
+        void test_pool (
+            thread_pool_scheduler sched
+        )
         {
             add_functor f;
             for (int num_threads= 0; num_threads < 4; ++num_threads)
             {
                 dlib::future<int> a, b, c, res, d;
-                thread_pool tp(num_threads);
+                thread_pool tp(num_threads, sched);
                 print_spinner();
 
                 dlib::future<some_struct> obj;
@@ -10,6 +10,10 @@
 #include <stdlib.h>
 #include "../string.h"
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
 
 namespace dlib
 {
@@ -28,15 +32,104 @@ namespace dlib
             } catch(string_cast_error&) {}
             return std::thread::hardware_concurrency();
         }
+
+        thread_pool_scheduler default_scheduler()
+        {
+            char* sched = getenv("DLIB_THREAD_POOL_SCHEDULER");
+            if (sched && std::string(sched) == "work_stealing")
+                return thread_pool_scheduler::work_stealing;
+            return thread_pool_scheduler::shared_queue;
+        }
+
+        // The pool installed by the innermost thread_pool_scope on this thread, if any.
+        thread_local thread_pool* scoped_pool = nullptr;
+
+        // Every pool installed by a live thread_pool_scope on any thread.  Tasks running
+        // on the workers of one of these pools don't have scoped_pool set, so this is how
+        // a parallel_for nested inside such a task finds its way back to the same pool
+        // rather than spilling into the global one.
+        std::atomic<long> num_active_scopes(0);
+        std::mutex& active_scopes_mutex() { static std::mutex m; return m; }
+        std::vector<thread_pool*>& active_scoped_pools() { static std::vector<thread_pool*> v; return v; }
+
+        thread_pool* find_pool_of_task_thread()
+        {
+            std::lock_guard<std::mutex> lock(active_scopes_mutex());
+            for (auto tp : active_scoped_pools())
+            {
+                // A pool without threads runs its tasks in the thread that submits
+                // them, which already has scoped_pool set.  is_task_thread() is true for
+                // every thread in that case, so skip it.
+                if (tp->num_threads_in_pool() != 0 && tp->is_task_thread())
+                    return tp;
+            }
+            return nullptr;
+        }
     }
 
 // ----------------------------------------------------------------------------------------
 
     thread_pool& default_thread_pool()
     {
-        static thread_pool tp(impl::default_num_threads());
+        if (impl::scoped_pool)
+            return *impl::scoped_pool;
+        if (impl::num_active_scopes.load(std::memory_order_acquire) != 0)
+        {
+            if (thread_pool* tp = impl::find_pool_of_task_thread())
+                return *tp;
+        }
+
+        static thread_pool tp(impl::default_num_threads(), impl::default_scheduler());
         return tp;
     }
+
+// ----------------------------------------------------------------------------------------
+
+    thread_pool_scope::
+    thread_pool_scope (
+        thread_pool& tp
+    ) : pool(&tp)
+    {
+        activate();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    thread_pool_scope::
+    thread_pool_scope (
+        unsigned long num_threads
+    ) : owned_pool(new thread_pool(num_threads)), pool(owned_pool.get())
+    {
+        activate();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void thread_pool_scope::
+    activate (
+    )
+    {
+        {
+            std::lock_guard<std::mutex> lock(impl::active_scopes_mutex());
+            impl::active_scoped_pools().push_back(pool);
+            impl::num_active_scopes.fetch_add(1, std::memory_order_release);
+        }
+        previous = impl::scoped_pool;
+        impl::scoped_pool = pool;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    thread_pool_scope::
+    ~thread_pool_scope (
+    )
+    {
+        impl::scoped_pool = previous;
+        std::lock_guard<std::mutex> lock(impl::active_scopes_mutex());
+        auto& pools = impl::active_scoped_pools();
+        pools.erase(std::find(pools.begin(), pools.end(), pool));
+        impl::num_active_scopes.fetch_sub(1, std::memory_order_release);
+    }
 }
 
 // ----------------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include "thread_pool_extension.h"
 #include <future>
 #include <functional>
+#include <memory>
 
 namespace dlib
 {
@@ -59,6 +60,36 @@ namespace dlib
 
     thread_pool& default_thread_pool();
 
+// ----------------------------------------------------------------------------------------
+
+    class thread_pool_scope
+    {
+    public:
+        explicit thread_pool_scope (
+            thread_pool& tp
+        );
+
+        explicit thread_pool_scope (
+            unsigned long num_threads
+        );
+
+        ~thread_pool_scope (
+        );
+
+        thread_pool_scope(const thread_pool_scope&) = delete;
+        thread_pool_scope& operator=(const thread_pool_scope&) = delete;
+
+        thread_pool& get_thread_pool (
+        ) const { return *pool; }
+
+    private:
+        void activate();
+
+        std::unique_ptr<thread_pool> owned_pool;
+        thread_pool* pool;
+        thread_pool* previous;
+    };
+
 // ----------------------------------------------------------------------------------------
 
     template < 
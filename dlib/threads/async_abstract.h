@@ -16,12 +16,96 @@ namespace dlib
     );
     /*!
         ensures
-            - returns a reference to a global thread_pool.  If the DLIB_NUM_THREADS
+            - If the calling thread is inside a thread_pool_scope then this function
+              returns the thread pool of the innermost such scope.  It also does so if
+              the calling thread is one of the threads of a pool installed by a live
+              thread_pool_scope, so work nested inside tasks stays in that pool.
+            - Otherwise, returns a reference to a global thread_pool.  If the DLIB_NUM_THREADS
               environment variable is set to an integer then the thread pool will contain
               DLIB_NUM_THREADS threads, otherwise it will contain
               std::thread::hardware_concurrency() threads.
+            - If the DLIB_THREAD_POOL_SCHEDULER environment variable is set to
+              "work_stealing" then the thread pool uses thread_pool_scheduler::work_stealing,
+              otherwise it uses thread_pool_scheduler::shared_queue.
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    class thread_pool_scope
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object makes default_thread_pool() return a different thread pool in
+                the thread that creates it, for as long as it exists.  Everything in dlib
+                that runs on default_thread_pool() then uses that pool instead of the
+                global one.  This includes parallel_for() and parallel_for_blocked()
+                without an explicit pool, async() without an explicit pool, all the CPU
+                dnn kernels in tt::, the input layers' to_tensor(), and dlib's own matrix
+                multiply.
+
+                This is how you cap or isolate the threads used by a network.  E.g. if a
+                process runs several networks at once, each on its own thread, the
+                networks otherwise all share the global pool and each asks it for every
+                core, so they oversubscribe the machine.  Running each network like this
+                gives it a fixed share instead:
+                    thread_pool_scope scope(2);
+                    auto out = net(samples);
+                and thread_pool_scope scope(0) runs everything in the calling thread.
+
+                Note that when dlib is linked against a BLAS library the matrix multiplies,
+                and therefore the fc_ and con_ layers, run on that library's own threads,
+                which this object can't control.  Set them with the library's own means,
+                e.g. the OPENBLAS_NUM_THREADS environment variable.  Also note that
+                dnn_trainer trains on a thread of its own, which a scope created in the
+                thread that made the trainer doesn't cover.
+        !*/
+
+    public:
+
+        explicit thread_pool_scope (
+            thread_pool& tp
+        );
+        /*!
+            ensures
+                - #get_thread_pool() == tp
+                - default_thread_pool() returns tp in the calling thread, and in the
+                  threads of tp, until *this is destroyed.
+        !*/
+
+        explicit thread_pool_scope (
+            unsigned long num_threads
+        );
+        /*!
+            ensures
+                - #get_thread_pool() is a new thread pool owned by *this, with
+                  num_threads threads.  If num_threads == 0 then all tasks given to it run
+                  serially in the thread that submits them.
+                - default_thread_pool() returns #get_thread_pool() in the calling thread,
+                  and in the threads of that pool, until *this is destroyed.
+        !*/
+
+        ~thread_pool_scope (
+        );
+        /*!
+            requires
+                - This object is destroyed in the thread that created it, and scopes
+                  created in the same thread are destroyed in the opposite order of their
+                  creation (which is what happens when they are local variables).
+            ensures
+                - default_thread_pool() goes back to returning whatever it returned before
+                  *this was created.
+                - If *this made its own pool then that pool is destroyed, after waiting
+                  for its tasks to finish.
+        !*/
+
+        thread_pool& get_thread_pool (
+        ) const;
+        /*!
+            ensures
+                - returns the thread pool this scope installs.
+        !*/
+    };
+
 // ----------------------------------------------------------------------------------------
 
     template < 
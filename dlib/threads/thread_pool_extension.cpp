@@ -9,16 +9,61 @@
 namespace dlib
 {
 
+// ----------------------------------------------------------------------------------------
+
+    namespace
+    {
+        // These let a work stealing worker find its own deque without taking any locks.
+        thread_local const thread_pool_implementation* ws_current_pool = nullptr;
+        thread_local unsigned long ws_current_worker = 0;
+
+        unsigned long ws_thread_slot (
+        )
+        /*!
+            ensures
+                - returns a small integer that is unique to the calling thread.  It is
+                  used to spread the task bookkeeping of different submitting threads
+                  over different shards.
+        !*/
+        {
+            static std::atomic<unsigned long> next_slot(0);
+            thread_local const unsigned long slot = next_slot++;
+            return slot;
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     thread_pool_implementation::
     thread_pool_implementation (
-        unsigned long num_threads
+        unsigned long num_threads,
+        thread_pool_scheduler scheduler_
     ) : 
         task_done_signaler(m),
         task_ready_signaler(m),
-        we_are_destructing(false)
+        we_are_destructing(false),
+        scheduler(scheduler_),
+        ws_num_queued(0),
+        ws_num_sleeping(0),
+        ws_next_queue(0),
+        ws_destructing(false),
+        ws_has_eptr(false)
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+        {
+            for (unsigned long i = 0; i < num_threads; ++i)
+                ws_queues.emplace_back(new ws_worker_queue);
+            for (unsigned long i = 0; i < std::max(num_threads,1UL); ++i)
+                ws_shards.emplace_back(new ws_task_shard);
+
+            threads.resize(num_threads);
+            for (unsigned long i = 0; i < num_threads; ++i)
+            {
+                threads[i] = std::thread([this,i](){this->ws_thread(i);});
+            }
+            return;
+        }
+
         tasks.resize(num_threads);
         threads.resize(num_threads);
         for (unsigned long i = 0; i < num_threads; ++i)
@@ -33,6 +78,27 @@ namespace dlib
     shutdown_pool (
     )
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+        {
+            // first wait for all pending tasks to finish
+            for (unsigned long s = 0; s < ws_shards.size(); ++s)
+                ws_wait(s, [&](){ return ws_shards[s]->outstanding_ids.empty(); });
+
+            // now tell the threads to kill themselves
+            {
+                std::lock_guard<std::mutex> lock(ws_sleep_m);
+                ws_destructing = true;
+            }
+            ws_wake.notify_all();
+
+            for (auto& t : threads)
+                t.join();
+            threads.clear();
+
+            ws_propagate_exception();
+            return;
+        }
+
         {
             auto_mutex M(m);
             
@@ -85,6 +151,9 @@ namespace dlib
     num_threads_in_pool (
     ) const
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+            return ws_queues.size();
+
         auto_mutex M(m);
         return tasks.size();
     }
@@ -96,6 +165,14 @@ namespace dlib
         uint64 task_id
     ) const
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+        {
+            const unsigned long s = task_id%ws_shards.size();
+            ws_wait(s, [&](){ return ws_shards[s]->outstanding_ids.count(task_id) == 0; });
+            ws_propagate_exception();
+            return;
+        }
+
         auto_mutex M(m);
         if (tasks.size() != 0)
         {
@@ -116,6 +193,14 @@ namespace dlib
     {
         const thread_id_type thread_id = get_thread_id();
 
+        if (scheduler == thread_pool_scheduler::work_stealing)
+        {
+            const unsigned long s = ws_thread_slot()%ws_shards.size();
+            ws_wait(s, [&](){ return ws_shards[s]->outstanding_per_thread.count(thread_id) == 0; });
+            ws_propagate_exception();
+            return;
+        }
+
         auto_mutex M(m);
         bool found_task = true;
         while (found_task)
@@ -196,14 +281,7 @@ namespace dlib
             try
             {
                 // now do the task
-                if (task.bfp)
-                    task.bfp();
-                else if (task.mfp0)
-                    task.mfp0();
-                else if (task.mfp1)
-                    task.mfp1(task.arg1);
-                else if (task.mfp2)
-                    task.mfp2(task.arg1, task.arg2);
+                call_task(task);
             }
             catch(...)
             {
@@ -291,6 +369,14 @@ namespace dlib
         std::shared_ptr<function_object_copy>& item
     )
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+        {
+            task_state_type task;
+            task.bfp = bfp;
+            task.function_copy.swap(item);
+            return ws_add_task(task);
+        }
+
         auto_mutex M(m);
         const thread_id_type my_thread_id = get_thread_id();
 
@@ -334,10 +420,251 @@ namespace dlib
     is_task_thread (
     ) const
     {
+        if (scheduler == thread_pool_scheduler::work_stealing)
+            return ws_queues.size() == 0 || ws_worker_index() != -1;
+
         auto_mutex M(m);
         return is_worker_thread(get_thread_id());
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void thread_pool_implementation::
+    call_task (
+        const task_state_type& task
+    )
+    {
+        if (task.bfp)
+            task.bfp();
+        else if (task.mfp0)
+            task.mfp0();
+        else if (task.mfp1)
+            task.mfp1(task.arg1);
+        else if (task.mfp2)
+            task.mfp2(task.arg1, task.arg2);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    uint64 thread_pool_implementation::
+    ws_add_task (
+        task_state_type& task
+    )
+    {
+        ws_propagate_exception();
+
+        if (ws_queues.size() == 0)
+        {
+            // There aren't any threads in the pool so we just perform the task right
+            // here, just like the shared_queue scheduler does.
+            call_task(task);
+            return 1;
+        }
+
+        const thread_id_type my_thread_id = get_thread_id();
+        const unsigned long s = ws_thread_slot()%ws_shards.size();
+        ws_task_shard& shard = *ws_shards[s];
+        {
+            std::lock_guard<std::mutex> lock(shard.m);
+            task.task_id = shard.next_task_id*ws_shards.size() + s;
+            shard.next_task_id += 1;
+            shard.outstanding_ids.insert(task.task_id);
+            shard.outstanding_per_thread[my_thread_id] += 1;
+        }
+        task.thread_id = my_thread_id;
+        const uint64 id = task.task_id;
+
+        // Workers push onto their own deque so the task stays hot in their cache.
+        // Everyone else spreads their tasks round-robin over the workers.
+        const long worker = ws_worker_index();
+        ws_worker_queue& q = (worker != -1) ? *ws_queues[worker] : *ws_queues[ws_next_queue++%ws_queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(q.m);
+            q.tasks.push_back(task);
+        }
+
+        ws_num_queued += 1;
+        if (ws_num_sleeping != 0)
+        {
+            std::lock_guard<std::mutex> lock(ws_sleep_m);
+            ws_wake.notify_one();
+        }
+
+        return id;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void thread_pool_implementation::
+    ws_thread (
+        unsigned long worker_idx
+    )
+    {
+        ws_current_pool = this;
+        ws_current_worker = worker_idx;
+
+        task_state_type task;
+        while (true)
+        {
+            if (ws_pop_task(worker_idx, task))
+            {
+                ws_run_task(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(ws_sleep_m);
+            ws_num_sleeping += 1;
+            ws_wake.wait(lock, [&](){ return ws_num_queued > 0 || ws_destructing; });
+            ws_num_sleeping -= 1;
+            if (ws_num_queued <= 0 && ws_destructing)
+                break;
+        }
+
+        ws_current_pool = nullptr;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    bool thread_pool_implementation::
+    ws_pop_task (
+        unsigned long worker_idx,
+        task_state_type& task
+    ) const
+    {
+        // Take the newest task from our own deque first ...
+        {
+            ws_worker_queue& q = *ws_queues[worker_idx];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.tasks.size() != 0)
+            {
+                task = q.tasks.back();
+                q.tasks.pop_back();
+                ws_num_queued -= 1;
+                return true;
+            }
+        }
+
+        // ... and otherwise steal the oldest task from someone else.
+        for (unsigned long i = 1; i < ws_queues.size(); ++i)
+        {
+            ws_worker_queue& q = *ws_queues[(worker_idx+i)%ws_queues.size()];
+            std::lock_guard<std::mutex> lock(q.m);
+            if (q.tasks.size() != 0)
+            {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                ws_num_queued -= 1;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void thread_pool_implementation::
+    ws_run_task (
+        task_state_type& task
+    ) const
+    {
+        try
+        {
+            call_task(task);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(ws_eptr_m);
+            if (!ws_eptr)
+                ws_eptr = std::current_exception();
+            ws_has_eptr = true;
+        }
+
+        // Now let others know that we finished the task.  The function object copy is
+        // released first so it never outlives the task as seen by wait_for_task().
+        task.bfp.clear();
+        task.mfp0.clear();
+        task.mfp1.clear();
+        task.mfp2.clear();
+        task.function_copy.reset();
+
+        ws_task_shard& shard = *ws_shards[task.task_id%ws_shards.size()];
+        {
+            std::lock_guard<std::mutex> lock(shard.m);
+            shard.outstanding_ids.erase(task.task_id);
+            auto i = shard.outstanding_per_thread.find(task.thread_id);
+            if (--i->second == 0)
+                shard.outstanding_per_thread.erase(i);
+        }
+        shard.task_done.notify_all();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename predicate>
+    void thread_pool_implementation::
+    ws_wait (
+        unsigned long shard_idx,
+        predicate is_done
+    ) const
+    {
+        ws_task_shard& shard = *ws_shards[shard_idx];
+        const long worker = ws_worker_index();
+
+        std::unique_lock<std::mutex> lock(shard.m);
+        while (!is_done())
+        {
+            if (worker != -1)
+            {
+                lock.unlock();
+                task_state_type task;
+                const bool found_task = ws_pop_task(worker, task);
+                if (found_task)
+                    ws_run_task(task);
+                lock.lock();
+
+                if (found_task || is_done())
+                    continue;
+            }
+
+            // Either we aren't a worker or there was nothing queued for us to help
+            // with.  So sleep until some worker finishes a task from this shard.
+            shard.task_done.wait(lock);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    long thread_pool_implementation::
+    ws_worker_index (
+    ) const
+    {
+        if (ws_current_pool == this)
+            return ws_current_worker;
+        else
+            return -1;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void thread_pool_implementation::
+    ws_propagate_exception (
+    ) const
+    {
+        if (ws_has_eptr)
+        {
+            std::exception_ptr tmp;
+            {
+                std::lock_guard<std::mutex> lock(ws_eptr_m);
+                tmp = ws_eptr;
+                ws_eptr = nullptr;
+                ws_has_eptr = false;
+            }
+            if (tmp)
+                std::rethrow_exception(tmp);
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -3,9 +3,16 @@
 #ifndef DLIB_THREAD_POOl_Hh_
 #define DLIB_THREAD_POOl_Hh_ 
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "thread_pool_extension_abstract.h"
 #include "multithreaded_object_extension.h"
@@ -23,6 +30,12 @@ namespace dlib
 
     class thread_pool_implementation;
 
+    enum class thread_pool_scheduler
+    {
+        shared_queue,
+        work_stealing
+    };
+
     template <
         typename T
         >
@@ -142,12 +155,25 @@ namespace dlib
                 - m == the mutex used to protect everything in this object
                 - worker_thread_ids == an array that contains the thread ids for
                   all the threads in the thread pool
+
+                - if (scheduler == thread_pool_scheduler::work_stealing) then
+                    - tasks.size() == 0 and the ws_* members hold all the state.
+                    - ws_queues[i] == the deque of tasks owned by the i-th worker thread.
+                      The owner pushes and pops at the back while other workers steal
+                      from the front.  Each deque has its own mutex so there is no lock
+                      shared by all the workers.
+                    - ws_shards[s] == the bookkeeping for tasks submitted by threads
+                      whose ws_thread_slot() % ws_shards.size() == s.  A task with id
+                      ID lives in ws_shards[ID%ws_shards.size()].
+                    - ws_num_queued == the number of tasks sitting in ws_queues.
+                    - ws_num_sleeping == the number of workers blocked on ws_wake.
         !*/
         typedef bound_function_pointer::kernel_1a_c bfp_type;
 
         friend class thread_pool;
-        explicit thread_pool_implementation (
-            unsigned long num_threads
+        thread_pool_implementation (
+            unsigned long num_threads,
+            thread_pool_scheduler scheduler
         );
 
     public:
@@ -167,12 +193,22 @@ namespace dlib
         bool is_task_thread (
         ) const;
 
+        thread_pool_scheduler get_scheduler (
+        ) const { return scheduler; }
+
         template <typename T>
         uint64 add_task (
             T& obj,
             void (T::*funct)()
         )
         {
+            if (scheduler == thread_pool_scheduler::work_stealing)
+            {
+                task_state_type task;
+                task.mfp0.set(obj,funct);
+                return ws_add_task(task);
+            }
+
             auto_mutex M(m);
             const thread_id_type my_thread_id = get_thread_id();
 
@@ -216,6 +252,14 @@ namespace dlib
             long arg1
         )
         {
+            if (scheduler == thread_pool_scheduler::work_stealing)
+            {
+                task_state_type task;
+                task.mfp1.set(obj,funct);
+                task.arg1 = arg1;
+                return ws_add_task(task);
+            }
+
             auto_mutex M(m);
             const thread_id_type my_thread_id = get_thread_id();
 
@@ -261,6 +305,15 @@ namespace dlib
             long arg2
         )
         {
+            if (scheduler == thread_pool_scheduler::work_stealing)
+            {
+                task_state_type task;
+                task.mfp2.set(obj,funct);
+                task.arg1 = arg1;
+                task.arg2 = arg2;
+                return ws_add_task(task);
+            }
+
             auto_mutex M(m);
             const thread_id_type my_thread_id = get_thread_id();
 
@@ -467,6 +520,94 @@ namespace dlib
 
         };
 
+        static void call_task (
+            const task_state_type& task
+        );
+        /*!
+            ensures
+                - invokes whichever of the function pointers in task has been set.
+        !*/
+
+        uint64 ws_add_task (
+            task_state_type& task
+        );
+        /*!
+            requires
+                - scheduler == thread_pool_scheduler::work_stealing
+                - task contains a function pointer to call
+            ensures
+                - pushes task onto the deque of the calling worker thread, or onto one of
+                  the worker deques picked round-robin if the caller isn't a worker.
+                - returns the task id for this new task
+        !*/
+
+        void ws_thread (
+            unsigned long worker_idx
+        );
+        /*!
+            this is the function that executes the threads in the thread pool when
+            the work stealing scheduler is used
+        !*/
+
+        bool ws_pop_task (
+            unsigned long worker_idx,
+            task_state_type& task
+        ) const;
+        /*!
+            requires
+                - worker_idx < ws_queues.size()
+            ensures
+                - if (there is a task in ws_queues) then
+                    - removes a task, preferring the back of ws_queues[worker_idx] and
+                      otherwise stealing from the front of the other deques.
+                    - #task == the removed task
+                    - returns true
+                - else
+                    - returns false
+        !*/
+
+        void ws_run_task (
+            task_state_type& task
+        ) const;
+        /*!
+            ensures
+                - runs task, records any exception it throws, and then marks it as
+                  finished in its shard.
+        !*/
+
+        template <typename predicate>
+        void ws_wait (
+            unsigned long shard_idx,
+            predicate is_done
+        ) const;
+        /*!
+            ensures
+                - blocks until is_done() returns true.  is_done() is only evaluated
+                  while ws_shards[shard_idx]->m is locked.
+                - if (the calling thread is a worker thread) then
+                    - rather than sleeping, the calling thread runs queued tasks
+                      while it waits.  This lets tasks wait on tasks they created
+                      without deadlocking the pool.
+        !*/
+
+        long ws_worker_index (
+        ) const;
+        /*!
+            ensures
+                - if (the calling thread is one of this pool's worker threads) then
+                    - returns the index of its deque in ws_queues
+                - else
+                    - returns -1
+        !*/
+
+        void ws_propagate_exception (
+        ) const;
+        /*!
+            ensures
+                - rethrows the first exception thrown by a task which hasn't yet been
+                  rethrown.
+        !*/
+
         array<task_state_type> tasks;
         array<thread_id_type> worker_thread_ids;
 
@@ -477,6 +618,35 @@ namespace dlib
 
         std::vector<std::thread> threads;
 
+        const thread_pool_scheduler scheduler;
+
+        struct ws_worker_queue
+        {
+            std::mutex m;
+            std::deque<task_state_type> tasks;
+        };
+
+        struct ws_task_shard
+        {
+            std::mutex m;
+            std::condition_variable task_done;
+            uint64 next_task_id = 2;
+            std::unordered_set<uint64> outstanding_ids;
+            std::map<thread_id_type,long> outstanding_per_thread;
+        };
+
+        std::vector<std::unique_ptr<ws_worker_queue>> ws_queues;
+        std::vector<std::unique_ptr<ws_task_shard>> ws_shards;
+        std::mutex ws_sleep_m;
+        std::condition_variable ws_wake;
+        mutable std::atomic<long> ws_num_queued;
+        std::atomic<long> ws_num_sleeping;
+        std::atomic<unsigned long> ws_next_queue;
+        std::atomic<bool> ws_destructing;
+        mutable std::mutex ws_eptr_m;
+        mutable std::exception_ptr ws_eptr;
+        mutable std::atomic<bool> ws_has_eptr;
+
         // restricted functions
         thread_pool_implementation(thread_pool_implementation&);        // copy constructor
         thread_pool_implementation& operator=(thread_pool_implementation&);    // assignment operator
@@ -502,7 +672,15 @@ namespace dlib
             unsigned long num_threads
         ) 
         {
-            impl.reset(new thread_pool_implementation(num_threads));
+            impl.reset(new thread_pool_implementation(num_threads, thread_pool_scheduler::shared_queue));
+        }
+
+        thread_pool (
+            unsigned long num_threads,
+            thread_pool_scheduler scheduler
+        ) 
+        {
+            impl.reset(new thread_pool_implementation(num_threads, scheduler));
         }
 
         ~thread_pool (
@@ -536,6 +714,9 @@ namespace dlib
         unsigned long num_threads_in_pool (
         ) const { return impl->num_threads_in_pool(); }
 
+        thread_pool_scheduler get_scheduler (
+        ) const { return impl->get_scheduler(); }
+
         void wait_for_all_tasks (
         ) const { impl->wait_for_all_tasks(); }
 
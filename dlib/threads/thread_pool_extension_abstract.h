@@ -202,6 +202,36 @@ namespace dlib
     template <typename T> bool operator>  (const future<T>& a, const T& b)         { return a.get() >  b; }
     template <typename T> bool operator>  (const T& a,         const future<T>& b) { return a       >  b.get(); }
 
+// ----------------------------------------------------------------------------------------
+
+    enum class thread_pool_scheduler
+    {
+        shared_queue,
+        work_stealing
+    };
+    /*!
+        WHAT THIS ENUM REPRESENTS
+            This enum selects the algorithm a thread_pool uses to hand tasks to its
+            threads.  
+
+            shared_queue: 
+                All tasks go through a single mutex protected table with one slot per
+                thread.  So at most num_threads_in_pool() tasks are outstanding at any
+                time and add_task() blocks when the table is full.  This is the
+                default and doesn't allocate memory after construction.
+
+            work_stealing:
+                Each thread owns a deque of tasks.  A thread pushes the tasks it
+                submits onto its own deque and pops them in LIFO order, while idle
+                threads steal the oldest tasks from the other deques.  Tasks submitted
+                from outside the pool are distributed round-robin over the deques.
+                There is no lock shared by all the threads, so this scales much better
+                when there are many threads and many small tasks, e.g. parallel_for()
+                on a machine with lots of cores.  The number of outstanding tasks is
+                unbounded, so add_task() never blocks.  A pool thread that waits on a
+                task executes other queued tasks while it waits.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     class thread_pool 
@@ -218,12 +248,19 @@ namespace dlib
                 mode any thread that calls add_task() is considered to be
                 a thread_pool thread capable of executing tasks.
 
-                This object is also implemented such that no memory allocations occur 
+                When using the default thread_pool_scheduler::shared_queue scheduler,
+                this object is also implemented such that no memory allocations occur 
                 after the thread_pool has been constructed so long as the user doesn't 
                 call any of the add_task_by_value() routines.  The future object also 
                 doesn't perform any memory allocations or contain any system resources 
                 such as mutex objects. 
 
+                Finally, when the thread_pool_scheduler::work_stealing scheduler is
+                used, add_task() never blocks waiting for a free thread.  So in that
+                mode the "blocks until there is a free thread" parts of the add_task()
+                specs below don't apply.  Instead, tasks are queued and executed as soon
+                as any thread is free.
+
             EXCEPTIONS
                 Note that if an exception is thrown inside a task thread and is not caught
                 then the exception will be trapped inside the thread pool and rethrown at a
@@ -239,6 +276,22 @@ namespace dlib
         /*!
             ensures
                 - #num_threads_in_pool() == num_threads
+                - #get_scheduler() == thread_pool_scheduler::shared_queue
+            throws
+                - std::bad_alloc
+                - dlib::thread_error
+                    the constructor may throw this exception if there is a problem 
+                    gathering resources to create threading objects.
+        !*/
+
+        thread_pool (
+            unsigned long num_threads,
+            thread_pool_scheduler scheduler
+        );
+        /*!
+            ensures
+                - #num_threads_in_pool() == num_threads
+                - #get_scheduler() == scheduler
             throws
                 - std::bad_alloc
                 - dlib::thread_error
@@ -276,6 +329,13 @@ namespace dlib
                   the maximum number of tasks that this object will process concurrently.
         !*/
 
+        thread_pool_scheduler get_scheduler (
+        ) const;
+        /*!
+            ensures
+                - returns the algorithm this thread pool uses to assign tasks to threads.
+        !*/
+
         template <typename F>
         uint64 add_task_by_value (
             const F& function_object
@@ -0,0 +1,112 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures the CPU dnn activation kernels (sigmoid, tanh, mish and
+    softmax) against plain element by element loops calling the std:: math functions,
+    which is how those kernels used to be written.  It also reports the largest
+    difference between the two.  The kernels use default_thread_pool() for big tensors,
+    so the speedup includes both the SIMD and the threading gains.
+
+    Run it like:
+        ./bench_activations
+*/
+
+#include <dlib/dnn.h>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    void scalar_softmax (
+        tensor& dest,
+        const tensor& src
+    )
+    {
+        const long num_locations = src.nr()*src.nc();
+        const float* s = src.host();
+        float* d = dest.host();
+        for (long n = 0; n < src.num_samples(); ++n)
+        {
+            for (long i = 0; i < num_locations; ++i)
+            {
+                const float* ss = s + (n*src.k())*num_locations + i;
+                float* dd = d + (n*src.k())*num_locations + i;
+                float max_val = -std::numeric_limits<float>::infinity();
+                for (long k = 0; k < src.k(); ++k)
+                    max_val = std::max(max_val, ss[k*num_locations]);
+                float total = 0;
+                for (long k = 0; k < src.k(); ++k)
+                    total += dd[k*num_locations] = std::exp(ss[k*num_locations]-max_val);
+                for (long k = 0; k < src.k(); ++k)
+                    dd[k*num_locations] /= total;
+            }
+        }
+    }
+
+    template <typename F, typename G>
+    void run (
+        const string& name,
+        const tensor& src,
+        F&& kernel,
+        G&& reference
+    )
+    {
+        resizable_tensor dest1, dest2;
+        dest1.copy_size(src);
+        dest2.copy_size(src);
+        const double t1 = time_it([&]() { reference(dest1, src); });
+        const double t2 = time_it([&]() { kernel(dest2, src); });
+        cout << setw(10) << name
+             << setw(14) << t1 << setw(14) << t2
+             << setw(10) << t1/t2
+             << setw(14) << max(abs(mat(dest1)-mat(dest2))) << endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main() try
+{
+    resizable_tensor src(32,64,56,56);
+    tt::tensor_rand rnd;
+    rnd.fill_gaussian(src, 0, 3);
+
+    cout << "tensor: " << src.num_samples() << "x" << src.k() << "x" << src.nr() << "x" << src.nc()
+         << ", threads: " << default_thread_pool().num_threads_in_pool() << endl;
+    cout << setw(10) << "kernel" << setw(14) << "std:: ms" << setw(14) << "dlib ms"
+         << setw(10) << "speedup" << setw(14) << "max diff" << endl;
+
+    run("sigmoid", src, [](tensor& d, const tensor& s) { cpu::sigmoid(d, s); },
+        [](tensor& d, const tensor& s) {
+            for (size_t i = 0; i < s.size(); ++i) d.host()[i] = 1/(1+std::exp(-s.host()[i]));
+        });
+    run("tanh", src, [](tensor& d, const tensor& s) { cpu::tanh(d, s); },
+        [](tensor& d, const tensor& s) {
+            for (size_t i = 0; i < s.size(); ++i) d.host()[i] = std::tanh(s.host()[i]);
+        });
+    run("mish", src, [](tensor& d, const tensor& s) { cpu::mish(d, s); },
+        [](tensor& d, const tensor& s) {
+            for (size_t i = 0; i < s.size(); ++i)
+            {
+                const float x = s.host()[i];
+                const float e = std::exp(x);
+                d.host()[i] = x - 2*x/(2*e + e*e + 2);
+            }
+        });
+    run("softmax", src, [](tensor& d, const tensor& s) { cpu::softmax(d, s); }, scalar_softmax);
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
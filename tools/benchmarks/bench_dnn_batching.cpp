@@ -0,0 +1,245 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program is a load generator for dnn_batching_executor and dnn_inference_server.
+    A number of client threads each repeatedly send one image to a CNN and wait for its
+    label, the way the request handlers of a web service would.  For each number of
+    clients it compares three ways of serving them:
+        - unbatched: a single network behind a mutex that runs one image at a time.
+        - batched:   a dnn_batching_executor that groups concurrent images into
+                     mini-batches.
+        - http:      the same executor behind a dnn_inference_server.  Each client
+                     POSTs the raw pixels over a keep-alive connection.
+    It prints the images/second served, the median and 99th percentile latency, and the
+    average mini-batch size.
+
+    Run it like:
+        ./bench_dnn_batching [seconds_per_test] [max_clients] [max_batch_size] [max_delay_ms]
+
+    The benchmark only builds on Linux since the http test uses the event_loop io model.
+*/
+
+#include <dlib/dnn.h>
+#include <dlib/dnn/inference_server.h>
+#include <dlib/misc_api.h>
+#include <dlib/rand.h>
+#include <dlib/sockets.h>
+#include <dlib/string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    using net_type = loss_multiclass_log<fc<10,avg_pool_everything<
+                     relu<con<64,3,3,1,1,
+                     relu<con<32,3,3,2,2,
+                     relu<con<16,3,3,2,2,
+                     input_rgb_image
+                     >>>>>>>>>;
+
+    const long img_size = 64;
+
+    struct result
+    {
+        double rate = 0;
+        double p50_ms = 0;
+        double p99_ms = 0;
+    };
+
+    template <typename F>
+    result run_clients (
+        unsigned long num_clients,
+        double seconds,
+        F make_client
+    )
+    /*!
+        ensures
+            - runs make_client(client_index) in num_clients threads for the given number
+              of seconds.  make_client() returns a function that sends one request and
+              waits for the answer.
+    !*/
+    {
+        std::atomic<bool> done(false);
+        std::mutex m;
+        std::vector<float> latencies_ms;
+        std::vector<std::thread> threads;
+        for (unsigned long c = 0; c < num_clients; ++c)
+        {
+            threads.emplace_back([&,c]() {
+                auto send_request = make_client(c);
+                std::vector<float> lat;
+                while (!done)
+                {
+                    const auto start = clock_type::now();
+                    send_request();
+                    lat.push_back(std::chrono::duration<float,std::milli>(clock_type::now()-start).count());
+                }
+                std::lock_guard<std::mutex> lock(m);
+                latencies_ms.insert(latencies_ms.end(), lat.begin(), lat.end());
+            });
+        }
+        const auto start = clock_type::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        done = true;
+        for (auto& t : threads)
+            t.join();
+        const double elapsed = std::chrono::duration<double>(clock_type::now()-start).count();
+
+        std::sort(latencies_ms.begin(), latencies_ms.end());
+        auto percentile = [&](double p) { return latencies_ms.empty() ? 0.0 : latencies_ms[std::min<size_t>(latencies_ms.size()-1, latencies_ms.size()*p)]; };
+        result r;
+        r.rate = latencies_ms.size()/elapsed;
+        r.p50_ms = percentile(0.50);
+        r.p99_ms = percentile(0.99);
+        return r;
+    }
+
+    class http_client
+    {
+    public:
+        http_client (
+            unsigned short port,
+            const matrix<rgb_pixel>& img
+        ) : con(connect("127.0.0.1", port))
+        {
+            const std::string body((const char*)&img(0,0), img.size()*sizeof(rgb_pixel));
+            request = "POST /predict HTTP/1.1\r\nContent-Length: " + cast_to_string(body.size()) + "\r\n\r\n" + body;
+        }
+
+        void operator() (
+        )
+        {
+            if (con->write(request.data(), request.size()) != (long)request.size())
+                throw dlib::error("error sending request");
+            // Responses are short, so one read almost always gets all of it.
+            buf.clear();
+            size_t header_end;
+            while ((header_end = buf.find("\r\n\r\n")) == std::string::npos ||
+                   buf.size() < header_end+4+content_length(header_end))
+            {
+                char temp[1024];
+                const long num = con->read(temp, sizeof(temp));
+                if (num <= 0)
+                    throw dlib::error("connection closed by server");
+                buf.append(temp, num);
+            }
+        }
+
+    private:
+        size_t content_length (
+            size_t header_end
+        ) const
+        {
+            const size_t pos = buf.find("Content-Length: ");
+            if (pos == std::string::npos || pos > header_end)
+                return 0;
+            return string_cast<size_t>(buf.substr(pos+16, buf.find("\r\n", pos)-pos-16));
+        }
+
+        std::shared_ptr<connection> con;
+        std::string request;
+        std::string buf;
+    };
+
+    void print_row (
+        const std::string& mode,
+        unsigned long clients,
+        const result& r,
+        double batch_size
+    )
+    {
+        cout << setw(8) << clients << "  " << setw(10) << left << mode << right
+             << fixed << setprecision(1) << setw(12) << r.rate
+             << setprecision(2) << setw(12) << r.p50_ms << setw(12) << r.p99_ms
+             << setprecision(1) << setw(12) << batch_size << endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const double seconds = argc > 1 ? string_cast<double>(argv[1]) : 3;
+    const unsigned long max_clients = argc > 2 ? string_cast<unsigned long>(argv[2]) : 64;
+    const size_t max_batch_size = argc > 3 ? string_cast<size_t>(argv[3]) : 32;
+    const double max_delay_ms = argc > 4 ? string_cast<double>(argv[4]) : 2;
+    const auto max_delay = std::chrono::microseconds((long)(max_delay_ms*1000));
+
+    dlib::rand rnd;
+    matrix<rgb_pixel> img(img_size, img_size);
+    for (auto& p : img)
+        p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+
+    net_type net;
+    net(img);
+
+    cout << "max batch size: " << max_batch_size << ", max delay: " << max_delay_ms << "ms" << endl;
+    cout << setw(8) << "clients" << "  " << setw(10) << left << "mode" << right
+         << setw(12) << "images/s" << setw(12) << "p50 ms" << setw(12) << "p99 ms"
+         << setw(12) << "avg batch" << endl;
+    for (unsigned long clients = 1; clients <= max_clients; clients *= 4)
+    {
+        std::mutex net_mutex;
+        const result unbatched = run_clients(clients, seconds, [&](unsigned long) {
+            return [&]() {
+                std::lock_guard<std::mutex> lock(net_mutex);
+                net(img);
+            };
+        });
+        print_row("unbatched", clients, unbatched, 1);
+
+        {
+            dnn_batching_executor<net_type> executor(net, max_batch_size, max_delay);
+            const result batched = run_clients(clients, seconds, [&](unsigned long) {
+                return [&]() { executor(img); };
+            });
+            print_row("batched", clients, batched, executor.get_average_batch_size());
+        }
+
+        {
+            dnn_batching_executor<net_type> executor(net, max_batch_size, max_delay);
+            auto decode = [](const incoming_things& incoming)
+            {
+                if (incoming.body.size() != img_size*img_size*sizeof(rgb_pixel))
+                    throw dlib::error("expected a " + cast_to_string(img_size) + "x" + cast_to_string(img_size) + " RGB image");
+                matrix<rgb_pixel> x(img_size, img_size);
+                std::copy(incoming.body.begin(), incoming.body.end(), (char*)&x(0,0));
+                return x;
+            };
+            auto encode = [](const unsigned long& label, outgoing_things&) { return cast_to_string(label); };
+            dnn_inference_server<net_type> srv(executor, decode, encode);
+            srv.set_listening_ip("127.0.0.1");
+            srv.set_io_model(server_io_model::event_loop, std::max<unsigned long>(clients, max_batch_size));
+            srv.start_async();
+            while (srv.get_listening_port() == 0)
+                dlib::sleep(1);
+
+            const result http = run_clients(clients, seconds, [&](unsigned long) {
+                return http_client(srv.get_listening_port(), img);
+            });
+            print_row("http", clients, http, executor.get_average_batch_size());
+            srv.clear();
+        }
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
@@ -0,0 +1,110 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program runs several copies of a small convolutional network at the same time,
+    each on its own thread, the way a server hosting several models does.  It reports
+    the total number of images per second they get through under different threading
+    policies for the CPU dnn kernels:
+        - all the models sharing the global default_thread_pool(),
+        - each model with its own pool as big as the machine, which is what you get from
+          running the models in separate processes, so the machine is oversubscribed,
+        - each model with a thread_pool_scope holding its share of the cores,
+        - each model running serially with thread_pool_scope(0).
+
+    The fc_ and con_ layers do their matrix multiplies in BLAS when dlib is linked to
+    one, and BLAS has its own threads, so limit those to get meaningful numbers.
+
+    Run it like:
+        OPENBLAS_NUM_THREADS=1 ./bench_dnn_threads
+*/
+
+#include <dlib/dnn.h>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    using net_type = loss_multiclass_log<fc<10,
+                     relu<con<32,3,3,1,1,
+                     max_pool<2,2,2,2,relu<con<32,3,3,1,1,
+                     relu<con<16,5,5,2,2,
+                     input_rgb_image>>>>>>>>>;
+
+    const int batches_per_model = 20;
+    const size_t mini_batch_size = 8;
+
+    // threads_per_model == -1 means use the global pool, otherwise each model runs
+    // inside a thread_pool_scope with that many threads.
+    double images_per_second (
+        const net_type& trained,
+        const std::vector<matrix<rgb_pixel>>& images,
+        int num_models,
+        long threads_per_model
+    )
+    {
+        std::vector<net_type> nets(num_models, trained);
+        const auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int m = 0; m < num_models; ++m)
+        {
+            threads.emplace_back([&, m]()
+            {
+                std::unique_ptr<thread_pool_scope> scope;
+                if (threads_per_model >= 0)
+                    scope.reset(new thread_pool_scope(threads_per_model));
+                for (int i = 0; i < batches_per_model; ++i)
+                    nets[m](images);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        const auto stop = std::chrono::high_resolution_clock::now();
+        const double secs = std::chrono::duration<double>(stop-start).count();
+        return num_models*batches_per_model*images.size()/secs;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main() try
+{
+    const long cores = std::max(1u, std::thread::hardware_concurrency());
+
+    dlib::rand rnd;
+    std::vector<matrix<rgb_pixel>> images(mini_batch_size);
+    for (auto& img : images)
+    {
+        img.set_size(96, 96);
+        for (auto& p : img)
+            p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+    }
+    net_type net;
+    net(images);
+
+    cout << "cores: " << cores << ", global pool threads: " << default_thread_pool().num_threads_in_pool() << endl;
+    cout << setw(8) << "models" << setw(14) << "global pool" << setw(14) << "oversub"
+         << setw(14) << "fair share" << setw(14) << "serial" << "   (images/s)" << endl;
+    for (int num_models : {1, 2, 4, 8})
+    {
+        cout << setw(8) << num_models
+             << setw(14) << images_per_second(net, images, num_models, -1)
+             << setw(14) << images_per_second(net, images, num_models, cores)
+             << setw(14) << images_per_second(net, images, num_models, std::max(1L, cores/num_models))
+             << setw(14) << images_per_second(net, images, num_models, 0) << endl;
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
@@ -0,0 +1,110 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures how long extract_fhog_features() takes on 1080p and 4K
+    frames, for grayscale and RGB images, when run with a single thread and when run
+    with a thread pool.  It also checks that both give exactly the same features.
+
+    Run it like:
+        ./bench_fhog [num_threads]
+*/
+
+#include <dlib/image_transforms.h>
+#include <dlib/pixel.h>
+#include <dlib/rand.h>
+#include <dlib/string.h>
+#include <dlib/threads.h>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    void make_frame (
+        array2d<rgb_pixel>& img,
+        long nr,
+        long nc
+    )
+    {
+        // Something with both smooth gradients and noise so every orientation bin gets
+        // used.
+        dlib::rand rnd;
+        img.set_size(nr, nc);
+        for (long r = 0; r < nr; ++r)
+        {
+            for (long c = 0; c < nc; ++c)
+            {
+                img[r][c].red = static_cast<unsigned char>(128 + 100*std::sin(r*0.05 + c*0.02));
+                img[r][c].green = static_cast<unsigned char>((r*3 + c)%256);
+                img[r][c].blue = rnd.get_random_8bit_number();
+            }
+        }
+    }
+
+    template <typename image_type>
+    void run (
+        const string& name,
+        const image_type& img,
+        int cell_size,
+        thread_pool& serial,
+        thread_pool& parallel
+    )
+    {
+        dlib::array<array2d<float> > hog1, hog2;
+        const double t1 = time_it([&]() { extract_fhog_features(serial, img, hog1, cell_size); });
+        const double t2 = time_it([&]() { extract_fhog_features(parallel, img, hog2, cell_size); });
+
+        bool same = true;
+        for (unsigned long i = 0; i < hog1.size(); ++i)
+            same = same && mat(hog1[i]) == mat(hog2[i]);
+
+        cout << setw(14) << name << setw(6) << cell_size
+             << setw(14) << t1 << setw(14) << t2
+             << setw(10) << t1/t2 
+             << setw(12) << (same ? "yes" : "NO") << endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const unsigned long num_threads = argc > 1 ? string_cast<unsigned long>(argv[1]) : 
+        std::max(1u, std::thread::hardware_concurrency());
+    thread_pool serial(1), parallel(num_threads);
+
+    cout << "threads: " << num_threads << endl;
+    cout << setw(14) << "image" << setw(6) << "cell"
+         << setw(14) << "1 thread ms" << setw(14) << "N threads ms"
+         << setw(10) << "speedup" << setw(12) << "identical" << endl;
+
+    const long sizes[][2] = {{1080,1920}, {2160,3840}};
+    for (auto& size : sizes)
+    {
+        array2d<rgb_pixel> img;
+        array2d<unsigned char> gimg;
+        make_frame(img, size[0], size[1]);
+        assign_image(gimg, img);
+
+        const string res = cast_to_string(size[1]) + "x" + cast_to_string(size[0]);
+        for (int cell_size : {8, 4})
+        {
+            run(res + " gray", gimg, cell_size, serial, parallel);
+            run(res + " rgb", img, cell_size, serial, parallel);
+        }
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
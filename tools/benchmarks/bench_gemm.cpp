@@ -0,0 +1,116 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program compares the float GEMM dlib falls back on when no BLAS library is
+    linked (default_matrix_multiply(), which uses packed panels, SIMD, and the default
+    thread pool) against the cache blocked loop it replaced and, if dlib was built with
+    BLAS support, against the BLAS sgemm.
+
+    Run it like:
+        ./bench_gemm
+*/
+
+#include <dlib/matrix.h>
+#include <dlib/rand.h>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    void blocked_multiply (
+        matrix<float>& dest,
+        const matrix<float>& lhs,
+        const matrix<float>& rhs
+    )
+    {
+        // This is the blocked loop default_matrix_multiply() used before it got the
+        // packed GEMM.
+        const long bs = 90;
+        for (long r = 0; r < lhs.nr(); r+=bs)
+        {
+            for (long c = 0; c < lhs.nc(); c+=bs)
+            {
+                rectangle lhs_block(c, r, std::min(c+bs-1,lhs.nc()-1), std::min(r+bs-1,lhs.nr()-1));
+                for (long i = 0; i < rhs.nc(); i += bs)
+                {
+                    rectangle rhs_block(i, c, std::min(i+bs-1,rhs.nc()-1), std::min(c+bs-1,rhs.nr()-1));
+                    for (long r = lhs_block.top(); r <= lhs_block.bottom(); ++r)
+                    {
+                        for (long c = lhs_block.left(); c<= lhs_block.right(); ++c)
+                        {
+                            const float temp = lhs(r,c);
+                            for (long i = rhs_block.left(); i <= rhs_block.right(); ++i)
+                                dest(r,i) += rhs(c,i)*temp;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    matrix<float> random_matrix (
+        long nr,
+        long nc,
+        dlib::rand& rnd
+    )
+    {
+        matrix<float> m(nr,nc);
+        for (auto& v : m)
+            v = rnd.get_random_float()-0.5f;
+        return m;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main() try
+{
+    cout << setw(6) << "M" << setw(6) << "N" << setw(6) << "K"
+         << setw(14) << "blocked GF/s"
+         << setw(14) << "packed GF/s"
+#ifdef DLIB_USE_BLAS
+         << setw(14) << "BLAS GF/s"
+#endif
+         << setw(12) << "max error" << endl;
+
+    dlib::rand rnd;
+    // The first few are the shapes DNN layers produce, e.g. a conv layer's img2col GEMM
+    // and a fc layer with a mini-batch of 64.
+    const long shapes[][3] = {{64,3136,576}, {64,1000,2048}, {128,128,128}, {256,256,256},
+                              {512,512,512}, {1024,1024,1024}, {37,1001,129}};
+    for (auto& shape : shapes)
+    {
+        const long M = shape[0], N = shape[1], K = shape[2];
+        const matrix<float> a = random_matrix(M,K,rnd);
+        const matrix<float> b = random_matrix(K,N,rnd);
+        matrix<float> c1(M,N), c2(M,N);
+        const double flops = 2.0*M*N*K;
+
+        const double t_blocked = time_it([&]() { c1 = 0; blocked_multiply(c1, a, b); }, 3);
+        const double t_packed = time_it([&]() { c2 = 0; default_matrix_multiply(c2, a, b); }, 3);
+
+        cout << setw(6) << M << setw(6) << N << setw(6) << K
+             << setw(14) << flops/t_blocked*1e-6
+             << setw(14) << flops/t_packed*1e-6;
+#ifdef DLIB_USE_BLAS
+        // With BLAS enabled this expression is handed to sgemm.
+        matrix<float> c3;
+        const double t_blas = time_it([&]() { c3 = a*b; }, 3);
+        cout << setw(14) << flops/t_blas*1e-6;
+#endif
+        cout << setw(12) << max(abs(c1-c2)) << endl;
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures how much memory and time a forward pass of a segmentation
+    style network takes on a large image, with and without
+    enable_inference_memory_planning().  Each configuration runs in its own child
+    process so the peak resident memory reported by the OS can be measured separately
+    for each of them.
+
+    Run it like:
+        ./bench_inference_memory [image_size] [iterations]
+*/
+
+#include <dlib/dnn.h>
+#include <dlib/rand.h>
+#include <dlib/string.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    template <typename SUBNET> using block = relu<add_prev1<con<32,3,3,1,1,relu<con<32,3,3,1,1,tag1<SUBNET>>>>>>;
+
+    using net_type = loss_multiclass_log_per_pixel<
+                     cont<8,4,4,2,2,relu<cont<32,4,4,2,2,
+                     repeat<4,block,
+                     relu<con<32,3,3,2,2,relu<con<16,3,3,2,2,
+                     input_rgb_image
+                     >>>>>>>>>;
+
+    double memory_mb (
+        const std::string& field
+    )
+    {
+        std::ifstream fin("/proc/self/status");
+        std::string line;
+        while (std::getline(fin, line))
+        {
+            if (line.compare(0, field.size(), field) == 0)
+                return string_cast<double>(trim(line.substr(field.size()+1, line.size()-field.size()-3)))/1024;
+        }
+        return 0;
+    }
+
+    void run (
+        const std::string& name,
+        bool planned,
+        long size,
+        int iterations
+    )
+    {
+        dlib::rand rnd;
+        matrix<rgb_pixel> img(size,size);
+        for (auto& p : img)
+            p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+
+        net_type net;
+        if (planned)
+            enable_inference_memory_planning(net);
+
+        const double base = memory_mb("VmRSS");
+        net(img);
+        const double peak = memory_mb("VmHWM") - base;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            net(img);
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+        cout << setw(12) << left << name << right << fixed << setprecision(1)
+             << setw(16) << peak << setw(16) << 1000*secs/iterations << endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const long size = argc > 1 ? string_cast<long>(argv[1]) : 512;
+    const int iterations = argc > 2 ? string_cast<int>(argv[2]) : 5;
+
+    cout << size << "x" << size << " image" << endl;
+    cout << setw(12) << left << "mode" << right << setw(16) << "peak MB" << setw(16) << "ms/image" << endl;
+    cout.flush();
+    for (bool planned : {false, true})
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            run(planned ? "planned" : "regular", planned, size, iterations);
+            return 0;
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
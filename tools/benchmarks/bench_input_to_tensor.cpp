@@ -0,0 +1,140 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures how long input_rgb_image and input_rgb_image_pyramid take to
+    turn batches of RGB images into tensors.  Each is compared against the way they used
+    to do it: converting the pixels one sample at a time on a single thread, and for the
+    pyramid, building each pyramid level for the whole batch after all the samples were
+    copied in.
+
+    Run it like:
+        ./bench_input_to_tensor
+*/
+
+#include <dlib/dnn.h>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    using pyramid_input = input_rgb_image_pyramid<pyramid_down<6>>;
+
+    void serial_planes (
+        const std::vector<matrix<rgb_pixel>>& images,
+        float* ptr,
+        long row_stride,
+        long channel_stride,
+        long sample_stride
+    )
+    {
+        const input_rgb_image input;
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            for (long r = 0; r < images[i].nr(); ++r)
+            {
+                for (long c = 0; c < images[i].nc(); ++c)
+                {
+                    const rgb_pixel temp = images[i](r,c);
+                    float* p = ptr + i*sample_stride + r*row_stride + c;
+                    p[0] = (temp.red-input.get_avg_red())/256.0;
+                    p[channel_stride] = (temp.green-input.get_avg_green())/256.0;
+                    p[2*channel_stride] = (temp.blue-input.get_avg_blue())/256.0;
+                }
+            }
+        }
+    }
+
+    void serial_to_tensor (
+        const std::vector<matrix<rgb_pixel>>& images,
+        resizable_tensor& data
+    )
+    {
+        data.set_size(images.size(), 3, images[0].nr(), images[0].nc());
+        serial_planes(images, data.host_write_only(), data.nc(), data.nr()*data.nc(), data.k()*data.nr()*data.nc());
+    }
+
+    void serial_pyramid_to_tensor (
+        const std::vector<matrix<rgb_pixel>>& images,
+        resizable_tensor& data
+    )
+    {
+        long NR, NC;
+        pyramid_down<6> pyr;
+        auto& rects = data.annotation().get<std::vector<rectangle>>();
+        impl::compute_tiled_image_pyramid_details(pyr, images[0].nr(), images[0].nc(), 10, 11, rects, NR, NC);
+        data.set_size(images.size(), 3, NR, NC);
+        float* ptr = data.host_write_only();
+        for (size_t i = 0; i < data.size(); ++i)
+            ptr[i] = 0;
+        serial_planes(images, ptr + rects[0].top()*data.nc() + rects[0].left(), data.nc(),
+            data.nr()*data.nc(), data.k()*data.nr()*data.nc());
+        for (size_t i = 1; i < rects.size(); ++i)
+        {
+            alias_tensor src(data.num_samples(), data.k(), rects[i-1].height(), rects[i-1].width());
+            alias_tensor dest(data.num_samples(), data.k(), rects[i].height(), rects[i].width());
+            auto asrc = src(data, data.nc()*rects[i-1].top() + rects[i-1].left());
+            auto adest = dest(data, data.nc()*rects[i].top() + rects[i].left());
+            tt::resize_bilinear(adest, data.nc(), data.nr()*data.nc(), asrc, data.nc(), data.nr()*data.nc());
+        }
+    }
+
+    void run (
+        size_t num_images,
+        long nr,
+        long nc
+    )
+    {
+        dlib::rand rnd;
+        std::vector<matrix<rgb_pixel>> images(num_images);
+        for (auto& img : images)
+        {
+            img.set_size(nr, nc);
+            for (auto& p : img)
+                p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+        }
+
+        resizable_tensor data;
+        const input_rgb_image input;
+        const pyramid_input pyramid;
+        const double s1 = time_it([&]() { serial_to_tensor(images, data); });
+        const double p1 = time_it([&]() { input.to_tensor(images.begin(), images.end(), data); });
+        const double s2 = time_it([&]() { serial_pyramid_to_tensor(images, data); });
+        const double p2 = time_it([&]() { pyramid.to_tensor(images.begin(), images.end(), data); });
+
+        ostringstream name;
+        name << num_images << " x " << nr << "x" << nc;
+        cout << setw(18) << name.str()
+             << setw(12) << s1 << setw(12) << p1 << setw(10) << s1/p1
+             << setw(12) << s2 << setw(12) << p2 << setw(10) << s2/p2 << endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main() try
+{
+    cout << "threads: " << default_thread_pool().num_threads_in_pool() << endl;
+    cout << setw(18) << "" << setw(34) << "input_rgb_image (ms)" << setw(34) << "input_rgb_image_pyramid (ms)" << endl;
+    cout << setw(18) << "batch"
+         << setw(12) << "serial" << setw(12) << "parallel" << setw(10) << "speedup"
+         << setw(12) << "serial" << setw(12) << "parallel" << setw(10) << "speedup" << endl;
+
+    run(1, 1080, 1920);
+    run(8, 1080, 1920);
+    run(32, 224, 224);
+    run(128, 64, 64);
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
@@ -0,0 +1,95 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program compares training a classifier with a huge number of classes using a
+    fc_ layer and loss_multiclass_log_, which computes the score of every class for every
+    sample, against fc_sampled_ and loss_multiclass_log_sampled_, which only compute the
+    scores of the labels in the mini-batch and a few thousand randomly sampled ones.  It
+    times the gradient computation of one mini-batch, which is where the two differ, and
+    inference, which is the same dense computation for both.
+
+    Run it like:
+        ./bench_sampled_softmax
+*/
+
+#include <dlib/dnn.h>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    const unsigned long num_classes = 100000;
+    const long num_features = 128;
+    const long mini_batch_size = 64;
+
+    using dense_net = loss_multiclass_log<fc<num_classes,input<matrix<float>>>>;
+    using sampled_net = loss_multiclass_log_sampled<fc_sampled<num_classes,input<matrix<float>>>>;
+
+    template <typename net_type>
+    double time_gradient (
+        net_type& net,
+        const std::vector<matrix<float>>& samples,
+        const std::vector<unsigned long>& labels
+    )
+    {
+        return time_it([&]() { net.compute_parameter_gradients(samples.begin(), samples.end(), labels.begin()); });
+    }
+
+    template <typename net_type>
+    double time_inference (
+        net_type& net,
+        const std::vector<matrix<float>>& samples
+    )
+    {
+        return time_it([&]() { net(samples); });
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main() try
+{
+    dlib::rand rnd;
+    std::vector<matrix<float>> samples(mini_batch_size, matrix<float>(num_features,1));
+    std::vector<unsigned long> labels(mini_batch_size);
+    for (long i = 0; i < mini_batch_size; ++i)
+    {
+        for (auto& v : samples[i])
+            v = rnd.get_random_gaussian();
+        labels[i] = rnd.get_integer(num_classes);
+    }
+
+    cout << "classes: " << num_classes << ", features: " << num_features
+         << ", mini-batch: " << mini_batch_size << endl;
+    cout << setw(28) << "" << setw(14) << "gradient ms" << setw(10) << "speedup"
+         << setw(16) << "inference ms" << endl;
+
+    dense_net dense;
+    const double dense_grad = time_gradient(dense, samples, labels);
+    cout << setw(28) << "fc + loss_multiclass_log" << setw(14) << dense_grad << setw(10) << 1
+         << setw(16) << time_inference(dense, samples) << endl;
+
+    for (unsigned long num_sampled : {1024, 4096, 16384})
+    {
+        sampled_net sampled;
+        layer<1>(sampled).layer_details().set_num_sampled(num_sampled);
+        const double sampled_grad = time_gradient(sampled, samples, labels);
+        cout << setw(28) << ("sampled, " + std::to_string(num_sampled) + " negatives")
+             << setw(14) << sampled_grad << setw(10) << dense_grad/sampled_grad
+             << setw(16) << time_inference(sampled, samples) << endl;
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
@@ -0,0 +1,94 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program compares how long it takes to save and load large objects with the
+    regular dlib serialization format and with a mapped archive (serialize_mapped()).
+    It uses a 100MB matrix<float>, a std::vector<double> and a resizable_tensor of the
+    same size, which is what the weights of a big DNN look like.
+
+    Note that the second and later loads of a file are served from the OS's page cache,
+    which is also the situation for a model file that was just downloaded or that other
+    processes on the machine are using.
+
+    Run it like:
+        ./bench_serialization [megabytes]
+*/
+
+#include <dlib/serialize.h>
+#include <dlib/matrix.h>
+#include <dlib/dnn.h>
+#include <dlib/rand.h>
+#include <dlib/string.h>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    template <typename T>
+    void report (
+        const std::string& name,
+        const T& item
+    )
+    {
+        const std::string regular_file = "bench_serialization_regular.dat";
+        const std::string mapped_file = "bench_serialization_mapped.dat";
+
+        const double t_save = time_it([&]() { serialize(regular_file) << item; }, 3);
+        const double t_save_mapped = time_it([&]() { serialize_mapped(mapped_file) << item; }, 3);
+
+        T temp;
+        const double t_load = time_it([&]() { deserialize(regular_file) >> temp; }, 3);
+        const double t_load_mapped = time_it([&]() { deserialize(mapped_file) >> temp; }, 3);
+
+        cout << setw(20) << left << name << right
+             << setw(12) << t_save << setw(12) << t_save_mapped
+             << setw(12) << t_load << setw(12) << t_load_mapped << endl;
+
+        std::remove(regular_file.c_str());
+        std::remove(mapped_file.c_str());
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const long megabytes = argc > 1 ? string_cast<long>(argv[1]) : 100;
+    const long num_floats = megabytes*1024*1024/sizeof(float);
+
+    dlib::rand rnd;
+    matrix<float> m(num_floats/1024, 1024);
+    for (auto& v : m)
+        v = rnd.get_random_gaussian();
+
+    std::vector<double> v(num_floats/2);
+    for (auto& x : v)
+        x = rnd.get_random_gaussian();
+
+    resizable_tensor t(num_floats/1024, 1024);
+    std::copy(m.begin(), m.end(), t.begin());
+
+    cout << "times in milliseconds for " << megabytes << "MB objects" << endl;
+    cout << setw(20) << left << "object" << right
+         << setw(12) << "save" << setw(12) << "save mapped"
+         << setw(12) << "load" << setw(12) << "load mapped" << endl;
+    cout << fixed << setprecision(1);
+    report("matrix<float>", m);
+    report("std::vector<double>", v);
+    report("resizable_tensor", t);
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
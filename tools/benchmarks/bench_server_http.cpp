@@ -0,0 +1,381 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program is a load generator for dlib::server_http.  It starts a server that
+    answers every request with a short page and then hammers it from a single epoll
+    driven client thread with a fixed number of concurrent connections.  Each connection
+    sends a request, waits for the response and immediately sends the next one.  At the
+    end it prints the requests/second served and the median and 99th percentile
+    latency.
+
+    In the event_loop model the connections are kept alive, so this measures how well
+    the server multiplexes lots of mostly idle connections over its worker threads.  In
+    the thread_per_connection model the server closes each connection after one
+    response, so every request also pays for a connect and a new thread.
+
+    Run it like:
+        ./bench_server_http [event_loop|thread_per_connection] [connections] [seconds] [worker_threads]
+
+    The defaults are event_loop, 10000 connections and 10 seconds.  The benchmark only
+    builds on Linux.  Raise the open file limit (ulimit -n) if it can't open enough
+    connections.
+*/
+
+#include <dlib/server.h>
+#include <dlib/string.h>
+#include <dlib/misc_api.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    typedef std::chrono::steady_clock clock_type;
+
+    class hello_server : public server_http
+    {
+    public:
+        ~hello_server (
+        )
+        {
+            // stop before on_request() goes away
+            clear();
+        }
+
+    private:
+        const std::string on_request (
+            const incoming_things& ,
+            outgoing_things& outgoing
+        )
+        {
+            outgoing.headers["Content-Type"] = "text/plain";
+            return "hello world";
+        }
+    };
+
+    struct client
+    {
+        int fd = -1;
+        bool connecting = false;
+        std::string buf;
+        clock_type::time_point sent;
+    };
+
+    bool response_is_complete (
+        const std::string& buf,
+        size_t& size
+    )
+    /*!
+        ensures
+            - if buf starts with a whole HTTP response then returns true and sets size to
+              its length in bytes.
+    !*/
+    {
+        const size_t header_end = buf.find("\r\n\r\n");
+        if (header_end == std::string::npos)
+            return false;
+        size_t content_length = 0;
+        const size_t pos = buf.find("Content-Length: ");
+        if (pos != std::string::npos && pos < header_end)
+            content_length = std::stoul(buf.substr(pos+16, 20));
+        size = header_end + 4 + content_length;
+        return buf.size() >= size;
+    }
+
+    class load_generator
+    {
+    public:
+        load_generator (
+            unsigned short port_,
+            long num_connections,
+            bool keep_alive_
+        ) :
+            num_errors(0),
+            port(port_),
+            keep_alive(keep_alive_),
+            clients(num_connections),
+            num_connecting(0)
+        {
+            request = keep_alive ? "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n" :
+                                   "GET /hello HTTP/1.0\r\nHost: localhost\r\n\r\n";
+            epoll_fd = epoll_create1(0);
+            if (epoll_fd == -1)
+                throw dlib::error("unable to create an epoll instance");
+            for (auto& c : clients)
+                to_open.push_back(&c);
+        }
+
+        ~load_generator (
+        )
+        {
+            for (auto& c : clients)
+            {
+                if (c.fd != -1)
+                    ::close(c.fd);
+            }
+            ::close(epoll_fd);
+        }
+
+        void run (
+            double warmup_seconds,
+            double seconds
+        )
+        {
+            std::vector<epoll_event> events(1024);
+            const auto start = clock_type::now();
+            measure_begin = start + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(warmup_seconds));
+            measure_end = measure_begin + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(seconds));
+
+            while (clock_type::now() < measure_end)
+            {
+                open_some();
+                const int num = epoll_wait(epoll_fd, &events[0], events.size(), 10);
+                for (int i = 0; i < num; ++i)
+                    handle(*static_cast<client*>(events[i].data.ptr));
+            }
+        }
+
+        std::vector<float> latencies_us;
+        long num_errors;
+        long num_open (
+        ) const
+        {
+            long n = 0;
+            for (auto& c : clients)
+                n += (c.fd != -1 && !c.connecting);
+            return n;
+        }
+
+    private:
+
+        void open_some (
+        )
+        {
+            // Don't flood the listen queue with SYNs or the kernel starts dropping them
+            // and the clients sit in connect() retries for a second or more.
+            for (size_t n = to_open.size(); n != 0 && num_connecting < 256; --n)
+            {
+                client& c = *to_open.front();
+                to_open.pop_front();
+
+                c.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+                if (c.fd == -1)
+                    throw dlib::error("unable to create a socket, raise the open file limit");
+                int flag = 1;
+                setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+                sockaddr_in addr = {};
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(port);
+                addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+                c.connecting = true;
+                c.buf.clear();
+                c.sent = clock_type::now();
+                ++num_connecting;
+                if (::connect(c.fd, (sockaddr*)&addr, sizeof(addr)) == -1 && errno != EINPROGRESS)
+                {
+                    fail(c);
+                    continue;
+                }
+                epoll_event ev;
+                ev.events = EPOLLOUT;
+                ev.data.ptr = &c;
+                epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c.fd, &ev);
+            }
+        }
+
+        void close_client (
+            client& c
+        )
+        {
+            if (c.connecting)
+                --num_connecting;
+            c.connecting = false;
+            ::close(c.fd);
+            c.fd = -1;
+            to_open.push_back(&c);
+        }
+
+        void fail (
+            client& c
+        )
+        {
+            ++num_errors;
+            close_client(c);
+        }
+
+        void send_request (
+            client& c,
+            bool reset_clock
+        )
+        {
+            if (reset_clock)
+                c.sent = clock_type::now();
+            if (::send(c.fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size())
+                fail(c);
+        }
+
+        void handle (
+            client& c
+        )
+        {
+            if (c.connecting)
+            {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(c.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0)
+                {
+                    fail(c);
+                    return;
+                }
+                c.connecting = false;
+                --num_connecting;
+                epoll_event ev;
+                ev.events = EPOLLIN;
+                ev.data.ptr = &c;
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+                // Without keep-alive the connect is part of what each request costs.
+                send_request(c, keep_alive);
+                return;
+            }
+
+            char temp[4096];
+            bool peer_closed = false;
+            while (true)
+            {
+                const ssize_t num = ::recv(c.fd, temp, sizeof(temp), MSG_DONTWAIT);
+                if (num > 0)
+                    c.buf.append(temp, num);
+                else if (num == 0)
+                    peer_closed = true;
+                if (num <= 0 || num < (ssize_t)sizeof(temp))
+                    break;
+            }
+
+            size_t size;
+            if (response_is_complete(c.buf, size))
+            {
+                const auto now = clock_type::now();
+                if (now >= measure_begin && now < measure_end)
+                    latencies_us.push_back(std::chrono::duration<float,std::micro>(now - c.sent).count());
+                c.buf.erase(0, size);
+                if (keep_alive && !peer_closed)
+                    send_request(c, true);
+                else
+                    close_client(c);
+            }
+            else if (peer_closed)
+            {
+                fail(c);
+            }
+        }
+
+        const unsigned short port;
+        const bool keep_alive;
+        std::string request;
+        int epoll_fd;
+        std::vector<client> clients;
+        std::deque<client*> to_open;
+        long num_connecting;
+        clock_type::time_point measure_begin, measure_end;
+    };
+
+    long raise_open_file_limit (
+        long num_connections
+    )
+    /*!
+        ensures
+            - tries to raise the open file limit high enough for num_connections and
+              returns the number of connections we can actually have open.
+    !*/
+    {
+        // Both ends of every connection live in this process, plus some slack for the
+        // listening socket, epoll and whatever else is open.
+        const long slack = 256;
+        rlimit lim;
+        if (getrlimit(RLIMIT_NOFILE, &lim) != 0)
+            return num_connections;
+        const rlim_t needed = 2*num_connections + slack;
+        if (lim.rlim_cur < needed)
+        {
+            lim.rlim_cur = std::min(needed, lim.rlim_max);
+            setrlimit(RLIMIT_NOFILE, &lim);
+            getrlimit(RLIMIT_NOFILE, &lim);
+        }
+        return std::min<long>(num_connections, ((long)lim.rlim_cur - slack)/2);
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const std::string model_name = argc > 1 ? argv[1] : "event_loop";
+    const bool use_event_loop = model_name != "thread_per_connection";
+    long num_connections = argc > 2 ? string_cast<long>(argv[2]) : 10000;
+    const double seconds = argc > 3 ? string_cast<double>(argv[3]) : 10;
+    const unsigned long worker_threads = argc > 4 ? string_cast<unsigned long>(argv[4]) : 0;
+
+    const long max_connections = raise_open_file_limit(num_connections);
+    if (max_connections < num_connections)
+    {
+        cout << "The open file limit only allows " << max_connections << " connections." << endl;
+        num_connections = max_connections;
+    }
+
+    hello_server srv;
+    srv.set_listening_ip("127.0.0.1");
+    srv.set_max_connections(num_connections + 100);
+    srv.set_io_model(use_event_loop ? server_io_model::event_loop : server_io_model::thread_per_connection,
+                     worker_threads);
+    srv.start_async();
+    while (srv.get_listening_port() == 0)
+        dlib::sleep(1);
+
+    load_generator gen(srv.get_listening_port(), num_connections, use_event_loop);
+    // Give all the connections time to get established before we start measuring.
+    const double warmup = std::max(2.0, num_connections/2000.0);
+    gen.run(warmup, seconds);
+
+    std::vector<float>& lat = gen.latencies_us;
+    std::sort(lat.begin(), lat.end());
+    auto percentile = [&](double p) { return lat.empty() ? 0.0f : lat[std::min<size_t>(lat.size()-1, lat.size()*p)]; };
+
+    cout << "io model:          " << (use_event_loop ? "event_loop" : "thread_per_connection") << endl;
+    cout << "connections:       " << num_connections << " (" << gen.num_open() << " open at the end)" << endl;
+    cout << "errors:            " << gen.num_errors << endl;
+    cout << fixed << setprecision(1);
+    cout << "requests/sec:      " << lat.size()/seconds << endl;
+    cout << "p50 latency (ms):  " << percentile(0.50)/1000 << endl;
+    cout << "p99 latency (ms):  " << percentile(0.99)/1000 << endl;
+
+    srv.clear();
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
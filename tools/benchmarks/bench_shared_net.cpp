@@ -0,0 +1,124 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures the inference throughput of a CNN when it is run from several
+    threads at once.  It compares the classic approach of giving every thread its own
+    copy of the network with using a single shared_net, where all threads share one copy
+    of the parameters.  For each thread count it prints images/second and how much
+    memory the parameters take, not counting the original network, which a program
+    using shared_net doesn't need to keep around.
+
+    Run it like:
+        ./bench_shared_net [seconds_per_test] [max_threads]
+*/
+
+#include <dlib/dnn.h>
+#include <dlib/rand.h>
+#include <dlib/string.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    // A small CNN followed by a large fc layer, so most of the parameters are in one
+    // place, like the classifier head of a typical image model.
+    using net_type = loss_multiclass_log<fc<100,relu<fc<512,
+                     relu<affine<con<64,3,3,1,1,
+                     max_pool<2,2,2,2,relu<affine<con<32,3,3,2,2,
+                     input_rgb_image
+                     >>>>>>>>>>>;
+
+    template <typename F>
+    double images_per_second (
+        unsigned long num_threads,
+        double seconds,
+        F make_worker
+    )
+    /*!
+        ensures
+            - runs make_worker(thread_index) in num_threads threads for the given number
+              of seconds.  make_worker() returns a function that classifies one image.
+    !*/
+    {
+        std::atomic<bool> done(false);
+        std::atomic<long> count(0);
+        std::vector<std::thread> threads;
+        for (unsigned long t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back([&,t]() {
+                auto classify = make_worker(t);
+                long n = 0;
+                while (!done)
+                {
+                    classify();
+                    ++n;
+                }
+                count += n;
+            });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        done = true;
+        for (auto& t : threads)
+            t.join();
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        return count/elapsed;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    const double seconds = argc > 1 ? string_cast<double>(argv[1]) : 3;
+    const unsigned long max_threads = argc > 2 ? string_cast<unsigned long>(argv[2]) :
+        std::max(8u, std::thread::hardware_concurrency());
+
+    dlib::rand rnd;
+    matrix<rgb_pixel> img(64,64);
+    for (auto& p : img)
+        p = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+
+    net_type net;
+    net(img);
+    const double param_mb = count_parameters(net)*sizeof(float)/1024.0/1024.0;
+
+    shared_net<net_type> snet(net);
+
+    cout << "parameters: " << fixed << setprecision(1) << param_mb << "MB" << endl;
+    cout << setw(8) << "threads"
+         << setw(16) << "copies img/s" << setw(14) << "copies MB"
+         << setw(16) << "shared img/s" << setw(14) << "shared MB" << endl;
+    for (unsigned long threads = 1; threads <= max_threads; threads *= 2)
+    {
+        std::vector<net_type> copies(threads, net);
+        const double copies_rate = images_per_second(threads, seconds, [&](unsigned long t) {
+            net_type& n = copies[t];
+            return [&n,&img]() { n(img); };
+        });
+
+        const double shared_rate = images_per_second(threads, seconds, [&](unsigned long) {
+            return [&snet,&img]() { snet(img); };
+        });
+
+        cout << setw(8) << threads
+             << setw(16) << copies_rate << setw(14) << param_mb*threads
+             << setw(16) << shared_rate << setw(14) << param_mb << endl;
+    }
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
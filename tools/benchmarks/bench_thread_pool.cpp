@@ -0,0 +1,104 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+/*
+    This program measures the per task overhead of dlib::thread_pool for each of the
+    available schedulers.  It submits batches of tiny tasks (which are dominated by
+    scheduling cost) and of large tasks (which are dominated by the work itself), both
+    directly via add_task() and through parallel_for().
+
+    Run it like:
+        ./bench_thread_pool [num_threads]
+*/
+
+#include <dlib/threads.h>
+#include <dlib/string.h>
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <cmath>
+#include "bench_util.h"
+
+using namespace std;
+using namespace dlib;
+
+// ----------------------------------------------------------------------------------------
+
+namespace
+{
+    volatile double sink = 0;
+
+    double do_work (
+        long iters
+    )
+    {
+        double v = 0;
+        for (long i = 0; i < iters; ++i)
+            v += std::sqrt((double)i);
+        return v;
+    }
+
+    const char* name (
+        thread_pool_scheduler sched
+    )
+    {
+        return sched == thread_pool_scheduler::work_stealing ? "work_stealing" : "shared_queue";
+    }
+
+    void run (
+        thread_pool_scheduler sched,
+        unsigned long num_threads
+    )
+    {
+        thread_pool tp(num_threads, sched);
+
+        const long num_tasks = 200000;
+        for (long work : {0L, 100L, 10000L})
+        {
+            const long n = work > 1000 ? num_tasks/100 : num_tasks;
+
+            const double t_add = time_it([&]() {
+                for (long i = 0; i < n; ++i)
+                    tp.add_task_by_value([work]() { sink = do_work(work); });
+                tp.wait_for_all_tasks();
+            }, 3);
+
+            const double t_pfor = time_it([&]() {
+                parallel_for(tp, 0, n, [work](long) { sink = do_work(work); });
+            }, 3);
+
+            cout << setw(14) << name(sched) 
+                 << setw(8) << num_threads 
+                 << setw(12) << work
+                 << setw(10) << n
+                 << setw(16) << 1e6*t_add/n
+                 << setw(18) << 1e6*t_pfor/n << endl;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    unsigned long num_threads = std::thread::hardware_concurrency();
+    if (argc > 1)
+        num_threads = string_cast<unsigned long>(argv[1]);
+
+    cout << setw(14) << "scheduler" 
+         << setw(8) << "threads" 
+         << setw(12) << "work/task"
+         << setw(10) << "tasks"
+         << setw(16) << "add_task ns"
+         << setw(18) << "parallel_for ns" << endl;
+
+    run(thread_pool_scheduler::shared_queue, num_threads);
+    run(thread_pool_scheduler::work_stealing, num_threads);
+}
+catch (std::exception& e)
+{
+    cout << e.what() << endl;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------
+
@@ -0,0 +1,37 @@
+// Copyright (C) 2026  Davis E. King (davis@dlib.net)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_BENCH_UTIL_H_
+#define DLIB_BENCH_UTIL_H_
+
+#include <algorithm>
+#include <chrono>
+
+// ----------------------------------------------------------------------------------------
+
+template <typename F>
+double time_it (
+    F&& f,
+    int num_runs = 5
+)
+/*!
+    ensures
+        - Calls f() once to warm up and then num_runs more times.  Returns the time of
+          the fastest of those runs in milliseconds.
+!*/
+{
+    f();
+    double best = 1e300;
+    for (int i = 0; i < num_runs; ++i)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        f();
+        const auto stop = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double,std::milli>(stop-start).count());
+    }
+    return best;
+}
+
+// ----------------------------------------------------------------------------------------
+
+#endif // DLIB_BENCH_UTIL_H_
+